@@ -5,6 +5,7 @@
 #include <stdlib.h>
 
 #include "linalg_types.h"
+#include "logs.h"
 
 /**
  * =====================================================================
@@ -39,6 +40,8 @@
  *   2: Allocation failure, heap allocated parameters destroyed, caller must not free.
  *   3: Internal/unspecified failure.
  *   4: Create object failed, caller owns any heap allocated parameters.
+ *   6: Memory budget exceeded (linalg_set_memory_budget()); nothing was
+ *      created, caller owns any heap allocated parameters.
  */
 
 /**
@@ -53,6 +56,7 @@
     2: Allocation failure, elements.list destroyed, caller must not free.
     3: Internal error.
     4: create object failed, caller owns elements.list.
+    6: Memory budget exceeded, caller owns elements.list.
  @pre
     1. name != NULL and name[0] != '\0'.
     2. elements.list != NULL.
@@ -63,6 +67,57 @@
 int linalg_create_bind_matrix(struct List elements, size_t num_rows, size_t num_cols,
                               const char* name);
 
+/**
+ @brief Creates a matrix stored in a single allocation and binds it to name.
+ @param elements: matrix element values; copied into the matrix.
+ @param num_rows: number of matrix rows.
+ @param num_cols: number of matrix cols.
+ @param name: binding name for created matrix.
+ @param mode: INLINE_TAKE: elements.list is owned by the library after the
+    call, exactly as for linalg_create_bind_matrix(). INLINE_COPY: the
+    caller keeps elements.list whatever the result.
+ @return As linalg_create_bind_matrix().
+ @pre As linalg_create_bind_matrix().
+ @note
+    The object, its shape and its elements share one 64-byte-aligned block,
+    so element access does not chase separate header and buffer pointers.
+    Costs one copy of the elements at creation.
+ */
+int linalg_create_bind_matrix_inline(struct List elements, size_t num_rows, size_t num_cols,
+                                     const char* name, enum InlineMode mode);
+
+/**
+ @brief Creates and binds many matrices in one call.
+ @param specs: one (name, elements, num_rows, num_cols) item per matrix.
+ @param count: number of items in `specs` and `status`.
+ @param status: receives one linalg_create_bind_matrix() return code per
+    item:
+    0: Success, elements.list now owned by the library.
+    1: Invalid name, caller owns elements.list.
+    2: Allocation failure, elements.list destroyed, caller must not free.
+    3: Internal error, elements.list destroyed, caller must not free.
+    4: Create object failed, caller owns elements.list.
+    6: Memory budget exceeded, caller owns elements.list.
+ @return
+    0: Every item succeeded.
+    1: Invalid input or library not initialized; no item attempted.
+    2: Allocation failure before any item was attempted; caller owns every
+       elements.list.
+    5: At least one item failed; see `status`.
+ @pre
+    1. specs != NULL, status != NULL, count > 0.
+    2. Each item satisfies the linalg_create_bind_matrix() preconditions.
+ @post
+    Items are bound in array order, so a repeated name ends up bound to its
+    last successful item.
+ @note
+    Equivalent to calling linalg_create_bind_matrix() for each item, but the
+    registry is sized for `count` more bindings up front and the new objects
+    join the object store in one step, which makes large loads considerably
+    cheaper.
+ */
+int linalg_create_bind_matrices(const struct MatrixSpec* specs, size_t count, int* status);
+
 /**
  @brief Creates new vector and binds it to name.
  @param elements: vector element values.
@@ -72,6 +127,8 @@ int linalg_create_bind_matrix(struct List elements, size_t num_rows, size_t num_
     1: Invalid input.
     2: Allocation failure.
     3: Internal error.
+    4: create object failed, caller owns elements.list.
+    6: Memory budget exceeded, caller owns elements.list.
  @pre
     1. name != NULL and name[0] != '\0'.
     2. elements.list != NULL.
@@ -89,11 +146,235 @@ int linalg_create_bind_vector(struct List elements, const char* name);
     1: Invalid input.
     2: Allocation failure.
     3: Internal error.
+    6: Memory budget exceeded.
  @pre
     1. name != NULL and name[0] != '\0'.
  */
 int linalg_create_bind_scalar(double value, const char* name);
 
+/**
+ * =====================================================================
+ * Element buffers
+ * =====================================================================
+ *
+ * Matrices and vectors may be built from any malloc()'d buffer, which has
+ * no alignment beyond malloc()'s. Buffers from linalg_alloc_elements() are
+ * 64-byte aligned, padded to a multiple of 64 bytes, and can optionally be
+ * backed by transparent huge pages, so kernels may use aligned vector
+ * loads on them. Elements the library copies into an object (small and
+ * *_inline() objects) are 64-byte aligned as well.
+ *
+ *   - struct List records how its buffer was allocated in `alloc`. The
+ *     zero value, ELEMENTS_MALLOC, means a plain malloc() buffer, so lists
+ *     built with an initializer keep their old meaning; a List filled in
+ *     field by field must set `alloc` as well.
+ *   - An object that takes ownership of elements.list releases it through
+ *     the path matching `alloc`; pass the List exactly as
+ *     linalg_alloc_elements() filled it (same size and type_size).
+ *   - A buffer that stays with the caller (failed create, INLINE_COPY) is
+ *     released with linalg_free_elements().
+ *   - Memory the library did not allocate and must not free (a mapped file,
+ *     shared memory, another library's array) is bound in place through
+ *     linalg_wrap_elements(): the object uses the caller's memory directly,
+ *     even for tiny sizes, and hands it to a release callback (or nothing,
+ *     for a borrowed buffer) when the object is freed. Wrapped elements do
+ *     not count toward the memory budget.
+ */
+
+/**
+ @brief Allocates an aligned element buffer.
+ @param elements: receives list, size, type_size and alloc.
+ @param size: number of elements.
+ @param type_size: bytes per element.
+ @param kind:
+    ELEMENTS_ALIGNED: 64-byte aligned heap block.
+    ELEMENTS_HUGE: 2 MiB aligned mapping advised for transparent huge pages;
+    requests below 2 MiB get an ELEMENTS_ALIGNED block instead.
+ @return
+    0: Success; elements->alloc tells which kind was allocated.
+    1: Invalid input.
+    2: Allocation failure.
+ @pre
+    1. elements != NULL.
+    2. size > 0, type_size > 0.
+ @post
+    Contents are uninitialized. On failure *elements is zeroed.
+ @note Thread-safe; needs no initialized registry.
+ */
+int linalg_alloc_elements(struct List* elements, size_t size, size_t type_size,
+                          enum ElementAlloc kind);
+
+/**
+ @brief Describes caller memory as an element list, without copying it.
+ @param elements: receives list, size, type_size, alloc and the release pair.
+ @param list: first element.
+ @param size: number of elements.
+ @param type_size: bytes per element.
+ @param release: called as release(release_ctx, list, size * type_size) when
+    the owning object is freed (ELEMENTS_EXTERNAL); NULL borrows the buffer,
+    which the library then never releases (ELEMENTS_BORROWED).
+ @param release_ctx: passed to release.
+ @return
+    0: Success.
+    1: Invalid input.
+ @pre
+    1. elements != NULL, list != NULL.
+    2. size > 0, type_size > 0.
+    3. Borrowed: list stays valid until its object is freed (binding
+       removed and every reference dropped, or shutdown).
+ @post
+    The list may be passed to any create+bind call. Ownership follows the
+    usual rules: once an object takes it, release runs exactly once, on the
+    thread that frees the object; if no object takes it,
+    linalg_free_elements() runs release. On failure *elements is zeroed.
+ @note Thread-safe; needs no initialized registry.
+ */
+int linalg_wrap_elements(struct List* elements, void* list, size_t size, size_t type_size,
+                         element_release_fn release, void* release_ctx);
+
+/**
+ @brief Releases an element buffer the library does not own.
+ @param elements: list as filled by linalg_alloc_elements() (or any
+    malloc()'d list with alloc == ELEMENTS_MALLOC); a NULL list is a no-op.
+ @note Never pass a list owned by an object.
+ */
+void linalg_free_elements(struct List elements);
+
+/**
+ * =====================================================================
+ * Buffer recycling
+ * =====================================================================
+ *
+ * Loops that create and drop same-shaped matrices pay for a fresh
+ * allocation, and for faulting its pages in, every iteration. With the
+ * recycling pool on, a linalg_alloc_elements() buffer whose object is freed
+ * (or that is passed to linalg_free_elements()) is kept, and the next
+ * linalg_alloc_elements() of the same size class and kind gets it back
+ * with its pages still resident.
+ *
+ *   - Buffers of 64 KiB or more are pooled. Their size is rounded up to
+ *     one of 8 classes per power of two, so a class serves requests up to
+ *     12.5% apart; pages beyond what was asked for are never touched.
+ *   - The pool holds at most max_bytes and releases buffers idle for more
+ *     than max_age_ms. Both limits are checked whenever the pool is used;
+ *     linalg_trim_buffer_pool() releases idle buffers on demand.
+ *   - Recycled contents are uninitialized, like any new buffer. Malloc'd
+ *     and wrapped buffers are never pooled.
+ *   - The pool is process-wide (shared by every context) and starts off.
+ */
+
+/**
+ @brief Sets the limits of the buffer recycling pool.
+ @param max_bytes: most bytes kept for reuse; 0 turns the pool off.
+ @param max_age_ms: idle time after which a pooled buffer is released;
+    0 keeps buffers until the cap pushes them out.
+ @return
+    0: Success.
+ @post Pooled buffers beyond the new limits are released at once.
+ @note Thread-safe; needs no initialized registry.
+ */
+int linalg_set_buffer_pool(size_t max_bytes, uint32_t max_age_ms);
+
+/**
+ @brief Releases pooled buffers idle for longer than max_age_ms (0: all).
+ @return Bytes released.
+ @note Thread-safe.
+ */
+size_t linalg_trim_buffer_pool(uint32_t max_age_ms);
+
+/**
+ @brief Reports the recycling pool's contents, limits and hit counters.
+ @return
+    0: Success.
+    1: stats == NULL.
+ @note Thread-safe.
+ */
+int linalg_buffer_pool_stats(struct BufferPoolStats* stats);
+
+/**
+ * =====================================================================
+ * Allocator
+ * =====================================================================
+ *
+ * Every block the library allocates for itself goes through a
+ * struct LinalgAllocator, tagged with the subsystem it is for (enum
+ * AllocSite), so a program can put the library on an arena or a tracking
+ * allocator and profile its memory per subsystem.
+ *
+ *   - The process-wide allocator serves object memory (slabs, inline
+ *     objects, element buffers and the recycling pool), the default
+ *     context's object store and every registry or context created
+ *     without one of its own. It starts as
+ *     malloc()/aligned_alloc()/free() and can only be replaced before the
+ *     library first allocates, so no block outlives its allocator.
+ *   - RegistryConfig.allocator gives one registry its own allocator: the
+ *     default registry (linalg_init_reg_table_config()) or a context
+ *     (linalg_ctx_create(), which also places the context itself and its
+ *     object store there; the objects themselves stay process-wide).
+ *     Everything the registry allocates, snapshots and frozen tables
+ *     included, is freed through it, so its ctx must stay valid until the
+ *     registry and its last snapshot are released.
+ *   - Buffers the caller malloc()'d (ELEMENTS_MALLOC) are freed with
+ *     free(), and huge-page buffers are mapped with mmap(); neither goes
+ *     through the allocator.
+ *   - The per-thread reader records of concurrent registries come from the
+ *     process-wide allocator and are kept for the life of the process.
+ */
+
+/**
+ @brief Replaces the process-wide allocator.
+ @param allocator: allocator to copy; NULL restores the malloc() family.
+ @return
+    0: Success.
+    1: A function pointer in allocator is NULL.
+    4: The library has already allocated through the process-wide allocator.
+ @pre No other thread is calling into the library.
+ @note Call it first thing; the allocator's ctx must stay valid until
+    linalg_shutdown() and the last context is destroyed.
+*/
+int linalg_set_allocator(const struct LinalgAllocator* allocator);
+
+/**
+ * =====================================================================
+ * Memory budget
+ * =====================================================================
+ *
+ * The library counts the bytes held by live math objects (wrapper, shape
+ * header and elements) and the number of objects, per kind, across the
+ * whole process: the default context and every linalg_ctx_*() context
+ * share one set of counters and one budget. With a budget set, a
+ * create+bind that would push the total past it fails with return code 6
+ * before anything is allocated, instead of growing the process until it
+ * swaps or is killed.
+ *
+ *   - Registry memory (names, tables) is not counted.
+ *   - linalg_alloc_elements() buffers count their whole allocation: a huge
+ *     buffer is counted in whole 2 MiB pages.
+ *   - Objects waiting for deferred reclamation count until they are freed.
+ *   - Lowering the budget below current use keeps existing objects; only
+ *     new ones are refused until enough memory has been released.
+ */
+
+/**
+ @brief Sets the process-wide memory budget for math objects.
+ @param max_bytes: hard limit on bytes held by live objects; 0 removes it
+    (the default).
+ @return
+    0: In all cases.
+ @note Thread-safe; needs no initialized registry.
+*/
+int linalg_set_memory_budget(size_t max_bytes);
+
+/**
+ @brief Reports live objects and bytes per kind, and the budget.
+ @param stats: receives the counters.
+ @return
+    0: Success.
+    1: stats == NULL.
+ @note Thread-safe; counters are read one at a time.
+*/
+int linalg_memory_stats(struct MemoryStats* stats);
+
 /**
 @brief:
   Perform final teardown and release all held objects.
@@ -106,7 +387,7 @@ int linalg_shutdown(void);
 /**
  @brief
     Initializes the library's internal name registry.
- @param table_size num elements in hash table; must be > 0.
+ @param table_size initial (and minimum) bucket count; must be > 0.
  @return
     0: Success.
     2: Failure.
@@ -116,16 +397,43 @@ int linalg_shutdown(void);
     Registry is initialized and safe to create+bind APIs.
  @note
     - Registry is internal and released by linalg_shutdown().
+    - The registry grows and shrinks automatically with the number of
+      bindings; table_size does not need to anticipate the final count.
 */
 int linalg_init_reg_table(size_t table_size);
 
+/**
+ @brief
+    Initializes the library's internal name registry with explicit options.
+ @param table_size initial (and minimum) capacity hint; must be > 0.
+ @param config registry options (BORROW); NULL selects the defaults.
+ @return
+    0: Success.
+    2: Failure.
+ @pre
+    1. table_size > 0
+    2. config == NULL or config->backend is a valid enum RegistryBackend.
+ @post
+    Registry is initialized with the requested backend and safe to
+    create+bind APIs.
+ @note
+    - linalg_init_reg_table(n) is equivalent to
+      linalg_init_reg_table_config(n, NULL).
+    - With config->concurrent set, linalg_create_bind_*(),
+      linalg_remove_binding() and the handle calls may be made from many
+      threads at once; bindings of names that land in different shards do
+      not contend. Init and linalg_shutdown() remain single-threaded.
+    - Registry is internal and released by linalg_shutdown().
+*/
+int linalg_init_reg_table_config(size_t table_size, const struct RegistryConfig* config);
+
 /**
  @brief Release a binding by name.
  @param name: Name of binding to remove (null-terminated).
  @return
    0: Success. Binding existed and was removed.
    1: Invalid input.
-   2: Reserved (not returned by this function).
+   2: Allocation failure updating the snapshot map; binding kept.
    3: Internal error.
  @pre
    1. name != NULL.
@@ -141,4 +449,287 @@ int linalg_init_reg_table(size_t table_size);
  */
 int linalg_remove_binding(const char* name);
 
+/**
+ @brief Resolve a name once into a handle for repeated access.
+ @param name: Name of binding to resolve (null-terminated).
+ @param handle: Receives the handle on success.
+ @return
+   0: Success.
+   1: Invalid input or binding not found.
+   2: Allocation failure.
+   3: Internal error.
+ @pre
+   1. name != NULL and name[0] != '\0'.
+   2. handle != NULL.
+ @post
+    - Bindings and objects are unchanged.
+    - The handle stays valid until the binding is removed or rebound to a
+      different object; after that, handle-based calls report it as stale.
+ */
+int linalg_resolve_binding(const char* name, struct BindingHandle* handle);
+
+/**
+ @brief Release a binding through a handle, without hashing its name.
+ @param handle: Handle from linalg_resolve_binding().
+ @return
+   0: Success. Binding existed and was removed.
+   1: Stale handle or library not initialized.
+   2: Allocation failure updating the snapshot map; binding kept.
+   3: Internal error.
+ @post
+    - Every copy of the handle is stale.
+ @warning
+  Object will be destroyed if this is only reference to object.
+ */
+int linalg_remove_binding_handle(struct BindingHandle handle);
+
+/**
+ @brief Report name registry health for monitoring.
+ @param stats: Receives binding/bucket counts, load factor, chain-length
+    figures, cumulative lookup/add/remove counts with probe averages, and
+    negative-filter memory and false-positive rate when enabled.
+ @return
+   0: Success.
+   1: Invalid input or library not initialized.
+ @pre
+   1. stats != NULL.
+ @post
+    - Bindings and objects are unchanged.
+ @note
+    Safe in release builds. Cost grows with the bucket count, so poll it
+    periodically rather than per operation.
+ */
+int linalg_registry_stats(struct RegistryStats* stats);
+
+/**
+ @brief Enumerate bound names that start with `prefix`.
+ @param prefix: Byte prefix to match (null-terminated); "" matches all names.
+ @param visit: Called once per matching name; return nonzero to stop.
+ @param ctx: Passed through to visit.
+ @return
+   0: Success (including no matches or an early stop).
+   1: Invalid input or library not initialized.
+   2: Allocation failure; visit was not called.
+   4: Registry was initialized without config->prefix_index.
+ @pre
+   1. prefix != NULL, visit != NULL.
+ @post
+    - Bindings and objects are unchanged by the enumeration itself.
+ @note
+    - Cost is proportional to the number of matches, not to the number of
+      bindings. Matching is bytewise, so end hierarchical prefixes with
+      their separator ("session42." rather than "session42").
+    - visit may create or remove bindings; matches are gathered before the
+      first call.
+*/
+int linalg_for_each_binding_prefix(const char* prefix, binding_visit_fn visit, void* ctx);
+
+/**
+ @brief Release every binding whose name starts with `prefix`.
+ @param prefix: Byte prefix to match (null-terminated); "" removes all.
+ @param removed: Receives the number of bindings removed (may be NULL).
+ @return
+   0: Success (including no matches).
+   1: Invalid input or library not initialized.
+   2: Allocation failure; *removed reports what was already dropped.
+   4: Registry was initialized without config->prefix_index.
+ @pre
+   1. prefix != NULL.
+ @post
+    - On 0, no binding under `prefix` remains.
+ @note
+    Cost is proportional to the number of matches, not to the number of
+    bindings.
+ @warning
+  Objects will be destroyed if these were their only references.
+*/
+int linalg_remove_bindings_prefix(const char* prefix, size_t* removed);
+
+/**
+ @brief Freeze the current set of names for fast read-mostly lookups.
+ @return
+   0: Success, or already frozen.
+   1: Library not initialized.
+   2: Allocation failure; registry unchanged.
+   5: No perfect hash found for the current names; registry unchanged.
+ @post
+    - Bindings and objects are unchanged.
+    - Name lookups take one probe and one name compare until the next
+      create+bind or remove, which thaws the registry automatically.
+ @note
+    Intended to be called once after a warm-up phase; every write after it
+    pays for dropping the frozen table.
+*/
+int linalg_freeze_registry(void);
+
+/**
+ * =====================================================================
+ * Snapshots
+ * =====================================================================
+ *
+ * A snapshot is a consistent, read-only view of every name binding at one
+ * instant, for readers that must not see a mix of old and new bindings.
+ *
+ *   - The snapshot keeps every object it saw alive, even after its name is
+ *     removed or rebound, until linalg_snapshot_release().
+ *   - Queries on a snapshot take no lock and never block create+bind or
+ *     remove calls; they may run on any thread while the registry changes.
+ *   - Taking a snapshot costs one reference per registry shard, however
+ *     many names are bound. The registry keeps a persistent copy of its
+ *     bindings for this, started by the first snapshot (or at init with
+ *     RegistryConfig.snapshots); from then on every create+bind or remove
+ *     copies a few small nodes.
+ *   - Every snapshot must be released before linalg_shutdown() (or, for a
+ *     context snapshot, linalg_ctx_destroy()).
+ */
+struct RegSnapshot;
+
+/**
+ @brief Pin the current name bindings.
+ @param out: Receives the snapshot.
+ @return
+   0: Success.
+   1: Invalid input or library not initialized.
+   2: Allocation failure.
+ @pre
+   1. out != NULL.
+ @post
+    - Bindings are unchanged; every bound object stays alive while the
+      snapshot is held.
+*/
+int linalg_snapshot(struct RegSnapshot** out);
+
+/**
+ @brief Report whether `name` was bound when `snapshot` was taken.
+ @param snapshot: Snapshot from linalg_snapshot() (BORROW).
+ @param name: Name to look up.
+ @return true if bound in the snapshot; false otherwise or on invalid input.
+*/
+bool linalg_snapshot_has(const struct RegSnapshot* snapshot, const char* name);
+
+/**
+ @brief Return the number of bindings in `snapshot` (0 for NULL).
+*/
+size_t linalg_snapshot_count(const struct RegSnapshot* snapshot);
+
+/**
+ @brief Release a snapshot.
+ @param snapshot: Snapshot to release (NULL is a no-op).
+ @return
+   0: In all cases.
+ @post
+    Objects that were only kept alive by the snapshot are destroyed.
+*/
+int linalg_snapshot_release(struct RegSnapshot* snapshot);
+
+/**
+ * =====================================================================
+ * Contexts
+ * =====================================================================
+ *
+ * A context is an independent library instance: its own name registry,
+ * object store (root set) and log settings. The linalg_*() calls above
+ * operate on one built-in default context; every one of them has a
+ * linalg_ctx_*() counterpart taking an explicit context, with the same
+ * arguments, return codes and semantics.
+ *
+ *   - Contexts share nothing. Objects, names and handles of one context are
+ *     invisible to the others, and destroying a context never touches
+ *     another one or the default context.
+ *   - A context created without config->concurrent takes no locks at all;
+ *     it must only be used by one thread at a time (e.g. one context per
+ *     worker thread or core). With config->concurrent it is safe to share
+ *     exactly like the default context initialized with the same config.
+ *   - Each linalg_ctx_*() call logs with its context's settings
+ *     (linalg_ctx_set_log()); the default context uses the process-wide
+ *     set_log_level()/set_log_sink() settings.
+ *   - A handle resolved in one context must only be used with that context.
+ */
+struct LinalgContext;
+
+/**
+ @brief Create an independent context.
+ @param table_size: initial (and minimum) registry capacity hint; must be > 0.
+ @param config: registry options (BORROW); NULL selects the defaults.
+ @return
+    LinalgContext*: On success.
+    NULL: Invalid input or allocation failure.
+ @post
+    Context is ready for every linalg_ctx_*() call. It logs LOG_ERROR and
+    above to stderr until linalg_ctx_set_log() says otherwise.
+ */
+struct LinalgContext* linalg_ctx_create(size_t table_size, const struct RegistryConfig* config);
+
+/**
+ @brief Release a context with all of its bindings and objects.
+ @param ctx: Context to destroy (NULL is a no-op).
+ @return
+    0: In all cases.
+ @pre
+    1. No other thread is using ctx.
+ @post
+    ctx is freed; other contexts are unaffected.
+ */
+int linalg_ctx_destroy(struct LinalgContext* ctx);
+
+/**
+ @brief Set the log level and sink used by calls on ctx.
+ @param ctx: Context created by linalg_ctx_create().
+ @param level: Minimum level logged.
+ @param sink: Output stream (BORROW); NULL logs to stderr.
+ @return
+    0: Success.
+    1: Invalid input.
+ @pre
+    1. No call on ctx is in progress.
+ */
+int linalg_ctx_set_log(struct LinalgContext* ctx, LogType level, FILE* sink);
+
+/** @brief linalg_create_bind_matrix() on ctx. */
+int linalg_ctx_create_bind_matrix(struct LinalgContext* ctx, struct List elements,
+                                  size_t num_rows, size_t num_cols, const char* name);
+
+/** @brief linalg_create_bind_matrix_inline() on ctx. */
+int linalg_ctx_create_bind_matrix_inline(struct LinalgContext* ctx, struct List elements,
+                                         size_t num_rows, size_t num_cols, const char* name,
+                                         enum InlineMode mode);
+
+/** @brief linalg_create_bind_matrices() on ctx. */
+int linalg_ctx_create_bind_matrices(struct LinalgContext* ctx, const struct MatrixSpec* specs,
+                                    size_t count, int* status);
+
+/** @brief linalg_create_bind_vector() on ctx. */
+int linalg_ctx_create_bind_vector(struct LinalgContext* ctx, struct List elements,
+                                  const char* name);
+
+/** @brief linalg_create_bind_scalar() on ctx. */
+int linalg_ctx_create_bind_scalar(struct LinalgContext* ctx, double value, const char* name);
+
+/** @brief linalg_remove_binding() on ctx. */
+int linalg_ctx_remove_binding(struct LinalgContext* ctx, const char* name);
+
+/** @brief linalg_resolve_binding() on ctx. */
+int linalg_ctx_resolve_binding(struct LinalgContext* ctx, const char* name,
+                               struct BindingHandle* handle);
+
+/** @brief linalg_remove_binding_handle() on ctx. */
+int linalg_ctx_remove_binding_handle(struct LinalgContext* ctx, struct BindingHandle handle);
+
+/** @brief linalg_registry_stats() on ctx. */
+int linalg_ctx_registry_stats(struct LinalgContext* ctx, struct RegistryStats* stats);
+
+/** @brief linalg_for_each_binding_prefix() on ctx. */
+int linalg_ctx_for_each_binding_prefix(struct LinalgContext* ctx, const char* prefix,
+                                       binding_visit_fn visit, void* visit_ctx);
+
+/** @brief linalg_remove_bindings_prefix() on ctx. */
+int linalg_ctx_remove_bindings_prefix(struct LinalgContext* ctx, const char* prefix,
+                                      size_t* removed);
+
+/** @brief linalg_freeze_registry() on ctx. */
+int linalg_ctx_freeze_registry(struct LinalgContext* ctx);
+
+/** @brief linalg_snapshot() on ctx. */
+int linalg_ctx_snapshot(struct LinalgContext* ctx, struct RegSnapshot** out);
+
 #endif // LINALG_H
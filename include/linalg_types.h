@@ -1,13 +1,226 @@
 #ifndef LINALG_TYPES_H
 #define LINALG_TYPES_H
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * How an element buffer was allocated, which decides how it is released.
+ * The zero value is a plain malloc() buffer, so lists built without setting
+ * `alloc` keep working unchanged.
+ */
+enum ElementAlloc
+{
+    ELEMENTS_MALLOC = 0, // caller's malloc()/calloc()/realloc() buffer
+    ELEMENTS_ALIGNED,    // linalg_alloc_elements(): 64-byte aligned heap block
+    ELEMENTS_HUGE,       // linalg_alloc_elements(): 2 MiB aligned mapping, huge page backed
+    ELEMENTS_OBJECT,     // storage inside an object (64-byte aligned); never released alone
+    ELEMENTS_BORROWED,   // linalg_wrap_elements(): caller's memory, never released by the library
+    ELEMENTS_EXTERNAL,   // linalg_wrap_elements(): released by calling `release`
+};
+
+/*
+ * Release callback of an ELEMENTS_EXTERNAL buffer. Called once, with the
+ * List's release_ctx, list and size * type_size, by whichever thread frees
+ * the buffer's owner.
+ */
+typedef void (*element_release_fn)(void* ctx, void* list, size_t bytes);
+
 struct List
 {
     void* list;
     size_t size;
     size_t type_size;
+    enum ElementAlloc alloc;    // release path for `list`
+    element_release_fn release; // ELEMENTS_EXTERNAL only
+    void* release_ctx;          // passed to `release`
 };
 
 struct ObjWrapper;
 
+/*
+ * Library subsystem an allocation is made for, passed to every allocator
+ * call so memory use can be profiled per subsystem. A free always carries
+ * the site its block was allocated with.
+ */
+enum AllocSite
+{
+    ALLOC_SITE_CONTEXT,      // linalg.c: contexts and bulk-call scratch arrays
+    ALLOC_SITE_OBJ_STORE,    // math_objs.c: object stores and per-thread refcount records
+    ALLOC_SITE_OBJ_SLAB,     // obj_slab.c: pages of wrappers, headers and small objects
+    ALLOC_SITE_OBJ_INLINE,   // math_objs.c: single-block *_inline() objects
+    ALLOC_SITE_ELEMENTS,     // obj_buffer.c: linalg_alloc_elements() buffers
+    ALLOC_SITE_REG_TABLE,    // reg_hash.c, reg_flat.c, reg_ebr.c: tables, shards, retire lists
+    ALLOC_SITE_REG_NAMES,    // reg_arena.c: binding nodes and name strings
+    ALLOC_SITE_REG_HANDLES,  // reg_handles.c: binding handle directory
+    ALLOC_SITE_REG_PREFIX,   // reg_trie.c: prefix index and prefix query results
+    ALLOC_SITE_REG_FILTER,   // reg_filter.c: negative lookup filter
+    ALLOC_SITE_REG_FROZEN,   // reg_mphf.c: perfect hash tables of frozen registries
+    ALLOC_SITE_REG_SNAPSHOT, // reg_hash.c, reg_pmap.c: snapshots and persistent map nodes
+    ALLOC_SITE_COUNT,
+};
+
+/*
+ * Memory allocator the library routes its own allocations through
+ * (linalg_set_allocator(), RegistryConfig.allocator). Every function is
+ * required and must be thread-safe; `ctx` is passed back unchanged.
+ *   alloc:         `bytes` bytes aligned for any object type, NULL on failure.
+ *   aligned_alloc: `bytes` bytes (a multiple of `alignment`, a power of two)
+ *                  aligned to `alignment`, NULL on failure.
+ *   free:          releases a block from either function; never NULL.
+ */
+struct LinalgAllocator
+{
+    void* (*alloc)(void* ctx, size_t bytes, enum AllocSite site);
+    void* (*aligned_alloc)(void* ctx, size_t alignment, size_t bytes, enum AllocSite site);
+    void (*free)(void* ctx, void* block, enum AllocSite site);
+    void* ctx;
+};
+
+/*
+ * Ownership of the caller's element buffer for the *_inline() creators, which
+ * copy the elements into the object's own allocation.
+ */
+enum InlineMode
+{
+    INLINE_TAKE, // library frees elements.list on success (create_bind_matrix() contract)
+    INLINE_COPY, // caller keeps elements.list in every case (BORROW)
+};
+
+/*
+ * Live objects of one kind and the bytes they hold: wrapper, header and
+ * elements, whether the elements sit in a separate buffer or inside the
+ * object.
+ */
+struct MemoryUsage
+{
+    size_t objects;
+    size_t bytes;
+};
+
+/*
+ * Process-wide memory held by live math objects (every context included).
+ * Objects waiting for deferred reclamation still count until freed.
+ */
+struct MemoryStats
+{
+    struct MemoryUsage scalars;
+    struct MemoryUsage vectors;
+    struct MemoryUsage matrices;
+    size_t total_bytes;         // sum of the three
+    size_t budget;              // hard limit on total_bytes, 0 = unlimited
+    uint64_t budget_rejections; // creations refused by the budget since start
+};
+
+/*
+ * Element buffer recycling pool (linalg_set_buffer_pool()). Process-wide;
+ * pooled buffers belong to no object and are not part of MemoryStats.
+ */
+struct BufferPoolStats
+{
+    size_t buffers;      // buffers waiting for reuse
+    size_t bytes;        // bytes they hold
+    size_t max_bytes;    // cap on bytes, 0 = pool off
+    uint32_t max_age_ms; // idle limit, 0 = none
+    uint64_t hits;       // allocations served from the pool
+    uint64_t misses;     // poolable allocations that found their class empty
+    uint64_t released;   // buffers the pool gave back (age, cap or trim)
+};
+
+/*
+ * One item of a bulk matrix create+bind (linalg_create_bind_matrices()).
+ * Fields carry the same meaning and preconditions as the arguments of
+ * linalg_create_bind_matrix().
+ */
+struct MatrixSpec
+{
+    const char* name;
+    struct List elements; // ownership transfers only when the item succeeds
+    size_t num_rows;
+    size_t num_cols;
+};
+
+/*
+ * Storage layout used by the name registry.
+ *   REG_BACKEND_CHAINED: separate chaining with incremental rehash (default).
+ *   REG_BACKEND_FLAT:    open addressing with per-slot control bytes and SIMD
+ *                        group probing; fewer allocations and cache misses,
+ *                        but resizes in a single step.
+ */
+enum RegistryBackend
+{
+    REG_BACKEND_CHAINED = 0,
+    REG_BACKEND_FLAT,
+};
+
+/*
+ * Registry construction options. A zero-initialized config selects the
+ * defaults, so callers only set the fields they care about.
+ */
+struct RegistryConfig
+{
+    enum RegistryBackend backend;
+    uint64_t seed; // name hash seed; 0 picks a fresh random seed at init
+    bool concurrent; // thread-safe registry split into independently locked shards
+    size_t shards;   // concurrent only: shard count, rounded up to a power of two; 0 = 16
+    bool prefix_index; // keep a name trie so bindings can be listed/removed by prefix
+    bool negative_filter; // Bloom filter in front of lookups; misses skip the table
+    bool snapshots; // keep a persistent map from the start; snapshots then never copy bindings
+    const struct LinalgAllocator* allocator; // registry (and context) memory; NULL = process-wide
+};
+
+/*
+ * Callback for prefix enumeration. Receives each matching name (valid only
+ * for the duration of the call); return nonzero to stop early.
+ */
+typedef int (*binding_visit_fn)(void* ctx, const char* name);
+
+/*
+ * Resolve-once reference to a registry binding. Obtained by resolving a name
+ * once; later handle-based calls skip hashing and string compares. A handle
+ * goes stale when its binding is removed or rebound, and stale handles are
+ * rejected rather than reaching another binding. Treat the fields as opaque;
+ * a zero-initialized handle is always stale.
+ */
+struct BindingHandle
+{
+    uint32_t index;      // directory slot
+    uint32_t generation; // must match the slot's current generation
+};
+
+#define REG_STATS_HISTOGRAM_BINS 8
+
+/*
+ * Registry health snapshot. A "chain" is a bucket's node list for
+ * REG_BACKEND_CHAINED and one binding's probe sequence (in 16-slot control
+ * groups) for REG_BACKEND_FLAT. Counters are cumulative since init and cover
+ * name-based calls; handle-based calls do not probe and are not counted.
+ */
+struct RegistryStats
+{
+    size_t bindings;
+    size_t buckets;     // chained: live buckets (both tables while rehashing); flat: slots
+    double load_factor; // bindings / buckets
+    size_t max_chain;   // longest chain
+    double mean_chain;  // chained: mean over non-empty buckets; flat: mean probe length
+    size_t chain_histogram[REG_STATS_HISTOGRAM_BINS]; // [n]: chains of length n, last bin n+
+    uint64_t lookups;
+    uint64_t adds;
+    uint64_t removes;
+    uint64_t lookup_probes; // nodes visited (chained) or groups scanned (flat), summed
+    uint64_t add_probes;
+    uint64_t remove_probes;
+    double avg_lookup_probes; // lookup_probes / lookups, 0 when no lookups
+    double avg_add_probes;
+    double avg_remove_probes;
+    size_t frozen_bindings; // bindings served by a frozen perfect hash, 0 when thawed
+    size_t frozen_bytes;    // memory held by frozen tables
+    size_t filter_bytes;    // negative_filter: memory held by the filters, 0 without
+    double filter_bits_per_binding;  // filter_bytes * 8 / bindings, 0 when empty
+    uint64_t filter_rejects;         // lookups answered "absent" without touching the table
+    uint64_t filter_false_positives; // lookups the filter let through that then missed
+    double filter_fpr; // false_positives / (false_positives + rejects), 0 when no misses
+};
+
 #endif // LINALG_TYPES_H
\ No newline at end of file
@@ -26,4 +26,24 @@ int set_log_level(LogType log_level);
 
 int set_log_sink(FILE* new_sink);
 
+/*
+ * Log settings for a scope (e.g. one linalg context). While a scope is
+ * entered on a thread, that thread's log output uses these settings instead
+ * of the process-wide ones from set_log_level()/set_log_sink().
+ */
+struct LogSettings
+{
+    LogType level;
+    FILE* sink; // NULL logs to stderr
+};
+
+/*
+ * Make `settings` (BORROW, NULL = process-wide settings) current for the
+ * calling thread. Returns the previous scope, to be handed back to
+ * log_scope_leave() when the scope ends; scopes nest.
+ */
+const struct LogSettings* log_scope_enter(const struct LogSettings* settings);
+
+void log_scope_leave(const struct LogSettings* outer);
+
 #endif // LOGS_H
@@ -24,6 +24,61 @@ struct Vector;
 struct Scalar;
 struct ObjLL;
 
+/*
+ * Object store: the root set of live objects. Every object belongs to
+ * exactly one store, chosen at creation; decref_obj() removes it from that
+ * store when the last reference goes. The store-less create_*() calls and
+ * destroy_obj_list() use a process-wide store; linalg contexts own private
+ * ones so they can be torn down independently. The store links objects
+ * through the wrappers themselves, so adding and removing one is O(1)
+ * regardless of how many objects are live. Wrappers and Matrix/Vector
+ * headers come from per-type slabs (obj_slab.c) with per-thread caches, so
+ * small objects do not go through malloc().
+ *
+ * Small-object layout: a scalar's value is stored in its wrapper, and a
+ * matrix or vector whose elements fit in 128 bytes (e.g. 4x4 doubles) is
+ * copied into one slab item holding wrapper, header and elements. Neither
+ * form has a separate element allocation; get_obj_type(),
+ * get_obj_elements() and decref_obj() handle every layout alike.
+ *
+ * Element buffers: an object that takes a caller's buffer releases it the
+ * way elements.alloc says it was allocated (free() for ELEMENTS_MALLOC and
+ * ELEMENTS_ALIGNED, munmap() for ELEMENTS_HUGE; see obj_buffer.h). Buffers
+ * from obj_buffer_alloc() and every payload the library packs into an
+ * object (reported as ELEMENTS_OBJECT) are 64-byte aligned. Wrapped caller
+ * memory (obj_buffer_wrap()) is bound in place whatever its size: a
+ * borrowed buffer is never released, an external one goes back to its
+ * release callback when the object is freed.
+ *
+ * Memory accounting: every object's bytes (wrapper, header and elements,
+ * except wrapped caller memory) are counted per ObjType, process-wide,
+ * from just before its storage is allocated until it is freed. With a
+ * budget set, a create_*() call that would push the total past it fails up
+ * front and obj_budget_rejected() tells the caller why.
+ *
+ * Reference counts are biased toward the creating thread: its
+ * incref_obj()/decref_obj() calls use plain loads and stores on a private
+ * count, other threads use an atomic shared count. When other threads drop
+ * more references than they took, the object is queued for its owner, which
+ * merges the two counts at its next decref_obj() or when it exits (a later
+ * thread inherits an exited thread's objects). Objects can therefore be
+ * passed between threads freely; an object is destroyed exactly once, when
+ * the two counts together reach 0.
+ */
+struct ObjStore;
+
+/*
+ * When the memory of an object whose last reference was dropped is freed.
+ * The object leaves its store (and can no longer be reached) immediately in
+ * every mode; only the free() calls move.
+ */
+enum ReclaimMode
+{
+    RECLAIM_INLINE,     // freed by the thread that drops the last reference (default)
+    RECLAIM_DEFERRED,   // queued until obj_store_collect()
+    RECLAIM_BACKGROUND, // queued and freed by a reclaimer thread
+};
+
 /* ============================================================================
  * Public API
  * ============================================================================
@@ -44,13 +99,95 @@ struct ObjLL;
   num_rows > 0.
   num_cols > 0.
   elements.size == num_rows * num_cols.
-@post None.
+  elements.alloc is ELEMENTS_MALLOC, ELEMENTS_ALIGNED or ELEMENTS_HUGE and
+    matches how elements.list was allocated, or the List comes from
+    obj_buffer_wrap().
+@post
+  On success the object owns elements.list. Payloads of up to 128 bytes are
+  copied into the object and elements.list is freed right away, so callers
+  must not touch it after a successful call either way. Wrapped lists are
+  never copied: the object reads and writes the caller's memory and
+  releases it (ELEMENTS_EXTERNAL) only when freed.
 @note
   - Object destruction occurs when the final reference is released via
     `decref_obj()`.
  */
 struct ObjWrapper* create_matrix(struct List elements, size_t num_rows, size_t num_cols);
 
+/**
+@brief
+  create_matrix() into a specific object store.
+@param store: Store that will hold the object; NULL selects the process-wide
+  store.
+@return As create_matrix().
+@pre As create_matrix().
+@post On success the object belongs to `store`.
+ */
+struct ObjWrapper* create_matrix_in(struct ObjStore* store, struct List elements, size_t num_rows,
+                                    size_t num_cols);
+
+/**
+@brief
+  Create a matrix whose wrapper, shape header and elements share one
+  allocation.
+@param store: Store that will hold the object; NULL selects the process-wide
+  store.
+@param elements: Numeric list of matrix elements; copied into the object.
+@param num_rows: Number of rows.
+@param num_cols: Number of columns.
+@param mode: INLINE_TAKE frees elements.list on success; INLINE_COPY leaves
+  it with the caller.
+@return As create_matrix().
+@pre As create_matrix().
+@post
+  On failure elements.list stays with the caller in either mode.
+@note
+  - The block is 64-byte aligned and so is the element payload, which
+    directly follows the header: reaching the first element from the
+    wrapper costs no extra dependent load.
+  - Payloads of up to 128 bytes use the small-object layout instead (also
+    64-byte aligned).
+  - elements.list may be any readable buffer (ELEMENTS_OBJECT included)
+    with INLINE_COPY; INLINE_TAKE releases it according to elements.alloc.
+  - decref_obj() releases the whole block at once.
+ */
+struct ObjWrapper* create_matrix_inline(struct ObjStore* store, struct List elements,
+                                        size_t num_rows, size_t num_cols, enum InlineMode mode);
+
+/**
+@brief
+  Create one matrix object per spec in a single pass.
+@param specs: Matrix specs (BORROW).
+@param count: Number of specs.
+@param objects: Receives one ObjWrapper* per spec, NULL where that item
+  failed validation or allocation. Items with a NULL or empty name are
+  skipped (NULL) since they could never be bound.
+@return
+  Number of objects created.
+@pre
+  specs != NULL, objects != NULL.
+@post
+  Every created object is in the root set with ref_count == 1 and owns its
+  elements.list; failed items leave elements.list with the caller.
+@note
+  - Equivalent to create_matrix() per spec, but the root set is extended
+    under one lock acquisition.
+  - Logs one summary line instead of one line per object.
+ */
+size_t create_matrices(const struct MatrixSpec* specs, size_t count, struct ObjWrapper** objects);
+
+/**
+@brief
+  create_matrices() into a specific object store.
+@param store: Store that will hold the objects; NULL selects the
+  process-wide store.
+@param over_budget: NULL, or `count` flags; over_budget[i] is set when item
+  i was refused by the memory budget.
+@return As create_matrices().
+ */
+size_t create_matrices_in(struct ObjStore* store, const struct MatrixSpec* specs, size_t count,
+                          struct ObjWrapper** objects, bool* over_budget);
+
 /**
 @brief
   Create a vector object from a caller-provided element buffer.
@@ -62,7 +199,8 @@ struct ObjWrapper* create_matrix(struct List elements, size_t num_rows, size_t n
   elements.list != NULL.
   elements.type_size > 0.
   elements.size > 0.
-@post None.
+  elements.alloc as for create_matrix().
+@post As create_matrix().
 @note
   - All created objects are registered with the root set immediately.
 
@@ -73,6 +211,29 @@ struct ObjWrapper* create_matrix(struct List elements, size_t num_rows, size_t n
  */
 struct ObjWrapper* create_vector(struct List elements);
 
+/**
+@brief
+  create_vector() into a specific object store.
+@param store: Store that will hold the object; NULL selects the process-wide
+  store.
+@return As create_vector().
+ */
+struct ObjWrapper* create_vector_in(struct ObjStore* store, struct List elements);
+
+/**
+@brief
+  Vector counterpart of create_matrix_inline().
+@param store: Store that will hold the object; NULL selects the process-wide
+  store.
+@param elements: Numeric list of vector elements; copied into the object.
+@param mode: As create_matrix_inline().
+@return As create_vector().
+@pre As create_vector().
+@post As create_matrix_inline().
+ */
+struct ObjWrapper* create_vector_inline(struct ObjStore* store, struct List elements,
+                                        enum InlineMode mode);
+
 /**
 @brief
   Create new scalar object with value given by `value`.
@@ -92,6 +253,15 @@ struct ObjWrapper* create_vector(struct List elements);
  */
 struct ObjWrapper* create_scalar(double value);
 
+/**
+@brief
+  create_scalar() into a specific object store.
+@param store: Store that will hold the object; NULL selects the process-wide
+  store.
+@return As create_scalar().
+ */
+struct ObjWrapper* create_scalar_in(struct ObjStore* store, double value);
+
 /**
 @brief
   Return `type` field for passed wrapper.
@@ -107,6 +277,18 @@ struct ObjWrapper* create_scalar(double value);
  */
 enum ObjType get_obj_type(const struct ObjWrapper* wrapper);
 
+/**
+@brief
+  Return the element list of a matrix or vector.
+@param wrapper: Object to inspect.
+@return
+  const List*: Elements owned by the object (valid while it is alive).
+  NULL: wrapper is NULL or a scalar.
+@pre None.
+@post None.
+ */
+const struct List* get_obj_elements(const struct ObjWrapper* wrapper);
+
 /**
 @brief
   Perform decrementing and possibly deletion of wrappers.
@@ -120,6 +302,9 @@ enum ObjType get_obj_type(const struct ObjWrapper* wrapper);
   wrapper != NULL.
 @post None.
 @note Enforces invariant: Cannot decrement `wrapper` with `ref_count` == 0.
+@note Thread-safe: exactly one caller observes the transition to 0 and
+  destroys the object. On the creating thread no atomic read-modify-write
+  is needed; also merges counts other threads queued for this thread.
 @warning
  */
 int decref_obj(struct ObjWrapper* wrapper);
@@ -138,22 +323,140 @@ int decref_obj(struct ObjWrapper* wrapper);
   wrapper->ref_count != 0.
 @post None.
 @note Enforces invariant: Active object `ref_count` > 0.
+@note Thread-safe; never revives an object whose count already reached 0.
+  Lock-free and atomic-free on the creating thread.
 @warning None.
  */
 int incref_obj(struct ObjWrapper* wrapper);
 
 /**
 @brief
-  Perform final teardown of `obj_list`.
+  Perform final teardown of the process-wide object store.
 @return
   0: In all cases.
 @pre: None.
-@post: None.
+@post: The calling thread's slab caches are flushed and every completely
+  free slab page is released.
 @note Used exclusively for program/session shutdown.
-@warning None.
+@warning Not thread-safe; no other thread may use any object during the call.
  */
 int destroy_obj_list();
 
+/**
+@brief
+  Create an empty object store.
+@param locked: true if objects of the store may be created or destroyed
+  from several threads at once; false skips the store mutex entirely.
+@param allocator: Source of the store block (NULL for the process-wide
+  allocator); must outlive the store. Objects keep using the process-wide
+  allocator: their slab pages are shared by every store and their blocks are
+  freed wherever the last reference drops.
+@return
+  ObjStore*: On success.
+  NULL: On allocation failure.
+@pre None.
+@post Store is empty.
+@note An unlocked store must only be used by one thread at a time.
+ */
+struct ObjStore* obj_store_init(bool locked, const struct LinalgAllocator* allocator);
+
+/**
+@brief
+  Release every object left in `store`, then the store itself.
+@param store: Store to destroy (NULL is a no-op).
+@return
+  0: In all cases.
+@pre Every remaining object holds exactly one reference (its binding has
+  already been released).
+@post `store` is freed.
+@warning Not thread-safe; no other thread may use the store's objects.
+ */
+int obj_store_destroy(struct ObjStore* store);
+
+/**
+@brief
+  Return the number of live objects in `store`.
+@param store: Store to query; NULL selects the process-wide store.
+@return Object count.
+ */
+size_t obj_store_count(struct ObjStore* store);
+
+/**
+@brief
+  Choose when the memory of objects released from `store` is freed.
+@param store: Store to configure; NULL selects the process-wide store.
+@param mode: RECLAIM_INLINE, RECLAIM_DEFERRED or RECLAIM_BACKGROUND.
+@param max_pending: Queue length at which releasing threads are held back;
+  0 selects the default (1024).
+@return
+  0: Success.
+  1: Invalid mode.
+  2: Reclaimer thread could not be started (store left in RECLAIM_INLINE).
+@pre Not called concurrently for the same store.
+@post Anything queued under the previous mode has been freed.
+@note
+  - In the deferred modes the last decref_obj() only unlinks the object
+    (obj_store_count() drops at once) and queues it; wrapper, header and
+    element buffer are freed by obj_store_collect() or the reclaimer thread.
+  - Backpressure: with max_pending objects queued, a releasing thread waits
+    for the reclaimer (RECLAIM_BACKGROUND) or frees the queue itself
+    (RECLAIM_DEFERRED) before queuing more.
+  - obj_store_destroy() and destroy_obj_list() stop the reclaimer and free
+    the queue; the process-wide store is back in RECLAIM_INLINE afterwards.
+ */
+int obj_store_set_reclaim(struct ObjStore* store, enum ReclaimMode mode, size_t max_pending);
+
+/**
+@brief
+  Free every object queued for deferred reclamation in `store`.
+@param store: Store to collect; NULL selects the process-wide store.
+@return Number of objects freed.
+@note Thread-safe; valid in any mode (a no-op when nothing is queued).
+ */
+size_t obj_store_collect(struct ObjStore* store);
+
+/**
+@brief
+  Return the number of objects queued for deferred reclamation.
+@param store: Store to query; NULL selects the process-wide store.
+@return Queue length.
+ */
+size_t obj_store_pending(struct ObjStore* store);
+
+/**
+@brief
+  Set the process-wide hard limit on bytes held by live objects.
+@param max_bytes: Budget; 0 removes the limit.
+@return None.
+@pre None.
+@post Later create_*() calls that would exceed the budget return NULL.
+@note
+  - Objects already alive are kept even if they exceed a lowered budget.
+  - Thread-safe. Concurrent creations never overshoot the budget together.
+ */
+void obj_set_memory_budget(size_t max_bytes);
+
+/**
+@brief
+  Snapshot the live object and byte counters.
+@param stats: Receives the counters.
+@return
+  0: Success.
+  1: stats == NULL.
+@note Counters are read one at a time; under concurrent creation they may
+  be mutually inconsistent by a few objects.
+ */
+int obj_memory_stats(struct MemoryStats* stats);
+
+/**
+@brief
+  Tell whether the calling thread's most recent create_*() call was refused
+  by the memory budget.
+@return true if that call returned NULL (or skipped a create_matrices_in()
+  item) because of the budget; false otherwise.
+ */
+bool obj_budget_rejected(void);
+
 /* ============================================================================
  * Public debug functions
  * ============================================================================
@@ -169,7 +472,8 @@ int destroy_obj_list();
 @pre
   wrapper != NULL.
 @post None.
-@note None.
+@note Sums the owner's and the shared count; exact on the creating thread
+  or while no other thread uses the object.
 @warning None.
  */
 size_t debug_get_obj_refcount(const struct ObjWrapper* wrapper);
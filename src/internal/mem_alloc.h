@@ -0,0 +1,133 @@
+#ifndef MEM_ALLOC_H
+#define MEM_ALLOC_H
+
+#include <stddef.h>
+
+#include "linalg_types.h"
+
+/* ============================================================================
+ * Module overview / invariants
+ * ============================================================================
+  - The one path between the library and the system allocator. Every
+    internal allocation names a struct LinalgAllocator and an AllocSite;
+    the block is later freed through the same allocator with the same site.
+  - A NULL allocator means the process-wide one: malloc()/aligned_alloc()/
+    free() unless mem_set_process_allocator() installed another before the
+    library first allocated. It cannot change afterwards, so blocks never
+    outlive the allocator that made them.
+  - Structures that may use a non-default allocator (registries, contexts
+    and what hangs off them) keep a resolved copy (mem_resolve()) and pass
+    its address; they never fall back to the process-wide allocator for
+    blocks they own.
+  - Caller-allocated element buffers (ELEMENTS_MALLOC) are freed with
+    free() and huge-page buffers with munmap(); neither goes through here.
+ */
+
+/* ============================================================================
+ * Public API
+ * ============================================================================
+ */
+
+/**
+@brief
+  Install the process-wide allocator.
+@param allocator Allocator to copy; NULL restores the malloc() family.
+@return
+  0: Success.
+  1: Invalid input (a function pointer is NULL).
+  4: The process-wide allocator has already been used.
+@pre No other library call is running.
+@post On success every later process-wide allocation goes through it.
+@note Only valid before the library first allocates.
+ */
+int mem_set_process_allocator(const struct LinalgAllocator* allocator);
+
+/**
+@brief
+  Check a caller-supplied allocator.
+@param allocator Allocator to check; NULL (the process-wide one) is valid.
+@return true if every function pointer is set.
+@pre None.
+@post None.
+@note Thread-safe.
+ */
+bool mem_valid(const struct LinalgAllocator* allocator);
+
+/**
+@brief
+  Copy of the allocator a structure should keep for its own blocks.
+@param allocator Requested allocator, or NULL for the process-wide one.
+@return *allocator, or the process-wide allocator (which then counts as
+  used).
+@pre mem_valid(allocator).
+@post None.
+@note Thread-safe.
+ */
+struct LinalgAllocator mem_resolve(const struct LinalgAllocator* allocator);
+
+/**
+@brief
+  Allocate `bytes` bytes.
+@param allocator Allocator, or NULL for the process-wide one.
+@param bytes Size; 0 is passed on like malloc(0).
+@param site Subsystem making the allocation.
+@return Block on success, NULL on failure.
+@pre None.
+@post Release with mem_free(allocator, block, site).
+@note Thread-safe.
+ */
+void* mem_alloc(const struct LinalgAllocator* allocator, size_t bytes, enum AllocSite site);
+
+/**
+@brief
+  Allocate `count * size` zeroed bytes.
+@return Block on success, NULL on failure or when the product overflows.
+@pre As mem_alloc().
+@post As mem_alloc().
+@note Thread-safe.
+ */
+void* mem_calloc(const struct LinalgAllocator* allocator, size_t count, size_t size,
+                 enum AllocSite site);
+
+/**
+@brief
+  Allocate `bytes` bytes aligned to `alignment`.
+@param alignment Power of two.
+@param bytes Multiple of alignment.
+@return Block on success, NULL on failure.
+@pre As mem_alloc().
+@post As mem_alloc().
+@note Thread-safe.
+ */
+void* mem_aligned_alloc(const struct LinalgAllocator* allocator, size_t alignment, size_t bytes,
+                        enum AllocSite site);
+
+/**
+@brief
+  Resize a block to `new_bytes`, keeping its first min(old, new) bytes.
+@param block Block from mem_alloc() with the same allocator and site, or
+  NULL.
+@param old_bytes Current size of block (0 when NULL).
+@return New block on success (block is released); NULL on failure (block
+  untouched).
+@pre As mem_alloc().
+@post As mem_alloc().
+@note Thread-safe. Allocates and copies (the allocator interface has no
+  realloc), except with the malloc() family, where it calls realloc().
+ */
+void* mem_realloc(const struct LinalgAllocator* allocator, void* block, size_t old_bytes,
+                  size_t new_bytes, enum AllocSite site);
+
+/**
+@brief
+  Release a block.
+@param block Block from mem_alloc()/mem_calloc()/mem_aligned_alloc()/
+  mem_realloc() with the same allocator and site; NULL is a no-op.
+@return None.
+@pre None.
+@post block released.
+@note Thread-safe.
+ */
+void mem_free(const struct LinalgAllocator* allocator, void* block, enum AllocSite site);
+
+#endif // MEM_ALLOC_H
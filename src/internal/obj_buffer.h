@@ -0,0 +1,159 @@
+#ifndef OBJ_BUFFER_H
+#define OBJ_BUFFER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "linalg_types.h"
+
+/* ============================================================================
+ * Module overview / invariants
+ * ============================================================================
+  - Element buffers for matrices and vectors allocated by the library, and
+    the one release routine for every element buffer an object can own.
+  - Library buffers start on an OBJ_BUFFER_ALIGN boundary and their length
+    is padded to a multiple of it, so kernels may use aligned full-width
+    loads up to and including the last element.
+  - ELEMENTS_HUGE buffers of at least OBJ_BUFFER_HUGE_BYTES are mapped
+    directly, aligned to OBJ_BUFFER_HUGE_BYTES and marked MADV_HUGEPAGE so
+    the kernel may back them with transparent huge pages. Smaller requests
+    get an ELEMENTS_ALIGNED buffer instead; elements->alloc always records
+    what was actually allocated.
+  - The release path is picked from elements.alloc; a mapping's length is
+    recomputed from size * type_size, so neither may change while the
+    buffer lives.
+  - Library buffers of OBJ_BUFFER_POOL_MIN_BYTES or more are sized to a
+    size class (at most 12.5% above the request; pages past the request are
+    never touched). With the recycling pool on, releasing one keeps it for
+    the next request of the same class and kind instead of freeing it, so
+    same-shaped temporaries reuse memory that is already faulted in. The
+    pool is process-wide, bounded by a byte cap, and drops buffers that sit
+    idle longer than its age limit (checked whenever the pool is used).
+  - Wrapped buffers (ELEMENTS_BORROWED, ELEMENTS_EXTERNAL) are the caller's
+    memory described as a List, without copying. Borrowed ones are never
+    released; external ones are handed back to their release callback.
+ */
+
+/* ============================================================================
+ * Public types
+ * ============================================================================
+ */
+#define OBJ_BUFFER_ALIGN 64                // element payload alignment (one cache line)
+#define OBJ_BUFFER_HUGE_BYTES (2ul << 20) // transparent huge page size on x86-64
+#define OBJ_BUFFER_POOL_MIN_BYTES ((size_t)64 << 10) // smallest size-class (poolable) request
+
+/* ============================================================================
+ * Public API
+ * ============================================================================
+ */
+
+/**
+@brief
+  Allocate an aligned element buffer.
+@param elements Receives list, size, type_size and alloc.
+@param size Number of elements.
+@param type_size Bytes per element.
+@param kind ELEMENTS_ALIGNED or ELEMENTS_HUGE.
+@return
+  0: Success.
+  1: Invalid input (elements NULL, size or type_size 0, byte count overflows,
+     or another kind).
+  2: Allocation failure.
+@pre None.
+@post On success elements->list is OBJ_BUFFER_ALIGN aligned (and
+  OBJ_BUFFER_HUGE_BYTES aligned when elements->alloc == ELEMENTS_HUGE);
+  contents are uninitialized. On failure *elements is zeroed.
+@note Thread-safe.
+ */
+int obj_buffer_alloc(struct List* elements, size_t size, size_t type_size,
+                     enum ElementAlloc kind);
+
+/**
+@brief
+  Describe caller memory as an element buffer, without copying it.
+@param elements Receives list, size, type_size, alloc and the release pair.
+@param list First element.
+@param size Number of elements.
+@param type_size Bytes per element.
+@param release Called by obj_buffer_free() to give the buffer back
+  (ELEMENTS_EXTERNAL); NULL for a buffer that is never released
+  (ELEMENTS_BORROWED).
+@param release_ctx Passed to release.
+@return
+  0: Success.
+  1: Invalid input (elements or list NULL, size or type_size 0, or the byte
+     count overflows).
+@pre None.
+@post On success elements->alloc is ELEMENTS_EXTERNAL or ELEMENTS_BORROWED.
+  On failure *elements is zeroed.
+@note Thread-safe.
+ */
+int obj_buffer_wrap(struct List* elements, void* list, size_t size, size_t type_size,
+                    element_release_fn release, void* release_ctx);
+
+/**
+@brief
+  Release an element buffer the way elements.alloc says it was allocated.
+@param elements Buffer to release; a NULL list is a no-op.
+@return None.
+@pre elements.list, size, type_size and alloc unchanged since allocation.
+@post Buffer released (ELEMENTS_ALIGNED and ELEMENTS_HUGE ones possibly
+  into the recycling pool); ELEMENTS_EXTERNAL lists go to their release
+  callback; ELEMENTS_OBJECT (storage inside an object) and ELEMENTS_BORROWED
+  lists are left alone.
+@note Thread-safe.
+ */
+void obj_buffer_free(struct List elements);
+
+/**
+@brief
+  Return the bytes a buffer of `bytes` payload really occupies.
+@param bytes Payload bytes (size * type_size).
+@param kind How the buffer was allocated (elements.alloc).
+@return For ELEMENTS_ALIGNED and ELEMENTS_HUGE the allocation length
+  (rounded to its pool size class, then to OBJ_BUFFER_ALIGN or whole huge
+  pages), exactly what obj_buffer_alloc() took; `bytes` for every other
+  kind.
+@pre For ELEMENTS_HUGE, elements.alloc as set by obj_buffer_alloc().
+@note Pure function; thread-safe.
+ */
+size_t obj_buffer_length(size_t bytes, enum ElementAlloc kind);
+
+/**
+@brief
+  Set the limits of the buffer recycling pool.
+@param max_bytes Cap on the bytes the pool holds; 0 turns the pool off.
+@param max_age_ms Pooled buffers idle for longer are released; 0 keeps them
+  until the cap pushes them out.
+@return None.
+@pre None.
+@post Buffers beyond the new limits (all of them when max_bytes == 0) are
+  released.
+@note Thread-safe. The pool starts off.
+ */
+void obj_buffer_pool_config(size_t max_bytes, uint32_t max_age_ms);
+
+/**
+@brief
+  Release pooled buffers idle for longer than max_age_ms.
+@param max_age_ms Idle time limit; 0 releases every pooled buffer.
+@return Bytes released.
+@pre None.
+@post None.
+@note Thread-safe. Age limits are only checked when the pool is used, so a
+  process that stops allocating calls this to give idle memory back.
+ */
+size_t obj_buffer_pool_trim(uint32_t max_age_ms);
+
+/**
+@brief
+  Snapshot of the recycling pool.
+@param stats Receives the snapshot.
+@return None.
+@pre stats != NULL.
+@post None.
+@note Thread-safe.
+ */
+void obj_buffer_pool_stats(struct BufferPoolStats* stats);
+
+#endif // OBJ_BUFFER_H
@@ -0,0 +1,100 @@
+#ifndef OBJ_SLAB_H
+#define OBJ_SLAB_H
+
+#include <pthread.h>
+#include <stdlib.h>
+
+/* ============================================================================
+ * Module overview / invariants
+ * ============================================================================
+  - Process-wide slab pools for the fixed-size object structs (wrappers and
+    Matrix/Vector/Scalar headers), shared by every object store.
+  - Items are carved from OBJ_SLAB_PAGE_BYTES pages aligned to their own
+    size, so the page of any item is found by masking its address.
+  - Every thread keeps a small cache of free items per pool. Allocation and
+    release touch only that cache; the pool mutex is taken once per batch
+    of OBJ_SLAB_BATCH items when a cache runs empty or overflows.
+  - Items may be released on any thread, not just the allocating one. A
+    thread's caches go back to their pools when the thread exits.
+  - Pages stay mapped until obj_slab_trim() finds them completely free
+    (no item handed out or sitting in any thread cache).
+  - Pools are statically initialized with OBJ_SLAB_INITIALIZER and never
+    destroyed; each needs a distinct id below OBJ_SLAB_MAX_POOLS.
+ */
+
+/* ============================================================================
+ * Public types
+ * ============================================================================
+ */
+#define OBJ_SLAB_PAGE_BYTES 16384
+#define OBJ_SLAB_MAX_POOLS 8
+#define OBJ_SLAB_BATCH 32 // items moved between a thread cache and its pool at once
+
+struct ObjSlabPage;
+
+struct ObjSlab
+{
+    pthread_mutex_t lock;        // guards the page lists and counters below
+    size_t item_size;            // multiple of 16
+    unsigned int id;             // thread-cache slot
+    struct ObjSlabPage* partial; // pages with at least one free item
+    size_t pages;                // pages currently allocated
+};
+
+#define OBJ_SLAB_INITIALIZER(slab_id, size)                                                        \
+    {                                                                                              \
+        .lock = PTHREAD_MUTEX_INITIALIZER, .item_size = ((size) + 15) / 16 * 16, .id = (slab_id), \
+        .partial = NULL, .pages = 0                                                                \
+    }
+
+/* ============================================================================
+ * Public API
+ * ============================================================================
+ */
+
+/**
+@brief
+  Allocate one item.
+@param slab Pool to allocate from.
+@return
+  void*: Uninitialized storage of slab->item_size bytes, 16-byte aligned
+    (64-byte aligned when item_size is a multiple of 64).
+  NULL: Allocation failure.
+@pre slab initialized with OBJ_SLAB_INITIALIZER.
+@post None.
+@note Thread-safe.
+ */
+void* obj_slab_alloc(struct ObjSlab* slab);
+
+/**
+@brief
+  Return an item to the calling thread's cache.
+@param slab Pool that allocated `item`.
+@param item Item to release; NULL is a no-op.
+@return None.
+@pre item came from obj_slab_alloc(slab) and is not used afterwards.
+@post Storage may be handed out again by any thread.
+@note Thread-safe.
+ */
+void obj_slab_free(struct ObjSlab* slab, void* item);
+
+/**
+@brief
+  Flush the calling thread's cache and release every completely free page.
+@param slab Pool to trim.
+@return Number of pages released.
+@pre None.
+@post Pages still holding live or cached items are kept.
+@note Thread-safe; other threads' caches are left alone.
+ */
+size_t obj_slab_trim(struct ObjSlab* slab);
+
+/**
+@brief
+  Return the number of pages a pool currently holds.
+@param slab Pool to query.
+@return Page count.
+ */
+size_t obj_slab_pages(struct ObjSlab* slab);
+
+#endif // OBJ_SLAB_H
@@ -0,0 +1,109 @@
+#ifndef REG_ARENA_H
+#define REG_ARENA_H
+
+#include <stdlib.h>
+
+#include "linalg_types.h"
+
+/* ============================================================================
+ * Module overview / invariants
+ * ============================================================================
+  - Slab storage for registry nodes and interned name strings.
+  - Nodes come from one fixed-size pool; names come from size-class pools
+    (16-byte granularity up to REG_ARENA_MAX_POOLED_NAME bytes). Longer names
+    fall back to individual heap blocks that are still owned by the arena.
+  - Freed items go onto a per-pool free list and are reused before any new
+    slab is carved, so steady add/remove churn stops allocating.
+  - reg_arena_destroy() releases every slab at once; individual items never
+    need to be returned before teardown.
+  - An arena is single-owner and not thread-safe.
+ */
+
+/* ============================================================================
+ * Public types
+ * ============================================================================
+ */
+#define REG_ARENA_MAX_POOLED_NAME 256 // bytes incl. terminator served from pools
+
+struct RegArena;
+
+/* ============================================================================
+ * Public API
+ * ============================================================================
+ */
+
+/**
+@brief
+  Create an empty arena serving nodes of `node_size` bytes.
+@param node_size Size of one registry node; must be > 0.
+@param allocator Allocator for the arena and everything it hands out
+  (copied); NULL for the process-wide one.
+@return
+  struct RegArena*: On success.
+  NULL: On allocation failure or node_size == 0.
+@pre node_size > 0.
+@post No slabs are allocated until the first request.
+@note Caller owns the arena and must release it with reg_arena_destroy().
+ */
+struct RegArena* reg_arena_init(size_t node_size, const struct LinalgAllocator* allocator);
+
+/**
+@brief
+  Release every slab and oversize name owned by the arena.
+@param arena Arena to destroy.
+@return
+  0: In all cases (including NULL no-op).
+@pre None.
+@post All pointers handed out by the arena are invalid.
+@note Cost is O(slabs + oversize names), independent of live item count.
+ */
+int reg_arena_destroy(struct RegArena* arena);
+
+/**
+@brief
+  Allocate one node.
+@param arena Arena.
+@return
+  void*: Uninitialized node storage, aligned for any node type.
+  NULL: Allocation failure.
+@pre arena != NULL.
+@post None.
+ */
+void* reg_arena_alloc_node(struct RegArena* arena);
+
+/**
+@brief
+  Return a node to the arena's free list.
+@param arena Arena that allocated `node`.
+@param node Node to release; NULL is a no-op.
+@return None.
+@pre node was returned by reg_arena_alloc_node(arena) and not yet freed.
+@post Storage may be handed out again by the next reg_arena_alloc_node().
+ */
+void reg_arena_free_node(struct RegArena* arena, void* node);
+
+/**
+@brief
+  Intern a copy of `name`.
+@param arena Arena.
+@param name Name to copy (null-terminated).
+@return
+  char*: Arena-owned copy.
+  NULL: Allocation failure.
+@pre arena != NULL, name != NULL.
+@post None.
+ */
+char* reg_arena_copy_name(struct RegArena* arena, const char* name);
+
+/**
+@brief
+  Return a name copy to the arena.
+@param arena Arena that produced `name`.
+@param name Name returned by reg_arena_copy_name(); NULL is a no-op.
+@return None.
+@pre Contents of `name` are unchanged since it was copied.
+@post Storage may be reused by a later name of the same size class.
+ */
+void reg_arena_free_name(struct RegArena* arena, char* name);
+
+#endif // REG_ARENA_H
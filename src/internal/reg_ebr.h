@@ -0,0 +1,142 @@
+#ifndef REG_EBR_H
+#define REG_EBR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "linalg_types.h"
+
+/* ============================================================================
+ * Module overview / invariants
+ * ============================================================================
+  - Epoch-based reclamation for the registry's lock-free read path.
+  - One process-wide domain: a global epoch plus one record per reader thread
+    (registered lazily on first reg_ebr_enter() and recycled when the thread
+    exits).
+  - Readers bracket every traversal of shared registry memory with
+    reg_ebr_enter()/reg_ebr_exit(); sections may nest and never block.
+  - Writers unlink memory first and then hand it to reg_ebr_retire() on a
+    writer-owned RegEbrList. Memory retired at epoch e is reclaimed once the
+    global epoch reaches e + 2, i.e. after every reader that might still see
+    it has left its section.
+  - The epoch advances only when every active reader has observed the
+    current epoch; a reader stalled inside a section delays reclamation but
+    never correctness.
+  - A RegEbrList is not thread-safe; its owner serializes access (the
+    registry calls it under the shard lock).
+ */
+
+/* ============================================================================
+ * Public types
+ * ============================================================================
+ */
+typedef void (*reg_ebr_reclaim_fn)(void* ctx, void* ptr);
+
+struct RegEbrRetired
+{
+    void* ptr;
+    reg_ebr_reclaim_fn reclaim;
+    uint64_t epoch; // global epoch when retired
+};
+
+struct RegEbrList
+{
+    struct RegEbrRetired* items;
+    size_t count;
+    size_t capacity;
+    const struct LinalgAllocator* allocator; // source of items; NULL = process-wide
+};
+
+/* ============================================================================
+ * Public API
+ * ============================================================================
+ */
+
+/**
+@brief
+  Enter a read-side critical section on the calling thread.
+@return
+  true: Section entered.
+  false: The thread could not be registered (allocation failure); no
+    section was entered and the caller must not traverse shared memory.
+@pre None.
+@post On true, memory reachable from shared registry pointers stays
+  allocated until the matching reg_ebr_exit().
+@note Wait-free after the first call on a thread, which registers it (at
+  most one allocation).
+ */
+bool reg_ebr_enter(void);
+
+/**
+@brief
+  Leave the innermost read-side critical section.
+@return None.
+@pre Matches an earlier successful reg_ebr_enter() on the same thread.
+@post When the outermost section ends, the thread no longer delays
+  reclamation.
+ */
+void reg_ebr_exit(void);
+
+/**
+@brief
+  Return the current global epoch.
+@return Global epoch (never 0).
+ */
+uint64_t reg_ebr_epoch(void);
+
+/**
+@brief
+  Advance the global epoch if every active reader has observed it.
+@return
+  true: Epoch advanced.
+  false: A reader is still in an older epoch.
+@post No memory is reclaimed by this call.
+ */
+bool reg_ebr_try_advance(void);
+
+/**
+@brief
+  Check whether no reader can still hold references obtained at `epoch`.
+@param epoch Epoch recorded when the memory was unlinked or a view was
+  published.
+@return true once the global epoch has moved two steps past `epoch`.
+ */
+bool reg_ebr_safe(uint64_t epoch);
+
+/**
+@brief
+  Defer reclamation of `ptr` until all current readers have left.
+@param list Writer-owned retire list.
+@param ptr Memory already unreachable from shared pointers.
+@param reclaim Called as reclaim(ctx, ptr) once safe.
+@param ctx Passed through to reclaim.
+@return None.
+@pre The caller owns `list` exclusively.
+@post If the list cannot grow, the call waits for a grace period and
+  reclaims `ptr` directly instead.
+ */
+void reg_ebr_retire(struct RegEbrList* list, void* ptr, reg_ebr_reclaim_fn reclaim, void* ctx);
+
+/**
+@brief
+  Reclaim every retired item that is now safe.
+@param list Writer-owned retire list.
+@param ctx Passed through to each reclaim callback.
+@return Number of items reclaimed.
+@note Tries to advance the epoch first.
+ */
+size_t reg_ebr_collect(struct RegEbrList* list, void* ctx);
+
+/**
+@brief
+  Reclaim every retired item regardless of epoch and free the list storage.
+@param list Writer-owned retire list.
+@param ctx Passed through to each reclaim callback.
+@return None.
+@pre No reader can reach any retired item (teardown only).
+@post list is empty and may be reused.
+ */
+void reg_ebr_drain(struct RegEbrList* list, void* ctx);
+
+#endif // REG_EBR_H
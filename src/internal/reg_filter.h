@@ -0,0 +1,102 @@
+#ifndef REG_FILTER_H
+#define REG_FILTER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "linalg_types.h"
+
+/* ============================================================================
+ * Module overview / invariants
+ * ============================================================================
+  - Split-block Bloom filter over registry name hashes, used as the
+    registry's optional negative-lookup front end.
+  - Each hash selects one 32-byte block (half a cache line) and sets one bit
+    in each of its eight 32-bit words, so a query reads one block.
+  - No false negatives: every hash added since the last build tests
+    positive. There is no delete; removed names leave their bits set, and
+    the registry rebuilds the filter once enough of them accumulate.
+  - Sized for `capacity` hashes at about 16 bits each (~0.1-0.3% false
+    positives at capacity); the rate climbs past capacity, so the registry
+    rebuilds larger when it outgrows it.
+  - Writers must be serialized by the owner. Queries may run concurrently
+    with one writer: bits are read and written with relaxed atomics and a
+    bit is never cleared in place.
+  - The filter is one heap block and can be released with free().
+ */
+
+/* ============================================================================
+ * Public types
+ * ============================================================================
+ */
+struct RegFilter;
+
+/* ============================================================================
+ * Public API
+ * ============================================================================
+ */
+
+/**
+@brief
+  Create an empty filter sized for `capacity` hashes.
+@param capacity Expected number of hashes (0 is treated as 1).
+@param allocator Source of the filter's memory; NULL for the process-wide allocator.
+@return
+  struct RegFilter*: On success.
+  NULL: On allocation failure.
+@pre None.
+@post Every query tests negative until hashes are added.
+@note Release with reg_filter_destroy().
+ */
+struct RegFilter* reg_filter_init(size_t capacity, const struct LinalgAllocator* allocator);
+
+/**
+@brief
+  Release a filter.
+@param filter Filter to release (NULL is a no-op).
+@return None.
+ */
+void reg_filter_destroy(struct RegFilter* filter);
+
+/**
+@brief
+  Record hash `h`.
+@param filter Filter.
+@param h Registry hash of a bound name.
+@return None.
+@pre filter != NULL; caller serializes writers.
+@post reg_filter_maybe(filter, h) is true.
+ */
+void reg_filter_add(struct RegFilter* filter, uint64_t h);
+
+/**
+@brief
+  Test whether hash `h` may have been added.
+@param filter Filter.
+@param h Registry hash of the queried name.
+@return
+  false: h was definitely never added.
+  true: h may have been added.
+@pre filter != NULL.
+@post Read-only; safe concurrently with reg_filter_add().
+ */
+bool reg_filter_maybe(const struct RegFilter* filter, uint64_t h);
+
+/**
+@brief
+  Return the number of hashes the filter was sized for.
+@param filter Filter.
+@return Capacity; 0 for NULL.
+ */
+size_t reg_filter_capacity(const struct RegFilter* filter);
+
+/**
+@brief
+  Return the size of the filter's allocation.
+@param filter Filter.
+@return Bytes; 0 for NULL.
+ */
+size_t reg_filter_bytes(const struct RegFilter* filter);
+
+#endif // REG_FILTER_H
@@ -0,0 +1,263 @@
+#ifndef REG_FLAT_H
+#define REG_FLAT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "linalg_types.h"
+
+/* ============================================================================
+ * Module overview / invariants
+ * ============================================================================
+  - Open-addressing (SwissTable-style) name->object map used as the flat
+    registry backend by reg_hash.c.
+  - Slots live in one contiguous array; a parallel array of one-byte control
+    words (empty / deleted / 7 bits of hash) is probed a group at a time,
+    with SSE2 when available, so most misses never touch slot memory.
+  - The table owns its name strings, which are carved from a RegArena
+    supplied at init and released with that arena. Object pointers are
+    stored but never dereferenced: reference counting stays the
+    responsibility of reg_hash.c.
+  - Slots that have been resolved to a binding handle record their directory
+    slot; rebuilds retarget the directory so handles survive slot moves, and
+    erasing a slot releases its directory slot.
+  - Capacity is a power of two; the table rebuilds itself (grow, shrink or
+    tombstone purge) in a single step when load crosses 7/8 or drops below
+    1/8.
+  - Unless otherwise specified, functions that return int return 0 on success
+    and nonzero on error; specific codes are documented per function.
+ */
+
+/* ============================================================================
+ * Public types
+ * ============================================================================
+ */
+struct RegFlatTable;
+struct RegArena;
+struct RegHandleTable;
+struct ObjWrapper;
+
+/* ============================================================================
+ * Public API
+ * ============================================================================
+ */
+
+/**
+@brief
+  Create an empty flat table able to hold at least min_bindings names
+  without rebuilding.
+@param min_bindings Expected binding count; also the floor for shrinking.
+@param arena Source of name storage (BORROW); must outlive the table.
+@param handles Handle directory to keep in sync (BORROW); must outlive the
+  table.
+@param allocator Source of the table's memory; NULL for the process-wide allocator.
+@return
+  struct RegFlatTable*: On success.
+  NULL: On allocation failure.
+@pre None.
+@post Table is empty.
+@note Caller owns the table and must release it with reg_flat_destroy().
+ */
+struct RegFlatTable* reg_flat_init(size_t min_bindings, struct RegArena* arena,
+                                   struct RegHandleTable* handles,
+                                   const struct LinalgAllocator* allocator);
+
+/**
+@brief
+  Free the table and its slot arrays.
+@param table Table to destroy.
+@return
+  0: In all cases (including NULL no-op).
+@pre None.
+@post Stored object pointers are dropped without decref_obj(); stored names
+  stay allocated until the arena is destroyed.
+@warning Caller must release object references before calling.
+ */
+int reg_flat_destroy(struct RegFlatTable* table);
+
+/**
+@brief
+  Find the object slot bound to `name`.
+@param table Flat table.
+@param name Binding name (null-terminated).
+@param h 64-bit seeded hash of `name` as computed by reg_hash.c.
+@param probes Receives the number of control groups scanned; may be NULL.
+@return
+  struct ObjWrapper**: Address of the stored object pointer (RETURN-BORROWED,
+    valid until the next insert/erase).
+  NULL: Not found.
+@pre
+  table != NULL, name != NULL.
+@post No side effects.
+ */
+struct ObjWrapper** reg_flat_find(const struct RegFlatTable* table, const char* name, uint64_t h,
+                                  size_t* probes);
+
+/**
+@brief
+  Find the slot index bound to `name`.
+@param table Flat table.
+@param name Binding name (null-terminated).
+@param h hash of `name`.
+@param probes Receives the number of control groups scanned; may be NULL.
+@return
+  size_t: Slot index, valid until the next insert/erase.
+  reg_flat_capacity(table): Not found.
+@pre table != NULL, name != NULL.
+@post No side effects.
+ */
+size_t reg_flat_find_index(const struct RegFlatTable* table, const char* name, uint64_t h,
+                           size_t* probes);
+
+/**
+@brief
+  Address of the object stored in full slot `index`.
+@param table Flat table.
+@param index Full slot index.
+@return struct ObjWrapper**: (RETURN-BORROWED, valid until the next insert/erase).
+@pre index names a full slot.
+@post No side effects.
+ */
+struct ObjWrapper** reg_flat_object_at(struct RegFlatTable* table, size_t index);
+
+/**
+@brief
+  Address of the handle directory field of full slot `index`.
+@param table Flat table.
+@param index Full slot index.
+@return
+  uint32_t*: Directory slot + 1, or REG_HANDLE_NONE (RETURN-BORROWED, valid
+    until the next insert/erase).
+@pre index names a full slot.
+@post No side effects.
+@note The caller sets the field after reg_handles_acquire(); the table
+  maintains it from then on.
+ */
+uint32_t* reg_flat_handle_at(struct RegFlatTable* table, size_t index);
+
+/**
+@brief
+  Stored hash of full slot `index`.
+@param table Flat table.
+@param index Full slot index.
+@return Hash passed to reg_flat_insert() for the slot's name.
+@pre index names a full slot.
+@post No side effects.
+ */
+uint64_t reg_flat_hash_at(const struct RegFlatTable* table, size_t index);
+
+/**
+@brief
+  Insert a new binding for a name that is known not to be present.
+@param table Flat table.
+@param name Binding name (null-terminated); copied.
+@param h hash of `name`.
+@param object Object to store (no refcount change).
+@return
+  0: Success.
+  2: Allocation failure; table unchanged.
+@pre
+  table != NULL, name != NULL, object != NULL.
+  reg_flat_find(table, name, h) == NULL.
+@post Table may have been rebuilt at a larger capacity.
+ */
+int reg_flat_insert(struct RegFlatTable* table, const char* name, uint64_t h,
+                    struct ObjWrapper* object);
+
+/**
+@brief
+  Make room for `bindings` total bindings without further rebuilds.
+@param table Flat table.
+@param bindings Total binding count to hold.
+@return
+  0: Success (including when the table is already large enough).
+  2: Allocation failure; table unchanged.
+@pre table != NULL.
+@post Inserting up to `bindings - count` new names does not rebuild.
+ */
+int reg_flat_reserve(struct RegFlatTable* table, size_t bindings);
+
+/**
+@brief
+  Remove the binding for `name`.
+@param table Flat table.
+@param name Binding name (null-terminated).
+@param h hash of `name`.
+@param removed_object Receives the previously stored object on success.
+@return
+  0: Success.
+  1: Not found; table unchanged.
+@pre
+  table != NULL, name != NULL, removed_object != NULL.
+@post Stored name returned to the arena and any directory slot released;
+  table may have been rebuilt at a smaller capacity.
+ */
+int reg_flat_erase(struct RegFlatTable* table, const char* name, uint64_t h,
+                   struct ObjWrapper** removed_object);
+
+/**
+@brief
+  Remove the binding in slot `index` without touching its name.
+@param table Flat table.
+@param index Slot index.
+@param removed_object Receives the previously stored object on success.
+@return
+  0: Success.
+  1: Slot is not full; table unchanged.
+@pre table != NULL, removed_object != NULL.
+@post Same as reg_flat_erase().
+ */
+int reg_flat_erase_at(struct RegFlatTable* table, size_t index, struct ObjWrapper** removed_object);
+
+/**
+@brief
+  Read back slot `index` for iteration.
+@param table Flat table.
+@param index Slot index in [0, reg_flat_capacity(table)).
+@param name Receives the stored name if the slot is full.
+@param object Receives the stored object if the slot is full.
+@return
+  true: Slot is full and outputs are populated.
+  false: Slot is empty or deleted.
+@pre table != NULL.
+@post No side effects.
+ */
+bool reg_flat_slot(const struct RegFlatTable* table, size_t index, const char** name,
+                   struct ObjWrapper** object);
+
+/**
+@brief
+  Return the number of slots (full, deleted and empty).
+@param table Flat table.
+@return Slot count; 0 for NULL.
+ */
+size_t reg_flat_capacity(const struct RegFlatTable* table);
+
+/**
+@brief
+  Return the number of stored bindings.
+@param table Flat table.
+@return Binding count; 0 for NULL.
+ */
+size_t reg_flat_count(const struct RegFlatTable* table);
+
+/**
+@brief
+  Accumulate the probe length of every stored binding.
+@param table Flat table.
+@param histogram Array of `bins` counters; entry n is incremented for each
+  binding found after scanning n groups (the last entry collects n >= bins-1).
+@param bins Number of histogram entries (>= 2).
+@param max_groups Raised to the longest probe length seen.
+@param total_groups Increased by the sum of all probe lengths.
+@return None.
+@pre All pointers non-NULL.
+@post No side effects on the table.
+@note O(capacity); a probe length is the number of groups reg_flat_find()
+  scans to reach the binding, so 1 means it sits in its home group.
+ */
+void reg_flat_probe_stats(const struct RegFlatTable* table, size_t* histogram, size_t bins,
+                          size_t* max_groups, size_t* total_groups);
+
+#endif // REG_FLAT_H
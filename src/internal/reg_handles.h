@@ -0,0 +1,141 @@
+#ifndef REG_HANDLES_H
+#define REG_HANDLES_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "linalg_types.h"
+
+/* ============================================================================
+ * Module overview / invariants
+ * ============================================================================
+  - Generational slot directory backing struct BindingHandle.
+  - Each slot records where one registry entry currently lives (a node
+    pointer or a flat slot index, opaque to this module) and a generation.
+  - A handle {index, generation} is live while slot `index` is in use and
+    still carries `generation`. Releasing or refreshing a slot bumps its
+    generation, so every previously issued handle for it turns stale and is
+    rejected by a single compare.
+  - Generation 0 is never issued; a zero-initialized handle is always stale.
+  - Released slots are recycled through a free list; the directory only
+    grows to the peak number of simultaneously resolved entries.
+  - Unless otherwise specified, functions that return int return 0 on success
+    and nonzero on error; specific codes are documented per function.
+ */
+
+/* ============================================================================
+ * Public types
+ * ============================================================================
+ */
+#define REG_HANDLE_NONE 0 // entry field value meaning "no directory slot"
+
+struct RegHandleTable;
+
+/* ============================================================================
+ * Public API
+ * ============================================================================
+ */
+
+/**
+@brief
+  Create an empty handle directory.
+@param allocator Source of the directory's memory; NULL for the process-wide allocator.
+@return
+  struct RegHandleTable*: On success.
+  NULL: On allocation failure.
+@pre None.
+@post No slot storage is allocated until the first reg_handles_acquire().
+@note Caller owns the directory and must release it with reg_handles_destroy().
+ */
+struct RegHandleTable* reg_handles_init(const struct LinalgAllocator* allocator);
+
+/**
+@brief
+  Free the directory.
+@param handles Directory to destroy.
+@return
+  0: In all cases (including NULL no-op).
+@pre None.
+@post All issued handles are meaningless.
+ */
+int reg_handles_destroy(struct RegHandleTable* handles);
+
+/**
+@brief
+  Claim a slot for an entry located at `target`.
+@param handles Directory.
+@param target Backend-specific entry location.
+@param handle Receives the new handle.
+@return
+  0: Success.
+  2: Allocation failure; directory unchanged.
+@pre handles != NULL, handle != NULL.
+@post Entry field should store handle->index + 1 (0 is REG_HANDLE_NONE).
+ */
+int reg_handles_acquire(struct RegHandleTable* handles, uintptr_t target,
+                        struct BindingHandle* handle);
+
+/**
+@brief
+  Return slot `index` to the free list, invalidating its handles.
+@param handles Directory.
+@param index Slot index (handle.index, not the +1 entry field).
+@return None.
+@pre Slot `index` is in use.
+@post Handles issued for the slot are stale.
+ */
+void reg_handles_release(struct RegHandleTable* handles, uint32_t index);
+
+/**
+@brief
+  Invalidate existing handles for slot `index` while keeping the slot.
+@param handles Directory.
+@param index Slot index.
+@return The slot's handle under its new generation.
+@pre Slot `index` is in use.
+@post Previously issued handles for the slot are stale.
+@note Used when the bound object changes.
+ */
+struct BindingHandle reg_handles_refresh(struct RegHandleTable* handles, uint32_t index);
+
+/**
+@brief
+  Return the current handle for slot `index`.
+@param handles Directory.
+@param index Slot index.
+@return Live handle for the slot.
+@pre Slot `index` is in use.
+@post No side effects.
+ */
+struct BindingHandle reg_handles_current(const struct RegHandleTable* handles, uint32_t index);
+
+/**
+@brief
+  Record that the entry behind slot `index` moved to `target`.
+@param handles Directory.
+@param index Slot index.
+@param target New entry location.
+@return None.
+@pre Slot `index` is in use.
+@post Handles stay live; reg_handles_resolve() yields the new target.
+ */
+void reg_handles_retarget(struct RegHandleTable* handles, uint32_t index, uintptr_t target);
+
+/**
+@brief
+  Map a handle to its entry location.
+@param handles Directory.
+@param handle Handle to check.
+@param target Receives the entry location when the handle is live.
+@return
+  true: Handle is live; *target populated.
+  false: Handle is stale or out of range.
+@pre handles != NULL, target != NULL.
+@post No side effects.
+@note O(1): one bounds check and one generation compare.
+ */
+bool reg_handles_resolve(const struct RegHandleTable* handles, struct BindingHandle handle,
+                         uintptr_t* target);
+
+#endif // REG_HANDLES_H
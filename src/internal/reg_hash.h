@@ -3,6 +3,7 @@
 
 #include <stdlib.h>
 
+#include "linalg_types.h"
 #include "reg_hash.h"
 
 /* ============================================================================
@@ -19,6 +20,60 @@
     is an invariant violation and constitutes an internal registry error.
   - Unless otherwise specified, functions that return int return 0 on success
     and nonzero on error; specific codes are documented per function.
+  - The bucket count is managed by the registry: it grows when the load
+    factor (bindings / buckets) reaches 1 and shrinks when it drops below
+    1/8, never below the size passed to init_reg_table(). Rehashing is
+    incremental; add_binding()/remove_binding() each migrate a bounded number
+    of buckets, so no single call pays for copying the whole table.
+  - Names are hashed with a seeded 64-bit hash. The seed is fixed when the
+    registry is created (random unless RegistryConfig.seed is set), and each
+    entry stores its full hash so mismatches are rejected without comparing
+    name bytes.
+  - The flat backend (REG_BACKEND_FLAT) keeps the same API and binding
+    semantics but stores bindings in an open-addressing table; it grows at
+    7/8 load and resizes in one step.
+  - resolve_binding() turns a name into a struct BindingHandle. Handle-based
+    lookup/rebind/remove are O(1) and do no hashing or string compares. A
+    handle is stale once its binding is removed or bound to a different
+    object (by name or through another copy of the handle); stale handles are
+    detected by one generation compare and never reach another binding.
+    Resizing and rehashing do not invalidate handles.
+  - Registries are single-threaded unless created with
+    RegistryConfig.concurrent. A concurrent registry hashes each name once,
+    routes it to one of RegistryConfig.shards independent registries by the
+    top hash bits, and holds only that shard's mutex for the call, so
+    operations on names in different shards run in parallel. Every API in
+    this header except init/destroy is then safe to call from any thread.
+  - With the chained backend, concurrent lookup_binding() takes no lock at
+    all: readers never block writers or each other, and removed entries are
+    reclaimed only after every in-flight lookup has finished (epoch-based
+    reclamation). Writers still serialize per shard.
+  - In concurrent mode a pointer returned by lookup_binding() or
+    lookup_binding_handle() is only as stable as the binding: another thread
+    that removes or rebinds the name may destroy the object.
+  - With RegistryConfig.prefix_index, every registry (every shard, in
+    concurrent mode) also keeps its names in a radix trie (reg_trie.c), so
+    for_each_binding_prefix() and remove_bindings_prefix() touch only the
+    matching names. Adds of new names and removals pay one trie update.
+  - freeze_registry() snapshots the current bindings into a perfect hash
+    (reg_mphf.c) that lookup_binding() consults first: one probe and one
+    name compare. The mutable table is kept; any add, remove or rebind that
+    changes a binding drops the snapshot first (thaw), so freezing never
+    changes binding semantics.
+  - With RegistryConfig.negative_filter, every registry (every shard) keeps a
+    split-block Bloom filter (reg_filter.c) of its bound name hashes that
+    lookup_binding() checks before the table: a name that was never bound is
+    usually rejected after reading one 32-byte block. Filters never give
+    false negatives; they are rebuilt as bindings grow or removals pile up,
+    and registry_stats() reports their memory and false-positive rate.
+  - snapshot_registry() pins an immutable version of the whole name->object
+    mapping. Each registry (each shard) keeps that mapping as a persistent
+    map (reg_pmap.c) next to its table, from init with
+    RegistryConfig.snapshots or else from its first snapshot: every write
+    path-copies O(log32 n) map nodes before changing the table, and a
+    snapshot retains one map root per shard. The map holds one reference per
+    bound object, so objects outlive any removal or rebind until the last map
+    that binds them is released. Snapshot lookups take no lock.
  */
 
 /* ============================================================================
@@ -27,6 +82,7 @@
  */
 struct RegistryHash;
 struct ObjWrapper;
+struct RegSnapshot;
 
 /* ============================================================================
  * Public API
@@ -36,7 +92,7 @@ struct ObjWrapper;
 /**
 @brief
   Create an empty registry hash table.
-@param table_size num elements in hash table; must be > 0.
+@param table_size initial (and minimum) number of buckets; must be > 0.
 @return
   Returns struct RegistryHash* on success.
   Returns NULL on allocation failure or invalid table_size.
@@ -45,10 +101,34 @@ struct ObjWrapper;
 @post
   Table is initialized and safe to pass to other registry API calls.
 @note
+  The table resizes itself as bindings are added and removed; table_size is
+  only a starting hint and lower bound.
+  Equivalent to init_reg_table_config(table_size, NULL).
   Caller owns the returned registry and must destroy it with
   destroy_reg_table().*/
 struct RegistryHash* init_reg_table(size_t table_size);
 
+/**
+@brief
+  Create an empty registry hash table with explicit options.
+@param table_size initial (and minimum) capacity hint; must be > 0.
+@param config Registry options (BORROW); NULL selects the defaults.
+@return
+  Returns struct RegistryHash* on success.
+  Returns NULL on allocation failure or invalid input.
+@pre
+  1. table_size > 0.
+  2. config == NULL or config->backend is a valid enum RegistryBackend.
+  3. config == NULL or config->shards <= 4096.
+@post
+  Table is initialized with the requested backend and safe to pass to other
+  registry API calls. With config->concurrent, table_size is split across
+  the shards and the registry may be shared between threads.
+@note
+  Caller owns the returned registry and must destroy it with
+  destroy_reg_table().*/
+struct RegistryHash* init_reg_table_config(size_t table_size, const struct RegistryConfig* config);
+
 /**
 @brief
   Destroy the registry and all bindings.
@@ -112,7 +192,7 @@ int add_binding(const char* name, struct ObjWrapper* object, struct RegistryHash
 @return
   0: Success. Binding existed and was removed.
   1: Binding not found.
-  2: Reserved (not returned by this function).
+  2: Allocation failure updating the snapshot map; binding kept.
   3: Invalid or empty reg_table.
   4: Internal registry error.
 @pre
@@ -143,7 +223,10 @@ int remove_binding(const char* name, struct RegistryHash* reg_table);
  name != NULL.
  name[0] != '\0'.
 @post No side effects; does not modify registry or refcounts.
-@note Returned pointer is borrowed; caller must not free/destroy it.
+@note Returned pointer is borrowed; caller must not free/destroy it. In
+  concurrent mode it stays valid only while no other thread removes or
+  rebinds `name`. Concurrent chained registries answer without locking and
+  may return the binding as it was just before an overlapping write.
  */
 struct ObjWrapper* lookup_binding(const char* name, struct RegistryHash* reg_table);
 
@@ -161,4 +244,273 @@ struct ObjWrapper* lookup_binding(const char* name, struct RegistryHash* reg_tab
  */
 int list_bindings(struct RegistryHash* reg_table);
 
+/**
+@brief
+  Resolve a name to a handle for repeated access.
+@param name Binding name (null-terminated).
+@param reg_table Registry table of name bindings.
+@param handle Receives the handle on success.
+@return
+  0: Success.
+  1: Binding not found.
+  2: Allocation failure.
+  3: Invalid input.
+@pre
+  reg_table != NULL, handle != NULL.
+  name != NULL and name[0] != '\0'.
+@post
+  Binding, object and refcounts unchanged. Resolving the same binding again
+  returns an equal handle until the binding is removed or rebound.
+@note Handles hold no object reference; they do not keep the object alive.
+ */
+int resolve_binding(const char* name, struct RegistryHash* reg_table, struct BindingHandle* handle);
+
+/**
+@brief
+  Fetch the object bound through `handle`.
+@param handle Handle from resolve_binding() or rebind_handle().
+@param reg_table Registry the handle was resolved in.
+@return
+  struct ObjWrapper*: Handle is live.
+  NULL: Invalid input or stale handle.
+@pre reg_table != NULL.
+@post No side effects; does not modify registry or refcounts.
+@note O(1), no hashing or string compares. Returned pointer is borrowed.
+ */
+struct ObjWrapper* lookup_binding_handle(struct BindingHandle handle,
+                                         struct RegistryHash* reg_table);
+
+/**
+@brief
+  Bind the name behind `handle` to a different object.
+@param handle Live handle (IN/OUT); refreshed on success.
+@param object Object wrapper to bind to.
+@param reg_table Registry the handle was resolved in.
+@return
+  0: success.
+  1: Stale handle; nothing modified.
+  2: Allocation failure updating the snapshot map; nothing modified.
+  3: Invalid input or invalid/empty reg_table.
+  4: decref_obj() failure.
+  5: incref_obj() failure.
+@pre
+  reg_table != NULL, handle != NULL, object != NULL.
+@post
+  Same refcount semantics as add_binding() on an existing name. If the object
+  changed, *handle is updated to the binding's new generation and every other
+  copy of the old handle is stale. Rebinding to the same object is a no-op.
+@warning
+  Registry's decref_obj() call may destroy the previously bound object.
+ */
+int rebind_handle(struct BindingHandle* handle, struct ObjWrapper* object,
+                  struct RegistryHash* reg_table);
+
+/**
+@brief
+  Remove the binding behind `handle`.
+@param handle Handle from resolve_binding() or rebind_handle().
+@param reg_table Registry the handle was resolved in.
+@return
+  0: Success. Binding existed and was removed.
+  1: Stale handle; nothing modified.
+  2: Allocation failure updating the snapshot map; nothing modified.
+  3: Invalid or empty reg_table.
+  4: Internal registry error.
+@pre None.
+@post As remove_binding(); all copies of the handle are stale.
+@warning
+  Call to decref_obj() may destroy the bound object.
+ */
+int remove_binding_handle(struct BindingHandle handle, struct RegistryHash* reg_table);
+
+/**
+@brief
+  Snapshot registry health: occupancy, chain lengths and probe counters.
+@param reg_table Registry table of name bindings.
+@param stats Receives the snapshot.
+@return
+  0: Success.
+  1: Invalid input.
+@pre None.
+@post Bindings and counters unchanged.
+@note
+  - Available in release builds; O(buckets), so meant for periodic
+    monitoring rather than per-operation use.
+  - Concurrent registries are summed shard by shard (each under its own
+    lock), so the snapshot is not atomic across shards. Lock-free lookups
+    count into per-thread slots on separate cache lines; with more reader
+    threads than slots, threads sharing one may undercount slightly.
+ */
+int registry_stats(struct RegistryHash* reg_table, struct RegistryStats* stats);
+
+/**
+@brief
+  Size the registry for `additional` more bindings ahead of a bulk load.
+@param reg_table Registry table of name bindings.
+@param additional Number of bindings about to be added.
+@return
+  0: Success, or nothing to do.
+  2: Allocation failure; registry unchanged and still fully usable.
+  3: Invalid or empty reg_table.
+@pre None.
+@post Adding up to `additional` new names triggers no further resize
+  (concurrent registries: per shard, assuming an even spread).
+@note A capacity hint only: bindings are unchanged and add_binding() still
+  grows the registry on demand. Concurrent chained shards with lock-free
+  readers start the resize and let it finish incrementally.
+ */
+int reserve_bindings(struct RegistryHash* reg_table, size_t additional);
+
+/**
+@brief
+  Call `visit` once for every bound name that starts with `prefix`.
+@param reg_table Registry table of name bindings.
+@param prefix Byte prefix to match (null-terminated); "" matches every name.
+@param visit Callback; returning nonzero stops the enumeration.
+@param ctx Passed through to visit.
+@return
+  0: Success (including no matches or an early stop).
+  1: Invalid input.
+  2: Allocation failure; visit was not called.
+  4: Registry was created without config->prefix_index.
+@pre None.
+@post Bindings unchanged by this call.
+@note
+  - Cost is O(|prefix| + matches) per shard; unrelated bindings are never
+    touched.
+  - Matching is bytewise: pass "s42.model." rather than "s42.model" to
+    exclude "s42.model2.*".
+  - Matches are snapshotted first and visit runs with no registry lock held,
+    so it may add or remove bindings. Names come in byte order within a shard;
+    concurrent registries snapshot shard by shard, so the set is not atomic
+    across shards.
+ */
+int for_each_binding_prefix(struct RegistryHash* reg_table, const char* prefix,
+                            binding_visit_fn visit, void* ctx);
+
+/**
+@brief
+  Remove every binding whose name starts with `prefix`.
+@param reg_table Registry table of name bindings.
+@param prefix Byte prefix to match (null-terminated); "" removes everything.
+@param removed Receives the number of bindings removed (may be NULL).
+@return
+  0: Success (including no matches).
+  1: Invalid input.
+  2: Allocation failure; *removed reports the bindings already dropped.
+  4: Registry was created without config->prefix_index.
+@pre None.
+@post No binding under `prefix` remains (on 0), and each removed binding
+  released its object as remove_binding() would.
+@note Cost is O(|prefix| + matches) per shard. Concurrent registries clear
+  each shard under its lock, so a name added to another shard meanwhile may
+  survive.
+@warning
+  Call to decref_obj() may destroy bound objects.
+ */
+int remove_bindings_prefix(struct RegistryHash* reg_table, const char* prefix, size_t* removed);
+
+/* ============================================================================
+ * Public debug functions
+ * ============================================================================
+ */
+
+/**
+@brief
+  Return the number of buckets the registry currently hashes into.
+@param reg_table Registry table of name bindings.
+@return
+  size_t: Bucket count on success. While a rehash is in progress this is the
+    size of the table being migrated into.
+  0: Invalid input.
+@pre
+  reg_table != NULL.
+@post No side effects.
+@note Used to observe automatic growth/shrink in tests.
+ */
+size_t debug_get_reg_bucket_count(const struct RegistryHash* reg_table);
+
+/**
+@brief
+  Freeze the current bindings into a read-only perfect hash.
+@param reg_table Registry table of name bindings.
+@return
+  0: Success, or already frozen.
+  2: Allocation failure; registry unchanged (still served by its table).
+  3: Invalid or empty reg_table.
+  5: No perfect hash found (two names share a 64-bit hash); registry
+     unchanged.
+@pre None.
+@post lookup_binding() answers from the frozen table until the next add,
+  remove or rebind that changes a binding, which thaws it transparently.
+  Misses, stale handles and rebinds to the bound object keep it frozen.
+@note
+  - Build cost is O(n) and the snapshot costs about 28 bytes per binding
+    plus the name bytes; the mutable table is kept alongside it.
+  - Meant for read-mostly phases: freeze after warm-up, not between writes.
+  - Concurrent registries freeze shard by shard; lock-free lookups pick the
+    snapshot up without taking the lock.
+  - Handle-based calls keep using the mutable table.
+ */
+int freeze_registry(struct RegistryHash* reg_table);
+
+/**
+@brief
+  Pin a consistent, read-only version of every binding.
+@param reg_table Registry table of name bindings.
+@param out Receives the snapshot.
+@return
+  0: Success.
+  2: Allocation failure.
+  3: Invalid reg_table or out == NULL.
+@pre None.
+@post On success *out sees exactly the bindings present at the call, no
+  matter what is added, removed or rebound afterwards; on failure *out is
+  NULL and no references are held.
+@note
+  - O(shards): each shard's current map root is retained, with every shard
+    lock held at once for just that. The first snapshot of a registry built
+    without RegistryConfig.snapshots first builds each shard's map
+    (O(n log n)) under that shard's lock alone.
+  - Writers never wait on snapshot readers and never free a whole version:
+    a write frees at most the map path it replaced, and nodes still shared
+    with a snapshot are freed by the release_snapshot() that drops them.
+  - Bound objects stay alive while the snapshot is held; release it with
+    release_snapshot() before the objects' store is torn down.
+ */
+int snapshot_registry(struct RegistryHash* reg_table, struct RegSnapshot** out);
+
+/**
+@brief
+  Look up `name` in a snapshot.
+@param snapshot Snapshot from snapshot_registry().
+@param name Name to find (null-terminated).
+@return Object bound to name when the snapshot was taken, or NULL.
+@pre None.
+@post The object stays alive at least until release_snapshot(snapshot).
+@note Lock-free; safe from any number of threads at once.
+ */
+struct ObjWrapper* snapshot_lookup(const struct RegSnapshot* snapshot, const char* name);
+
+/**
+@brief
+  Return the number of bindings in a snapshot.
+@param snapshot Snapshot from snapshot_registry().
+@return Binding count; 0 for NULL.
+ */
+size_t snapshot_count(const struct RegSnapshot* snapshot);
+
+/**
+@brief
+  Release a snapshot and the object references it holds.
+@param snapshot Snapshot to release (NULL is a no-op).
+@return
+  0: In all cases.
+@pre snapshot is not used afterwards.
+@post Objects no longer bound anywhere else are destroyed.
+@note May be called from any thread, independently of the registry (the
+  registry may already be destroyed).
+ */
+int release_snapshot(struct RegSnapshot* snapshot);
+
 #endif // REG_HASH_H
@@ -0,0 +1,129 @@
+#ifndef REG_PMAP_H
+#define REG_PMAP_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "linalg_types.h"
+
+/* ============================================================================
+ * Module overview / invariants
+ * ============================================================================
+  - Persistent (immutable, structurally shared) map from name to object behind
+    registry snapshots: a hash array mapped trie over the registry's 64-bit
+    name hashes, 5 hash bits per level starting from the low bits (shard
+    routing fixes the high ones).
+  - A map is a pointer to its root node; NULL is the empty map. Updates never
+    modify a node: reg_pmap_put()/reg_pmap_remove() copy the O(log32 n) nodes
+    on the path to the changed leaf and share every other subtree with the
+    source map, so each update allocates a handful of small blocks.
+  - Nodes are reference counted (atomically): a map holds one reference on
+    its root and every node one on each child. Releasing a map frees only the
+    nodes no other map shares, so dropping a superseded version costs the
+    path that replaced it, not the size of the map.
+  - Each leaf holds one reference on its object (incref_obj()), dropped with
+    decref_obj() when the leaf is freed, so objects stay alive while any map
+    that binds them is held.
+  - Maps are read-only once built: any number of threads may search or
+    release maps concurrently. Building from a map requires that the caller
+    holds a reference on it for the duration of the call.
+  - Names with equal 64-bit hashes share a leaf chain below the last level.
+  - Unless otherwise specified, functions that return int return 0 on success
+    and nonzero on error; specific codes are documented per function.
+ */
+
+/* ============================================================================
+ * Public types
+ * ============================================================================
+ */
+struct RegPmap;
+struct ObjWrapper;
+
+/* ============================================================================
+ * Public API
+ * ============================================================================
+ */
+
+/**
+@brief
+  Build the map that binds `name` to `object` and is otherwise `map`.
+@param map Source map (NULL for empty); unchanged.
+@param name Name to bind (null-terminated, copied).
+@param h Registry hash of name.
+@param object Object to bind; gains one reference held by the new leaf.
+@param allocator Source of the new nodes; NULL for the process-wide
+  allocator.
+@param out Receives the new map (one reference, owned by the caller).
+@return
+  0: Success.
+  2: Allocation failure; *out is NULL and nothing changed.
+  4: incref_obj() failure; *out is NULL and nothing changed.
+@pre out != NULL; caller holds a reference on map.
+@post map still holds its own reference; the caller releases both maps
+  independently with reg_pmap_release().
+@note O(log32 n) node copies, plus the names sharing h when hashes collide.
+ */
+int reg_pmap_put(const struct RegPmap* map, const char* name, uint64_t h,
+                 struct ObjWrapper* object, const struct LinalgAllocator* allocator,
+                 struct RegPmap** out);
+
+/**
+@brief
+  Build the map that is `map` without `name`.
+@param map Source map (NULL for empty); unchanged.
+@param name Name to drop (null-terminated).
+@param h Registry hash of name.
+@param allocator As reg_pmap_put().
+@param out Receives the new map (one reference, owned by the caller).
+@return
+  0: Success.
+  1: name not in map; *out is NULL.
+  2: Allocation failure; *out is NULL.
+@pre out != NULL; caller holds a reference on map.
+@post As reg_pmap_put().
+ */
+int reg_pmap_remove(const struct RegPmap* map, const char* name, uint64_t h,
+                    const struct LinalgAllocator* allocator, struct RegPmap** out);
+
+/**
+@brief
+  Look up `name` with registry hash `h`.
+@param map Map to search (NULL for empty).
+@param name Name to find (null-terminated).
+@param h Registry hash of name.
+@return Bound object, or NULL.
+@post Read-only; safe for concurrent readers.
+ */
+struct ObjWrapper* reg_pmap_find(const struct RegPmap* map, const char* name, uint64_t h);
+
+/**
+@brief
+  Return the number of bindings in `map`.
+@param map Map (NULL for empty).
+@return Binding count, O(1).
+ */
+size_t reg_pmap_count(const struct RegPmap* map);
+
+/**
+@brief
+  Take one more reference on `map`.
+@param map Map (NULL is a no-op).
+@return None.
+@pre Caller already holds a reference (or owns the map's publisher lock).
+@note Thread-safe; O(1).
+ */
+void reg_pmap_retain(struct RegPmap* map);
+
+/**
+@brief
+  Drop one reference on `map`.
+@param map Map (NULL is a no-op).
+@param allocator Allocator the map's nodes came from.
+@return None.
+@post Nodes no longer referenced are freed and their leaves' objects
+  decref_obj()'d; shared nodes are untouched.
+@note Thread-safe. Costs the number of nodes freed.
+ */
+void reg_pmap_release(struct RegPmap* map, const struct LinalgAllocator* allocator);
+
+#endif // REG_PMAP_H
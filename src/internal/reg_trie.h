@@ -0,0 +1,134 @@
+#ifndef REG_TRIE_H
+#define REG_TRIE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "linalg_types.h"
+
+/* ============================================================================
+ * Module overview / invariants
+ * ============================================================================
+  - Path-compressed radix trie over registry names, used as the registry's
+    optional prefix index.
+  - Every edge carries a non-empty label; siblings are kept sorted by the
+    first byte of their label, so no two siblings share a first byte.
+  - Apart from the root, every node is terminal (a stored name ends there)
+    or has at least two children; removals re-merge nodes to keep it so.
+  - The trie stores its own copy of every label byte and never references
+    registry-owned names, so it is independent of backend storage moves.
+  - Prefix queries cost O(|prefix|) to reach the matching subtree plus
+    O(matched names) to walk it; they never touch unrelated names.
+  - Not thread-safe; the registry calls it under the shard lock.
+  - Unless otherwise specified, functions that return int return 0 on success
+    and nonzero on error; specific codes are documented per function.
+ */
+
+/* ============================================================================
+ * Public types
+ * ============================================================================
+ */
+struct RegTrie;
+
+// NUL-separated list of names produced by reg_trie_collect().
+struct RegTrieNames
+{
+    char* data;                       // names back to back, each NUL-terminated
+    size_t used;                      // bytes of data in use
+    size_t capacity;                  // bytes allocated
+    size_t count;                     // number of names
+    struct LinalgAllocator allocator; // source of data, set by reg_trie_collect()
+};
+
+/* ============================================================================
+ * Public API
+ * ============================================================================
+ */
+
+/**
+@brief
+  Create an empty trie.
+@param allocator Source of the trie's memory; NULL for the process-wide allocator.
+@return
+  struct RegTrie*: On success.
+  NULL: On allocation failure.
+@pre None.
+@post Trie holds no names.
+@note Caller owns the trie and must release it with reg_trie_destroy().
+ */
+struct RegTrie* reg_trie_init(const struct LinalgAllocator* allocator);
+
+/**
+@brief
+  Free the trie and every node.
+@param trie Trie to destroy.
+@return
+  0: In all cases (including NULL no-op).
+@pre None.
+@post trie is invalid.
+ */
+int reg_trie_destroy(struct RegTrie* trie);
+
+/**
+@brief
+  Add `name` to the trie.
+@param trie Trie.
+@param name Name to add (null-terminated, non-empty).
+@return
+  0: Success, or name already present.
+  2: Allocation failure; trie still holds exactly the names it held before.
+@pre trie != NULL, name != NULL.
+@post reg_trie_collect() with any prefix of `name` reports it.
+ */
+int reg_trie_insert(struct RegTrie* trie, const char* name);
+
+/**
+@brief
+  Remove `name` from the trie.
+@param trie Trie.
+@param name Name to remove (null-terminated).
+@return
+  0: Success.
+  1: Name not present; trie unchanged.
+@pre trie != NULL, name != NULL.
+@post Nodes left redundant by the removal are freed or merged (merging is
+  best effort and skipped on allocation failure).
+ */
+int reg_trie_remove(struct RegTrie* trie, const char* name);
+
+/**
+@brief
+  Append every stored name that starts with `prefix` to `names`.
+@param trie Trie.
+@param prefix Byte prefix to match (null-terminated; "" matches all names).
+@param names List to append to; zero-initialize before first use.
+@return
+  0: Success (including no matches).
+  2: Allocation failure; names may hold a partial result.
+@pre trie != NULL, prefix != NULL, names != NULL.
+@post Trie unchanged.
+@note Matching is bytewise, not per name component: "s1.m" matches
+  "s1.model.W". Release names with reg_trie_names_free().
+ */
+int reg_trie_collect(const struct RegTrie* trie, const char* prefix, struct RegTrieNames* names);
+
+/**
+@brief
+  Release storage held by a name list.
+@param names List to release.
+@return None.
+@pre None.
+@post names is empty and may be reused.
+ */
+void reg_trie_names_free(struct RegTrieNames* names);
+
+/**
+@brief
+  Return the number of stored names.
+@param trie Trie.
+@return Name count; 0 for NULL.
+ */
+size_t reg_trie_count(const struct RegTrie* trie);
+
+#endif // REG_TRIE_H
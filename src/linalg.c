@@ -1,23 +1,268 @@
 #include "linalg.h"
+
+#include <stdbool.h>
+
 #include "logs.h"
 #include "math_objs.h"
+#include "mem_alloc.h"
+#include "obj_buffer.h"
 #include "reg_hash.h"
 
-static struct RegistryHash* g_reg_table;
+struct LinalgContext
+{
+    struct RegistryHash* registry;
+    struct ObjStore* store;  // NULL for the default context: process-wide store
+    struct LogSettings log; // unused by the default context (process-wide settings)
+    struct LinalgAllocator allocator; // the context and its scratch arrays (RegistryConfig)
+};
+
+// behind the context-less API; registry set by linalg_init_reg_table*()
+static struct LinalgContext g_context;
+
+static const struct LogSettings* enter_ctx(const struct LinalgContext* ctx);
+static int bind_matrices(struct LinalgContext* ctx, const struct MatrixSpec* specs, size_t count,
+                         int* status);
 
 int linalg_create_bind_matrix(struct List elements, size_t num_rows, size_t num_cols,
                               const char* name)
 {
-    struct ObjWrapper* new_matrix = create_matrix(elements, num_rows, num_cols);
-    if (new_matrix == NULL)
-        return 4; // allocation error caller retains List elements
+    return linalg_ctx_create_bind_matrix(&g_context, elements, num_rows, num_cols, name);
+}
+
+int linalg_create_bind_matrix_inline(struct List elements, size_t num_rows, size_t num_cols,
+                                     const char* name, enum InlineMode mode)
+{
+    return linalg_ctx_create_bind_matrix_inline(&g_context, elements, num_rows, num_cols, name,
+                                                mode);
+}
+
+int linalg_create_bind_matrices(const struct MatrixSpec* specs, size_t count, int* status)
+{
+    return linalg_ctx_create_bind_matrices(&g_context, specs, count, status);
+}
+
+int linalg_create_bind_vector(struct List elements, const char* name)
+{
+    return linalg_ctx_create_bind_vector(&g_context, elements, name);
+}
+
+int linalg_create_bind_scalar(double value, const char* name)
+{
+    return linalg_ctx_create_bind_scalar(&g_context, value, name);
+}
+
+int linalg_alloc_elements(struct List* elements, size_t size, size_t type_size,
+                          enum ElementAlloc kind)
+{
+    return obj_buffer_alloc(elements, size, type_size, kind);
+}
+
+int linalg_wrap_elements(struct List* elements, void* list, size_t size, size_t type_size,
+                         element_release_fn release, void* release_ctx)
+{
+    return obj_buffer_wrap(elements, list, size, type_size, release, release_ctx);
+}
+
+void linalg_free_elements(struct List elements)
+{
+    obj_buffer_free(elements);
+}
+
+int linalg_set_buffer_pool(size_t max_bytes, uint32_t max_age_ms)
+{
+    obj_buffer_pool_config(max_bytes, max_age_ms);
+    return 0;
+}
+
+size_t linalg_trim_buffer_pool(uint32_t max_age_ms)
+{
+    return obj_buffer_pool_trim(max_age_ms);
+}
+
+int linalg_buffer_pool_stats(struct BufferPoolStats* stats)
+{
+    if (!stats)
+        return 1; // invalid input
+    obj_buffer_pool_stats(stats);
+    return 0;
+}
+
+int linalg_set_allocator(const struct LinalgAllocator* allocator)
+{
+    return mem_set_process_allocator(allocator);
+}
+
+int linalg_set_memory_budget(size_t max_bytes)
+{
+    obj_set_memory_budget(max_bytes);
+    return 0;
+}
+
+int linalg_memory_stats(struct MemoryStats* stats)
+{
+    return obj_memory_stats(stats);
+}
+
+/* Binding Table API Note:
+   The default context's registry is validated by reg_hash APIs;
+   callers must initialize via linalg_init_reg_table().
+*/
+
+int linalg_init_reg_table(size_t table_size)
+{
+    return linalg_init_reg_table_config(table_size, NULL);
+}
+
+int linalg_init_reg_table_config(size_t table_size, const struct RegistryConfig* config)
+{
+    g_context.registry = init_reg_table_config(table_size, config);
+    if (g_context.registry == NULL)
+        return 2;
+    g_context.allocator = mem_resolve(config ? config->allocator : NULL);
+    return 0;
+}
+
+int linalg_remove_binding(const char* name)
+{
+    return linalg_ctx_remove_binding(&g_context, name);
+}
+
+int linalg_resolve_binding(const char* name, struct BindingHandle* handle)
+{
+    return linalg_ctx_resolve_binding(&g_context, name, handle);
+}
 
-    int bind_ret = add_binding(name, new_matrix, g_reg_table);
+int linalg_remove_binding_handle(struct BindingHandle handle)
+{
+    return linalg_ctx_remove_binding_handle(&g_context, handle);
+}
+
+int linalg_registry_stats(struct RegistryStats* stats)
+{
+    return linalg_ctx_registry_stats(&g_context, stats);
+}
+
+int linalg_for_each_binding_prefix(const char* prefix, binding_visit_fn visit, void* ctx)
+{
+    return linalg_ctx_for_each_binding_prefix(&g_context, prefix, visit, ctx);
+}
+
+int linalg_remove_bindings_prefix(const char* prefix, size_t* removed)
+{
+    return linalg_ctx_remove_bindings_prefix(&g_context, prefix, removed);
+}
+
+int linalg_freeze_registry(void)
+{
+    return linalg_ctx_freeze_registry(&g_context);
+}
+
+int linalg_snapshot(struct RegSnapshot** out)
+{
+    return linalg_ctx_snapshot(&g_context, out);
+}
+
+bool linalg_snapshot_has(const struct RegSnapshot* snapshot, const char* name)
+{
+    return snapshot_lookup(snapshot, name) != NULL;
+}
+
+size_t linalg_snapshot_count(const struct RegSnapshot* snapshot)
+{
+    return snapshot_count(snapshot);
+}
+
+int linalg_snapshot_release(struct RegSnapshot* snapshot)
+{
+    return release_snapshot(snapshot);
+}
+
+int linalg_shutdown()
+{
+    destroy_reg_table(g_context.registry);
+    g_context.registry = NULL;
+    destroy_obj_list();
+
+    return 0;
+}
+
+/* Context API Note:
+   Every linalg_ctx_*() call runs with the context's log settings in scope
+   on the calling thread; the default context keeps the process-wide ones.
+*/
+
+struct LinalgContext* linalg_ctx_create(size_t table_size, const struct RegistryConfig* config)
+{
+    const struct LinalgAllocator* allocator = config ? config->allocator : NULL;
+    if (!mem_valid(allocator))
+        return NULL; // invalid input
+
+    struct LinalgContext* ctx =
+        mem_calloc(allocator, 1, sizeof(struct LinalgContext), ALLOC_SITE_CONTEXT);
+    if (!ctx)
+    {
+        LOG_OUT(LOG_ERROR, "failed to allocate %zu bytes for context.",
+                sizeof(struct LinalgContext));
+        return NULL;
+    }
+    ctx->log = (struct LogSettings){.level = LOG_ERROR, .sink = NULL};
+    ctx->allocator = mem_resolve(allocator);
+
+    // a single-threaded context needs no store lock
+    ctx->store = obj_store_init(config && config->concurrent, allocator);
+    ctx->registry = init_reg_table_config(table_size, config);
+    if (!ctx->store || !ctx->registry)
+    {
+        destroy_reg_table(ctx->registry);
+        obj_store_destroy(ctx->store);
+        mem_free(&ctx->allocator, ctx, ALLOC_SITE_CONTEXT);
+        return NULL;
+    }
+    return ctx;
+}
+
+int linalg_ctx_destroy(struct LinalgContext* ctx)
+{
+    if (!ctx || ctx == &g_context)
+        return 0; // noop, the default context ends with linalg_shutdown()
+
+    const struct LogSettings* outer = enter_ctx(ctx);
+    destroy_reg_table(ctx->registry);
+    obj_store_destroy(ctx->store);
+    log_scope_leave(outer);
+
+    struct LinalgAllocator allocator = ctx->allocator;
+    mem_free(&allocator, ctx, ALLOC_SITE_CONTEXT);
+    return 0;
+}
+
+int linalg_ctx_set_log(struct LinalgContext* ctx, LogType level, FILE* sink)
+{
+    if (!ctx || ctx == &g_context || level < LOG_ALL || level > LOG_NONE)
+        return 1; // invalid input
+    ctx->log = (struct LogSettings){.level = level, .sink = sink};
+    return 0;
+}
+
+int linalg_ctx_create_bind_matrix(struct LinalgContext* ctx, struct List elements,
+                                  size_t num_rows, size_t num_cols, const char* name)
+{
+    if (!ctx)
+        return 4; // nothing created, caller retains List elements
+
+    const struct LogSettings* outer = enter_ctx(ctx);
+    struct ObjWrapper* new_matrix = create_matrix_in(ctx->store, elements, num_rows, num_cols);
+    int bind_ret = new_matrix ? add_binding(name, new_matrix, ctx->registry) : -1;
+    if (new_matrix && bind_ret != 0)
+        decref_obj(new_matrix); // List elements has been freed
+    log_scope_leave(outer);
+
+    if (new_matrix == NULL)
+        return obj_budget_rejected() ? 6 : 4; // caller retains List elements
     if (bind_ret == 0)
         return 0;
     else
     {
-        decref_obj(new_matrix);
         switch (bind_ret) // List elements has been freed
         {
         case 1:
@@ -36,19 +281,68 @@ int linalg_create_bind_matrix(struct List elements, size_t num_rows, size_t num_
     }
 }
 
-int linalg_create_bind_vector(struct List elements, const char* name)
+int linalg_ctx_create_bind_matrix_inline(struct LinalgContext* ctx, struct List elements,
+                                         size_t num_rows, size_t num_cols, const char* name,
+                                         enum InlineMode mode)
 {
-    struct ObjWrapper* new_vector = create_vector(elements);
-    if (new_vector == NULL)
-        return 4; // allocation error caller retains List elements
+    if (!ctx)
+        return 4; // nothing created, caller retains List elements
+
+    const struct LogSettings* outer = enter_ctx(ctx);
+    struct ObjWrapper* new_matrix =
+        create_matrix_inline(ctx->store, elements, num_rows, num_cols, mode);
+    int bind_ret = new_matrix ? add_binding(name, new_matrix, ctx->registry) : -1;
+    if (new_matrix && bind_ret != 0)
+        decref_obj(new_matrix); // releases the inline copy only
+    log_scope_leave(outer);
 
-    int bind_ret = add_binding(name, new_vector, g_reg_table);
+    if (new_matrix == NULL)
+        return obj_budget_rejected() ? 6 : 4; // caller retains List elements
+    switch (bind_ret) // INLINE_TAKE: List elements has been freed
+    {
+    case 0:
+        return 0;
+    case 1:
+        return 1; // invalid input
+    case 2:
+        return 2; // allocation
+    default:
+        return 3; // internal error
+    }
+}
+
+int linalg_ctx_create_bind_matrices(struct LinalgContext* ctx, const struct MatrixSpec* specs,
+                                    size_t count, int* status)
+{
+    if (!ctx)
+        return 1; // invalid input
+
+    const struct LogSettings* outer = enter_ctx(ctx);
+    int ret = bind_matrices(ctx, specs, count, status);
+    log_scope_leave(outer);
+    return ret;
+}
+
+int linalg_ctx_create_bind_vector(struct LinalgContext* ctx, struct List elements,
+                                  const char* name)
+{
+    if (!ctx)
+        return 4; // nothing created, caller retains List elements
+
+    const struct LogSettings* outer = enter_ctx(ctx);
+    struct ObjWrapper* new_vector = create_vector_in(ctx->store, elements);
+    int bind_ret = new_vector ? add_binding(name, new_vector, ctx->registry) : -1;
+    if (new_vector && bind_ret != 0)
+        decref_obj(new_vector);
+    log_scope_leave(outer);
+
+    if (new_vector == NULL)
+        return obj_budget_rejected() ? 6 : 4; // caller retains List elements
     if (bind_ret == 0)
         return 0;
 
     else
     {
-        decref_obj(new_vector);
         switch (bind_ret)
         {
         case 1:
@@ -67,18 +361,24 @@ int linalg_create_bind_vector(struct List elements, const char* name)
     }
 }
 
-int linalg_create_bind_scalar(double value, const char* name)
+int linalg_ctx_create_bind_scalar(struct LinalgContext* ctx, double value, const char* name)
 {
-    struct ObjWrapper* new_scalar = create_scalar(value);
-    if (new_scalar == NULL)
-        return 2;
+    if (!ctx)
+        return 1; // invalid input
+
+    const struct LogSettings* outer = enter_ctx(ctx);
+    struct ObjWrapper* new_scalar = create_scalar_in(ctx->store, value);
+    int bind_ret = new_scalar ? add_binding(name, new_scalar, ctx->registry) : -1;
+    if (new_scalar && bind_ret != 0)
+        decref_obj(new_scalar);
+    log_scope_leave(outer);
 
-    int bind_ret = add_binding(name, new_scalar, g_reg_table);
+    if (new_scalar == NULL)
+        return obj_budget_rejected() ? 6 : 2;
     if (bind_ret == 0)
         return 0;
     else
     {
-        decref_obj(new_scalar);
         switch (bind_ret)
         {
         case 1:
@@ -95,29 +395,76 @@ int linalg_create_bind_scalar(double value, const char* name)
     }
 }
 
-/* Binding Table API Note:
-   g_reg_table is validated by reg_hash APIs;
-   callers must initialize via linalg_init_reg_table().
-*/
-
-int linalg_init_reg_table(size_t table_size)
+int linalg_ctx_remove_binding(struct LinalgContext* ctx, const char* name)
 {
-    g_reg_table = init_reg_table(table_size);
-    if (g_reg_table == NULL)
-        return 2;
-    return 0;
+    if (!ctx)
+        return 1; // invalid input
+
+    const struct LogSettings* outer = enter_ctx(ctx);
+    int ret = remove_binding(name, ctx->registry);
+    log_scope_leave(outer);
+
+    switch (ret)
+    {
+    case 0:
+        return 0; // success
+    case 1:
+        return 1; // binding not found-> caller error
+    case 2:
+        return 2; // allocation (snapshot map); binding kept
+    case 3:
+        return 1; // invalid input
+    case 4:
+        return 3; // internal error
+    default:
+        return 3; // internal error
+    }
 }
 
-int linalg_remove_binding(const char* name)
+int linalg_ctx_resolve_binding(struct LinalgContext* ctx, const char* name,
+                               struct BindingHandle* handle)
 {
-    switch (remove_binding(name, g_reg_table))
+    if (!ctx)
+        return 1; // invalid input
+
+    const struct LogSettings* outer = enter_ctx(ctx);
+    int ret = resolve_binding(name, ctx->registry, handle);
+    log_scope_leave(outer);
+
+    switch (ret)
     {
     case 0:
         return 0; // success
     case 1:
         return 1; // binding not found-> caller error
+    case 2:
+        return 2; // allocation
     case 3:
         return 1; // invalid input
+    default:
+        return 3; // internal error
+    }
+}
+
+int linalg_ctx_remove_binding_handle(struct LinalgContext* ctx, struct BindingHandle handle)
+{
+    if (!ctx)
+        return 1; // not initialized
+
+    const struct LogSettings* outer = enter_ctx(ctx);
+    int ret = remove_binding_handle(handle, ctx->registry);
+    log_scope_leave(outer);
+
+    switch (ret)
+    {
+    case 0:
+        return 0; // success
+    case 1:
+        return 1; // stale handle-> caller error
+    case 2:
+        return 2; // allocation (snapshot map); binding kept
+    case 3:
+        return 1; // not initialized
     case 4:
         return 3; // internal error
     default:
@@ -125,11 +472,188 @@ int linalg_remove_binding(const char* name)
     }
 }
 
-int linalg_shutdown()
+int linalg_ctx_registry_stats(struct LinalgContext* ctx, struct RegistryStats* stats)
 {
-    destroy_reg_table(g_reg_table);
-    g_reg_table = NULL;
-    destroy_obj_list();
+    if (!ctx)
+        return 1; // invalid input
 
+    const struct LogSettings* outer = enter_ctx(ctx);
+    int ret = registry_stats(ctx->registry, stats);
+    log_scope_leave(outer);
+
+    if (ret != 0)
+        return 1; // invalid input or not initialized
     return 0;
 }
+
+int linalg_ctx_for_each_binding_prefix(struct LinalgContext* ctx, const char* prefix,
+                                       binding_visit_fn visit, void* visit_ctx)
+{
+    if (!ctx)
+        return 1; // invalid input
+
+    const struct LogSettings* outer = enter_ctx(ctx);
+    int ret = for_each_binding_prefix(ctx->registry, prefix, visit, visit_ctx);
+    log_scope_leave(outer);
+
+    switch (ret)
+    {
+    case 0:
+        return 0; // success
+    case 1:
+        return 1; // invalid input or not initialized
+    case 2:
+        return 2; // allocation
+    case 4:
+        return 4; // no prefix index
+    default:
+        return 3; // internal error
+    }
+}
+
+int linalg_ctx_remove_bindings_prefix(struct LinalgContext* ctx, const char* prefix,
+                                      size_t* removed)
+{
+    if (!ctx)
+        return 1; // invalid input
+
+    const struct LogSettings* outer = enter_ctx(ctx);
+    int ret = remove_bindings_prefix(ctx->registry, prefix, removed);
+    log_scope_leave(outer);
+
+    switch (ret)
+    {
+    case 0:
+        return 0; // success
+    case 1:
+        return 1; // invalid input or not initialized
+    case 2:
+        return 2; // allocation
+    case 4:
+        return 4; // no prefix index
+    default:
+        return 3; // internal error
+    }
+}
+
+int linalg_ctx_freeze_registry(struct LinalgContext* ctx)
+{
+    if (!ctx)
+        return 1; // invalid input
+
+    const struct LogSettings* outer = enter_ctx(ctx);
+    int ret = freeze_registry(ctx->registry);
+    log_scope_leave(outer);
+
+    switch (ret)
+    {
+    case 0:
+        return 0; // success
+    case 2:
+        return 2; // allocation
+    case 3:
+        return 1; // not initialized
+    case 5:
+        return 5; // no perfect hash; registry unchanged
+    default:
+        return 3; // internal error
+    }
+}
+
+int linalg_ctx_snapshot(struct LinalgContext* ctx, struct RegSnapshot** out)
+{
+    if (!ctx || !out)
+        return 1; // invalid input
+
+    const struct LogSettings* outer = enter_ctx(ctx);
+    int ret = snapshot_registry(ctx->registry, out);
+    log_scope_leave(outer);
+
+    switch (ret)
+    {
+    case 0:
+        return 0; // success
+    case 2:
+        return 2; // allocation
+    case 3:
+        return 1; // not initialized
+    default:
+        return 3; // internal error
+    }
+}
+
+//  Purpose: Put ctx's log settings in scope for the calling thread.
+//  Input Assumptions: ctx != NULL.
+//  Effects: Thread's log scope replaced (process-wide for the default
+//    context).
+//  Returns: Previous scope, for log_scope_leave().
+static const struct LogSettings* enter_ctx(const struct LinalgContext* ctx)
+{
+    return log_scope_enter(ctx == &g_context ? NULL : &ctx->log);
+}
+
+//  Purpose: Body of linalg_ctx_create_bind_matrices().
+//  Input Assumptions: ctx != NULL; ctx's log scope entered.
+//  Effects: As linalg_ctx_create_bind_matrices().
+//  Returns: As linalg_ctx_create_bind_matrices().
+static int bind_matrices(struct LinalgContext* ctx, const struct MatrixSpec* specs, size_t count,
+                         int* status)
+{
+    if (!specs || !status || count == 0 || !ctx->registry)
+        return 1; // invalid input
+
+    struct ObjWrapper** objects =
+        mem_calloc(&ctx->allocator, count, sizeof(struct ObjWrapper*), ALLOC_SITE_CONTEXT);
+    bool* over_budget = mem_calloc(&ctx->allocator, count, sizeof(bool), ALLOC_SITE_CONTEXT);
+    if (!objects || !over_budget)
+    {
+        LOG_OUT(LOG_ERROR, "failed to allocate %zu bytes for %zu-item batch.",
+                count * (sizeof(struct ObjWrapper*) + sizeof(bool)), count);
+        mem_free(&ctx->allocator, objects, ALLOC_SITE_CONTEXT);
+        mem_free(&ctx->allocator, over_budget, ALLOC_SITE_CONTEXT);
+        return 2; // allocation error caller retains every List elements
+    }
+
+    // capacity hint only, a failure just means the registry grows on demand
+    reserve_bindings(ctx->registry, count);
+    create_matrices_in(ctx->store, specs, count, objects, over_budget);
+
+    size_t failed = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!objects[i])
+        { // not created, caller retains List elements
+            bool bad_name = (!specs[i].name || specs[i].name[0] == '\0');
+            status[i] = bad_name ? 1 : over_budget[i] ? 6 : 4;
+            failed++;
+            continue;
+        }
+
+        int bind_ret = add_binding(specs[i].name, objects[i], ctx->registry);
+        if (bind_ret != 0)
+        {
+            decref_obj(objects[i]); // List elements has been freed
+            failed++;
+        }
+        switch (bind_ret)
+        {
+        case 0:
+            status[i] = 0; // success
+            break;
+        case 1:
+            status[i] = 1; // invalid input
+            break;
+        case 2:
+            status[i] = 2; // allocation
+            break;
+        default:
+            status[i] = 3; // internal error
+            break;
+        }
+    }
+
+    mem_free(&ctx->allocator, objects, ALLOC_SITE_CONTEXT);
+    mem_free(&ctx->allocator, over_budget, ALLOC_SITE_CONTEXT);
+    LOG_OUT(LOG_DEBUG, "bulk create+bind finished count=%zu failed=%zu.", count, failed);
+    return failed ? 5 : 0;
+}
@@ -7,6 +7,7 @@
 
 static LogType log_level = LOG_ALL;
 static FILE* log_sink = NULL;
+static _Thread_local const struct LogSettings* log_scope; // NULL: process-wide settings
 
 /* ============================================================================
  * Private function prototypes
@@ -27,15 +28,21 @@ int log_out(LogType log_type, const char* file, const int line, const char* func
         log_sink = stderr;
     }
 
+    // Scoped settings (a context's) take precedence over the process-wide ones
+    const struct LogSettings* scope = log_scope;
+    LogType level = scope ? scope->level : log_level;
+    FILE* sink = scope ? (scope->sink ? scope->sink : stderr) : log_sink;
+
     // Only log messages at or above the current Log Level
-    if (log_type < log_level)
+    if (log_type < level)
         return 0;
 
     // Get timestamp
     char time_str[50];
     time_t now = time(NULL);
-    struct tm* t = localtime(&now);
-    strftime(time_str, sizeof(time_str), "%Y-%m-%d %H:%M:%S", t);
+    struct tm t;
+    localtime_r(&now, &t); // reentrant: registry shards may log concurrently
+    strftime(time_str, sizeof(time_str), "%Y-%m-%d %H:%M:%S", &t);
 
     // Format the user message
     char user_msg[512];
@@ -66,7 +73,7 @@ int log_out(LogType log_type, const char* file, const int line, const char* func
     }
 
     // Final output
-    fprintf(log_sink, "[%s] [%s] [%s:%d %s] %s\n", time_str, type_str, basename_from_path(file),
+    fprintf(sink, "[%s] [%s] [%s:%d %s] %s\n", time_str, type_str, basename_from_path(file),
             line, func, user_msg);
 
     return 0;
@@ -90,6 +97,18 @@ int set_log_sink(FILE* new_sink)
     return 0;
 }
 
+const struct LogSettings* log_scope_enter(const struct LogSettings* settings)
+{
+    const struct LogSettings* outer = log_scope;
+    log_scope = settings;
+    return outer;
+}
+
+void log_scope_leave(const struct LogSettings* outer)
+{
+    log_scope = outer;
+}
+
 /* ============================================================================
  * Private helper functions
  * ============================================================================
@@ -1,9 +1,18 @@
 #include "math_objs.h"
 #include "logs.h"
+#include "mem_alloc.h"
+#include "obj_buffer.h"
+#include "obj_slab.h"
 
 #include <assert.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #pragma region Local Definitions
 /* ============================================================================
@@ -11,16 +20,44 @@
  * ============================================================================
  */
 
+// Where an object's header and elements live, which decides how it is freed.
+enum ObjStorage
+{
+    OBJ_STORAGE_SPLIT,    // header from its type slab; elements.list is the caller's buffer,
+                          // released by obj_buffer_free() according to elements.alloc
+    OBJ_STORAGE_EMBEDDED, // scalar held in the wrapper itself
+    OBJ_STORAGE_SMALL,    // SmallObj: header and copied elements in one small_slab item
+    OBJ_STORAGE_BLOCK,    // InlineObj: one aligned_alloc() block (create_*_inline())
+};
+
+struct Scalar
+{
+    double value;
+};
+
+// References are counted in two parts (biased reference counting): `biased`
+// is touched only by the thread holding `owner` and needs no atomic RMW;
+// every other thread goes through `shared`. See "Reference counts" in the
+// header comment of math_objs.h.
 struct ObjWrapper
 {
-    void* obj;
+    void* obj; // header; points into this wrapper's own storage unless SPLIT
     enum ObjType type;
-    size_t ref_count;
+    enum ObjStorage storage;
+    struct BiasRecord* owner;       // creating thread's record, fixed at creation; may be NULL
+    atomic_size_t biased;           // owner's references; 0 once merged into shared
+    atomic_intptr_t shared;         // other threads' references * SHARED_ONE | SHARED_* flags
+    struct ObjWrapper* merge_next;  // owner->pending link while SHARED_QUEUED
+    struct ObjStore* store;         // root set holding this object; NULL while unlinked
+    struct ObjWrapper* prev; // root set links (intrusive), guarded by the store
+    struct ObjWrapper* next;
+    size_t charged;       // bytes counted against the memory budget (obj_memory)
+    struct Scalar scalar; // OBJ_STORAGE_EMBEDDED value
 };
 
 struct Matrix
 {
-    struct List elements; // owns elements.list (heap)
+    struct List elements; // owns elements.list (elements.alloc says how to free it)
     size_t num_rows;
     size_t num_cols;
 };
@@ -30,24 +67,138 @@ struct Vector
     struct List elements;
 };
 
-struct Scalar
+#define INLINE_ALIGN OBJ_BUFFER_ALIGN // packed element payloads start on a cache line
+#define SMALL_ELEMENT_BYTES 128       // largest payload kept in a SmallObj (4x4 doubles)
+
+// Header of a packed (SMALL or BLOCK) matrix or vector.
+union PackedHeader
 {
-    double value;
+    struct Matrix matrix;
+    struct Vector vector;
+};
+
+// Small matrix or vector: wrapper, header and a copy of the elements in one
+// fixed-size slab item.
+struct SmallObj
+{
+    struct ObjWrapper wrapper; // first: the item is freed through the wrapper
+    union PackedHeader header;
+    _Alignas(INLINE_ALIGN) unsigned char elements[SMALL_ELEMENT_BYTES];
 };
 
-struct ObjLLNode
+// slab items whose size is a multiple of 64 are 64-byte aligned (obj_slab.h)
+_Static_assert(sizeof(struct SmallObj) % INLINE_ALIGN == 0, "SmallObj payload misaligned");
+
+// Matrix or vector whose wrapper, header and elements share one aligned
+// allocation (create_*_inline()).
+struct InlineObj
 {
-    struct ObjWrapper* object;
-    struct ObjLLNode* next;
+    struct ObjWrapper wrapper; // first: the block is freed through the wrapper
+    union PackedHeader header; // header.*.elements.list points at elements
+    _Alignas(INLINE_ALIGN) unsigned char elements[];
 };
 
+// Doubly linked through ObjWrapper.prev/next, so linking and unlinking an
+// object is O(1) and needs no allocation.
 struct ObjLL
 {
-    struct ObjLLNode* head;
+    struct ObjWrapper* head;
     size_t count;
 };
 
-static struct ObjLL obj_list;
+#define RECLAIM_DEFAULT_PENDING 1024
+
+// Objects waiting to be freed (RECLAIM_DEFERRED/BACKGROUND), linked through
+// wrapper->next once they have left the store's list. Always locked: the
+// reclaimer thread and collect calls race with the releasing threads even
+// in an unlocked store.
+struct ObjReclaim
+{
+    pthread_mutex_t lock;      // guards every field below except mode reads
+    pthread_cond_t work;       // pending > 0 or stop (reclaimer waits)
+    pthread_cond_t space;      // pending dropped below max_pending (producers wait)
+    atomic_int mode;           // enum ReclaimMode; written under lock
+    struct ObjWrapper* head;   // queued objects, newest first
+    size_t pending;            // objects on head
+    size_t max_pending;        // backpressure threshold
+    bool stop;                 // reclaimer thread should exit once the queue is empty
+    bool has_thread;           // reclaimer thread running
+    pthread_t thread;
+};
+
+struct ObjStore
+{
+    struct ObjLL list;
+    bool locked;          // false: owner guarantees single-threaded use
+    pthread_mutex_t lock; // guards list when locked
+    struct ObjReclaim reclaim;
+    struct LinalgAllocator allocator; // resolved; the store block is freed through it
+};
+
+#define OBJ_TYPE_COUNT 3 // OBJ_SCALAR, OBJ_VECTOR, OBJ_MATRIX
+
+// Per-thread ownership record for biased reference counts. A record is held
+// by at most one thread at a time; records of exited threads wait on
+// free_records and are handed to the next thread that needs one, together
+// with the objects they own. Records are never freed, so they also carry
+// the holder's share of the memory counters (see struct ObjMemory).
+struct BiasRecord
+{
+    pthread_mutex_t lock;         // guards pending
+    struct ObjWrapper* pending;   // objects whose shared count went negative
+    atomic_bool has_pending;      // pending != NULL, readable without the lock
+    atomic_bool held;             // a thread owns the record (written under bias_lock)
+    struct BiasRecord* next_free; // free_records link, guarded by bias_lock
+    struct BiasRecord* next_all;  // all_records link, set once under bias_lock
+    atomic_intptr_t live_objects[OBJ_TYPE_COUNT]; // holder-written; negative when objects
+    atomic_intptr_t live_bytes[OBJ_TYPE_COUNT];   // created elsewhere die here
+};
+
+#define SHARED_MERGED ((intptr_t)1) // biased part folded in; shared is the whole count
+#define SHARED_QUEUED ((intptr_t)2) // on owner->pending; only a merge may destroy it
+#define SHARED_ONE ((intptr_t)4)    // one reference in `shared`
+
+static pthread_mutex_t bias_lock = PTHREAD_MUTEX_INITIALIZER; // guards free_records
+static struct BiasRecord* free_records;
+static struct BiasRecord* all_records; // every record ever made, guarded by bias_lock
+static _Thread_local struct BiasRecord* self_record;
+static pthread_once_t bias_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t bias_key; // releases self_record at thread exit
+
+// process-wide store behind the store-less API (create_scalar(), ...)
+static struct ObjStore default_store = {
+    .locked = true,
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .reclaim = {.lock = PTHREAD_MUTEX_INITIALIZER,
+                .work = PTHREAD_COND_INITIALIZER,
+                .space = PTHREAD_COND_INITIALIZER,
+                .mode = RECLAIM_INLINE,
+                .max_pending = RECLAIM_DEFAULT_PENDING}};
+
+// fixed-size structs come from slabs shared by every store
+static struct ObjSlab wrapper_slab = OBJ_SLAB_INITIALIZER(0, sizeof(struct ObjWrapper));
+static struct ObjSlab matrix_slab = OBJ_SLAB_INITIALIZER(1, sizeof(struct Matrix));
+static struct ObjSlab vector_slab = OBJ_SLAB_INITIALIZER(2, sizeof(struct Vector));
+static struct ObjSlab small_slab = OBJ_SLAB_INITIALIZER(3, sizeof(struct SmallObj));
+
+// Process-wide memory held by live objects, charged before an object's
+// storage is allocated and uncharged when it is freed. `total` is the one
+// shared RMW per charge and only moves past `budget` (when set) through the
+// CAS in charge_obj(). Per-type counts are split like reference counts: each
+// thread adds to its BiasRecord with plain loads and stores, and
+// obj_memory_stats() sums every record plus the shared fallback counters
+// below (used by threads without a record).
+struct ObjMemory
+{
+    atomic_intptr_t objects[OBJ_TYPE_COUNT]; // recordless threads' live objects per ObjType
+    atomic_intptr_t bytes[OBJ_TYPE_COUNT];   // and their bytes
+    atomic_size_t total;                     // all live bytes
+    atomic_size_t budget;                    // hard limit on total; 0 = unlimited
+    atomic_uint_least64_t rejections;        // creations refused by the budget
+};
+
+static struct ObjMemory obj_memory;
+static _Thread_local bool budget_rejected; // last create_*() on this thread hit the budget
 #pragma endregion
 
 #pragma region Private Function Prototypes
@@ -57,12 +208,54 @@ static struct ObjLL obj_list;
  */
 static int destroy_matrix(struct Matrix* matrix);
 static int destroy_vector(struct Vector* vector);
-static int destroy_scalar(struct Scalar* scalar);
 static int destroy_wrapper(struct ObjWrapper* wrapper);
-static int add_obj(struct ObjWrapper* object);
+static int add_obj(struct ObjStore* store, struct ObjWrapper* object);
+static struct ObjWrapper* new_matrix_wrapper(struct List elements, size_t num_rows,
+                                             size_t num_cols);
+static struct ObjWrapper* new_vector_wrapper(struct List elements);
+static void init_wrapper(struct ObjWrapper* wrapper, enum ObjType type, enum ObjStorage storage,
+                         void* obj, size_t charged);
 static int remove_obj(struct ObjWrapper* object);
 static int destroy_obj(struct ObjWrapper* wrapper);
-static struct ObjLLNode* find_node(struct ObjWrapper* wrapper, struct ObjLLNode** prev_node);
+static inline bool is_linked(const struct ObjStore* store, const struct ObjWrapper* object);
+static struct ObjWrapper* new_small_obj(enum ObjType type, struct List elements);
+static struct ObjWrapper* new_inline_obj(enum ObjType type, struct List elements);
+static void pack_elements(struct ObjWrapper* wrapper, union PackedHeader* header,
+                          unsigned char* payload, struct List elements);
+static inline bool fits_small(struct List elements);
+static void discard_obj(struct ObjWrapper* wrapper);
+static inline struct Matrix* matrix_of(struct ObjWrapper* wrapper);
+static bool valid_matrix_shape(struct List elements, size_t num_rows, size_t num_cols);
+static bool valid_vector_shape(struct List elements);
+static inline bool ownable_buffer(struct List elements);
+static inline bool wrapped_buffer(struct List elements);
+static inline bool payload_fits(struct List elements);
+static bool charge_obj(enum ObjType type, size_t bytes);
+static void uncharge_obj(enum ObjType type, size_t bytes);
+static void tally_obj(enum ObjType type, intptr_t objects, intptr_t bytes);
+static inline size_t split_bytes(enum ObjType type, struct List elements);
+static struct ObjWrapper* link_inline_obj(struct ObjStore* store, struct ObjWrapper* wrapper,
+                                          struct List elements, enum InlineMode mode);
+static inline struct ObjStore* resolve_store(struct ObjStore* store);
+static inline void store_lock(struct ObjStore* store);
+static inline void store_unlock(struct ObjStore* store);
+static void drain_store(struct ObjStore* store);
+static inline intptr_t shared_count(intptr_t shared);
+static struct BiasRecord* own_record(void);
+static void make_bias_key(void);
+static void release_thread_record(void* record);
+static void release_record(struct BiasRecord* record);
+static void adopt_and_merge(struct BiasRecord* record);
+static void queue_merge(struct ObjWrapper* wrapper);
+static void merge_pending(struct BiasRecord* record);
+static intptr_t merge_one(struct ObjWrapper* wrapper);
+static void settle_refs(struct ObjWrapper* wrapper);
+static void release_obj(struct ObjWrapper* wrapper);
+static bool defer_release(struct ObjReclaim* reclaim, struct ObjWrapper* wrapper);
+static struct ObjWrapper* take_pending(struct ObjReclaim* reclaim);
+static size_t release_list(struct ObjWrapper* head);
+static void* reclaimer_main(void* arg);
+static void stop_reclaimer(struct ObjReclaim* reclaim);
 #pragma endregion
 
 #pragma region Public API
@@ -80,62 +273,114 @@ static struct ObjLLNode* find_node(struct ObjWrapper* wrapper, struct ObjLLNode*
 // Post conditions: None.
 struct ObjWrapper* create_matrix(struct List elements, size_t num_rows, size_t num_cols)
 {
-    if (!elements.list)
-        return NULL; // No matrix element list
-
-    // Check for rows/cols/size consistency
-    if ((!num_cols) || (!num_rows))
-        return NULL; // rows and or cols == 0
-    if ((num_rows * num_cols) != elements.size)
-        return NULL; // size != rows*cols
-    if (elements.type_size == 0)
-        return NULL; // zero type size
-
-    // Allocate matrix object and wrapper
-    struct Matrix* new_matrix = malloc(sizeof(struct Matrix));
-    if (!new_matrix)
-    {
-        LOG_OUT(LOG_ERROR, "Failed to malloc %zu bytes for new matrix (%zuX%zu).",
-                sizeof(struct Matrix), num_rows, num_cols);
-        return NULL;
-    }
+    return create_matrix_in(NULL, elements, num_rows, num_cols);
+}
 
-    struct ObjWrapper* new_wrapper = malloc(sizeof(struct ObjWrapper));
+struct ObjWrapper* create_matrix_in(struct ObjStore* store, struct List elements, size_t num_rows,
+                                    size_t num_cols)
+{
+    budget_rejected = false;
+    struct ObjWrapper* new_wrapper = new_matrix_wrapper(elements, num_rows, num_cols);
     if (!new_wrapper)
-    {
-        LOG_OUT(LOG_ERROR, "Failed to malloc %zu bytes for new wrapper (matrix %zuX%zu).",
-                sizeof(struct ObjWrapper), num_rows, num_cols);
-        free(new_matrix);
-        return NULL;
-    }
-
-    // Populate matrix and wrapper
-    new_matrix->num_rows = num_rows;
-    new_matrix->num_cols = num_cols;
-
-    new_wrapper->obj = new_matrix;
-    new_wrapper->type = OBJ_MATRIX;
-    new_wrapper->ref_count = 1;
+        return NULL; // invalid input or allocation failure
 
     // Add wrapper to object list
-    int add_obj_ret = add_obj(new_wrapper);
+    int add_obj_ret = add_obj(resolve_store(store), new_wrapper);
     if (add_obj_ret)
     {
         LOG_OUT(LOG_ERROR, "add_obj() failed: wrapper=%p obj=%p type=MATRIX dims=%zuX%zu ret=%d.",
                 new_wrapper, new_wrapper->obj, num_rows, num_cols, add_obj_ret);
-        free(new_matrix);
-        free(new_wrapper);
+        discard_obj(new_wrapper); // elements.list stays with the caller
         return NULL;
     }
-
-    // Pass ownership of elements.list to new_matrix
-    new_matrix->elements = elements;
+    if (new_wrapper->storage == OBJ_STORAGE_SMALL)
+        obj_buffer_free(elements); // copied into the object; ownership was ours
 
     LOG_OUT(LOG_DEBUG, "succeeded: wrapper=%p obj=%p type=MATRIX dims=%zuX%zu.", new_wrapper,
             new_wrapper->obj, num_rows, num_cols);
     return new_wrapper;
 }
 
+struct ObjWrapper* create_matrix_inline(struct ObjStore* store, struct List elements,
+                                        size_t num_rows, size_t num_cols, enum InlineMode mode)
+{
+    budget_rejected = false;
+    if (!valid_matrix_shape(elements, num_rows, num_cols))
+        return NULL; // invalid input
+
+    struct ObjWrapper* new_wrapper = fits_small(elements) ? new_small_obj(OBJ_MATRIX, elements)
+                                                          : new_inline_obj(OBJ_MATRIX, elements);
+    if (!new_wrapper)
+        return NULL; // allocation failure
+    matrix_of(new_wrapper)->num_rows = num_rows;
+    matrix_of(new_wrapper)->num_cols = num_cols;
+
+    new_wrapper = link_inline_obj(resolve_store(store), new_wrapper, elements, mode);
+    if (new_wrapper)
+        LOG_OUT(LOG_DEBUG, "succeeded: wrapper=%p type=MATRIX dims=%zuX%zu inline mode=%d.",
+                new_wrapper, num_rows, num_cols, mode);
+    return new_wrapper;
+}
+
+size_t create_matrices(const struct MatrixSpec* specs, size_t count, struct ObjWrapper** objects)
+{
+    return create_matrices_in(NULL, specs, count, objects, NULL);
+}
+
+size_t create_matrices_in(struct ObjStore* store, const struct MatrixSpec* specs, size_t count,
+                          struct ObjWrapper** objects, bool* over_budget)
+{
+    store = resolve_store(store);
+    struct ObjWrapper* batch = NULL; // prepared root set links, newest first
+    struct ObjWrapper* tail = NULL;
+    size_t created = 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const struct MatrixSpec* spec = &specs[i];
+        objects[i] = NULL;
+        if (over_budget)
+            over_budget[i] = false;
+        if (!spec->name || spec->name[0] == '\0')
+            continue; // unbindable, leave elements.list with the caller
+        budget_rejected = false;
+        objects[i] = new_matrix_wrapper(spec->elements, spec->num_rows, spec->num_cols);
+        if (over_budget)
+            over_budget[i] = budget_rejected;
+        if (!objects[i])
+            continue;
+
+        objects[i]->store = store;
+        objects[i]->next = batch;
+        if (batch)
+            batch->prev = objects[i];
+        else
+            tail = objects[i];
+        batch = objects[i];
+        created++;
+    }
+
+    // splice the whole batch in front of the root set at once
+    if (batch)
+    {
+        store_lock(store);
+        tail->next = store->list.head;
+        if (store->list.head)
+            store->list.head->prev = tail;
+        store->list.head = batch;
+        store->list.count += created;
+        store_unlock(store);
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        if (objects[i] && objects[i]->storage == OBJ_STORAGE_SMALL)
+            obj_buffer_free(specs[i].elements); // copied into the object
+    }
+
+    LOG_OUT(LOG_DEBUG, "succeeded: %zu of %zu matrices created.", created, count);
+    return created;
+}
+
 //  Pre conditions:
 //    1.  elements.list != NULL.
 //    2.  elements.size > 0.
@@ -143,86 +388,84 @@ struct ObjWrapper* create_matrix(struct List elements, size_t num_rows, size_t n
 //  Post conditions: None.
 struct ObjWrapper* create_vector(struct List elements)
 {
-    // Check elements to make sure we have list, size, and type_size
-    if (!elements.list)
-        return NULL; // No list
-    if (elements.size == 0)
-        return NULL; // zero size
-    if (elements.type_size == 0)
-        return NULL; // zero type size
-
-    struct Vector* new_vector = malloc(sizeof(struct Vector));
-    if (!new_vector)
-    {
-        LOG_OUT(LOG_ERROR, "Failed to malloc %zu bytes for new vector dim=%zu.",
-                sizeof(struct Vector), elements.size);
-        return NULL;
-    }
+    return create_vector_in(NULL, elements);
+}
 
-    struct ObjWrapper* new_wrapper = malloc(sizeof(struct ObjWrapper));
+struct ObjWrapper* create_vector_in(struct ObjStore* store, struct List elements)
+{
+    budget_rejected = false;
+    struct ObjWrapper* new_wrapper = new_vector_wrapper(elements);
     if (!new_wrapper)
-    {
-        LOG_OUT(LOG_ERROR, "Failed to malloc %zu bytes for new wrapper (vector dim=%zu).",
-                sizeof(struct ObjWrapper), elements.size);
-        free(new_vector);
-        return NULL;
-    }
-
-    new_wrapper->obj = new_vector;
-    new_wrapper->type = OBJ_VECTOR;
-    new_wrapper->ref_count = 1;
+        return NULL; // invalid input or allocation failure
 
-    int add_obj_ret = add_obj(new_wrapper);
+    int add_obj_ret = add_obj(resolve_store(store), new_wrapper);
     if (add_obj_ret)
     { // failed add_obj()
         LOG_OUT(LOG_ERROR, "add_obj() failed: wrapper=%p obj=%p type=VECTOR dim=%zu ret=%d.",
                 new_wrapper, new_wrapper->obj, elements.size, add_obj_ret);
-        free(new_vector);
-        free(new_wrapper);
+        discard_obj(new_wrapper); // elements.list stays with the caller
         return NULL;
     }
-
-    // Pass ownership of elements.list to new_vector
-    new_vector->elements = elements;
+    if (new_wrapper->storage == OBJ_STORAGE_SMALL)
+        obj_buffer_free(elements); // copied into the object; ownership was ours
 
     LOG_OUT(LOG_DEBUG, "succeeded: wrapper=%p obj=%p type=VECTOR dim=%zu.", new_wrapper,
             new_wrapper->obj, elements.size);
     return new_wrapper;
 }
 
+struct ObjWrapper* create_vector_inline(struct ObjStore* store, struct List elements,
+                                        enum InlineMode mode)
+{
+    budget_rejected = false;
+    if (!valid_vector_shape(elements))
+        return NULL; // invalid input
+
+    struct ObjWrapper* new_wrapper = fits_small(elements) ? new_small_obj(OBJ_VECTOR, elements)
+                                                          : new_inline_obj(OBJ_VECTOR, elements);
+    if (!new_wrapper)
+        return NULL; // allocation failure
+
+    new_wrapper = link_inline_obj(resolve_store(store), new_wrapper, elements, mode);
+    if (new_wrapper)
+        LOG_OUT(LOG_DEBUG, "succeeded: wrapper=%p type=VECTOR dim=%zu inline mode=%d.",
+                new_wrapper, elements.size, mode);
+    return new_wrapper;
+}
+
 //  Pre conditions: None.
 //  Post conditions: None.
 struct ObjWrapper* create_scalar(double value)
 {
-    struct Scalar* new_scalar = malloc(sizeof(struct Scalar));
-    if (!new_scalar)
-    {
-        LOG_OUT(LOG_ERROR, "Failed to malloc %zu bytes for new scalar.", sizeof(struct Scalar));
-        return NULL;
-    }
+    return create_scalar_in(NULL, value);
+}
+
+struct ObjWrapper* create_scalar_in(struct ObjStore* store, double value)
+{
+    budget_rejected = false;
+    if (!charge_obj(OBJ_SCALAR, sizeof(struct ObjWrapper)))
+        return NULL; // over the memory budget
 
-    struct ObjWrapper* new_wrapper = malloc(sizeof(struct ObjWrapper));
+    struct ObjWrapper* new_wrapper = obj_slab_alloc(&wrapper_slab);
     if (!new_wrapper)
     {
         LOG_OUT(LOG_ERROR, "Failed to malloc %zu bytes for new wrapper (scalar).",
                 sizeof(struct ObjWrapper));
-        free(new_scalar);
+        uncharge_obj(OBJ_SCALAR, sizeof(struct ObjWrapper));
         return NULL;
     }
 
-    new_scalar->value = value;
-
-    new_wrapper->obj = new_scalar;
-    new_wrapper->type = OBJ_SCALAR;
-    new_wrapper->ref_count = 1;
+    // the value lives in the wrapper: one allocation, no pointer chase
+    new_wrapper->scalar.value = value;
+    init_wrapper(new_wrapper, OBJ_SCALAR, OBJ_STORAGE_EMBEDDED, &new_wrapper->scalar,
+                 sizeof(struct ObjWrapper));
 
-    int add_obj_ret = add_obj(new_wrapper);
+    int add_obj_ret = add_obj(resolve_store(store), new_wrapper);
     if (add_obj_ret)
     { // failed add_obj()
         LOG_OUT(LOG_ERROR, "add_obj() failed: wrapper=%p obj=%p type=SCALAR ret=%d.", new_wrapper,
                 new_wrapper->obj, add_obj_ret);
-        free(new_scalar);
-        free(new_wrapper);
+        discard_obj(new_wrapper);
         return NULL;
     }
 
@@ -242,6 +485,7 @@ int destroy_obj(struct ObjWrapper* wrapper)
         return 4; // invalid type
     }
 
+    struct ObjStore* store = wrapper->store;
     int remove_ret = remove_obj(wrapper);
     if (remove_ret)
     {
@@ -250,26 +494,11 @@ int destroy_obj(struct ObjWrapper* wrapper)
         return remove_ret; // remove failed
     }
 
-    switch (wrapper->type)
-    {
-    case OBJ_MATRIX:
-        destroy_matrix((struct Matrix*)wrapper->obj);
-        break;
-    case OBJ_VECTOR:
-        destroy_vector((struct Vector*)wrapper->obj);
-        break;
-    case OBJ_SCALAR:
-        destroy_scalar((struct Scalar*)wrapper->obj);
-        break;
-    default:
-        LOG_OUT(LOG_ERROR, "invariant violated wrapper=%p obj=%p type=%d.", wrapper, wrapper->obj,
-                wrapper->type);
-        assert(false); // should be unreachable
-        return 3;
-    }
-
-    wrapper->obj = NULL;
-    destroy_wrapper(wrapper);
+    // unreachable from here on; only freeing its memory may be deferred
+    if (atomic_load_explicit(&store->reclaim.mode, memory_order_relaxed) != RECLAIM_INLINE &&
+        defer_release(&store->reclaim, wrapper))
+        return 0;
+    release_obj(wrapper);
     return 0;
 }
 
@@ -280,17 +509,39 @@ int incref_obj(struct ObjWrapper* wrapper)
 {
     if (!wrapper)
         return 1; // caller error
-    if (wrapper->ref_count == 0)
+
+    // owning thread: plain load/store, no bus lock
+    struct BiasRecord* self = self_record;
+    if (self && wrapper->owner == self)
     {
-        LOG_OUT(LOG_ERROR, "invariant violated: wrapper=%p obj=%p type=%d rc=%zu.", wrapper,
-                wrapper->obj, wrapper->type, wrapper->ref_count);
-        return 3; // internal error
+        size_t biased = atomic_load_explicit(&wrapper->biased, memory_order_relaxed);
+        if (biased != 0)
+        {
+            atomic_store_explicit(&wrapper->biased, biased + 1, memory_order_relaxed);
+            LOG_OUT(LOG_DEBUG, "succeeded wrapper=%p obj=%p type=%d biased:%zu->%zu.", wrapper,
+                    wrapper->obj, wrapper->type, biased, biased + 1);
+            return 0;
+        }
+        // merged: fall through to the shared count
     }
 
-    size_t old_rc = wrapper->ref_count;
-    wrapper->ref_count++;
-    LOG_OUT(LOG_DEBUG, "succeeded wrapper=%p obj=%p type=%d rc:%zu->%zu.", wrapper, wrapper->obj,
-            wrapper->type, old_rc, wrapper->ref_count);
+    // never resurrect an object another thread is destroying
+    intptr_t old_shared = atomic_load_explicit(&wrapper->shared, memory_order_relaxed);
+    do
+    {
+        if ((old_shared & SHARED_MERGED) && shared_count(old_shared) <= 0)
+        {
+            LOG_OUT(LOG_ERROR, "invariant violated: wrapper=%p obj=%p type=%d rc=%" PRIdPTR ".",
+                    wrapper, wrapper->obj, wrapper->type, shared_count(old_shared));
+            return 3; // internal error
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&wrapper->shared, &old_shared,
+                                                    old_shared + SHARED_ONE, memory_order_relaxed,
+                                                    memory_order_relaxed));
+
+    LOG_OUT(LOG_DEBUG, "succeeded wrapper=%p obj=%p type=%d shared:%" PRIdPTR "->%" PRIdPTR ".",
+            wrapper, wrapper->obj, wrapper->type, shared_count(old_shared),
+            shared_count(old_shared) + 1);
     return 0;
 }
 
@@ -302,26 +553,72 @@ int decref_obj(struct ObjWrapper* wrapper)
     if (!wrapper)
         return 1; // caller error
 
-    assert(wrapper->ref_count != 0);
-    if (wrapper->ref_count == 0)
+    struct BiasRecord* self = self_record;
+    if (self && atomic_load_explicit(&self->has_pending, memory_order_relaxed))
+        merge_pending(self); // other threads dropped references to our objects
+
+    if (self && wrapper->owner == self)
     {
-        LOG_OUT(LOG_ERROR, "invariant violated: wrapper=%p obj=%p type=%d rc=%zu.", wrapper,
-                wrapper->obj, wrapper->type, wrapper->ref_count);
-        return 3; // internal error
+        size_t biased = atomic_load_explicit(&wrapper->biased, memory_order_relaxed);
+        if (biased > 1)
+        {
+            atomic_store_explicit(&wrapper->biased, biased - 1, memory_order_relaxed);
+            LOG_OUT(LOG_DEBUG, "succeeded wrapper=%p obj=%p type=%d biased:%zu->%zu.", wrapper,
+                    wrapper->obj, wrapper->type, biased, biased - 1);
+            return 0;
+        }
+        if (biased == 1)
+        {
+            // last owner reference: give up the bias; shared becomes the whole count
+            atomic_store_explicit(&wrapper->biased, 0, memory_order_relaxed);
+            intptr_t old_shared = atomic_fetch_or_explicit(&wrapper->shared, SHARED_MERGED,
+                                                           memory_order_acq_rel);
+            if (shared_count(old_shared) == 0 && !(old_shared & SHARED_QUEUED))
+            {
+                LOG_OUT(LOG_DEBUG, "wrapper=%p obj=%p type=%d biased:1->0 (destroy).", wrapper,
+                        wrapper->obj, wrapper->type);
+                destroy_obj(wrapper);
+            }
+            return 0;
+        }
+        // merged: fall through to the shared count
     }
 
-    size_t old_rc = wrapper->ref_count;
-    wrapper->ref_count--;
-    if (wrapper->ref_count == 0) // destroy obj if ref_count -> 0
+    // once the decrement lands another thread may free the wrapper: log copies
+    void* obj = wrapper->obj;
+    enum ObjType type = wrapper->type;
+    intptr_t old_shared = atomic_load_explicit(&wrapper->shared, memory_order_relaxed);
+    intptr_t new_shared;
+    do
+    {
+        bool merged = (old_shared & SHARED_MERGED) != 0;
+        assert(!merged || shared_count(old_shared) > 0);
+        if (merged && shared_count(old_shared) <= 0)
+        {
+            LOG_OUT(LOG_ERROR, "invariant violated: wrapper=%p obj=%p type=%d rc=%" PRIdPTR ".",
+                    wrapper, wrapper->obj, wrapper->type, shared_count(old_shared));
+            return 3; // internal error
+        }
+        new_shared = old_shared - SHARED_ONE;
+        // below zero the owner still holds the rest; it merges the two counts later
+        if (!merged && shared_count(new_shared) < 0)
+            new_shared |= SHARED_QUEUED;
+        // acq_rel: the thread that drops the last reference sees every prior write
+    } while (!atomic_compare_exchange_weak_explicit(&wrapper->shared, &old_shared, new_shared,
+                                                    memory_order_acq_rel, memory_order_relaxed));
+
+    if ((new_shared & SHARED_MERGED) && shared_count(new_shared) == 0 &&
+        !(new_shared & SHARED_QUEUED)) // destroy obj if ref_count -> 0
     {
-        LOG_OUT(LOG_DEBUG, "wrapper=%p obj=%p type=%d rc:%zu->%zu (destroy).", wrapper,
-                wrapper->obj, wrapper->type, old_rc, wrapper->ref_count);
+        LOG_OUT(LOG_DEBUG, "wrapper=%p obj=%p type=%d rc:1->0 (destroy).", wrapper, obj, type);
         destroy_obj(wrapper);
         return 0;
     }
+    if ((new_shared & SHARED_QUEUED) && !(old_shared & SHARED_QUEUED))
+        queue_merge(wrapper);
 
-    LOG_OUT(LOG_DEBUG, "succeeded wrapper=%p obj=%p type=%d rc:%zu->%zu.", wrapper, wrapper->obj,
-            wrapper->type, old_rc, wrapper->ref_count);
+    LOG_OUT(LOG_DEBUG, "succeeded wrapper=%p obj=%p type=%d shared:%" PRIdPTR "->%" PRIdPTR ".",
+            wrapper, obj, type, shared_count(old_shared), shared_count(new_shared));
     return 0;
 }
 
@@ -337,26 +634,202 @@ enum ObjType get_obj_type(const struct ObjWrapper* wrapper)
 
 //  Pre conditions: None.
 //  Post conditions: None.
-//  Asserts invariant: obj->ref_count == 1 for all objects before teardown.
-//  Asserts invariant: obj_list.count == 0 after teardown.
-//  Asserts invariant: obj_list.head == NULL after teardown.
+const struct List* get_obj_elements(const struct ObjWrapper* wrapper)
+{
+    if (!wrapper)
+        return NULL; // wrapper is NULL
+
+    switch (wrapper->type)
+    {
+    case OBJ_MATRIX:
+        return &((const struct Matrix*)wrapper->obj)->elements;
+    case OBJ_VECTOR:
+        return &((const struct Vector*)wrapper->obj)->elements;
+    default:
+        return NULL; // scalars have no element list
+    }
+}
+
+//  Pre conditions: None.
+//  Post conditions: None.
 int destroy_obj_list()
 {
-    LOG_OUT(LOG_DEBUG, "beginning obj_list teardown count=%zu", obj_list.count);
-    while (obj_list.head)
+    stop_reclaimer(&default_store.reclaim); // back to RECLAIM_INLINE
+    drain_store(&default_store);
+
+    // hand fully free pages back; pages still used by other stores stay
+    obj_slab_trim(&wrapper_slab);
+    obj_slab_trim(&matrix_slab);
+    obj_slab_trim(&vector_slab);
+    obj_slab_trim(&small_slab);
+    return 0;
+}
+
+//  Pre conditions: None.
+//  Post conditions: None.
+struct ObjStore* obj_store_init(bool locked, const struct LinalgAllocator* allocator)
+{
+    struct ObjStore* store =
+        mem_calloc(allocator, 1, sizeof(struct ObjStore), ALLOC_SITE_OBJ_STORE);
+    if (!store)
     {
-        assert(obj_list.head->object->ref_count == 1);
+        LOG_OUT(LOG_ERROR, "Failed to calloc %zu bytes for object store.", sizeof(struct ObjStore));
+        return NULL;
+    }
+    store->allocator = mem_resolve(allocator);
+    store->locked = locked;
+    if (locked && pthread_mutex_init(&store->lock, NULL) != 0)
+    {
+        mem_free(&store->allocator, store, ALLOC_SITE_OBJ_STORE);
+        return NULL;
+    }
+    struct ObjReclaim* reclaim = &store->reclaim;
+    pthread_mutex_init(&reclaim->lock, NULL);
+    pthread_cond_init(&reclaim->work, NULL);
+    pthread_cond_init(&reclaim->space, NULL);
+    atomic_init(&reclaim->mode, RECLAIM_INLINE);
+    reclaim->max_pending = RECLAIM_DEFAULT_PENDING;
+    LOG_OUT(LOG_DEBUG, "succeeded: store=%p locked=%d.", store, locked);
+    return store;
+}
 
-        int decref_ret = decref_obj(obj_list.head->object);
-        assert(decref_ret == 0);
+//  Pre conditions: None.
+//  Post conditions: `store` freed.
+int obj_store_destroy(struct ObjStore* store)
+{
+    if (!store)
+        return 0; // no store is noop
+    stop_reclaimer(&store->reclaim);
+    drain_store(store);
+    if (store->locked)
+        pthread_mutex_destroy(&store->lock);
+    pthread_cond_destroy(&store->reclaim.space);
+    pthread_cond_destroy(&store->reclaim.work);
+    pthread_mutex_destroy(&store->reclaim.lock);
+    struct LinalgAllocator allocator = store->allocator;
+    mem_free(&allocator, store, ALLOC_SITE_OBJ_STORE);
+    return 0;
+}
+
+//  Pre conditions: None.
+//  Post conditions: None.
+int obj_store_set_reclaim(struct ObjStore* store, enum ReclaimMode mode, size_t max_pending)
+{
+    if (mode != RECLAIM_INLINE && mode != RECLAIM_DEFERRED && mode != RECLAIM_BACKGROUND)
+        return 1; // invalid mode
+
+    struct ObjReclaim* reclaim = &resolve_store(store)->reclaim;
+    stop_reclaimer(reclaim); // queue empty and mode RECLAIM_INLINE from here
+
+    pthread_mutex_lock(&reclaim->lock);
+    reclaim->max_pending = max_pending ? max_pending : RECLAIM_DEFAULT_PENDING;
+    if (mode == RECLAIM_BACKGROUND)
+    {
+        reclaim->stop = false;
+        if (pthread_create(&reclaim->thread, NULL, reclaimer_main, reclaim) != 0)
+        {
+            pthread_mutex_unlock(&reclaim->lock);
+            LOG_OUT(LOG_ERROR, "failed to start reclaimer thread for store=%p.", store);
+            return 2; // thread creation failure; mode stays RECLAIM_INLINE
+        }
+        reclaim->has_thread = true;
     }
+    atomic_store_explicit(&reclaim->mode, mode, memory_order_relaxed);
+    pthread_mutex_unlock(&reclaim->lock);
+
+    LOG_OUT(LOG_DEBUG, "succeeded: store=%p mode=%d max_pending=%zu.", store, mode,
+            reclaim->max_pending);
+    return 0;
+}
 
-    assert(obj_list.count == 0 && obj_list.head == NULL);
-    LOG_OUT(LOG_DEBUG, "ended obj_list teardown count=%zu", obj_list.count);
+//  Pre conditions: None.
+//  Post conditions: None.
+size_t obj_store_collect(struct ObjStore* store)
+{
+    size_t freed = release_list(take_pending(&resolve_store(store)->reclaim));
+    LOG_OUT(LOG_DEBUG, "store=%p freed %zu objects.", store, freed);
+    return freed;
+}
 
+//  Pre conditions: None.
+//  Post conditions: None.
+size_t obj_store_pending(struct ObjStore* store)
+{
+    struct ObjReclaim* reclaim = &resolve_store(store)->reclaim;
+    pthread_mutex_lock(&reclaim->lock);
+    size_t pending = reclaim->pending;
+    pthread_mutex_unlock(&reclaim->lock);
+    return pending;
+}
+
+//  Pre conditions: None.
+//  Post conditions: None.
+size_t obj_store_count(struct ObjStore* store)
+{
+    store = resolve_store(store);
+    store_lock(store);
+    size_t count = store->list.count;
+    store_unlock(store);
+    return count;
+}
+
+//  Pre conditions: None.
+//  Post conditions: None.
+void obj_set_memory_budget(size_t max_bytes)
+{
+    atomic_store_explicit(&obj_memory.budget, max_bytes, memory_order_relaxed);
+    LOG_OUT(LOG_DEBUG, "memory budget set to %zu bytes (%zu live).", max_bytes,
+            atomic_load_explicit(&obj_memory.total, memory_order_relaxed));
+}
+
+//  Pre conditions:
+//   1. stats != NULL.
+//  Post conditions: None.
+int obj_memory_stats(struct MemoryStats* stats)
+{
+    if (!stats)
+        return 1; // invalid input
+
+    intptr_t objects[OBJ_TYPE_COUNT];
+    intptr_t bytes[OBJ_TYPE_COUNT];
+    for (int type = 0; type < OBJ_TYPE_COUNT; type++)
+    {
+        objects[type] = atomic_load_explicit(&obj_memory.objects[type], memory_order_relaxed);
+        bytes[type] = atomic_load_explicit(&obj_memory.bytes[type], memory_order_relaxed);
+    }
+    pthread_mutex_lock(&bias_lock);
+    for (struct BiasRecord* record = all_records; record; record = record->next_all)
+    {
+        for (int type = 0; type < OBJ_TYPE_COUNT; type++)
+        {
+            objects[type] +=
+                atomic_load_explicit(&record->live_objects[type], memory_order_relaxed);
+            bytes[type] += atomic_load_explicit(&record->live_bytes[type], memory_order_relaxed);
+        }
+    }
+    pthread_mutex_unlock(&bias_lock);
+
+    struct MemoryUsage* usage[OBJ_TYPE_COUNT] = {&stats->scalars, &stats->vectors,
+                                                 &stats->matrices};
+    for (int type = 0; type < OBJ_TYPE_COUNT; type++)
+    {
+        usage[type]->objects = (size_t)objects[type];
+        usage[type]->bytes = (size_t)bytes[type];
+    }
+    stats->total_bytes = atomic_load_explicit(&obj_memory.total, memory_order_relaxed);
+    stats->budget = atomic_load_explicit(&obj_memory.budget, memory_order_relaxed);
+    stats->budget_rejections =
+        atomic_load_explicit(&obj_memory.rejections, memory_order_relaxed);
     return 0;
 }
 
+//  Pre conditions: None.
+//  Post conditions: None.
+bool obj_budget_rejected(void)
+{
+    return budget_rejected;
+}
+
 /* ============================================================================
  * Public debug functions
  * ============================================================================
@@ -371,7 +844,9 @@ size_t debug_get_obj_refcount(const struct ObjWrapper* wrapper)
 #else
     if (!wrapper)
         return -1; // invalid input
-    return wrapper->ref_count;
+    // exact on the owning thread or while no other thread uses the object
+    return atomic_load_explicit(&wrapper->biased, memory_order_relaxed) +
+           (size_t)shared_count(atomic_load_explicit(&wrapper->shared, memory_order_relaxed));
 #endif
 }
 #pragma endregion
@@ -384,42 +859,31 @@ size_t debug_get_obj_refcount(const struct ObjWrapper* wrapper)
 
 //  Purpose: Destroy matrix struct and allocated members.
 //  Input Assumptions: None.
-//  Effects: `matrix` and `matrix->elements.list` freed.
+//  Effects: `matrix` freed; `matrix->elements.list` released by its
+//    allocation kind.
 //  Returns: 0 in all cases.
 //  Notes: None.
 static int destroy_matrix(struct Matrix* matrix)
 {
     if (!matrix)
         return 0;
-    free(matrix->elements.list);
-    free(matrix);
+    obj_buffer_free(matrix->elements);
+    obj_slab_free(&matrix_slab, matrix);
     return 0;
 }
 
 //  Purpose: Destroy vector struct and allocated members.
 //  Input Assumptions: None.
-//  Effects: `vector` and `vector->elements.list` freed.
+//  Effects: `vector` freed; `vector->elements.list` released by its
+//    allocation kind.
 //  Returns: 0 in all cases.
 //  Notes: None.
 static int destroy_vector(struct Vector* vector)
 {
     if (!vector)
         return 0;
-    free(vector->elements.list);
-    free(vector);
-    return 0;
-}
-
-//  Purpose: Destroy scalar struct.
-//  Input Assumptions: None.
-//  Effects: `scalar` freed.
-//  Returns: 0 in all cases.
-//  Notes: None.
-static int destroy_scalar(struct Scalar* scalar)
-{
-    if (!scalar)
-        return 0;
-    free(scalar);
+    obj_buffer_free(vector->elements);
+    obj_slab_free(&vector_slab, vector);
     return 0;
 }
 
@@ -432,111 +896,973 @@ static int destroy_wrapper(struct ObjWrapper* wrapper)
 {
     if (!wrapper)
         return 0;
-    free(wrapper);
+    obj_slab_free(&wrapper_slab, wrapper);
     return 0;
 }
 
-//  Purpose: Add new object to the object linked list.
-//  Input Assumptions: None.
-//  Effects: `object` added to object list and list parameters updated.
+//  Purpose: Add new object to a store's object linked list.
+//  Input Assumptions: store != NULL. Takes the store lock.
+//  Effects: `object` linked at the head of the store's list, object->store set.
 //  Returns:
 //    0: Success.
 //    1: Invalid input.
-//    2: Allocation error.
+//    2: Not used in this function.
 //    3: Internal invariance violation.
-//  Notes: Enforces invariant: one `obj_list` reference per object.
-static int add_obj(struct ObjWrapper* object)
+//  Notes: Enforces invariant: one store list reference per object (O(1):
+//    a linked object always has its store set).
+static int add_obj(struct ObjStore* store, struct ObjWrapper* object)
 {
     // return immediately for invalid input
     if (!object)
         return 1; // caller error
 
-    // check if object is already in the object list
-    struct ObjLLNode* prev_node = NULL;
-    struct ObjLLNode* found_node = find_node(object, &prev_node);
-    if (found_node)
-        return 3; // invariant violation
-
-    // create new object list node
-    struct ObjLLNode* new_node = malloc(sizeof(struct ObjLLNode));
-    if (!new_node)
-        return 2; // allocation error
-
-    // populate new object list node
-    new_node->next = obj_list.head;
-    new_node->object = object;
-
-    // update the object list
-    obj_list.head = new_node;
-    obj_list.count++;
-
+    if (object->store)
+        return 3; // invariant violation: already in a store
+
+    store_lock(store);
+    object->store = store;
+    object->prev = NULL;
+    object->next = store->list.head;
+    if (store->list.head)
+        store->list.head->prev = object;
+    store->list.head = object;
+    store->list.count++;
+    store_unlock(store);
     return 0;
 }
 
-//  Purpose: Remove node bound to `object` from `obj_list`.
-//  Input Assumptions: None.
-//  Effects: Free the node and update `obj_list.count`
+//  Purpose: Unlink `object` from its store's list.
+//  Input Assumptions: object->store set by add_obj(). Takes the store lock.
+//  Effects: Neighbours relinked, store count updated, object->store cleared.
 //  Returns:
 //    0: Success.
-//    1: Invalid input.
+//    1: Invalid input or object not in a store.
 //    2: Not used in this function.
 //    3: Internal invariant violation.
 //  Notes:
-//    - Enforces invariant: Removal not allowed from empty `obj_list`.
-//    - Enforces invariant: `obj_list.head` must exist.
+//    - Enforces invariant: Removal not allowed from an empty list.
+//    - Enforces invariant: the object's links agree with the list.
 static int remove_obj(struct ObjWrapper* object)
 {
-    if (!object)
+    if (!object || !object->store)
         return 1; // caller error
-    if (obj_list.count == 0 || obj_list.head == NULL)
+
+    struct ObjStore* store = object->store;
+    store_lock(store);
+    if (store->list.count == 0 || !is_linked(store, object))
+    {
+        store_unlock(store);
         return 3; // internal error
+    }
+
+    if (object->prev)
+        object->prev->next = object->next;
+    else
+        store->list.head = object->next;
+    if (object->next)
+        object->next->prev = object->prev;
+    store->list.count--;
+    store_unlock(store);
+
+    object->store = NULL;
+    object->prev = NULL;
+    object->next = NULL;
+    return 0;
+}
 
-    struct ObjLLNode* prev_node = NULL;
-    struct ObjLLNode* search_node = find_node(object, &prev_node);
+//  Purpose: Check that `object`'s links agree with `store`'s list.
+//  Input Assumptions: Caller holds the store lock.
+//  Effects: None.
+//  Returns: true if the neighbours (or the list head) point back at object.
+static inline bool is_linked(const struct ObjStore* store, const struct ObjWrapper* object)
+{
+    if (object->prev ? object->prev->next != object : store->list.head != object)
+        return false;
+    return !object->next || object->next->prev == object;
+}
+
+//  Purpose: Validate matrix components and build a wrapper that is not yet
+//    in the root set.
+//  Input Assumptions: None.
+//  Effects: Payloads of up to SMALL_ELEMENT_BYTES are copied into a
+//    SmallObj; larger and wrapped ones get a Matrix from matrix_slab that
+//    takes `elements` (ownership only becomes final once the caller links
+//    it).
+//  Returns:
+//    ObjWrapper*: ref_count == 1, not in any store.
+//    NULL: Invalid components or allocation failure; nothing allocated.
+//  Notes: Undo with discard_obj(), which leaves elements.list to the
+//    caller. After linking a SMALL object the caller frees elements.list.
+static struct ObjWrapper* new_matrix_wrapper(struct List elements, size_t num_rows,
+                                             size_t num_cols)
+{
+    if (!valid_matrix_shape(elements, num_rows, num_cols) || !ownable_buffer(elements))
+        return NULL; // invalid components
 
-    // node found
-    if (search_node)
+    struct ObjWrapper* new_wrapper;
+    if (fits_small(elements) && !wrapped_buffer(elements))
     {
-        // not first element
-        if (prev_node)
-            prev_node->next = search_node->next;
-        // is first element
-        else
-            obj_list.head = search_node->next;
+        new_wrapper = new_small_obj(OBJ_MATRIX, elements);
+        if (!new_wrapper)
+            return NULL; // allocation failure
+        matrix_of(new_wrapper)->num_rows = num_rows;
+        matrix_of(new_wrapper)->num_cols = num_cols;
+        return new_wrapper;
+    }
 
-        // free node and update list count
-        free(search_node);
-        obj_list.count--;
+    size_t charged = split_bytes(OBJ_MATRIX, elements);
+    if (!charge_obj(OBJ_MATRIX, charged))
+        return NULL; // over the memory budget
 
-        return 0;
+    // Allocate matrix object and wrapper
+    struct Matrix* new_matrix = obj_slab_alloc(&matrix_slab);
+    if (!new_matrix)
+    {
+        LOG_OUT(LOG_ERROR, "Failed to malloc %zu bytes for new matrix (%zuX%zu).",
+                sizeof(struct Matrix), num_rows, num_cols);
+        uncharge_obj(OBJ_MATRIX, charged);
+        return NULL;
+    }
+
+    new_wrapper = obj_slab_alloc(&wrapper_slab);
+    if (!new_wrapper)
+    {
+        LOG_OUT(LOG_ERROR, "Failed to malloc %zu bytes for new wrapper (matrix %zuX%zu).",
+                sizeof(struct ObjWrapper), num_rows, num_cols);
+        obj_slab_free(&matrix_slab, new_matrix);
+        uncharge_obj(OBJ_MATRIX, charged);
+        return NULL;
+    }
+
+    // Populate matrix and wrapper
+    new_matrix->elements = elements;
+    new_matrix->num_rows = num_rows;
+    new_matrix->num_cols = num_cols;
+    init_wrapper(new_wrapper, OBJ_MATRIX, OBJ_STORAGE_SPLIT, new_matrix, charged);
+    return new_wrapper;
+}
+
+//  Purpose: Validate vector components and build a wrapper that is not yet
+//    in the root set.
+//  Input Assumptions: None.
+//  Effects: As new_matrix_wrapper(), with a Vector from vector_slab for
+//    wrapped payloads and those that do not fit a SmallObj.
+//  Returns:
+//    ObjWrapper*: ref_count == 1, not in any store.
+//    NULL: Invalid components or allocation failure; nothing allocated.
+//  Notes: Undo with discard_obj().
+static struct ObjWrapper* new_vector_wrapper(struct List elements)
+{
+    if (!valid_vector_shape(elements) || !ownable_buffer(elements))
+        return NULL; // invalid components
+
+    if (fits_small(elements) && !wrapped_buffer(elements))
+        return new_small_obj(OBJ_VECTOR, elements);
+
+    size_t charged = split_bytes(OBJ_VECTOR, elements);
+    if (!charge_obj(OBJ_VECTOR, charged))
+        return NULL; // over the memory budget
+
+    struct Vector* new_vector = obj_slab_alloc(&vector_slab);
+    if (!new_vector)
+    {
+        LOG_OUT(LOG_ERROR, "Failed to malloc %zu bytes for new vector dim=%zu.",
+                sizeof(struct Vector), elements.size);
+        uncharge_obj(OBJ_VECTOR, charged);
+        return NULL;
+    }
+
+    struct ObjWrapper* new_wrapper = obj_slab_alloc(&wrapper_slab);
+    if (!new_wrapper)
+    {
+        LOG_OUT(LOG_ERROR, "Failed to malloc %zu bytes for new wrapper (vector dim=%zu).",
+                sizeof(struct ObjWrapper), elements.size);
+        obj_slab_free(&vector_slab, new_vector);
+        uncharge_obj(OBJ_VECTOR, charged);
+        return NULL;
+    }
+
+    new_vector->elements = elements; // Pass ownership of elements.list to new_vector
+    init_wrapper(new_wrapper, OBJ_VECTOR, OBJ_STORAGE_SPLIT, new_vector, charged);
+    return new_wrapper;
+}
+
+//  Purpose: Initialize the bookkeeping fields of a fresh wrapper.
+//  Input Assumptions: wrapper points at uninitialized wrapper storage.
+//  Effects: ref_count 1, not in any store.
+//  Returns: None.
+static void init_wrapper(struct ObjWrapper* wrapper, enum ObjType type, enum ObjStorage storage,
+                         void* obj, size_t charged)
+{
+    wrapper->obj = obj;
+    wrapper->type = type;
+    wrapper->storage = storage;
+    wrapper->charged = charged;
+    wrapper->owner = own_record();
+    wrapper->merge_next = NULL;
+    if (wrapper->owner)
+    {
+        atomic_init(&wrapper->biased, 1);
+        atomic_init(&wrapper->shared, 0);
+    }
+    else
+    { // no record (allocation failure): count in shared from the start
+        atomic_init(&wrapper->biased, 0);
+        atomic_init(&wrapper->shared, SHARED_ONE | SHARED_MERGED);
+    }
+    wrapper->store = NULL;
+    wrapper->prev = NULL;
+    wrapper->next = NULL;
+}
+
+//  Purpose: Check matrix components for consistency.
+//  Input Assumptions: None.
+//  Effects: None.
+//  Returns: true if elements.list is set, the shape is non-empty, matches
+//    elements.size, elements.type_size > 0 and the byte size is plausible.
+static bool valid_matrix_shape(struct List elements, size_t num_rows, size_t num_cols)
+{
+    if (!elements.list)
+        return false; // No matrix element list
+
+    // Check for rows/cols/size consistency
+    if ((!num_cols) || (!num_rows))
+        return false; // rows and or cols == 0
+    if ((num_rows * num_cols) != elements.size)
+        return false; // size != rows*cols
+    if (elements.type_size == 0)
+        return false; // zero type size
+    return payload_fits(elements);
+}
+
+//  Purpose: Check vector components for consistency.
+//  Input Assumptions: None.
+//  Effects: None.
+//  Returns: true if elements.list is set, size, type_size > 0 and the
+//    byte size is plausible.
+static bool valid_vector_shape(struct List elements)
+{
+    return elements.list && elements.size > 0 && elements.type_size > 0 &&
+           payload_fits(elements);
+}
+
+//  Purpose: Reject element counts whose byte size could not be a real
+//    buffer, so size arithmetic on validated lists never overflows.
+//  Input Assumptions: elements.type_size > 0.
+//  Effects: None.
+//  Returns: true if size * type_size is at most SIZE_MAX / 2.
+static inline bool payload_fits(struct List elements)
+{
+    return elements.size <= SIZE_MAX / 2 / elements.type_size;
+}
+
+//  Purpose: Check that an object may take ownership of elements.list.
+//  Input Assumptions: None.
+//  Effects: None.
+//  Returns: true for the buffer kinds obj_buffer_free() handles (an
+//    ELEMENTS_EXTERNAL list needs its callback); false for another object's
+//    storage (ELEMENTS_OBJECT) or an unknown kind.
+static inline bool ownable_buffer(struct List elements)
+{
+    return elements.alloc == ELEMENTS_MALLOC || elements.alloc == ELEMENTS_ALIGNED ||
+           elements.alloc == ELEMENTS_HUGE || elements.alloc == ELEMENTS_BORROWED ||
+           (elements.alloc == ELEMENTS_EXTERNAL && elements.release);
+}
+
+//  Purpose: Tell wrapped caller memory apart from library-managed buffers.
+//  Input Assumptions: None.
+//  Effects: None.
+//  Returns: true for ELEMENTS_BORROWED and ELEMENTS_EXTERNAL lists, which
+//    are never copied into an object and not counted as object memory.
+static inline bool wrapped_buffer(struct List elements)
+{
+    return elements.alloc == ELEMENTS_BORROWED || elements.alloc == ELEMENTS_EXTERNAL;
+}
+
+//  Purpose: Count a new object's bytes as live, within the memory budget.
+//  Input Assumptions: type is a valid ObjType; called before the object's
+//    storage is allocated.
+//  Effects: On success the per-type counters and the total grow. On
+//    rejection budget_rejected is set and the rejection counted.
+//  Returns: true if the bytes were charged, false if they would push the
+//    total past a set budget.
+static bool charge_obj(enum ObjType type, size_t bytes)
+{
+    size_t budget = atomic_load_explicit(&obj_memory.budget, memory_order_relaxed);
+    if (budget == 0)
+        atomic_fetch_add_explicit(&obj_memory.total, bytes, memory_order_relaxed);
+    else
+    {
+        size_t total = atomic_load_explicit(&obj_memory.total, memory_order_relaxed);
+        do
+        {
+            if (bytes > budget || total > budget - bytes)
+            {
+                budget_rejected = true;
+                atomic_fetch_add_explicit(&obj_memory.rejections, 1, memory_order_relaxed);
+                LOG_OUT(LOG_WARNING,
+                        "memory budget %zu exceeded: %zu live + %zu requested (type=%d).", budget,
+                        total, bytes, type);
+                return false;
+            }
+        } while (!atomic_compare_exchange_weak_explicit(&obj_memory.total, &total, total + bytes,
+                                                        memory_order_relaxed,
+                                                        memory_order_relaxed));
     }
+    tally_obj(type, 1, (intptr_t)bytes);
+    return true;
+}
+
+//  Purpose: Undo charge_obj() for an object whose storage is gone.
+//  Input Assumptions: The same (type, bytes) were charged earlier.
+//  Effects: Per-type counters and the total shrink.
+//  Returns: None.
+static void uncharge_obj(enum ObjType type, size_t bytes)
+{
+    tally_obj(type, -1, -(intptr_t)bytes);
+    atomic_fetch_sub_explicit(&obj_memory.total, bytes, memory_order_relaxed);
+}
 
-    // node not found
-    return 1;
+//  Purpose: Add to the calling thread's per-type object and byte counts.
+//  Input Assumptions: type is a valid ObjType.
+//  Effects: The thread's BiasRecord tally changes (relaxed load + store, no
+//    RMW: only the holder writes it); without a record the shared fallback
+//    counters take the change.
+//  Returns: None.
+static void tally_obj(enum ObjType type, intptr_t objects, intptr_t bytes)
+{
+    struct BiasRecord* self = own_record();
+    if (!self)
+    {
+        atomic_fetch_add_explicit(&obj_memory.objects[type], objects, memory_order_relaxed);
+        atomic_fetch_add_explicit(&obj_memory.bytes[type], bytes, memory_order_relaxed);
+        return;
+    }
+    atomic_store_explicit(
+        &self->live_objects[type],
+        atomic_load_explicit(&self->live_objects[type], memory_order_relaxed) + objects,
+        memory_order_relaxed);
+    atomic_store_explicit(&self->live_bytes[type],
+                          atomic_load_explicit(&self->live_bytes[type], memory_order_relaxed) +
+                              bytes,
+                          memory_order_relaxed);
 }
 
-//  Purpose:  Find/return `obj_list` node bound to `wrapper` if it exsits.
-//  Input Assumptions:
-//    - Valid input assured by add/remove_obj().
-//    - Caller must provide Null `prev_node`
+//  Purpose: Bytes a SPLIT object holds: wrapper, header and elements.
+//  Input Assumptions: type is OBJ_MATRIX or OBJ_VECTOR; elements validated.
 //  Effects: None.
+//  Returns: Byte count; wrapped elements are the caller's memory and left
+//    out. Library buffers count their whole allocation (alignment, size
+//    class and huge page padding included).
+static inline size_t split_bytes(enum ObjType type, struct List elements)
+{
+    size_t header = sizeof(struct ObjWrapper) +
+                    (type == OBJ_MATRIX ? sizeof(struct Matrix) : sizeof(struct Vector));
+    if (wrapped_buffer(elements))
+        return header;
+    // bounded by payload_fits()
+    return header + obj_buffer_length(elements.size * elements.type_size, elements.alloc);
+}
+
+//  Purpose: Decide whether `elements` can be copied into a SmallObj.
+//  Input Assumptions: elements validated.
+//  Effects: None.
+//  Returns: true if the payload is at most SMALL_ELEMENT_BYTES.
+static inline bool fits_small(struct List elements)
+{
+    return elements.size <= SMALL_ELEMENT_BYTES / elements.type_size;
+}
+
+//  Purpose: Allocate a SmallObj holding a wrapper, its header and a copy of
+//    `elements`.
+//  Input Assumptions: type is OBJ_MATRIX or OBJ_VECTOR; fits_small(elements).
+//  Effects: As new_inline_obj(), from small_slab.
 //  Returns:
-//    ObjLLNode*: On success.
-//    NULL: Not found.
+//    ObjWrapper*: On success.
+//    NULL: Allocation failure.
+static struct ObjWrapper* new_small_obj(enum ObjType type, struct List elements)
+{
+    if (!charge_obj(type, sizeof(struct SmallObj)))
+        return NULL; // over the memory budget
+
+    struct SmallObj* small = obj_slab_alloc(&small_slab);
+    if (!small)
+    {
+        LOG_OUT(LOG_ERROR, "Failed to allocate %zu bytes for small object type=%d.",
+                sizeof(struct SmallObj), type);
+        uncharge_obj(type, sizeof(struct SmallObj));
+        return NULL;
+    }
+
+    init_wrapper(&small->wrapper, type, OBJ_STORAGE_SMALL, &small->header,
+                 sizeof(struct SmallObj));
+    pack_elements(&small->wrapper, &small->header, small->elements, elements);
+    return &small->wrapper;
+}
+
+//  Purpose: Allocate one block for a wrapper, its header and a copy of
+//    `elements`.
+//  Input Assumptions: type is OBJ_MATRIX or OBJ_VECTOR; elements validated.
+//  Effects: Elements copied into the block; header.*.elements points at the
+//    copy; wrapper initialized (ref_count 1, not in any store). The caller
+//    fills matrix shape fields.
+//  Returns:
+//    ObjWrapper*: On success.
+//    NULL: Payload size overflow or allocation failure.
+static struct ObjWrapper* new_inline_obj(enum ObjType type, struct List elements)
+{
+    if (elements.size > (SIZE_MAX - sizeof(struct InlineObj) - INLINE_ALIGN) / elements.type_size)
+        return NULL; // payload would overflow size_t
+
+    size_t payload = elements.size * elements.type_size;
+    size_t bytes = (sizeof(struct InlineObj) + payload + INLINE_ALIGN - 1) / INLINE_ALIGN *
+                   INLINE_ALIGN; // aligned_alloc() wants a multiple of the alignment
+    if (!charge_obj(type, bytes))
+        return NULL; // over the memory budget
+
+    struct InlineObj* block = mem_aligned_alloc(NULL, INLINE_ALIGN, bytes, ALLOC_SITE_OBJ_INLINE);
+    if (!block)
+    {
+        LOG_OUT(LOG_ERROR, "Failed to allocate %zu bytes for inline object type=%d.", bytes,
+                type);
+        uncharge_obj(type, bytes);
+        return NULL;
+    }
+
+    init_wrapper(&block->wrapper, type, OBJ_STORAGE_BLOCK, &block->header, bytes);
+    pack_elements(&block->wrapper, &block->header, block->elements, elements);
+    return &block->wrapper;
+}
+
+//  Purpose: Copy `elements` into a packed object's payload and point its
+//    header at the copy.
+//  Input Assumptions: payload holds elements.size * elements.type_size bytes.
+//  Effects: Header element list set; matrix shape left to the caller.
+//  Returns: None.
+static void pack_elements(struct ObjWrapper* wrapper, union PackedHeader* header,
+                          unsigned char* payload, struct List elements)
+{
+    memcpy(payload, elements.list, elements.size * elements.type_size);
+    struct List packed = {.list = payload,
+                          .size = elements.size,
+                          .type_size = elements.type_size,
+                          .alloc = ELEMENTS_OBJECT};
+    if (wrapper->type == OBJ_MATRIX)
+        header->matrix.elements = packed;
+    else
+        header->vector.elements = packed;
+}
+
+//  Purpose: Matrix header of a wrapper under construction.
+//  Input Assumptions: wrapper->type == OBJ_MATRIX.
+//  Effects: None.
+//  Returns: Header pointer.
+static inline struct Matrix* matrix_of(struct ObjWrapper* wrapper)
+{
+    return (struct Matrix*)wrapper->obj;
+}
+
+//  Purpose: Release an object that was never linked into a store.
+//  Input Assumptions: wrapper built by a new_*() helper above; not linked.
+//  Effects: Wrapper and header storage freed and uncharged. A SPLIT
+//    object's elements.list is left alone: it still belongs to the caller.
+//  Returns: None.
+static void discard_obj(struct ObjWrapper* wrapper)
+{
+    uncharge_obj(wrapper->type, wrapper->charged);
+    switch (wrapper->storage)
+    {
+    case OBJ_STORAGE_SPLIT:
+        obj_slab_free(wrapper->type == OBJ_MATRIX ? &matrix_slab : &vector_slab, wrapper->obj);
+        obj_slab_free(&wrapper_slab, wrapper);
+        break;
+    case OBJ_STORAGE_EMBEDDED:
+        obj_slab_free(&wrapper_slab, wrapper);
+        break;
+    case OBJ_STORAGE_SMALL:
+        obj_slab_free(&small_slab, wrapper);
+        break;
+    case OBJ_STORAGE_BLOCK:
+        mem_free(NULL, wrapper, ALLOC_SITE_OBJ_INLINE);
+        break;
+    }
+}
+
+//  Purpose: Put a new packed object in `store` and settle ownership of the
+//    caller's element buffer.
+//  Input Assumptions: wrapper from new_small_obj() or new_inline_obj();
+//    store != NULL.
+//  Effects: On success the object is in the store and, for INLINE_TAKE,
+//    elements.list is freed. On failure the object is freed and
+//    elements.list stays with the caller.
+//  Returns:
+//    ObjWrapper*: On success.
+//    NULL: add_obj() failed.
+static struct ObjWrapper* link_inline_obj(struct ObjStore* store, struct ObjWrapper* wrapper,
+                                          struct List elements, enum InlineMode mode)
+{
+    int add_obj_ret = add_obj(store, wrapper);
+    if (add_obj_ret)
+    {
+        LOG_OUT(LOG_ERROR, "add_obj() failed: wrapper=%p type=%d inline ret=%d.", wrapper,
+                wrapper->type, add_obj_ret);
+        discard_obj(wrapper);
+        return NULL;
+    }
+
+    if (mode == INLINE_TAKE)
+        obj_buffer_free(elements); // contents already copied into the object
+    return wrapper;
+}
+
+//  Purpose: Map the store-less API onto the process-wide store.
+//  Input Assumptions: None.
+//  Effects: None.
+//  Returns: `store`, or the process-wide store when NULL.
+static inline struct ObjStore* resolve_store(struct ObjStore* store)
+{
+    return store ? store : &default_store;
+}
+
+//  Purpose: Take the store lock, if the store has one.
+//  Input Assumptions: store != NULL.
+//  Effects: Lock held when store->locked.
+//  Returns: None.
+static inline void store_lock(struct ObjStore* store)
+{
+    if (store->locked)
+        pthread_mutex_lock(&store->lock);
+}
+
+//  Purpose: Release the store lock taken by store_lock().
+//  Input Assumptions: store != NULL.
+//  Effects: Lock released when store->locked.
+//  Returns: None.
+static inline void store_unlock(struct ObjStore* store)
+{
+    if (store->locked)
+        pthread_mutex_unlock(&store->lock);
+}
+
+//  Purpose: Release every object left in `store`.
+//  Input Assumptions: No other thread uses the store's objects.
+//  Effects: Each object's final reference dropped; store list empty.
+//  Returns: None.
 //  Notes:
-//    `prev_node` populated if `wrapper` found and `wrapper` is not the first
-//    list element.
-static struct ObjLLNode* find_node(struct ObjWrapper* wrapper, struct ObjLLNode** prev_node)
+//    - Asserts invariant: ref_count == 1 for all objects before teardown
+//      (after settle_refs() folds in the owner's biased count).
+//    - Asserts invariant: the list is empty after teardown.
+static void drain_store(struct ObjStore* store)
 {
-    struct ObjLLNode* search_node = obj_list.head;
-    while (search_node)
+    LOG_OUT(LOG_DEBUG, "beginning store=%p teardown count=%zu", store, store->list.count);
+    while (store->list.head)
     {
-        if (search_node->object == wrapper)
-            return search_node;
+        settle_refs(store->list.head);
+        assert(atomic_load(&store->list.head->shared) == (SHARED_ONE | SHARED_MERGED));
+
+        int decref_ret = decref_obj(store->list.head);
+        assert(decref_ret == 0);
+    }
+
+    assert(store->list.count == 0 && store->list.head == NULL);
+    LOG_OUT(LOG_DEBUG, "ended store=%p teardown count=%zu", store, store->list.count);
+}
+
+//  Purpose: Free an unlinked object's memory according to its layout.
+//  Input Assumptions: wrapper no longer in any store; no references left.
+//  Effects: Wrapper, header and (for SPLIT objects) elements.list freed;
+//    its bytes uncharged from the memory budget.
+//  Returns: None.
+static void release_obj(struct ObjWrapper* wrapper)
+{
+    uncharge_obj(wrapper->type, wrapper->charged);
+    switch (wrapper->storage)
+    {
+    case OBJ_STORAGE_SPLIT:
+        if (wrapper->type == OBJ_MATRIX)
+            destroy_matrix((struct Matrix*)wrapper->obj);
         else
-            *prev_node = search_node;
-        search_node = search_node->next;
+            destroy_vector((struct Vector*)wrapper->obj);
+        wrapper->obj = NULL;
+        destroy_wrapper(wrapper);
+        break;
+    case OBJ_STORAGE_EMBEDDED:
+        destroy_wrapper(wrapper); // value lives in the wrapper
+        break;
+    case OBJ_STORAGE_SMALL:
+        obj_slab_free(&small_slab, wrapper); // header and elements live in the same item
+        break;
+    case OBJ_STORAGE_BLOCK:
+        mem_free(NULL, wrapper, ALLOC_SITE_OBJ_INLINE); // header and elements share the block
+        break;
+    default:
+        LOG_OUT(LOG_ERROR, "invariant violated wrapper=%p obj=%p type=%d storage=%d.", wrapper,
+                wrapper->obj, wrapper->type, wrapper->storage);
+        assert(false); // should be unreachable
+    }
+}
+
+//  Purpose: Queue an unlinked object for a later release_obj().
+//  Input Assumptions: As release_obj().
+//  Effects: wrapper pushed on the queue and the reclaimer woken. With
+//    max_pending objects already queued the caller first waits for the
+//    reclaimer (RECLAIM_BACKGROUND) or frees the queue itself
+//    (RECLAIM_DEFERRED).
+//  Returns: false if the mode went back to RECLAIM_INLINE meanwhile; the
+//    caller frees the object itself.
+static bool defer_release(struct ObjReclaim* reclaim, struct ObjWrapper* wrapper)
+{
+    pthread_mutex_lock(&reclaim->lock);
+    while (reclaim->pending >= reclaim->max_pending &&
+           atomic_load_explicit(&reclaim->mode, memory_order_relaxed) != RECLAIM_INLINE)
+    {
+        if (reclaim->has_thread)
+        {
+            pthread_cond_wait(&reclaim->space, &reclaim->lock);
+            continue;
+        }
+        struct ObjWrapper* head = reclaim->head;
+        reclaim->head = NULL;
+        reclaim->pending = 0;
+        pthread_mutex_unlock(&reclaim->lock);
+        release_list(head);
+        pthread_mutex_lock(&reclaim->lock);
+    }
+    if (atomic_load_explicit(&reclaim->mode, memory_order_relaxed) == RECLAIM_INLINE)
+    {
+        pthread_mutex_unlock(&reclaim->lock);
+        return false;
+    }
+
+    wrapper->next = reclaim->head;
+    reclaim->head = wrapper;
+    reclaim->pending++;
+    if (reclaim->has_thread)
+        pthread_cond_signal(&reclaim->work);
+    pthread_mutex_unlock(&reclaim->lock);
+    return true;
+}
+
+//  Purpose: Empty the reclaim queue.
+//  Input Assumptions: None.
+//  Effects: Takes reclaim->lock; producers waiting for space are woken.
+//  Returns: The queued objects (linked through next), or NULL.
+static struct ObjWrapper* take_pending(struct ObjReclaim* reclaim)
+{
+    pthread_mutex_lock(&reclaim->lock);
+    struct ObjWrapper* head = reclaim->head;
+    reclaim->head = NULL;
+    reclaim->pending = 0;
+    pthread_cond_broadcast(&reclaim->space);
+    pthread_mutex_unlock(&reclaim->lock);
+    return head;
+}
+
+//  Purpose: release_obj() every object of a list taken off a reclaim queue.
+//  Input Assumptions: head from take_pending() or NULL.
+//  Effects: Every object freed.
+//  Returns: Number of objects freed.
+static size_t release_list(struct ObjWrapper* head)
+{
+    size_t freed = 0;
+    while (head)
+    {
+        struct ObjWrapper* next = head->next;
+        release_obj(head);
+        head = next;
+        freed++;
     }
+    return freed;
+}
+
+//  Purpose: Reclaimer thread body for RECLAIM_BACKGROUND.
+//  Input Assumptions: arg is the store's ObjReclaim.
+//  Effects: Frees queued objects as they arrive until stop is set and the
+//    queue is empty.
+//  Returns: NULL.
+static void* reclaimer_main(void* arg)
+{
+    struct ObjReclaim* reclaim = arg;
+    pthread_mutex_lock(&reclaim->lock);
+    for (;;)
+    {
+        while (!reclaim->head && !reclaim->stop)
+            pthread_cond_wait(&reclaim->work, &reclaim->lock);
+        if (!reclaim->head)
+            break; // stop requested and nothing left
+
+        struct ObjWrapper* head = reclaim->head;
+        reclaim->head = NULL;
+        reclaim->pending = 0;
+        pthread_cond_broadcast(&reclaim->space);
+        pthread_mutex_unlock(&reclaim->lock);
+        release_list(head);
+        pthread_mutex_lock(&reclaim->lock);
+    }
+    pthread_mutex_unlock(&reclaim->lock);
     return NULL;
 }
-#pragma endregion
\ No newline at end of file
+
+//  Purpose: Return a store to RECLAIM_INLINE.
+//  Input Assumptions: None.
+//  Effects: Reclaimer thread (if any) joined after it drained the queue;
+//    anything still queued freed; producers waiting for space released.
+//  Returns: None.
+static void stop_reclaimer(struct ObjReclaim* reclaim)
+{
+    pthread_mutex_lock(&reclaim->lock);
+    atomic_store_explicit(&reclaim->mode, RECLAIM_INLINE, memory_order_relaxed);
+    bool has_thread = reclaim->has_thread;
+    reclaim->stop = true;
+    pthread_cond_broadcast(&reclaim->work);
+    pthread_cond_broadcast(&reclaim->space);
+    pthread_mutex_unlock(&reclaim->lock);
+
+    if (has_thread)
+        pthread_join(reclaim->thread, NULL);
+
+    pthread_mutex_lock(&reclaim->lock);
+    reclaim->has_thread = false;
+    reclaim->stop = false;
+    pthread_mutex_unlock(&reclaim->lock);
+    release_list(take_pending(reclaim));
+}
+
+//  Purpose: Reference count held in a `shared` word.
+//  Input Assumptions: None.
+//  Effects: None.
+//  Returns: Signed count with the flag bits stripped.
+static inline intptr_t shared_count(intptr_t shared)
+{
+    return (shared & ~(SHARED_ONE - 1)) / SHARED_ONE;
+}
+
+//  Purpose: Return the calling thread's ownership record, taking one on
+//    first use.
+//  Input Assumptions: None.
+//  Effects: May reuse a record of an exited thread (and so become the owner
+//    of its objects) or allocate a new one; registers the thread-exit
+//    release.
+//  Returns:
+//    BiasRecord*: On success.
+//    NULL: Allocation failure.
+static struct BiasRecord* own_record(void)
+{
+    if (self_record)
+        return self_record;
+
+    pthread_mutex_lock(&bias_lock);
+    struct BiasRecord* record = free_records;
+    if (record)
+        free_records = record->next_free;
+    pthread_mutex_unlock(&bias_lock);
+
+    if (!record)
+    {
+        record = mem_calloc(NULL, 1, sizeof(struct BiasRecord), ALLOC_SITE_OBJ_STORE);
+        if (!record)
+        {
+            LOG_OUT(LOG_ERROR, "Failed to calloc %zu bytes for bias record.",
+                    sizeof(struct BiasRecord));
+            return NULL;
+        }
+        pthread_mutex_init(&record->lock, NULL);
+        pthread_mutex_lock(&bias_lock);
+        record->next_all = all_records;
+        all_records = record;
+        pthread_mutex_unlock(&bias_lock);
+    }
+    atomic_store(&record->held, true);
+    record->next_free = NULL;
+
+    pthread_once(&bias_key_once, make_bias_key);
+    pthread_setspecific(bias_key, record);
+    self_record = record;
+    return record;
+}
+
+//  Purpose: pthread_once() callback creating the thread-exit key.
+//  Input Assumptions: None.
+//  Effects: bias_key created with release_thread_record() as destructor.
+//  Returns: None.
+static void make_bias_key(void)
+{
+    pthread_key_create(&bias_key, release_thread_record);
+}
+
+//  Purpose: Thread-exit destructor handing the thread's record back.
+//  Input Assumptions: Runs on the exiting thread; record == self_record.
+//  Effects: Pending merges done; the record goes to free_records with the
+//    objects it still owns.
+//  Returns: None.
+static void release_thread_record(void* record)
+{
+    merge_pending(record);
+    self_record = NULL;
+    release_record(record);
+}
+
+//  Purpose: Put a held record on free_records.
+//  Input Assumptions: Calling thread holds `record`.
+//  Effects: If merges were queued while the record was being released, they
+//    are done here (re-taking the record unless another thread got it).
+//  Returns: None.
+static void release_record(struct BiasRecord* record)
+{
+    for (;;)
+    {
+        pthread_mutex_lock(&bias_lock);
+        atomic_store(&record->held, false);
+        record->next_free = free_records;
+        free_records = record;
+        pthread_mutex_unlock(&bias_lock);
+
+        // seq_cst pairs with queue_merge(): one side sees the other's store
+        if (!atomic_load(&record->has_pending))
+            return;
+
+        pthread_mutex_lock(&bias_lock);
+        bool taken = atomic_load(&record->held);
+        if (!taken)
+        {
+            struct BiasRecord** link = &free_records;
+            while (*link != record)
+                link = &(*link)->next_free;
+            *link = record->next_free;
+            atomic_store(&record->held, true);
+        }
+        pthread_mutex_unlock(&bias_lock);
+        if (taken)
+            return; // the new holder merges
+        merge_pending(record);
+    }
+}
+
+//  Purpose: Merge the pending objects of a record no thread holds.
+//  Input Assumptions: None.
+//  Effects: Takes the record off free_records for the duration; does
+//    nothing if a thread holds it (that thread merges instead).
+//  Returns: None.
+static void adopt_and_merge(struct BiasRecord* record)
+{
+    pthread_mutex_lock(&bias_lock);
+    if (atomic_load(&record->held))
+    {
+        pthread_mutex_unlock(&bias_lock);
+        return;
+    }
+    struct BiasRecord** link = &free_records;
+    while (*link != record)
+        link = &(*link)->next_free;
+    *link = record->next_free;
+    atomic_store(&record->held, true);
+    pthread_mutex_unlock(&bias_lock);
+
+    merge_pending(record);
+    release_record(record);
+}
+
+//  Purpose: Hand an object whose shared count went negative to its owner.
+//  Input Assumptions: The caller just set SHARED_QUEUED on wrapper->shared;
+//    wrapper->owner != NULL.
+//  Effects: wrapper pushed on owner->pending. If no thread holds the record
+//    the merge is done right away.
+//  Returns: None.
+static void queue_merge(struct ObjWrapper* wrapper)
+{
+    struct BiasRecord* record = wrapper->owner;
+    pthread_mutex_lock(&record->lock);
+    wrapper->merge_next = record->pending;
+    record->pending = wrapper;
+    atomic_store(&record->has_pending, true);
+    pthread_mutex_unlock(&record->lock);
+
+    if (!atomic_load(&record->held))
+        adopt_and_merge(record); // owner thread has exited
+}
+
+//  Purpose: Fold the biased count of every pending object into its shared
+//    count and destroy those that reach zero.
+//  Input Assumptions: Calling thread holds `record`.
+//  Effects: record->pending emptied; merged objects are counted in `shared`
+//    only from now on.
+//  Returns: None.
+static void merge_pending(struct BiasRecord* record)
+{
+    struct ObjWrapper* dead = NULL;
+
+    pthread_mutex_lock(&record->lock);
+    struct ObjWrapper* wrapper = record->pending;
+    record->pending = NULL;
+    atomic_store_explicit(&record->has_pending, false, memory_order_relaxed);
+    while (wrapper)
+    {
+        struct ObjWrapper* next = wrapper->merge_next;
+        wrapper->merge_next = NULL;
+        if (shared_count(merge_one(wrapper)) == 0)
+        {
+            wrapper->merge_next = dead;
+            dead = wrapper;
+        }
+        wrapper = next;
+    }
+    pthread_mutex_unlock(&record->lock);
+
+    while (dead)
+    {
+        struct ObjWrapper* next = dead->merge_next;
+        LOG_OUT(LOG_DEBUG, "wrapper=%p obj=%p type=%d merged rc=0 (destroy).", dead, dead->obj,
+                dead->type);
+        destroy_obj(dead);
+        dead = next;
+    }
+}
+
+//  Purpose: Merge one object's biased count into its shared count.
+//  Input Assumptions: Caller holds wrapper->owner->lock and either holds
+//    the record or knows no other thread uses the object.
+//  Effects: biased set to 0; SHARED_MERGED set, SHARED_QUEUED cleared.
+//  Returns: The new shared word.
+static intptr_t merge_one(struct ObjWrapper* wrapper)
+{
+    size_t biased = atomic_load_explicit(&wrapper->biased, memory_order_relaxed);
+    atomic_store_explicit(&wrapper->biased, 0, memory_order_relaxed);
+
+    intptr_t old_shared = atomic_load_explicit(&wrapper->shared, memory_order_relaxed);
+    intptr_t new_shared;
+    do
+    {
+        new_shared = ((old_shared & ~SHARED_QUEUED) | SHARED_MERGED) +
+                     (intptr_t)biased * SHARED_ONE;
+    } while (!atomic_compare_exchange_weak_explicit(&wrapper->shared, &old_shared, new_shared,
+                                                    memory_order_acq_rel, memory_order_relaxed));
+    return new_shared;
+}
+
+//  Purpose: Make `shared` the whole count of an object about to be torn
+//    down, whichever thread owns it.
+//  Input Assumptions: No other thread uses the object (store teardown).
+//  Effects: The object is merged and off its owner's pending list.
+//  Returns: None.
+static void settle_refs(struct ObjWrapper* wrapper)
+{
+    struct BiasRecord* record = wrapper->owner;
+    intptr_t shared = atomic_load_explicit(&wrapper->shared, memory_order_relaxed);
+    if (!record || ((shared & SHARED_MERGED) && !(shared & SHARED_QUEUED)))
+        return; // already counted in shared alone
+
+    pthread_mutex_lock(&record->lock);
+    if (shared & SHARED_QUEUED)
+    {
+        struct ObjWrapper** link = &record->pending;
+        while (*link != wrapper)
+            link = &(*link)->merge_next;
+        *link = wrapper->merge_next;
+        wrapper->merge_next = NULL;
+        if (!record->pending)
+            atomic_store_explicit(&record->has_pending, false, memory_order_relaxed);
+    }
+    merge_one(wrapper);
+    pthread_mutex_unlock(&record->lock);
+}
+#pragma endregion
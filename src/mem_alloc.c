@@ -0,0 +1,179 @@
+#include "mem_alloc.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "logs.h"
+
+#pragma region Head Comment
+/*
+ * Translation unit implements:
+ * - The process-wide allocator (the malloc() family by default) and its
+ *   one-time replacement.
+ * - calloc and realloc on top of the three-function allocator interface.
+ *
+ * Internal conventions:
+ * - process_used is set the first time the process-wide allocator is
+ *   resolved or called; from then on mem_set_process_allocator() refuses.
+ *   It is checked with a relaxed load first so steady-state allocations do
+ *   not write the shared flag.
+ */
+#pragma endregion
+
+#pragma region Local Definitions
+/* ============================================================================
+ * File-local definitions
+ * ============================================================================
+ */
+static void* libc_alloc(void* ctx, size_t bytes, enum AllocSite site);
+static void* libc_aligned_alloc(void* ctx, size_t alignment, size_t bytes, enum AllocSite site);
+static void libc_free(void* ctx, void* block, enum AllocSite site);
+
+static struct LinalgAllocator process_allocator = {libc_alloc, libc_aligned_alloc, libc_free,
+                                                   NULL};
+static atomic_bool process_used;
+#pragma endregion
+
+#pragma region Private Function Prototypes
+/* ============================================================================
+ * Private function prototypes
+ * ============================================================================
+ */
+static inline const struct LinalgAllocator* use(const struct LinalgAllocator* allocator);
+#pragma endregion
+
+#pragma region Public API
+/* ============================================================================
+ * Public API implementation
+ * ============================================================================
+ */
+
+int mem_set_process_allocator(const struct LinalgAllocator* allocator)
+{
+    if (allocator && !mem_valid(allocator))
+        return 1; // invalid input
+    if (atomic_load(&process_used))
+    {
+        LOG_OUT(LOG_ERROR, "process allocator already in use; it can only be set before the "
+                           "library first allocates.");
+        return 4;
+    }
+
+    if (allocator)
+        process_allocator = *allocator;
+    else
+        process_allocator =
+            (struct LinalgAllocator){libc_alloc, libc_aligned_alloc, libc_free, NULL};
+    LOG_OUT(LOG_DEBUG, "process allocator set (custom=%d).", allocator != NULL);
+    return 0;
+}
+
+bool mem_valid(const struct LinalgAllocator* allocator)
+{
+    return !allocator || (allocator->alloc && allocator->aligned_alloc && allocator->free);
+}
+
+struct LinalgAllocator mem_resolve(const struct LinalgAllocator* allocator)
+{
+    return *use(allocator);
+}
+
+void* mem_alloc(const struct LinalgAllocator* allocator, size_t bytes, enum AllocSite site)
+{
+    allocator = use(allocator);
+    return allocator->alloc(allocator->ctx, bytes, site);
+}
+
+void* mem_calloc(const struct LinalgAllocator* allocator, size_t count, size_t size,
+                 enum AllocSite site)
+{
+    if (size != 0 && count > SIZE_MAX / size)
+        return NULL; // size overflow
+    allocator = use(allocator);
+    if (allocator->alloc == libc_alloc)
+        return calloc(count, size); // may hand out fresh zero pages without touching them
+    void* block = allocator->alloc(allocator->ctx, count * size, site);
+    if (block)
+        memset(block, 0, count * size);
+    return block;
+}
+
+void* mem_aligned_alloc(const struct LinalgAllocator* allocator, size_t alignment, size_t bytes,
+                        enum AllocSite site)
+{
+    allocator = use(allocator);
+    return allocator->aligned_alloc(allocator->ctx, alignment, bytes, site);
+}
+
+void* mem_realloc(const struct LinalgAllocator* allocator, void* block, size_t old_bytes,
+                  size_t new_bytes, enum AllocSite site)
+{
+    if (use(allocator)->alloc == libc_alloc)
+        return realloc(block, new_bytes); // may grow in place
+    void* grown = mem_alloc(allocator, new_bytes, site);
+    if (!grown)
+        return NULL; // allocation failure; block untouched
+    if (block)
+    {
+        memcpy(grown, block, old_bytes < new_bytes ? old_bytes : new_bytes);
+        mem_free(allocator, block, site);
+    }
+    return grown;
+}
+
+void mem_free(const struct LinalgAllocator* allocator, void* block, enum AllocSite site)
+{
+    if (!block)
+        return;
+    allocator = use(allocator);
+    allocator->free(allocator->ctx, block, site);
+}
+#pragma endregion
+
+#pragma region Private Functions
+/* ============================================================================
+ * Private helper implementation
+ * ============================================================================
+ */
+
+//  Purpose: Map NULL to the process-wide allocator.
+//  Input Assumptions: None.
+//  Effects: Marks the process-wide allocator used when it is selected.
+//  Returns: Allocator to call.
+static inline const struct LinalgAllocator* use(const struct LinalgAllocator* allocator)
+{
+    if (allocator)
+        return allocator;
+    if (!atomic_load_explicit(&process_used, memory_order_relaxed))
+        atomic_store_explicit(&process_used, true, memory_order_relaxed);
+    return &process_allocator;
+}
+
+//  Purpose: Default allocator functions: the malloc() family.
+//  Input Assumptions: As struct LinalgAllocator.
+//  Effects: As malloc()/aligned_alloc()/free().
+//  Returns: As malloc()/aligned_alloc().
+static void* libc_alloc(void* ctx, size_t bytes, enum AllocSite site)
+{
+    (void)ctx;
+    (void)site;
+    return malloc(bytes);
+}
+
+static void* libc_aligned_alloc(void* ctx, size_t alignment, size_t bytes, enum AllocSite site)
+{
+    (void)ctx;
+    (void)site;
+    return aligned_alloc(alignment, bytes);
+}
+
+static void libc_free(void* ctx, void* block, enum AllocSite site)
+{
+    (void)ctx;
+    (void)site;
+    free(block);
+}
+#pragma endregion
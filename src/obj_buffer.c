@@ -0,0 +1,501 @@
+#include "obj_buffer.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <time.h>
+
+#include "logs.h"
+#include "mem_alloc.h"
+
+#pragma region Head Comment
+/*
+ * Translation unit implements:
+ * - Aligned element buffers from the process-wide allocator.
+ * - Huge-page element buffers from anonymous mmap() with MADV_HUGEPAGE.
+ * - Wrapping of caller memory (borrowed or with a release callback).
+ * - The matching release path for every ElementAlloc kind.
+ * - A size-class recycling pool for released library buffers.
+ *
+ * Internal conventions:
+ * - A buffer's length is a pure function of (size * type_size, kind), see
+ *   buffer_length(), so the release path recomputes it from the List. From
+ *   OBJ_BUFFER_POOL_MIN_BYTES up, lengths are rounded to a size class (8 per
+ *   power of two), so any pooled buffer of a class fits every request of it.
+ * - A huge mapping is over-allocated by OBJ_BUFFER_HUGE_BYTES and trimmed
+ *   so that it starts and ends on a huge page boundary; what remains is
+ *   exactly buffer_length() long and is unmapped with that length.
+ * - A pooled buffer carries its own PoolEntry in its first bytes, so
+ *   pooling allocates nothing. Entries sit on their class list and on one
+ *   pool-wide list, both newest first; the pool-wide tail is the oldest
+ *   entry, which is what age trimming and cap eviction release. Buffers
+ *   are released outside the pool lock.
+ * - madvise() is advisory: if the kernel refuses it, or the platform has
+ *   no MADV_HUGEPAGE, the mapping is kept and backed by normal pages.
+ */
+#pragma endregion
+
+#pragma region Local Definitions
+/* ============================================================================
+ * File-local definitions
+ * ============================================================================
+ */
+#define POOL_MIN_SHIFT 16 // log2(OBJ_BUFFER_POOL_MIN_BYTES)
+#define POOL_MAX_SHIFT 47 // largest pooled class: below 256 TiB
+#define POOL_CLASS_STEPS 8 // classes per power of two: lengths round up by <= 12.5%
+#define POOL_CLASSES ((POOL_MAX_SHIFT - POOL_MIN_SHIFT + 1) * POOL_CLASS_STEPS)
+#define POOL_KINDS 2 // ELEMENTS_ALIGNED, ELEMENTS_HUGE
+
+_Static_assert(OBJ_BUFFER_POOL_MIN_BYTES == (size_t)1 << POOL_MIN_SHIFT, "pool shift mismatch");
+
+// Header kept in the first bytes of a buffer waiting in the pool.
+struct PoolEntry
+{
+    struct PoolEntry* newer; // class list links
+    struct PoolEntry* older;
+    struct PoolEntry* lru_newer; // pool-wide list links
+    struct PoolEntry* lru_older;
+    uint64_t freed_ns; // CLOCK_MONOTONIC time the buffer entered the pool
+    size_t length;     // allocation length, as buffer_length()
+    unsigned int cls;  // size class
+    unsigned int kind; // pool_kind()
+};
+
+struct BufferPool
+{
+    pthread_mutex_t lock;                // guards every field below except the limits
+    atomic_size_t max_bytes;             // cap on pooled bytes; 0 = pool off
+    atomic_uint_least32_t max_age_ms;    // idle time before release; 0 = no limit
+    struct PoolEntry* classes[POOL_KINDS][POOL_CLASSES]; // newest entry per class
+    struct PoolEntry* newest;            // pool-wide list
+    struct PoolEntry* oldest;
+    size_t bytes;
+    size_t buffers;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t released;
+};
+
+static struct BufferPool pool = {.lock = PTHREAD_MUTEX_INITIALIZER};
+#pragma endregion
+
+#pragma region Private Function Prototypes
+/* ============================================================================
+ * Private function prototypes
+ * ============================================================================
+ */
+static inline size_t round_up(size_t bytes, size_t align);
+static bool size_class(size_t bytes, size_t* rounded, unsigned int* cls);
+static size_t buffer_length(size_t bytes, enum ElementAlloc kind);
+static void* map_huge(size_t length);
+static void release_buffer(void* list, size_t length, enum ElementAlloc kind);
+static inline unsigned int pool_kind(enum ElementAlloc kind);
+static inline uint64_t now_ns(void);
+static void* pool_take(size_t bytes, enum ElementAlloc kind);
+static bool pool_put(void* list, size_t bytes, enum ElementAlloc kind);
+static void pool_unlink(struct PoolEntry* entry);
+static struct PoolEntry* pool_expire(uint64_t now, uint64_t max_age_ns, size_t max_bytes);
+static size_t release_entries(struct PoolEntry* chain);
+#pragma endregion
+
+#pragma region Public API
+/* ============================================================================
+ * Public API implementation
+ * ============================================================================
+ */
+
+int obj_buffer_alloc(struct List* elements, size_t size, size_t type_size,
+                     enum ElementAlloc kind)
+{
+    if (!elements)
+        return 1; // invalid input
+    *elements = (struct List){0};
+    if (size == 0 || type_size == 0 || (kind != ELEMENTS_ALIGNED && kind != ELEMENTS_HUGE))
+        return 1; // invalid input
+    if (size > (SIZE_MAX - 2 * OBJ_BUFFER_HUGE_BYTES) / type_size)
+        return 1; // byte count would overflow once padded
+
+    size_t bytes = size * type_size;
+    if (kind == ELEMENTS_HUGE && bytes < OBJ_BUFFER_HUGE_BYTES)
+        kind = ELEMENTS_ALIGNED; // too small to fill a huge page
+    size_t length = buffer_length(bytes, kind);
+
+    void* list = pool_take(bytes, kind);
+    for (int attempt = 0; !list && attempt < 2; attempt++)
+    {
+        list = (kind == ELEMENTS_HUGE)
+                   ? map_huge(length)
+                   : mem_aligned_alloc(NULL, OBJ_BUFFER_ALIGN, length, ALLOC_SITE_ELEMENTS);
+        if (!list && obj_buffer_pool_trim(0) == 0)
+            break; // nothing pooled to give back; retrying cannot help
+    }
+    if (!list)
+    {
+        LOG_OUT(LOG_ERROR, "failed to allocate %zu byte element buffer kind=%d.", bytes, kind);
+        return 2;
+    }
+
+    *elements = (struct List){.list = list, .size = size, .type_size = type_size, .alloc = kind};
+    LOG_OUT(LOG_DEBUG, "allocated list=%p bytes=%zu kind=%d.", list, bytes, kind);
+    return 0;
+}
+
+int obj_buffer_wrap(struct List* elements, void* list, size_t size, size_t type_size,
+                    element_release_fn release, void* release_ctx)
+{
+    if (!elements)
+        return 1; // invalid input
+    *elements = (struct List){0};
+    if (!list || size == 0 || type_size == 0 || size > SIZE_MAX / type_size)
+        return 1; // invalid input
+
+    enum ElementAlloc kind = release ? ELEMENTS_EXTERNAL : ELEMENTS_BORROWED;
+    *elements = (struct List){.list = list,
+                              .size = size,
+                              .type_size = type_size,
+                              .alloc = kind,
+                              .release = release,
+                              .release_ctx = release ? release_ctx : NULL};
+    LOG_OUT(LOG_DEBUG, "wrapped list=%p bytes=%zu kind=%d.", list, size * type_size, kind);
+    return 0;
+}
+
+void obj_buffer_free(struct List elements)
+{
+    if (!elements.list)
+        return;
+
+    switch (elements.alloc)
+    {
+    case ELEMENTS_MALLOC:
+        free(elements.list);
+        break;
+    case ELEMENTS_ALIGNED:
+    case ELEMENTS_HUGE:
+    {
+        size_t bytes = elements.size * elements.type_size;
+        if (!pool_put(elements.list, bytes, elements.alloc))
+            release_buffer(elements.list, buffer_length(bytes, elements.alloc), elements.alloc);
+        break;
+    }
+    case ELEMENTS_EXTERNAL:
+        elements.release(elements.release_ctx, elements.list, elements.size * elements.type_size);
+        break;
+    case ELEMENTS_OBJECT:
+        break; // released together with the object holding it
+    case ELEMENTS_BORROWED:
+        break; // the caller's to release
+    default:
+        LOG_OUT(LOG_ERROR, "invalid element buffer kind list=%p alloc=%d.", elements.list,
+                elements.alloc);
+        break;
+    }
+}
+
+size_t obj_buffer_length(size_t bytes, enum ElementAlloc kind)
+{
+    if (bytes == 0 || (kind != ELEMENTS_ALIGNED && kind != ELEMENTS_HUGE))
+        return bytes;
+    return buffer_length(bytes, kind);
+}
+
+void obj_buffer_pool_config(size_t max_bytes, uint32_t max_age_ms)
+{
+    atomic_store_explicit(&pool.max_bytes, max_bytes, memory_order_relaxed);
+    atomic_store_explicit(&pool.max_age_ms, max_age_ms, memory_order_relaxed);
+
+    pthread_mutex_lock(&pool.lock);
+    struct PoolEntry* chain = pool_expire(now_ns(), (uint64_t)max_age_ms * 1000000u, max_bytes);
+    pthread_mutex_unlock(&pool.lock);
+    release_entries(chain);
+    LOG_OUT(LOG_DEBUG, "buffer pool max_bytes=%zu max_age_ms=%u.", max_bytes,
+            (unsigned int)max_age_ms);
+}
+
+size_t obj_buffer_pool_trim(uint32_t max_age_ms)
+{
+    pthread_mutex_lock(&pool.lock);
+    struct PoolEntry* chain = pool_expire(now_ns(), (uint64_t)max_age_ms * 1000000u,
+                                          max_age_ms ? pool.bytes : 0);
+    pthread_mutex_unlock(&pool.lock);
+    return release_entries(chain);
+}
+
+void obj_buffer_pool_stats(struct BufferPoolStats* stats)
+{
+    pthread_mutex_lock(&pool.lock);
+    stats->buffers = pool.buffers;
+    stats->bytes = pool.bytes;
+    stats->hits = pool.hits;
+    stats->misses = pool.misses;
+    stats->released = pool.released;
+    pthread_mutex_unlock(&pool.lock);
+    stats->max_bytes = atomic_load_explicit(&pool.max_bytes, memory_order_relaxed);
+    stats->max_age_ms = atomic_load_explicit(&pool.max_age_ms, memory_order_relaxed);
+}
+#pragma endregion
+
+#pragma region Private Functions
+/* ============================================================================
+ * Private helper implementation
+ * ============================================================================
+ */
+
+//  Purpose: Round `bytes` up to a multiple of `align`.
+//  Input Assumptions: align is a power of two; no overflow.
+//  Effects: None.
+//  Returns: Rounded byte count.
+static inline size_t round_up(size_t bytes, size_t align)
+{
+    return (bytes + align - 1) & ~(align - 1);
+}
+
+//  Purpose: Find the pool size class of a request.
+//  Input Assumptions: None.
+//  Effects: None.
+//  Returns: true with *rounded (the class length) and *cls set when bytes
+//    lies in [OBJ_BUFFER_POOL_MIN_BYTES, 2^(POOL_MAX_SHIFT + 1)); false
+//    otherwise (not pooled).
+static bool size_class(size_t bytes, size_t* rounded, unsigned int* cls)
+{
+    if (bytes < OBJ_BUFFER_POOL_MIN_BYTES || bytes >> (POOL_MAX_SHIFT + 1) != 0)
+        return false;
+
+    // 8 classes between 2^shift and 2^(shift + 1); the top one rounds into
+    // the first class of the next power, which the index formula agrees with
+    unsigned int shift = 63u - (unsigned int)__builtin_clzll((unsigned long long)bytes);
+    unsigned int step_shift = shift - 3;
+    *rounded = round_up(bytes, (size_t)1 << step_shift);
+    *cls = (shift - POOL_MIN_SHIFT) * POOL_CLASS_STEPS +
+           (unsigned int)(*rounded >> step_shift) - POOL_CLASS_STEPS;
+    return *cls < POOL_CLASSES;
+}
+
+//  Purpose: Allocation length of a library buffer.
+//  Input Assumptions: bytes > 0; kind is ELEMENTS_ALIGNED or ELEMENTS_HUGE
+//    (HUGE only for bytes >= OBJ_BUFFER_HUGE_BYTES); padding cannot
+//    overflow.
+//  Effects: None.
+//  Returns: bytes rounded to its size class (when pooled) and then to
+//    whole OBJ_BUFFER_ALIGN units or huge pages.
+static size_t buffer_length(size_t bytes, enum ElementAlloc kind)
+{
+    size_t rounded;
+    unsigned int cls;
+    if (!size_class(bytes, &rounded, &cls))
+        rounded = bytes;
+    return round_up(rounded, kind == ELEMENTS_HUGE ? OBJ_BUFFER_HUGE_BYTES : OBJ_BUFFER_ALIGN);
+}
+
+//  Purpose: Map a huge-page aligned buffer of `length` bytes.
+//  Input Assumptions: length is a multiple of OBJ_BUFFER_HUGE_BYTES;
+//    padding cannot overflow.
+//  Effects: Maps `length` bytes of zeroed memory and asks for transparent
+//    huge pages on it.
+//  Returns:
+//    Buffer on success.
+//    NULL on mapping failure.
+static void* map_huge(size_t length)
+{
+    size_t padded = length + OBJ_BUFFER_HUGE_BYTES;
+    unsigned char* raw =
+        mmap(NULL, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED)
+        return NULL;
+
+    // trim the unaligned head and the surplus tail
+    unsigned char* start = (unsigned char*)round_up((uintptr_t)raw, OBJ_BUFFER_HUGE_BYTES);
+    size_t head = (size_t)(start - raw);
+    if (head > 0)
+        munmap(raw, head);
+    if (padded - head > length)
+        munmap(start + length, padded - head - length);
+
+#ifdef MADV_HUGEPAGE
+    if (madvise(start, length, MADV_HUGEPAGE) != 0)
+        LOG_OUT(LOG_DEBUG, "madvise(MADV_HUGEPAGE) refused for %zu bytes; using normal pages.",
+                length);
+#endif
+    return start;
+}
+
+//  Purpose: Give a library buffer back to the system.
+//  Input Assumptions: length == buffer_length() of the buffer's request.
+//  Effects: Allocator free or munmap() by kind.
+//  Returns: None.
+static void release_buffer(void* list, size_t length, enum ElementAlloc kind)
+{
+    if (kind == ELEMENTS_HUGE)
+        munmap(list, length);
+    else
+        mem_free(NULL, list, ALLOC_SITE_ELEMENTS);
+}
+
+//  Purpose: Pool index of a buffer kind.
+//  Input Assumptions: kind is ELEMENTS_ALIGNED or ELEMENTS_HUGE.
+//  Effects: None.
+//  Returns: 0 or 1.
+static inline unsigned int pool_kind(enum ElementAlloc kind)
+{
+    return kind == ELEMENTS_HUGE ? 1u : 0u;
+}
+
+//  Purpose: Read the monotonic clock.
+//  Input Assumptions: None.
+//  Effects: None.
+//  Returns: Nanoseconds since an arbitrary start.
+static inline uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+//  Purpose: Reuse a pooled buffer for a request.
+//  Input Assumptions: bytes and kind as passed to buffer_length().
+//  Effects: With the pool on: a hit unlinks the newest buffer of the
+//    request's class, a miss is counted; expired buffers are released.
+//  Returns:
+//    Buffer of buffer_length(bytes, kind) bytes on a hit.
+//    NULL when the pool is off, the request is not pooled or its class is
+//    empty.
+static void* pool_take(size_t bytes, enum ElementAlloc kind)
+{
+    size_t rounded;
+    unsigned int cls;
+    size_t max_bytes = atomic_load_explicit(&pool.max_bytes, memory_order_relaxed);
+    if (max_bytes == 0 || !size_class(bytes, &rounded, &cls))
+        return NULL;
+
+    uint64_t max_age_ns =
+        (uint64_t)atomic_load_explicit(&pool.max_age_ms, memory_order_relaxed) * 1000000u;
+    pthread_mutex_lock(&pool.lock);
+    struct PoolEntry* entry = pool.classes[pool_kind(kind)][cls];
+    if (entry)
+    {
+        pool_unlink(entry);
+        pool.hits++;
+    }
+    else
+        pool.misses++;
+    struct PoolEntry* chain = pool_expire(now_ns(), max_age_ns, max_bytes);
+    pthread_mutex_unlock(&pool.lock);
+
+    release_entries(chain);
+    return entry;
+}
+
+//  Purpose: Keep a released buffer for reuse.
+//  Input Assumptions: list came from obj_buffer_alloc() with this bytes and
+//    kind and is no longer in use.
+//  Effects: With the pool on and room for it, the buffer becomes the
+//    newest entry of its class; older buffers past the age limit or the
+//    cap are released.
+//  Returns: true if the pool took the buffer, false if the caller must
+//    release it.
+static bool pool_put(void* list, size_t bytes, enum ElementAlloc kind)
+{
+    size_t rounded;
+    unsigned int cls;
+    size_t max_bytes = atomic_load_explicit(&pool.max_bytes, memory_order_relaxed);
+    size_t length = buffer_length(bytes, kind);
+    if (max_bytes == 0 || length > max_bytes || !size_class(bytes, &rounded, &cls))
+        return false;
+
+    uint64_t max_age_ns =
+        (uint64_t)atomic_load_explicit(&pool.max_age_ms, memory_order_relaxed) * 1000000u;
+    uint64_t now = now_ns();
+    struct PoolEntry* entry = list;
+    *entry = (struct PoolEntry){
+        .freed_ns = now, .length = length, .cls = cls, .kind = pool_kind(kind)};
+
+    pthread_mutex_lock(&pool.lock);
+    struct PoolEntry** head = &pool.classes[entry->kind][cls];
+    entry->older = *head;
+    if (*head)
+        (*head)->newer = entry;
+    *head = entry;
+    entry->lru_older = pool.newest;
+    if (pool.newest)
+        pool.newest->lru_newer = entry;
+    else
+        pool.oldest = entry;
+    pool.newest = entry;
+    pool.bytes += length;
+    pool.buffers++;
+    struct PoolEntry* chain = pool_expire(now, max_age_ns, max_bytes);
+    pthread_mutex_unlock(&pool.lock);
+
+    release_entries(chain);
+    return true;
+}
+
+//  Purpose: Remove an entry from its class list and the pool-wide list.
+//  Input Assumptions: Caller holds pool.lock; entry is pooled.
+//  Effects: Links, pool.bytes and pool.buffers updated.
+//  Returns: None.
+static void pool_unlink(struct PoolEntry* entry)
+{
+    if (entry->newer)
+        entry->newer->older = entry->older;
+    else
+        pool.classes[entry->kind][entry->cls] = entry->older;
+    if (entry->older)
+        entry->older->newer = entry->newer;
+
+    if (entry->lru_newer)
+        entry->lru_newer->lru_older = entry->lru_older;
+    else
+        pool.newest = entry->lru_older;
+    if (entry->lru_older)
+        entry->lru_older->lru_newer = entry->lru_newer;
+    else
+        pool.oldest = entry->lru_newer;
+
+    pool.bytes -= entry->length;
+    pool.buffers--;
+}
+
+//  Purpose: Unlink the oldest entries until the pool is within its limits.
+//  Input Assumptions: Caller holds pool.lock.
+//  Effects: Entries idle longer than max_age_ns (0: no age limit), then the
+//    oldest ones while pool.bytes > max_bytes, leave the pool and are
+//    counted as released.
+//  Returns: Unlinked entries chained through lru_older, for
+//    release_entries() once the lock is dropped.
+static struct PoolEntry* pool_expire(uint64_t now, uint64_t max_age_ns, size_t max_bytes)
+{
+    struct PoolEntry* chain = NULL;
+    while (pool.oldest && (pool.bytes > max_bytes ||
+                           (max_age_ns && now - pool.oldest->freed_ns > max_age_ns)))
+    {
+        struct PoolEntry* entry = pool.oldest;
+        pool_unlink(entry);
+        pool.released++;
+        entry->lru_older = chain;
+        chain = entry;
+    }
+    return chain;
+}
+
+//  Purpose: Release buffers unlinked by pool_expire().
+//  Input Assumptions: pool.lock not held.
+//  Effects: Every buffer on the chain freed or unmapped.
+//  Returns: Bytes released.
+static size_t release_entries(struct PoolEntry* chain)
+{
+    size_t released = 0;
+    while (chain)
+    {
+        struct PoolEntry* next = chain->lru_older;
+        size_t length = chain->length;
+        released += length;
+        release_buffer(chain, length, chain->kind ? ELEMENTS_HUGE : ELEMENTS_ALIGNED);
+        chain = next;
+    }
+    return released;
+}
+#pragma endregion
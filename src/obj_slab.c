@@ -0,0 +1,321 @@
+#include "obj_slab.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "logs.h"
+#include "mem_alloc.h"
+
+#pragma region Head Comment
+/*
+ * Translation unit implements:
+ * - Page-based slab pools with per-page free lists.
+ * - Per-thread item caches in front of every pool.
+ *
+ * Page invariants:
+ * - A page is OBJ_SLAB_PAGE_BYTES aligned to OBJ_SLAB_PAGE_BYTES; its header
+ *   sits at the start and items follow at PAGE_HEADER_BYTES.
+ * - Items at index >= bump have never been handed out; every other item
+ *   that is not in use or in a thread cache is on the page's free_list.
+ * - free_count counts both; a page is on its pool's partial list exactly
+ *   when free_count > 0.
+ *
+ * Internal conventions:
+ * - Page lists and counters change only under the pool lock; thread caches
+ *   are touched only by their owning thread.
+ * - A thread registers a pthread key destructor on first use so its
+ *   cached items are flushed when it exits.
+ */
+#pragma endregion
+
+#pragma region Local Definitions
+/* ============================================================================
+ * File-local definitions
+ * ============================================================================
+ */
+#define PAGE_HEADER_BYTES 64 // keeps items of 64-byte multiples cache-line aligned
+#define CACHE_CAPACITY (2 * OBJ_SLAB_BATCH)
+
+struct ObjSlabPage
+{
+    struct ObjSlab* slab; // owning pool
+    struct ObjSlabPage* prev;
+    struct ObjSlabPage* next; // partial list links
+    void* free_list;          // singly linked through the first word of each item
+    size_t free_count;
+    size_t capacity;
+    size_t bump; // next untouched item
+};
+
+_Static_assert(sizeof(struct ObjSlabPage) <= PAGE_HEADER_BYTES, "page header too large");
+
+struct SlabCache
+{
+    struct ObjSlab* slab; // set on first refill
+    size_t count;
+    void* items[CACHE_CAPACITY];
+};
+
+static _Thread_local struct SlabCache thread_caches[OBJ_SLAB_MAX_POOLS];
+static _Thread_local bool thread_registered;
+
+static pthread_once_t exit_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t exit_key;
+#pragma endregion
+
+#pragma region Private Function Prototypes
+/* ============================================================================
+ * Private function prototypes
+ * ============================================================================
+ */
+static size_t refill(struct ObjSlab* slab, struct SlabCache* cache);
+static void flush(struct ObjSlab* slab, struct SlabCache* cache, size_t count);
+static struct ObjSlabPage* add_page(struct ObjSlab* slab);
+static inline struct ObjSlabPage* page_of(void* item);
+static inline void link_partial(struct ObjSlab* slab, struct ObjSlabPage* page);
+static inline void unlink_partial(struct ObjSlab* slab, struct ObjSlabPage* page);
+static void register_thread(void);
+static void make_exit_key(void);
+static void flush_thread_caches(void* unused);
+#pragma endregion
+
+#pragma region Public API
+/* ============================================================================
+ * Public API implementation
+ * ============================================================================
+ */
+
+void* obj_slab_alloc(struct ObjSlab* slab)
+{
+    struct SlabCache* cache = &thread_caches[slab->id];
+    if (cache->count == 0 && refill(slab, cache) == 0)
+        return NULL; // allocation failure
+    return cache->items[--cache->count];
+}
+
+void obj_slab_free(struct ObjSlab* slab, void* item)
+{
+    if (!item)
+        return;
+
+    assert(page_of(item)->slab == slab);
+    if (!thread_registered)
+        register_thread(); // releasing thread may never have allocated
+    struct SlabCache* cache = &thread_caches[slab->id];
+    if (cache->count == CACHE_CAPACITY)
+        flush(slab, cache, OBJ_SLAB_BATCH);
+    cache->slab = slab;
+    cache->items[cache->count++] = item;
+}
+
+size_t obj_slab_trim(struct ObjSlab* slab)
+{
+    struct SlabCache* cache = &thread_caches[slab->id];
+    flush(slab, cache, cache->count);
+
+    size_t released = 0;
+    pthread_mutex_lock(&slab->lock);
+    struct ObjSlabPage* page = slab->partial;
+    while (page)
+    {
+        struct ObjSlabPage* next = page->next;
+        if (page->free_count == page->capacity)
+        {
+            unlink_partial(slab, page);
+            mem_free(NULL, page, ALLOC_SITE_OBJ_SLAB);
+            slab->pages--;
+            released++;
+        }
+        page = next;
+    }
+    pthread_mutex_unlock(&slab->lock);
+
+    LOG_OUT(LOG_DEBUG, "slab=%p item_size=%zu released %zu pages, %zu left.", slab,
+            slab->item_size, released, slab->pages);
+    return released;
+}
+
+size_t obj_slab_pages(struct ObjSlab* slab)
+{
+    pthread_mutex_lock(&slab->lock);
+    size_t pages = slab->pages;
+    pthread_mutex_unlock(&slab->lock);
+    return pages;
+}
+#pragma endregion
+
+#pragma region Private Functions
+/* ============================================================================
+ * Private helper implementation
+ * ============================================================================
+ */
+
+//  Purpose: Move up to OBJ_SLAB_BATCH free items from the pool into an
+//    empty thread cache.
+//  Input assumptions: cache is the calling thread's cache for slab and is
+//    empty.
+//  Effects: Takes the pool lock; may allocate a page; registers the thread
+//    for exit-time flushing.
+//  Returns: Number of items moved (0 on allocation failure).
+static size_t refill(struct ObjSlab* slab, struct SlabCache* cache)
+{
+    if (!thread_registered)
+        register_thread();
+    cache->slab = slab;
+
+    pthread_mutex_lock(&slab->lock);
+    while (cache->count < OBJ_SLAB_BATCH)
+    {
+        struct ObjSlabPage* page = slab->partial ? slab->partial : add_page(slab);
+        if (!page)
+            break; // allocation failure; hand out what we have
+
+        while (page->free_count > 0 && cache->count < OBJ_SLAB_BATCH)
+        {
+            void* item;
+            if (page->free_list)
+            {
+                item = page->free_list;
+                page->free_list = *(void**)item;
+            }
+            else
+            {
+                item = (unsigned char*)page + PAGE_HEADER_BYTES + page->bump * slab->item_size;
+                page->bump++;
+            }
+            page->free_count--;
+            cache->items[cache->count++] = item;
+        }
+        if (page->free_count == 0)
+            unlink_partial(slab, page);
+    }
+    pthread_mutex_unlock(&slab->lock);
+    return cache->count;
+}
+
+//  Purpose: Return the newest `count` cached items to their pages.
+//  Input assumptions: cache is the calling thread's cache for slab;
+//    count <= cache->count.
+//  Effects: Takes the pool lock (unless count == 0); pages that were full
+//    rejoin the partial list.
+//  Returns: None.
+static void flush(struct ObjSlab* slab, struct SlabCache* cache, size_t count)
+{
+    if (count == 0)
+        return;
+
+    pthread_mutex_lock(&slab->lock);
+    while (count-- > 0)
+    {
+        void* item = cache->items[--cache->count];
+        struct ObjSlabPage* page = page_of(item);
+        *(void**)item = page->free_list;
+        page->free_list = item;
+        if (page->free_count++ == 0)
+            link_partial(slab, page);
+    }
+    pthread_mutex_unlock(&slab->lock);
+}
+
+//  Purpose: Allocate an empty page and put it on the partial list.
+//  Input assumptions: Caller holds the pool lock.
+//  Effects: slab->pages incremented on success.
+//  Returns:
+//    Page on success.
+//    NULL on allocation failure.
+static struct ObjSlabPage* add_page(struct ObjSlab* slab)
+{
+    struct ObjSlabPage* page =
+        mem_aligned_alloc(NULL, OBJ_SLAB_PAGE_BYTES, OBJ_SLAB_PAGE_BYTES, ALLOC_SITE_OBJ_SLAB);
+    if (!page)
+    {
+        LOG_OUT(LOG_ERROR, "failed to allocate %d byte slab page (item_size=%zu).",
+                OBJ_SLAB_PAGE_BYTES, slab->item_size);
+        return NULL;
+    }
+
+    page->slab = slab;
+    page->free_list = NULL;
+    page->capacity = (OBJ_SLAB_PAGE_BYTES - PAGE_HEADER_BYTES) / slab->item_size;
+    page->free_count = page->capacity;
+    page->bump = 0;
+    link_partial(slab, page);
+    slab->pages++;
+    return page;
+}
+
+//  Purpose: Find the page holding `item`.
+//  Input assumptions: item came from a slab page.
+//  Effects: None.
+//  Returns: Page header.
+static inline struct ObjSlabPage* page_of(void* item)
+{
+    return (struct ObjSlabPage*)((uintptr_t)item & ~(uintptr_t)(OBJ_SLAB_PAGE_BYTES - 1));
+}
+
+//  Purpose: Push `page` onto the pool's partial list.
+//  Input assumptions: Caller holds the pool lock; page not on the list.
+//  Effects: slab->partial updated.
+//  Returns: None.
+static inline void link_partial(struct ObjSlab* slab, struct ObjSlabPage* page)
+{
+    page->prev = NULL;
+    page->next = slab->partial;
+    if (slab->partial)
+        slab->partial->prev = page;
+    slab->partial = page;
+}
+
+//  Purpose: Remove `page` from the pool's partial list.
+//  Input assumptions: Caller holds the pool lock; page on the list.
+//  Effects: Neighbours relinked.
+//  Returns: None.
+static inline void unlink_partial(struct ObjSlab* slab, struct ObjSlabPage* page)
+{
+    if (page->prev)
+        page->prev->next = page->next;
+    else
+        slab->partial = page->next;
+    if (page->next)
+        page->next->prev = page->prev;
+    page->prev = NULL;
+    page->next = NULL;
+}
+
+//  Purpose: Arrange for the calling thread's caches to be flushed at exit.
+//  Input assumptions: None.
+//  Effects: Exit key created once per process; thread marked registered.
+//  Returns: None.
+static void register_thread(void)
+{
+    pthread_once(&exit_key_once, make_exit_key);
+    pthread_setspecific(exit_key, &thread_registered); // any non-NULL value
+    thread_registered = true;
+}
+
+//  Purpose: pthread_once() callback creating the exit key.
+//  Input assumptions: None.
+//  Effects: exit_key created with flush_thread_caches() as destructor.
+//  Returns: None.
+static void make_exit_key(void)
+{
+    pthread_key_create(&exit_key, flush_thread_caches);
+}
+
+//  Purpose: Thread-exit destructor returning every cached item.
+//  Input assumptions: Runs on the exiting thread.
+//  Effects: All of the thread's caches emptied into their pools.
+//  Returns: None.
+static void flush_thread_caches(void* unused)
+{
+    (void)unused;
+    thread_registered = false; // items freed by later destructors re-arm the key
+    for (size_t i = 0; i < OBJ_SLAB_MAX_POOLS; i++)
+    {
+        if (thread_caches[i].slab)
+            flush(thread_caches[i].slab, &thread_caches[i], thread_caches[i].count);
+    }
+}
+#pragma endregion
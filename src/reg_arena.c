@@ -0,0 +1,301 @@
+#include "reg_arena.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "logs.h"
+#include "mem_alloc.h"
+
+#pragma region Head Comment
+/*
+ * Translation unit implements:
+ * - Fixed-size slab pools with intrusive free lists.
+ * - The registry arena: one node pool plus one pool per name size class, and
+ *   a list of oversize names.
+ *
+ * Pool invariants:
+ * - slabs[0 .. slab_count) each hold items_per_slab items of item_size bytes.
+ * - Items in slabs[slab_count - 1] at index >= bump have never been handed
+ *   out; all other free items are on free_list.
+ * - item_size is a multiple of ITEM_ALIGN and >= sizeof(void*), so a free
+ *   item can hold the free-list link.
+ *
+ * Internal conventions:
+ * - Oversize names carry a BigName header placed directly before the string
+ *   and are linked so teardown can find them.
+ */
+#pragma endregion
+
+#pragma region Local Definitions
+/* ============================================================================
+ * File-local definitions
+ * ============================================================================
+ */
+#define SLAB_BYTES 16384
+#define ITEM_ALIGN 16
+#define NAME_CLASS_BYTES 16
+#define NAME_CLASSES (REG_ARENA_MAX_POOLED_NAME / NAME_CLASS_BYTES)
+
+struct RegPool
+{
+    size_t item_size;
+    size_t items_per_slab;
+    unsigned char** slabs;
+    size_t slab_count;
+    size_t slab_capacity;
+    size_t bump;     // next untouched item in the newest slab
+    void* free_list; // singly linked through the first word of each item
+    const struct LinalgAllocator* allocator; // the owning arena's
+};
+
+struct BigName
+{
+    struct BigName* prev;
+    struct BigName* next;
+    // name bytes follow, aligned by the header size
+};
+
+struct RegArena
+{
+    struct RegPool nodes;
+    struct RegPool names[NAME_CLASSES]; // class i serves (i + 1) * 16 bytes
+    struct BigName* big_names;
+    struct LinalgAllocator allocator; // every slab, index and oversize name
+};
+#pragma endregion
+
+#pragma region Private Function Prototypes
+/* ============================================================================
+ * Private function prototypes
+ * ============================================================================
+ */
+static void pool_init(struct RegPool* pool, size_t item_size,
+                      const struct LinalgAllocator* allocator);
+static void* pool_alloc(struct RegPool* pool);
+static void pool_free(struct RegPool* pool, void* item);
+static void pool_destroy(struct RegPool* pool);
+static int pool_add_slab(struct RegPool* pool);
+#pragma endregion
+
+#pragma region Public API
+/* ============================================================================
+ * Public API implementation
+ * ============================================================================
+ */
+
+struct RegArena* reg_arena_init(size_t node_size, const struct LinalgAllocator* allocator)
+{
+    if (node_size == 0)
+        return NULL; // caller error
+
+    struct RegArena* arena = mem_alloc(allocator, sizeof(struct RegArena), ALLOC_SITE_REG_NAMES);
+    if (!arena)
+    {
+        LOG_OUT(LOG_ERROR, "failed to allocate %zu bytes for registry arena.",
+                sizeof(struct RegArena));
+        return NULL;
+    }
+
+    arena->allocator = mem_resolve(allocator);
+    pool_init(&arena->nodes, node_size, &arena->allocator);
+    for (size_t i = 0; i < NAME_CLASSES; i++)
+        pool_init(&arena->names[i], (i + 1) * NAME_CLASS_BYTES, &arena->allocator);
+    arena->big_names = NULL;
+
+    return arena;
+}
+
+int reg_arena_destroy(struct RegArena* arena)
+{
+    if (!arena)
+        return 0;
+
+    pool_destroy(&arena->nodes);
+    for (size_t i = 0; i < NAME_CLASSES; i++)
+        pool_destroy(&arena->names[i]);
+
+    struct BigName* big = arena->big_names;
+    while (big)
+    {
+        struct BigName* next = big->next;
+        mem_free(&arena->allocator, big, ALLOC_SITE_REG_NAMES);
+        big = next;
+    }
+
+    struct LinalgAllocator allocator = arena->allocator;
+    mem_free(&allocator, arena, ALLOC_SITE_REG_NAMES);
+    return 0;
+}
+
+void* reg_arena_alloc_node(struct RegArena* arena)
+{
+    return pool_alloc(&arena->nodes);
+}
+
+void reg_arena_free_node(struct RegArena* arena, void* node)
+{
+    if (node)
+        pool_free(&arena->nodes, node);
+}
+
+char* reg_arena_copy_name(struct RegArena* arena, const char* name)
+{
+    size_t bytes = strlen(name) + 1;
+    char* copy = NULL;
+
+    if (bytes <= REG_ARENA_MAX_POOLED_NAME)
+        copy = pool_alloc(&arena->names[(bytes - 1) / NAME_CLASS_BYTES]);
+    else
+    {
+        struct BigName* big =
+            mem_alloc(&arena->allocator, sizeof(struct BigName) + bytes, ALLOC_SITE_REG_NAMES);
+        if (big)
+        {
+            big->prev = NULL;
+            big->next = arena->big_names;
+            if (arena->big_names)
+                arena->big_names->prev = big;
+            arena->big_names = big;
+            copy = (char*)(big + 1);
+        }
+    }
+
+    if (!copy)
+        return NULL; // allocation failure
+    memcpy(copy, name, bytes);
+    return copy;
+}
+
+void reg_arena_free_name(struct RegArena* arena, char* name)
+{
+    if (!name)
+        return;
+
+    size_t bytes = strlen(name) + 1;
+    if (bytes <= REG_ARENA_MAX_POOLED_NAME)
+    {
+        pool_free(&arena->names[(bytes - 1) / NAME_CLASS_BYTES], name);
+        return;
+    }
+
+    struct BigName* big = (struct BigName*)name - 1;
+    if (big->prev)
+        big->prev->next = big->next;
+    else
+        arena->big_names = big->next;
+    if (big->next)
+        big->next->prev = big->prev;
+    mem_free(&arena->allocator, big, ALLOC_SITE_REG_NAMES);
+}
+#pragma endregion
+
+#pragma region Private Functions
+/* ============================================================================
+ * Private helper implementation
+ * ============================================================================
+ */
+
+//  Purpose: Initialize an empty pool of item_size-byte items.
+//  Input assumptions: item_size > 0; allocator outlives the pool.
+//  Effects: item_size rounded up to ITEM_ALIGN; no memory allocated.
+//  Returns: None.
+static void pool_init(struct RegPool* pool, size_t item_size,
+                      const struct LinalgAllocator* allocator)
+{
+    if (item_size < sizeof(void*))
+        item_size = sizeof(void*);
+    item_size = (item_size + ITEM_ALIGN - 1) / ITEM_ALIGN * ITEM_ALIGN;
+
+    pool->item_size = item_size;
+    pool->items_per_slab = (item_size < SLAB_BYTES) ? SLAB_BYTES / item_size : 1;
+    pool->slabs = NULL;
+    pool->slab_count = 0;
+    pool->slab_capacity = 0;
+    pool->bump = 0;
+    pool->free_list = NULL;
+    pool->allocator = allocator;
+}
+
+//  Purpose: Hand out one item, preferring the free list over fresh slab space.
+//  Input assumptions: pool initialized.
+//  Effects: May allocate a new slab.
+//  Returns:
+//    Item pointer on success.
+//    NULL on allocation failure.
+static void* pool_alloc(struct RegPool* pool)
+{
+    if (pool->free_list)
+    {
+        void* item = pool->free_list;
+        pool->free_list = *(void**)item;
+        return item;
+    }
+
+    if (pool->slab_count == 0 || pool->bump == pool->items_per_slab)
+    {
+        if (pool_add_slab(pool))
+            return NULL;
+    }
+
+    void* item = pool->slabs[pool->slab_count - 1] + pool->bump * pool->item_size;
+    pool->bump++;
+    return item;
+}
+
+//  Purpose: Push `item` onto the pool's free list.
+//  Input assumptions: item came from pool_alloc(pool).
+//  Effects: First word of item overwritten with the free-list link.
+//  Returns: None.
+static void pool_free(struct RegPool* pool, void* item)
+{
+    *(void**)item = pool->free_list;
+    pool->free_list = item;
+}
+
+//  Purpose: Free every slab and the slab index.
+//  Input assumptions: pool initialized.
+//  Effects: Pool reset to empty.
+//  Returns: None.
+static void pool_destroy(struct RegPool* pool)
+{
+    for (size_t i = 0; i < pool->slab_count; i++)
+        mem_free(pool->allocator, pool->slabs[i], ALLOC_SITE_REG_NAMES);
+    mem_free(pool->allocator, pool->slabs, ALLOC_SITE_REG_NAMES);
+    pool_init(pool, pool->item_size, pool->allocator);
+}
+
+//  Purpose: Append a fresh slab, growing the slab index as needed.
+//  Input assumptions: pool initialized.
+//  Effects: slab_count incremented and bump reset on success.
+//  Returns:
+//    0: Success.
+//    2: Allocation failure; pool unchanged.
+static int pool_add_slab(struct RegPool* pool)
+{
+    if (pool->slab_count == pool->slab_capacity)
+    {
+        size_t new_capacity = pool->slab_capacity ? pool->slab_capacity * 2 : 8;
+        unsigned char** slabs =
+            mem_realloc(pool->allocator, pool->slabs, pool->slab_capacity * sizeof(unsigned char*),
+                        new_capacity * sizeof(unsigned char*), ALLOC_SITE_REG_NAMES);
+        if (!slabs)
+            return 2;
+        pool->slabs = slabs;
+        pool->slab_capacity = new_capacity;
+    }
+
+    unsigned char* slab = mem_alloc(pool->allocator, pool->items_per_slab * pool->item_size,
+                                    ALLOC_SITE_REG_NAMES);
+    if (!slab)
+    {
+        LOG_OUT(LOG_ERROR, "failed to allocate %zu byte slab.",
+                pool->items_per_slab * pool->item_size);
+        return 2;
+    }
+
+    pool->slabs[pool->slab_count++] = slab;
+    pool->bump = 0;
+    return 0;
+}
+#pragma endregion
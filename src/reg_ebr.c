@@ -0,0 +1,258 @@
+#include "reg_ebr.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "logs.h"
+#include "mem_alloc.h"
+
+#pragma region Head Comment
+/*
+ * Translation unit implements:
+ * - The process-wide epoch domain: global epoch, reader records and the
+ *   advance rule.
+ * - Writer-side retire lists.
+ *
+ * Domain invariants:
+ * - global_epoch starts at 1 and only increases.
+ * - A record's state is 0 while its thread is outside any section, or
+ *   (epoch << 1) | 1 where epoch is the global epoch it observed on entry.
+ * - The epoch moves from e to e + 1 only when no active record shows an
+ *   epoch other than e, so once it reaches e + 2 no reader that entered at
+ *   or before e is still inside.
+ * - Records are never freed; a thread's record is marked unused when the
+ *   thread exits and handed to the next thread that registers.
+ */
+#pragma endregion
+
+#pragma region Local Definitions
+/* ============================================================================
+ * File-local definitions
+ * ============================================================================
+ */
+#define RETIRE_MIN_CAPACITY 64
+
+struct EbrThread
+{
+    _Alignas(64) atomic_uint_fast64_t state; // 0 or (epoch << 1) | 1
+    atomic_bool in_use;
+    unsigned int nesting; // owner thread only
+    struct EbrThread* next;
+};
+
+static atomic_uint_fast64_t global_epoch = 1;
+static _Atomic(struct EbrThread*) threads_head = NULL;
+static pthread_once_t key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t thread_key;
+static _Thread_local struct EbrThread* self = NULL;
+#pragma endregion
+
+#pragma region Private Function Prototypes
+/* ============================================================================
+ * Private function prototypes
+ * ============================================================================
+ */
+static void make_key(void);
+static void release_thread(void* record);
+static struct EbrThread* register_thread(void);
+#pragma endregion
+
+#pragma region Public API
+/* ============================================================================
+ * Public API implementation
+ * ============================================================================
+ */
+
+bool reg_ebr_enter(void)
+{
+    struct EbrThread* record = self ? self : register_thread();
+    if (!record)
+        return false; // caller falls back to a locked read
+
+    if (record->nesting++ == 0)
+    {
+        uint64_t epoch = atomic_load_explicit(&global_epoch, memory_order_relaxed);
+        atomic_store_explicit(&record->state, (epoch << 1) | 1, memory_order_release);
+        // announcement must be visible before any shared pointer is read
+        atomic_thread_fence(memory_order_seq_cst);
+    }
+    return true;
+}
+
+void reg_ebr_exit(void)
+{
+    struct EbrThread* record = self;
+    if (!record || record->nesting == 0)
+        return;
+    if (--record->nesting == 0)
+        atomic_store_explicit(&record->state, 0, memory_order_release);
+}
+
+uint64_t reg_ebr_epoch(void)
+{
+    return atomic_load_explicit(&global_epoch, memory_order_acquire);
+}
+
+bool reg_ebr_try_advance(void)
+{
+    uint64_t epoch = atomic_load_explicit(&global_epoch, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+
+    for (struct EbrThread* record = atomic_load_explicit(&threads_head, memory_order_acquire);
+         record; record = record->next)
+    {
+        uint64_t state = atomic_load_explicit(&record->state, memory_order_acquire);
+        if ((state & 1) && (state >> 1) != epoch)
+            return false; // reader still inside an older epoch
+    }
+
+    return atomic_compare_exchange_strong_explicit(&global_epoch, &epoch, epoch + 1,
+                                                   memory_order_acq_rel, memory_order_relaxed);
+}
+
+bool reg_ebr_safe(uint64_t epoch)
+{
+    return atomic_load_explicit(&global_epoch, memory_order_acquire) >= epoch + 2;
+}
+
+void reg_ebr_retire(struct RegEbrList* list, void* ptr, reg_ebr_reclaim_fn reclaim, void* ctx)
+{
+    uint64_t epoch = atomic_load_explicit(&global_epoch, memory_order_acquire);
+
+    if (list->count == list->capacity)
+    {
+        size_t new_capacity = list->capacity ? list->capacity * 2 : RETIRE_MIN_CAPACITY;
+        struct RegEbrRetired* items = mem_realloc(
+            list->allocator, list->items, list->capacity * sizeof(struct RegEbrRetired),
+            new_capacity * sizeof(struct RegEbrRetired), ALLOC_SITE_REG_TABLE);
+        if (!items)
+        {
+            LOG_OUT(LOG_WARNING, "retire list full (%zu items); waiting for readers.",
+                    list->count);
+            while (!reg_ebr_safe(epoch))
+            {
+                if (!reg_ebr_try_advance())
+                    sched_yield();
+            }
+            reclaim(ctx, ptr);
+            return;
+        }
+        list->items = items;
+        list->capacity = new_capacity;
+    }
+
+    list->items[list->count++] = (struct RegEbrRetired){ptr, reclaim, epoch};
+}
+
+size_t reg_ebr_collect(struct RegEbrList* list, void* ctx)
+{
+    if (list->count == 0)
+        return 0;
+
+    reg_ebr_try_advance();
+
+    // items are appended in epoch order, so the safe ones form a prefix
+    size_t safe = 0;
+    while (safe < list->count && reg_ebr_safe(list->items[safe].epoch))
+    {
+        list->items[safe].reclaim(ctx, list->items[safe].ptr);
+        safe++;
+    }
+
+    for (size_t i = safe; i < list->count; i++)
+        list->items[i - safe] = list->items[i];
+    list->count -= safe;
+    return safe;
+}
+
+void reg_ebr_drain(struct RegEbrList* list, void* ctx)
+{
+    for (size_t i = 0; i < list->count; i++)
+        list->items[i].reclaim(ctx, list->items[i].ptr);
+
+    mem_free(list->allocator, list->items, ALLOC_SITE_REG_TABLE);
+    list->items = NULL;
+    list->count = 0;
+    list->capacity = 0;
+}
+#pragma endregion
+
+#pragma region Private Functions
+/* ============================================================================
+ * Private helper implementation
+ * ============================================================================
+ */
+
+//  Purpose: Create the TLS key whose destructor recycles thread records.
+//  Input assumptions: Called once via pthread_once().
+//  Effects: thread_key created.
+//  Returns: None.
+static void make_key(void)
+{
+    pthread_key_create(&thread_key, release_thread);
+}
+
+//  Purpose: Thread-exit hook; hand the record back for reuse.
+//  Input assumptions: record belongs to the exiting thread.
+//  Effects: Record marked quiescent and unused.
+//  Returns: None.
+static void release_thread(void* record)
+{
+    struct EbrThread* thread = record;
+    thread->nesting = 0;
+    atomic_store_explicit(&thread->state, 0, memory_order_release);
+    atomic_store_explicit(&thread->in_use, false, memory_order_release);
+}
+
+//  Purpose: Give the calling thread a record, reusing one left by an exited
+//    thread when possible.
+//  Input assumptions: self == NULL.
+//  Effects: May allocate and publish a new record; sets self.
+//  Returns:
+//    Record on success.
+//    NULL on allocation failure.
+static struct EbrThread* register_thread(void)
+{
+    pthread_once(&key_once, make_key);
+
+    struct EbrThread* record = atomic_load_explicit(&threads_head, memory_order_acquire);
+    for (; record; record = record->next)
+    {
+        bool expected = false;
+        if (atomic_compare_exchange_strong(&record->in_use, &expected, true))
+            break;
+    }
+
+    if (!record)
+    {
+        record = mem_aligned_alloc(NULL, _Alignof(struct EbrThread), sizeof(struct EbrThread),
+                                   ALLOC_SITE_REG_TABLE);
+        if (!record)
+        {
+            LOG_OUT(LOG_ERROR, "failed to allocate %zu bytes for reader record.",
+                    sizeof(struct EbrThread));
+            return NULL;
+        }
+        atomic_init(&record->state, 0);
+        atomic_init(&record->in_use, true);
+        record->nesting = 0;
+
+        struct EbrThread* head = atomic_load_explicit(&threads_head, memory_order_relaxed);
+        do
+        {
+            record->next = head;
+        } while (!atomic_compare_exchange_weak_explicit(&threads_head, &head, record,
+                                                        memory_order_release,
+                                                        memory_order_relaxed));
+    }
+
+    record->nesting = 0;
+    pthread_setspecific(thread_key, record);
+    self = record;
+    return record;
+}
+#pragma endregion
@@ -0,0 +1,162 @@
+#include "reg_filter.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "logs.h"
+#include "mem_alloc.h"
+
+#pragma region Head Comment
+/*
+ * Translation unit implements:
+ * - The split-block Bloom filter in front of registry lookups.
+ *
+ * Scheme:
+ * - Block = range(mix(h), blocks); key = low 32 bits. The mix matters: a
+ *   concurrent registry routes names to shards by their top hash bits, so
+ *   within one shard those bits are constant.
+ * - Word i of the block gets bit (key * SALT[i]) >> 27, so a hash sets
+ *   exactly eight bits, all within one 32-byte block. Queries load that one
+ *   block and compare against the same mask.
+ * - BITS_PER_HASH bits of filter per expected hash (16 hashes per block).
+ */
+#pragma endregion
+
+#pragma region Local Definitions
+/* ============================================================================
+ * File-local definitions
+ * ============================================================================
+ */
+#define WORDS_PER_BLOCK 8
+#define BITS_PER_HASH 16
+#define HASHES_PER_BLOCK ((WORDS_PER_BLOCK * 32) / BITS_PER_HASH)
+
+struct RegFilterBlock
+{
+    _Alignas(32) uint32_t words[WORDS_PER_BLOCK];
+};
+
+struct RegFilter
+{
+    size_t capacity; // hashes the filter was sized for
+    size_t blocks;
+    size_t bytes; // size of this allocation
+    struct LinalgAllocator allocator; // allocated this filter
+    struct RegFilterBlock block[];
+};
+
+// odd multipliers, one per word (same constants as Parquet's split-block filter)
+static const uint32_t SALT[WORDS_PER_BLOCK] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU,
+                                               0xa2b7289dU, 0x705495c7U, 0x2df1424bU,
+                                               0x9efc4947U, 0x5c6bfb31U};
+#pragma endregion
+
+#pragma region Private Function Prototypes
+/* ============================================================================
+ * Private function prototypes
+ * ============================================================================
+ */
+static inline size_t block_index(const struct RegFilter* filter, uint64_t h);
+static inline uint32_t word_bit(uint32_t key, int word);
+#pragma endregion
+
+#pragma region Public API
+/* ============================================================================
+ * Public API implementation
+ * ============================================================================
+ */
+
+struct RegFilter* reg_filter_init(size_t capacity, const struct LinalgAllocator* allocator)
+{
+    if (capacity == 0)
+        capacity = 1;
+    size_t blocks = (capacity + HASHES_PER_BLOCK - 1) / HASHES_PER_BLOCK;
+    size_t bytes = sizeof(struct RegFilter) + blocks * sizeof(struct RegFilterBlock);
+
+    struct RegFilter* filter =
+        mem_aligned_alloc(allocator, _Alignof(struct RegFilter), bytes, ALLOC_SITE_REG_FILTER);
+    if (!filter)
+    {
+        LOG_OUT(LOG_ERROR, "failed to allocate %zu bytes for filter of capacity %zu.", bytes,
+                capacity);
+        return NULL;
+    }
+
+    memset(filter, 0, bytes);
+    filter->capacity = capacity;
+    filter->blocks = blocks;
+    filter->bytes = bytes;
+    filter->allocator = mem_resolve(allocator);
+    return filter;
+}
+
+void reg_filter_destroy(struct RegFilter* filter)
+{
+    if (!filter)
+        return;
+    struct LinalgAllocator allocator = filter->allocator;
+    mem_free(&allocator, filter, ALLOC_SITE_REG_FILTER);
+}
+
+void reg_filter_add(struct RegFilter* filter, uint64_t h)
+{
+    uint32_t* words = filter->block[block_index(filter, h)].words;
+    uint32_t key = (uint32_t)h;
+
+    // writers are serialized, so load + store cannot lose a concurrent set
+    for (int i = 0; i < WORDS_PER_BLOCK; i++)
+    {
+        uint32_t word = __atomic_load_n(&words[i], __ATOMIC_RELAXED);
+        __atomic_store_n(&words[i], word | word_bit(key, i), __ATOMIC_RELAXED);
+    }
+}
+
+bool reg_filter_maybe(const struct RegFilter* filter, uint64_t h)
+{
+    const uint32_t* words = filter->block[block_index(filter, h)].words;
+    uint32_t key = (uint32_t)h;
+
+    uint32_t missing = 0;
+    for (int i = 0; i < WORDS_PER_BLOCK; i++)
+        missing |= word_bit(key, i) & ~__atomic_load_n(&words[i], __ATOMIC_RELAXED);
+    return missing == 0;
+}
+
+size_t reg_filter_capacity(const struct RegFilter* filter)
+{
+    return filter ? filter->capacity : 0;
+}
+
+size_t reg_filter_bytes(const struct RegFilter* filter)
+{
+    return filter ? filter->bytes : 0;
+}
+#pragma endregion
+
+#pragma region Private Functions
+/* ============================================================================
+ * Private helper implementation
+ * ============================================================================
+ */
+
+//  Purpose: Block selected by h, with all 64 bits folded into the choice.
+//  Input assumptions: filter->blocks > 0.
+//  Effects: None.
+//  Returns: Index in [0, blocks).
+static inline size_t block_index(const struct RegFilter* filter, uint64_t h)
+{
+    uint64_t x = (h ^ (h >> 29)) * 0xbf58476d1ce4e5b9ull;
+    return (size_t)(((unsigned __int128)(x ^ (x >> 32)) * filter->blocks) >> 64);
+}
+
+//  Purpose: Bit a key sets in word `word` of its block.
+//  Input assumptions: 0 <= word < WORDS_PER_BLOCK.
+//  Effects: None.
+//  Returns: Single-bit mask.
+static inline uint32_t word_bit(uint32_t key, int word)
+{
+    return (uint32_t)1 << ((key * SALT[word]) >> 27);
+}
+#pragma endregion
@@ -0,0 +1,541 @@
+#include "reg_flat.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "logs.h"
+#include "mem_alloc.h"
+#include "reg_arena.h"
+#include "reg_handles.h"
+
+#pragma region Head Comment
+/*
+ * Translation unit implements:
+ * - The flat (open-addressing) registry backend: a SwissTable-style layout of
+ *   one control byte per slot plus a contiguous slot array.
+ * - Group probing: GROUP_WIDTH control bytes are compared against the 7-bit
+ *   hash tag at once (SSE2, or a portable byte loop), so a probe touches a
+ *   slot only when its tag matches.
+ *
+ * Table invariants:
+ * - capacity is a power of two >= GROUP_WIDTH.
+ * - ctrl has capacity + GROUP_WIDTH bytes; ctrl[capacity + i] mirrors ctrl[i]
+ *   for i < GROUP_WIDTH so a group can be loaded at any slot index.
+ * - count + deleted < capacity * MAX_LOAD_NUM / MAX_LOAD_DEN, so every probe
+ *   sequence reaches an empty slot.
+ * - Full slots own their name string, carved from the registry arena.
+ * - A full slot with handle_slot != REG_HANDLE_NONE is the target of
+ *   directory slot handle_slot - 1; rebuild() retargets it when the slot moves
+ *   and erase releases it.
+ *
+ * Internal conventions:
+ * - h1 (hash >> 7) picks the starting slot, h2 (low 7 bits) is stored in the
+ *   control byte.
+ * - Erase leaves a tombstone (CTRL_DELETED); tombstones are purged whenever
+ *   the table is rebuilt.
+ */
+#pragma endregion
+
+#pragma region Local Definitions
+/* ============================================================================
+ * File-local definitions
+ * ============================================================================
+ */
+#define GROUP_WIDTH 16
+#define MIN_CAPACITY GROUP_WIDTH
+#define MAX_LOAD_NUM 7 // rebuild when (count + deleted) exceeds 7/8 of capacity
+#define MAX_LOAD_DEN 8
+#define SHRINK_DIV 8 // shrink when count drops below 1/8 of capacity
+
+#define CTRL_EMPTY ((int8_t)-128)
+#define CTRL_DELETED ((int8_t)-2)
+
+struct RegFlatSlot
+{
+    uint64_t hash;             // full hash, reused on rebuild and checked before strcmp
+    char* name;                // owning
+    struct ObjWrapper* object; // non-owning, lifetime via ref_count in reg_hash.c
+    uint32_t handle_slot;      // directory slot + 1, REG_HANDLE_NONE if never resolved
+};
+
+struct RegFlatTable
+{
+    int8_t* ctrl;              // capacity + GROUP_WIDTH control bytes
+    struct RegFlatSlot* slots; // capacity slots
+    size_t capacity;
+    size_t count;        // full slots
+    size_t deleted;      // tombstones
+    size_t min_capacity; // floor for shrinking
+    struct RegArena* arena;          // non-owning, source of name storage
+    struct RegHandleTable* handles;  // non-owning, kept in sync on rebuild
+    struct LinalgAllocator allocator; // the table and its arrays
+};
+#pragma endregion
+
+#pragma region Private Function Prototypes
+/* ============================================================================
+ * Private function prototypes
+ * ============================================================================
+ */
+static inline uint32_t group_match(const int8_t* group, int8_t tag);
+static inline uint32_t group_match_empty(const int8_t* group);
+static inline uint32_t group_match_free(const int8_t* group);
+static inline unsigned int lowest_bit(uint32_t mask);
+static inline void set_ctrl(struct RegFlatTable* table, size_t index, int8_t value);
+static size_t find_free_slot(const struct RegFlatTable* table, uint64_t h);
+static size_t find_index(const struct RegFlatTable* table, const char* name, uint64_t h,
+                         size_t* groups);
+static size_t capacity_for(size_t bindings);
+static int rebuild(struct RegFlatTable* table, size_t new_capacity);
+static int alloc_arrays(const struct LinalgAllocator* allocator, size_t capacity, int8_t** ctrl,
+                        struct RegFlatSlot** slots);
+#pragma endregion
+
+#pragma region Public API
+/* ============================================================================
+ * Public API implementation
+ * ============================================================================
+ */
+
+struct RegFlatTable* reg_flat_init(size_t min_bindings, struct RegArena* arena,
+                                   struct RegHandleTable* handles,
+                                   const struct LinalgAllocator* allocator)
+{
+    struct RegFlatTable* table =
+        mem_alloc(allocator, sizeof(struct RegFlatTable), ALLOC_SITE_REG_TABLE);
+    if (!table)
+    {
+        LOG_OUT(LOG_ERROR, "failed to allocate %zu bytes for flat table.",
+                sizeof(struct RegFlatTable));
+        return NULL;
+    }
+
+    size_t capacity = capacity_for(min_bindings);
+    if (alloc_arrays(allocator, capacity, &table->ctrl, &table->slots))
+    {
+        LOG_OUT(LOG_ERROR, "failed to allocate slot arrays for flat table capacity=%zu.",
+                capacity);
+        mem_free(allocator, table, ALLOC_SITE_REG_TABLE);
+        return NULL;
+    }
+
+    table->capacity = capacity;
+    table->count = 0;
+    table->deleted = 0;
+    table->min_capacity = capacity;
+    table->arena = arena;
+    table->handles = handles;
+    table->allocator = mem_resolve(allocator);
+
+    LOG_OUT(LOG_DEBUG, "success: flat table=%p capacity=%zu.", table, capacity);
+    return table;
+}
+
+int reg_flat_destroy(struct RegFlatTable* table)
+{
+    if (!table)
+        return 0;
+
+    // names belong to the arena and are released with it
+    struct LinalgAllocator allocator = table->allocator;
+    mem_free(&allocator, table->ctrl, ALLOC_SITE_REG_TABLE);
+    mem_free(&allocator, table->slots, ALLOC_SITE_REG_TABLE);
+    mem_free(&allocator, table, ALLOC_SITE_REG_TABLE);
+    return 0;
+}
+
+struct ObjWrapper** reg_flat_find(const struct RegFlatTable* table, const char* name, uint64_t h,
+                                  size_t* probes)
+{
+    size_t groups = 0;
+    size_t index = find_index(table, name, h, &groups);
+    if (probes)
+        *probes = groups;
+    if (index == table->capacity)
+        return NULL;
+    return &table->slots[index].object;
+}
+
+int reg_flat_insert(struct RegFlatTable* table, const char* name, uint64_t h,
+                    struct ObjWrapper* object)
+{
+    // make room first so the free slot found below survives
+    if ((table->count + table->deleted + 1) * MAX_LOAD_DEN > table->capacity * MAX_LOAD_NUM)
+    {
+        size_t new_capacity = table->capacity;
+        if ((table->count + 1) * MAX_LOAD_DEN > table->capacity * MAX_LOAD_NUM / 2)
+            new_capacity = table->capacity * 2; // genuinely full, not just tombstones
+        if (rebuild(table, new_capacity))
+            return 2; // allocation failure
+    }
+
+    char* name_copy = reg_arena_copy_name(table->arena, name);
+    if (!name_copy)
+    {
+        LOG_OUT(LOG_ERROR, "failed to copy name=%s for ptr=%p", name, object);
+        return 2;
+    }
+
+    size_t index = find_free_slot(table, h);
+    if (table->ctrl[index] == CTRL_DELETED)
+        table->deleted--;
+    set_ctrl(table, index, (int8_t)(h & 0x7F));
+    table->slots[index].hash = h;
+    table->slots[index].name = name_copy;
+    table->slots[index].object = object;
+    table->slots[index].handle_slot = REG_HANDLE_NONE;
+    table->count++;
+
+    return 0;
+}
+
+int reg_flat_reserve(struct RegFlatTable* table, size_t bindings)
+{
+    size_t capacity = capacity_for(bindings);
+    if (capacity <= table->capacity)
+        return 0;
+    return rebuild(table, capacity);
+}
+
+int reg_flat_erase(struct RegFlatTable* table, const char* name, uint64_t h,
+                   struct ObjWrapper** removed_object)
+{
+    size_t groups = 0;
+    size_t index = find_index(table, name, h, &groups);
+    if (index == table->capacity)
+        return 1; // not found
+    return reg_flat_erase_at(table, index, removed_object);
+}
+
+int reg_flat_erase_at(struct RegFlatTable* table, size_t index, struct ObjWrapper** removed_object)
+{
+    if (index >= table->capacity || table->ctrl[index] < 0)
+        return 1; // not a full slot
+
+    if (table->slots[index].handle_slot != REG_HANDLE_NONE)
+        reg_handles_release(table->handles, table->slots[index].handle_slot - 1);
+    *removed_object = table->slots[index].object;
+    reg_arena_free_name(table->arena, table->slots[index].name);
+    table->slots[index].name = NULL;
+    table->slots[index].object = NULL;
+    set_ctrl(table, index, CTRL_DELETED);
+    table->count--;
+    table->deleted++;
+
+    // shrinking is best effort; on allocation failure the table stays valid
+    if (table->capacity > table->min_capacity && table->count * SHRINK_DIV < table->capacity)
+    {
+        size_t new_capacity = capacity_for(table->count * 2);
+        if (new_capacity < table->min_capacity)
+            new_capacity = table->min_capacity;
+        if (new_capacity < table->capacity)
+            rebuild(table, new_capacity);
+    }
+
+    return 0;
+}
+
+size_t reg_flat_find_index(const struct RegFlatTable* table, const char* name, uint64_t h,
+                           size_t* probes)
+{
+    size_t groups = 0;
+    size_t index = find_index(table, name, h, &groups);
+    if (probes)
+        *probes = groups;
+    return index;
+}
+
+struct ObjWrapper** reg_flat_object_at(struct RegFlatTable* table, size_t index)
+{
+    return &table->slots[index].object;
+}
+
+uint32_t* reg_flat_handle_at(struct RegFlatTable* table, size_t index)
+{
+    return &table->slots[index].handle_slot;
+}
+
+uint64_t reg_flat_hash_at(const struct RegFlatTable* table, size_t index)
+{
+    return table->slots[index].hash;
+}
+
+bool reg_flat_slot(const struct RegFlatTable* table, size_t index, const char** name,
+                   struct ObjWrapper** object)
+{
+    if (index >= table->capacity || table->ctrl[index] < 0)
+        return false;
+    *name = table->slots[index].name;
+    *object = table->slots[index].object;
+    return true;
+}
+
+size_t reg_flat_capacity(const struct RegFlatTable* table)
+{
+    if (!table)
+        return 0;
+    return table->capacity;
+}
+
+size_t reg_flat_count(const struct RegFlatTable* table)
+{
+    if (!table)
+        return 0;
+    return table->count;
+}
+
+void reg_flat_probe_stats(const struct RegFlatTable* table, size_t* histogram, size_t bins,
+                          size_t* max_groups, size_t* total_groups)
+{
+    size_t mask = table->capacity - 1;
+    for (size_t i = 0; i < table->capacity; i++)
+    {
+        if (table->ctrl[i] < 0)
+            continue;
+
+        // replay the probe sequence until the group that covers slot i
+        size_t pos = (table->slots[i].hash >> 7) & mask;
+        size_t stride = 0;
+        size_t groups = 1;
+        while (((i - pos) & mask) >= GROUP_WIDTH)
+        {
+            stride += GROUP_WIDTH;
+            pos = (pos + stride) & mask;
+            groups++;
+        }
+
+        histogram[groups < bins ? groups : bins - 1]++;
+        if (groups > *max_groups)
+            *max_groups = groups;
+        *total_groups += groups;
+    }
+}
+#pragma endregion
+
+#pragma region Private Functions
+/* ============================================================================
+ * Private helper implementation
+ * ============================================================================
+ */
+
+//  Purpose: Bitmask of the control bytes in `group` equal to `tag`.
+//  Input assumptions: `group` has GROUP_WIDTH readable bytes.
+//  Effects: None.
+//  Returns: Bit i set when group[i] == tag.
+static inline uint32_t group_match(const int8_t* group, int8_t tag)
+{
+#if defined(__SSE2__)
+    __m128i ctrl = _mm_loadu_si128((const __m128i*)group);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(tag)));
+#else
+    uint32_t mask = 0;
+    for (int i = 0; i < GROUP_WIDTH; i++)
+    {
+        if (group[i] == tag)
+            mask |= (uint32_t)1 << i;
+    }
+    return mask;
+#endif
+}
+
+//  Purpose: Bitmask of empty control bytes in `group`.
+//  Input assumptions: `group` has GROUP_WIDTH readable bytes.
+//  Effects: None.
+//  Returns: Bit i set when group[i] == CTRL_EMPTY.
+static inline uint32_t group_match_empty(const int8_t* group)
+{
+    return group_match(group, CTRL_EMPTY);
+}
+
+//  Purpose: Bitmask of empty or deleted control bytes in `group`.
+//  Input assumptions: `group` has GROUP_WIDTH readable bytes.
+//  Effects: None.
+//  Returns: Bit i set when group[i] is negative (not a full slot).
+static inline uint32_t group_match_free(const int8_t* group)
+{
+#if defined(__SSE2__)
+    return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)group));
+#else
+    uint32_t mask = 0;
+    for (int i = 0; i < GROUP_WIDTH; i++)
+    {
+        if (group[i] < 0)
+            mask |= (uint32_t)1 << i;
+    }
+    return mask;
+#endif
+}
+
+//  Purpose: Index of the lowest set bit.
+//  Input assumptions: mask != 0.
+//  Effects: None.
+//  Returns: Bit index in [0, 32).
+static inline unsigned int lowest_bit(uint32_t mask)
+{
+#if defined(__GNUC__)
+    return (unsigned int)__builtin_ctz(mask);
+#else
+    unsigned int i = 0;
+    while (!(mask & 1u))
+    {
+        mask >>= 1;
+        i++;
+    }
+    return i;
+#endif
+}
+
+//  Purpose: Write control byte `index`, keeping the tail mirror in sync.
+//  Input assumptions: index < capacity.
+//  Effects: ctrl[index] (and its mirror) updated.
+//  Returns: None.
+static inline void set_ctrl(struct RegFlatTable* table, size_t index, int8_t value)
+{
+    table->ctrl[index] = value;
+    if (index < GROUP_WIDTH)
+        table->ctrl[table->capacity + index] = value;
+}
+
+//  Purpose: First empty or deleted slot on the probe sequence of `h`.
+//  Input assumptions: Load invariant holds (a free slot exists).
+//  Effects: None.
+//  Returns: Slot index in [0, capacity).
+static size_t find_free_slot(const struct RegFlatTable* table, uint64_t h)
+{
+    size_t mask = table->capacity - 1;
+    size_t pos = (h >> 7) & mask;
+    size_t stride = 0;
+
+    for (;;)
+    {
+        uint32_t free_mask = group_match_free(table->ctrl + pos);
+        if (free_mask)
+            return (pos + lowest_bit(free_mask)) & mask;
+        stride += GROUP_WIDTH;
+        pos = (pos + stride) & mask;
+    }
+}
+
+//  Purpose: Locate the full slot holding `name`.
+//  Input assumptions: table, name valid; h == hash(name); groups != NULL.
+//  Effects: *groups incremented once per control group scanned.
+//  Returns:
+//    Slot index on success.
+//    table->capacity when not found.
+//  Note: The stored hash is compared before strcmp so tag collisions rarely
+//    touch name bytes. The probe stops at the first group with an empty slot.
+static size_t find_index(const struct RegFlatTable* table, const char* name, uint64_t h,
+                         size_t* groups)
+{
+    size_t mask = table->capacity - 1;
+    size_t pos = (h >> 7) & mask;
+    size_t stride = 0;
+    int8_t tag = (int8_t)(h & 0x7F);
+
+    for (;;)
+    {
+        const int8_t* group = table->ctrl + pos;
+        (*groups)++;
+        uint32_t match = group_match(group, tag);
+        while (match)
+        {
+            size_t index = (pos + lowest_bit(match)) & mask;
+            const struct RegFlatSlot* slot = &table->slots[index];
+            if (slot->hash == h && !strcmp(slot->name, name))
+                return index;
+            match &= match - 1;
+        }
+        if (group_match_empty(group))
+            return table->capacity;
+        stride += GROUP_WIDTH;
+        pos = (pos + stride) & mask;
+    }
+}
+
+//  Purpose: Smallest power-of-two capacity that holds `bindings` under the
+//    max load factor.
+//  Input assumptions: None.
+//  Effects: None.
+//  Returns: Capacity >= MIN_CAPACITY.
+static size_t capacity_for(size_t bindings)
+{
+    size_t capacity = MIN_CAPACITY;
+    while ((bindings + 1) * MAX_LOAD_DEN > capacity * MAX_LOAD_NUM)
+        capacity *= 2;
+    return capacity;
+}
+
+//  Purpose: Reinsert every full slot into fresh arrays of new_capacity.
+//  Input assumptions: new_capacity is a power of two holding table->count.
+//  Effects: Old arrays freed, tombstones dropped. Names are moved, not copied;
+//    resolved slots are retargeted in the handle directory.
+//  Returns:
+//    0: Success.
+//    2: Allocation failure; table unchanged.
+static int rebuild(struct RegFlatTable* table, size_t new_capacity)
+{
+    int8_t* new_ctrl = NULL;
+    struct RegFlatSlot* new_slots = NULL;
+    if (alloc_arrays(&table->allocator, new_capacity, &new_ctrl, &new_slots))
+    {
+        LOG_OUT(LOG_WARNING, "failed to allocate flat table rebuild %zu->%zu slots.",
+                table->capacity, new_capacity);
+        return 2;
+    }
+
+    struct RegFlatTable rebuilt = {new_ctrl, new_slots, new_capacity, 0, 0, table->min_capacity,
+                                   table->arena, table->handles, table->allocator};
+    for (size_t i = 0; i < table->capacity; i++)
+    {
+        if (table->ctrl[i] < 0)
+            continue;
+        const struct RegFlatSlot* slot = &table->slots[i];
+        size_t index = find_free_slot(&rebuilt, slot->hash);
+        set_ctrl(&rebuilt, index, (int8_t)(slot->hash & 0x7F));
+        rebuilt.slots[index] = *slot;
+        if (slot->handle_slot != REG_HANDLE_NONE)
+            reg_handles_retarget(table->handles, slot->handle_slot - 1, index);
+        rebuilt.count++;
+    }
+    assert(rebuilt.count == table->count);
+
+    LOG_OUT(LOG_DEBUG, "flat table=%p rebuilt capacity=%zu->%zu count=%zu tombstones=%zu.",
+            table, table->capacity, new_capacity, table->count, table->deleted);
+
+    mem_free(&table->allocator, table->ctrl, ALLOC_SITE_REG_TABLE);
+    mem_free(&table->allocator, table->slots, ALLOC_SITE_REG_TABLE);
+    *table = rebuilt;
+    return 0;
+}
+
+//  Purpose: Allocate control and slot arrays for `capacity` slots.
+//  Input assumptions: capacity power of two >= GROUP_WIDTH.
+//  Effects: On success all control bytes (including the mirror) are empty.
+//  Returns:
+//    0: Success.
+//    2: Allocation failure; nothing allocated.
+static int alloc_arrays(const struct LinalgAllocator* allocator, size_t capacity, int8_t** ctrl,
+                        struct RegFlatSlot** slots)
+{
+    *ctrl = mem_alloc(allocator, capacity + GROUP_WIDTH, ALLOC_SITE_REG_TABLE);
+    *slots = mem_alloc(allocator, capacity * sizeof(struct RegFlatSlot), ALLOC_SITE_REG_TABLE);
+    if (!*ctrl || !*slots)
+    {
+        mem_free(allocator, *ctrl, ALLOC_SITE_REG_TABLE);
+        mem_free(allocator, *slots, ALLOC_SITE_REG_TABLE);
+        *ctrl = NULL;
+        *slots = NULL;
+        return 2;
+    }
+    memset(*ctrl, (unsigned char)CTRL_EMPTY, capacity + GROUP_WIDTH);
+    return 0;
+}
+
+#pragma endregion
@@ -0,0 +1,207 @@
+#include "reg_handles.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "logs.h"
+#include "mem_alloc.h"
+
+#pragma region Head Comment
+/*
+ * Translation unit implements:
+ * - The generational slot directory behind binding handles.
+ *
+ * Directory invariants:
+ * - slots[0 .. used) have been handed out at least once; slots beyond used
+ *   are uninitialized capacity.
+ * - A slot is in use iff next_free == SLOT_IN_USE; free slots form a singly
+ *   linked list through next_free starting at free_head.
+ * - generation is never 0 and only moves forward (wrapping past 0 to 1).
+ */
+#pragma endregion
+
+#pragma region Local Definitions
+/* ============================================================================
+ * File-local definitions
+ * ============================================================================
+ */
+#define SLOT_IN_USE UINT32_MAX
+#define SLOT_LIST_END (UINT32_MAX - 1)
+#define MAX_SLOTS (UINT32_MAX - 1) // indices must stay below the sentinels
+#define MIN_SLOTS 16
+
+struct RegHandleSlot
+{
+    uintptr_t target;    // backend entry location, meaningful only while in use
+    uint32_t generation; // current generation; handles must match it
+    uint32_t next_free;  // SLOT_IN_USE, or next free slot index
+};
+
+struct RegHandleTable
+{
+    struct RegHandleSlot* slots;
+    size_t capacity;    // allocated slots
+    size_t used;        // high-water mark of handed-out slots
+    uint32_t free_head; // first recycled slot, SLOT_LIST_END when empty
+    struct LinalgAllocator allocator; // the directory and its slots
+};
+#pragma endregion
+
+#pragma region Private Function Prototypes
+/* ============================================================================
+ * Private function prototypes
+ * ============================================================================
+ */
+static inline uint32_t next_generation(uint32_t generation);
+static int grow_slots(struct RegHandleTable* handles);
+#pragma endregion
+
+#pragma region Public API
+/* ============================================================================
+ * Public API implementation
+ * ============================================================================
+ */
+
+struct RegHandleTable* reg_handles_init(const struct LinalgAllocator* allocator)
+{
+    struct RegHandleTable* handles =
+        mem_alloc(allocator, sizeof(struct RegHandleTable), ALLOC_SITE_REG_HANDLES);
+    if (!handles)
+    {
+        LOG_OUT(LOG_ERROR, "failed to allocate %zu bytes for handle directory.",
+                sizeof(struct RegHandleTable));
+        return NULL;
+    }
+
+    handles->slots = NULL;
+    handles->capacity = 0;
+    handles->used = 0;
+    handles->free_head = SLOT_LIST_END;
+    handles->allocator = mem_resolve(allocator);
+    return handles;
+}
+
+int reg_handles_destroy(struct RegHandleTable* handles)
+{
+    if (!handles)
+        return 0;
+
+    struct LinalgAllocator allocator = handles->allocator;
+    mem_free(&allocator, handles->slots, ALLOC_SITE_REG_HANDLES);
+    mem_free(&allocator, handles, ALLOC_SITE_REG_HANDLES);
+    return 0;
+}
+
+int reg_handles_acquire(struct RegHandleTable* handles, uintptr_t target,
+                        struct BindingHandle* handle)
+{
+    uint32_t index;
+    if (handles->free_head != SLOT_LIST_END)
+    {
+        index = handles->free_head;
+        handles->free_head = handles->slots[index].next_free;
+    }
+    else
+    {
+        if (handles->used == handles->capacity && grow_slots(handles))
+            return 2; // allocation failure
+        index = (uint32_t)handles->used++;
+        handles->slots[index].generation = 1;
+    }
+
+    struct RegHandleSlot* slot = &handles->slots[index];
+    slot->target = target;
+    slot->next_free = SLOT_IN_USE;
+
+    handle->index = index;
+    handle->generation = slot->generation;
+    return 0;
+}
+
+void reg_handles_release(struct RegHandleTable* handles, uint32_t index)
+{
+    struct RegHandleSlot* slot = &handles->slots[index];
+    slot->generation = next_generation(slot->generation);
+    slot->target = 0;
+    slot->next_free = handles->free_head;
+    handles->free_head = index;
+}
+
+struct BindingHandle reg_handles_refresh(struct RegHandleTable* handles, uint32_t index)
+{
+    struct RegHandleSlot* slot = &handles->slots[index];
+    slot->generation = next_generation(slot->generation);
+    return (struct BindingHandle){.index = index, .generation = slot->generation};
+}
+
+struct BindingHandle reg_handles_current(const struct RegHandleTable* handles, uint32_t index)
+{
+    return (struct BindingHandle){.index = index, .generation = handles->slots[index].generation};
+}
+
+void reg_handles_retarget(struct RegHandleTable* handles, uint32_t index, uintptr_t target)
+{
+    handles->slots[index].target = target;
+}
+
+bool reg_handles_resolve(const struct RegHandleTable* handles, struct BindingHandle handle,
+                         uintptr_t* target)
+{
+    if (handle.index >= handles->used)
+        return false;
+
+    const struct RegHandleSlot* slot = &handles->slots[handle.index];
+    if (slot->generation != handle.generation || slot->next_free != SLOT_IN_USE)
+        return false;
+
+    *target = slot->target;
+    return true;
+}
+#pragma endregion
+
+#pragma region Private Functions
+/* ============================================================================
+ * Private helper implementation
+ * ============================================================================
+ */
+
+//  Purpose: Advance a slot generation, skipping 0.
+//  Input assumptions: None.
+//  Effects: None.
+//  Returns: generation + 1, or 1 on wraparound.
+static inline uint32_t next_generation(uint32_t generation)
+{
+    generation++;
+    return generation ? generation : 1;
+}
+
+//  Purpose: Double the slot array.
+//  Input assumptions: handles->used == handles->capacity.
+//  Effects: slots reallocated; existing slots preserved.
+//  Returns:
+//    0: Success.
+//    2: Allocation failure or directory full; directory unchanged.
+static int grow_slots(struct RegHandleTable* handles)
+{
+    size_t new_capacity = handles->capacity ? handles->capacity * 2 : MIN_SLOTS;
+    if (new_capacity > MAX_SLOTS)
+        new_capacity = MAX_SLOTS;
+    if (new_capacity <= handles->capacity)
+        return 2; // index space exhausted
+
+    struct RegHandleSlot* slots = mem_realloc(
+        &handles->allocator, handles->slots, handles->capacity * sizeof(struct RegHandleSlot),
+        new_capacity * sizeof(struct RegHandleSlot), ALLOC_SITE_REG_HANDLES);
+    if (!slots)
+    {
+        LOG_OUT(LOG_ERROR, "failed to grow handle directory %zu->%zu slots.", handles->capacity,
+                new_capacity);
+        return 2;
+    }
+
+    handles->slots = slots;
+    handles->capacity = new_capacity;
+    return 0;
+}
+#pragma endregion
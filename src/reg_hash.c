@@ -1,23 +1,45 @@
 #include "reg_hash.h"
 
 #include <assert.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #include "logs.h"
 #include "math_objs.h"
+#include "mem_alloc.h"
+#include "reg_arena.h"
+#include "reg_ebr.h"
+#include "reg_filter.h"
+#include "reg_flat.h"
+#include "reg_handles.h"
+#include "reg_mphf.h"
+#include "reg_pmap.h"
+#include "reg_trie.h"
 
 #pragma region Head Comment
 /*
  * Translation unit implements:
  * - Creation, operations, and teardown of the name-binding hash table.
+ * - Dispatch to the selected backend: separate chaining (this file) or the
+ *   open-addressing table in reg_flat.c.
  * - Coordination with the math_objs API via incref_obj() and decref_obj()
  *   for reference-counted object lifetime management.
  * - Lookup functionality for retrieving bindings by name.
+ * - Binding handles: names resolved once into a generational directory
+ *   (reg_handles.c) so later lookup/rebind/remove skip hashing.
+ * - Concurrent mode: a router registry that hashes once, picks a shard from
+ *   the top hash bits and runs the single-threaded code on that shard's
+ *   registry under the shard's mutex.
  *
  * Registry invariants:
  * - Registry owns all stored name strings.
+ * - Nodes and names are carved from reg_table->arena; teardown releases the
+ *   arena wholesale instead of freeing bindings one by one.
  * - Successful binding retains the associated ObjWrapper
  *   via incref_obj().
  * - Unbinding releases the associated ObjWrapper
@@ -26,9 +48,71 @@
  *     - Existing binding is released (decref_obj()).
  *     - New binding is retained (incref_obj()).
  * - Overwrite with the same ObjWrapper is a no-op.
+ * - count == number of nodes reachable from table[0] and table[1].
+ * - Every stored entry carries hash() of its name under the registry's seed;
+ *   entries are only strcmp'd when their stored hash matches.
+ * - An entry with handle_slot != REG_HANDLE_NONE owns directory slot
+ *   handle_slot - 1. Changing the entry's object refreshes that slot's
+ *   generation; removing the entry releases it.
  *
  * Internal conventions:
- * - None.
+ * - table[0] is the live table; table[1] is only non-NULL while an
+ *   incremental rehash is in progress (rehash_index != REHASH_IDLE).
+ * - Buckets of table[0] below rehash_index are empty; their nodes have been
+ *   migrated to table[1]. New nodes are always linked into the insert table
+ *   (table[1] while rehashing, table[0] otherwise).
+ * - Only add_binding()/remove_binding() migrate buckets; lookup_binding() has
+ *   no side effects and simply searches both tables.
+ * - With REG_BACKEND_FLAT, table[]/size[] are unused and all storage lives in
+ *   `flat`; refcounting is still done here for both backends.
+ * - Directory targets are RegistryLL* for the chained backend (nodes never
+ *   move) and flat slot indices for REG_BACKEND_FLAT (reg_flat.c retargets
+ *   them when it rebuilds).
+ * - A router (shards != NULL) owns no bindings itself: only seed, shards and
+ *   shard_bits are meaningful. Shard registries share the router's seed so
+ *   the router's hash is valid inside the shard. Public entry points hash
+ *   and validate, then call the *_hashed() helpers on the target registry.
+ * - Handles issued by a router carry the shard in their low shard_bits bits
+ *   and the shard-local directory index above them.
+ * - prefix != NULL iff the registry was built with config->prefix_index (for
+ *   a router: on every shard, never on the router). It then holds exactly the
+ *   bound names; every successful new-name add inserts and every removal
+ *   (by name, handle or prefix) removes under the same lock as the table
+ *   change. Lock-free readers never touch it.
+ * - frozen != NULL only while no binding has changed since freeze_registry()
+ *   built it: every mutating path calls thaw() once it has found a binding to
+ *   change and before publishing the change. Misses, stale handles and
+ *   rebinds to the same object leave the frozen table in place.
+ *   Lookups try frozen first and never fall back (a miss there is a miss).
+ *   With lockfree_reads it is published with a release store and retired on
+ *   thaw like any other reader-visible block.
+ * - persist is the persistent map of exactly the bound names once
+ *   `snapshots` is set (config->snapshots, or the first snapshot_registry()).
+ *   Every mutating path stages the updated map before changing the table
+ *   and swaps it in (finish_persist()) under the same lock, so a snapshot
+ *   retaining persist under the lock sees one consistent cut.
+ * - filter != NULL iff built with config->negative_filter. It holds the hash
+ *   of every bound name (plus stale hashes of removed ones, counted in
+ *   filter_stale), so a negative answer is always right. It is rebuilt from
+ *   the table when bindings outgrow its capacity or stale hashes fill half
+ *   of it or outnumber the live bindings; with lockfree_reads the old filter
+ *   is retired.
+ *
+ * Lock-free reads (chained shards of a router, lockfree_reads set):
+ * - lookup_binding() takes no lock. It enters an epoch (reg_ebr.c), loads
+ *   `view` and walks the buckets through acquire loads.
+ * - Writers still hold the shard mutex. Every store a reader can observe
+ *   (bucket heads, next, object, view) is a release store, and a node is fully
+ *   initialized before it is linked.
+ * - Readers never write shared registry state: their lookup counters go to
+ *   read_stripes[], one cache line per reader slot, summed by
+ *   registry_stats().
+ * - Unlinked nodes, names, bucket arrays and views are retired, never freed
+ *   directly; they are reclaimed once every reader that could hold them has
+ *   left its epoch.
+ * - Rehash copies nodes instead of relinking them, so a reader walking an old
+ *   chain never gets diverted into a new one. Migration only starts once no
+ *   reader can still hold the view that predates table[1].
  */
 #pragma endregion
 
@@ -39,16 +123,110 @@
  */
 struct RegistryLL
 {
+    uint64_t hash;             // seeded hash of name, checked before strcmp
     struct ObjWrapper* object; // non-owning, lifetime via ref_count
     char* name;                // owning, must free on unbind
     struct RegistryLL* next;
+    uint32_t handle_slot; // directory slot + 1, REG_HANDLE_NONE if never resolved
+};
+
+struct RegOpCounters
+{
+    uint64_t lookups; // lookup_binding() and resolve_binding()
+    uint64_t lookup_probes;
+    uint64_t adds;
+    uint64_t add_probes;
+    uint64_t removes; // remove_binding()
+    uint64_t remove_probes;
+    uint64_t filter_rejects;         // lookups answered "absent" by the filter alone
+    uint64_t filter_false_positives; // lookups the filter passed that then missed
+};
+
+// A reader slot's lookup counters, alone on its cache line so lock-free
+// readers in different slots never write the same line.
+struct RegReadStripe
+{
+    _Alignas(64) struct RegOpCounters counters; // lookup and filter fields only
+};
+
+struct RegTableView
+{
+    struct RegistryLL** table[2]; // snapshot of RegistryHash.table
+    size_t size[2];               // snapshot of RegistryHash.size
+};
+
+struct RegistryShard
+{
+    _Alignas(64) pthread_mutex_t lock; // one cache line per shard, no false sharing
+    struct RegistryHash* reg;          // single-threaded registry guarded by lock
 };
 
 struct RegistryHash
 {
-    struct RegistryLL** table;
-    size_t size;
+    enum RegistryBackend backend;
+    struct RegistryShard* shards; // concurrent router only, NULL otherwise
+    size_t shard_count;           // power of two
+    unsigned int shard_bits;      // log2(shard_count)
+    struct RegFlatTable* flat;    // REG_BACKEND_FLAT storage, NULL otherwise
+    struct RegArena* arena;       // owns every node and name string
+    struct RegHandleTable* handles; // directory behind struct BindingHandle
+    struct RegistryLL** table[2]; // [0] live, [1] rehash target (NULL when idle)
+    size_t size[2];               // bucket counts of table[0] and table[1]
+    size_t count;                 // number of bindings across both tables
+    size_t min_size;              // initial table_size, floor for shrinking
+    size_t rehash_index;          // next table[0] bucket to migrate
+    uint64_t seed;                // hash seed, fixed for the registry's lifetime
+    bool lockfree_reads;          // lookups skip the shard lock (chained shards only)
+    struct RegTableView* view;    // lockfree_reads: tables readers traverse
+    struct RegTableView* done_view; // lockfree_reads: published when the rehash completes
+    uint64_t rehash_epoch;        // lockfree_reads: epoch table[1] became visible in
+    struct RegEbrList retired;    // lockfree_reads: unlinked memory awaiting readers
+    struct RegOpCounters counters; // cumulative name-based operation counts (under lock)
+    struct RegReadStripe* read_stripes; // lockfree_reads: READ_STRIPES lock-free counters
+    struct RegTrie* prefix;        // prefix_index: every bound name, NULL otherwise
+    struct RegMphf* frozen;        // freeze_registry() snapshot, NULL when thawed
+    struct RegFilter* filter;      // negative_filter: hashes of bound names, NULL otherwise
+    size_t filter_stale;           // removals since the filter was last built
+    size_t filter_min;             // negative_filter: floor for the rebuilt capacity
+    bool snapshots;                // persist maintained (config->snapshots or first snapshot)
+    struct RegPmap* persist;       // snapshots: persistent copy of the bindings
+    struct LinalgAllocator allocator; // every block above; shards use the router's
+};
+
+struct RegSnapshot
+{
+    uint64_t seed;                    // registry seed, for hashing lookups
+    unsigned int shard_bits;          // routes a hash to roots[] like the router
+    size_t count;                     // bindings across all roots
+    size_t root_count;                // shard_count, 1 for a plain registry
+    struct LinalgAllocator allocator; // the registry's, which this may outlive
+    struct RegPmap* roots[];          // one retained persistent map per shard
 };
+
+// enable_snapshots() build state, threaded through visit_entries().
+struct PersistBuild
+{
+    struct RegistryHash* reg_table;
+    struct RegPmap* root; // map built so far (one reference)
+    int ret;              // first failure; later bindings are skipped
+};
+
+// Callback for visit_entries(): one live binding.
+typedef void (*entry_visit_fn)(void* ctx, const char* name, uint64_t h,
+                               struct ObjWrapper* object);
+
+#define REHASH_IDLE ((size_t)-1)
+#define REHASH_STEP_BUCKETS 4                              // non-empty buckets moved per op
+#define REHASH_MAX_EMPTY_VISITS (REHASH_STEP_BUCKETS * 10) // bound on empty buckets per op
+#define LOAD_FACTOR_GROW_NUM 1                             // grow when count >= size * 1
+#define LOAD_FACTOR_SHRINK_DIV 8                           // shrink when count < size / 8
+#define DEFAULT_SHARDS 16
+#define MAX_SHARDS 4096
+#define RETIRE_COLLECT_THRESHOLD 64 // retired items before a writer tries to reclaim
+#define READ_STRIPES 16             // lock-free counter slots per registry, power of two
+
+static unsigned int next_read_stripe;                  // atomic: hands out reader slots
+static _Thread_local unsigned int thread_read_stripe; // slot + 1, 0 until first lock-free read
 #pragma endregion
 
 #pragma region Private Function Prototypes
@@ -57,17 +235,90 @@ struct RegistryHash
  * ============================================================================
  */
 
-static unsigned int hash(const char* s); // from K&R 'C programming language'
-static struct RegistryLL* find_node(struct RegistryLL** prev_node, struct RegistryHash* reg_table,
-                                    const char* name, size_t index);
-static char* copy_name(const char* name);
+static uint64_t hash(const struct RegistryHash* reg_table, const char* s);
+static uint64_t hash_seeded(uint64_t seed, const char* s);
+static inline uint64_t mix_mul(uint64_t a, uint64_t b);
+static inline uint64_t read_u64(const unsigned char* p);
+static uint64_t make_seed(const void* salt);
+static bool is_valid_table(const struct RegistryHash* reg_table);
+static int add_binding_new_flat(const char* name, struct ObjWrapper* new_wrapper,
+                                struct RegistryHash* reg_table, uint64_t h);
+static struct RegistryLL* find_node(struct RegistryLL** prev_node, struct RegistryLL*** list_head,
+                                    const struct RegistryHash* reg_table, const char* name,
+                                    uint64_t h, size_t* probes);
+static struct RegistryLL** insert_bucket(struct RegistryHash* reg_table, uint64_t h);
+static int start_rehash(struct RegistryHash* reg_table, size_t new_size);
+static int rehash_step(struct RegistryHash* reg_table, size_t num_buckets);
+static int finish_rehash(struct RegistryHash* reg_table);
+static int maybe_grow(struct RegistryHash* reg_table);
+static int maybe_shrink(struct RegistryHash* reg_table);
+static size_t next_prime(size_t n);
 static int add_node(struct RegistryLL* new_node, struct RegistryLL** list_head);
 static int remove_node(struct RegistryLL* node, struct RegistryLL* prev_node,
                        struct RegistryLL** list_head);
 static int add_binding_already_bound(struct ObjWrapper* new_wrapper, struct ObjWrapper** slot);
-static int add_binding_new_binding(const char* name, struct ObjWrapper* new_wrapper,
-                                   struct RegistryHash* reg_table, size_t index);
-static int free_registry_node(struct RegistryLL* node);
+static int add_binding_new_binding(const char* name, uint64_t h, struct ObjWrapper* new_wrapper,
+                                   struct RegistryHash* reg_table, struct RegistryLL** list_head);
+static int free_registry_node(struct RegistryHash* reg_table, struct RegistryLL* node);
+static int rebind_entry(struct RegistryHash* reg_table, const char* name, uint64_t h,
+                        struct ObjWrapper* new_wrapper, struct ObjWrapper** slot,
+                        uint32_t handle_slot);
+static bool find_node_links(struct RegistryLL** prev_node, struct RegistryLL*** list_head,
+                            const struct RegistryHash* reg_table, const struct RegistryLL* node);
+static int decref_removed(struct ObjWrapper* object);
+static struct RegistryHash* init_sharded(size_t table_size, const struct RegistryConfig* config);
+static inline struct RegistryShard* shard_for_hash(const struct RegistryHash* reg_table,
+                                                   uint64_t h);
+static inline struct RegistryShard* shard_for_handle(const struct RegistryHash* reg_table,
+                                                     struct BindingHandle* handle);
+static inline void encode_handle(const struct RegistryHash* reg_table,
+                                 const struct RegistryShard* shard,
+                                 struct BindingHandle* handle);
+static int add_binding_hashed(const char* name, uint64_t h, struct ObjWrapper* object,
+                              struct RegistryHash* reg_table);
+static int remove_binding_hashed(const char* name, uint64_t h, struct RegistryHash* reg_table);
+static struct ObjWrapper* lookup_binding_hashed(const char* name, uint64_t h,
+                                                struct RegistryHash* reg_table);
+static int resolve_binding_hashed(const char* name, uint64_t h, struct RegistryHash* reg_table,
+                                  struct BindingHandle* handle);
+static inline void publish_node(struct RegistryLL** link, struct RegistryLL* node);
+static inline void publish_object(struct ObjWrapper** slot, struct ObjWrapper* object);
+static int enable_lockfree_reads(struct RegistryHash* reg_table);
+static int publish_view(struct RegistryHash* reg_table, struct RegTableView* view);
+static struct ObjWrapper* lookup_binding_lockfree(const char* name, uint64_t h,
+                                                  struct RegistryHash* reg_table);
+static void retire(struct RegistryHash* reg_table, void* ptr, reg_ebr_reclaim_fn reclaim);
+static void reclaim_node(void* reg_table, void* node);
+static void reclaim_name(void* reg_table, void* name);
+static void reclaim_block(void* reg_table, void* block);
+static void reclaim_frozen(void* unused, void* frozen);
+static void reclaim_filter(void* unused, void* filter);
+static int migrate_bucket_copies(struct RegistryHash* reg_table, size_t bucket);
+static inline void count_op(uint64_t* ops, uint64_t* probe_total, size_t probes);
+static inline void count_event(uint64_t* counter);
+static inline struct RegOpCounters* read_counters(struct RegistryHash* reg_table);
+static void accumulate_stats(struct RegistryHash* reg_table, struct RegistryStats* stats,
+                             size_t* chain_total, size_t* chains);
+static int index_name(struct RegistryHash* reg_table, const char* name, uint64_t h);
+static int remove_prefix_local(struct RegistryHash* reg_table, const char* prefix,
+                               size_t* removed);
+static int freeze_local(struct RegistryHash* reg_table);
+static void thaw(struct RegistryHash* reg_table);
+static void visit_entries(struct RegistryHash* reg_table, entry_visit_fn visit, void* ctx);
+static void collect_key(void* cursor, const char* name, uint64_t h, struct ObjWrapper* object);
+static void add_filter_hash(void* filter, const char* name, uint64_t h,
+                            struct ObjWrapper* object);
+static void rebuild_filter(struct RegistryHash* reg_table);
+static void note_removal(struct RegistryHash* reg_table);
+static inline bool filter_rejects(struct RegOpCounters* counters, const struct RegFilter* filter,
+                                  uint64_t h);
+static int enable_snapshots(struct RegistryHash* reg_table);
+static void persist_binding(void* build, const char* name, uint64_t h,
+                            struct ObjWrapper* object);
+static int stage_persist(struct RegistryHash* reg_table, const char* name, uint64_t h,
+                         struct ObjWrapper* object, struct RegPmap** next);
+static void finish_persist(struct RegistryHash* reg_table, struct RegPmap* next, bool landed);
+static inline struct RegistryHash* shard_reg(struct RegistryHash* reg_table, size_t i);
 #pragma endregion
 
 #pragma region Public API
@@ -81,36 +332,102 @@ static int free_registry_node(struct RegistryLL* node);
 // Caller must use destroy_reg_table() for cleanup.
 // Allocation failures return NULL
 struct RegistryHash* init_reg_table(size_t table_size)
+{
+    return init_reg_table_config(table_size, NULL);
+}
+
+struct RegistryHash* init_reg_table_config(size_t table_size, const struct RegistryConfig* config)
 {
     if (table_size == 0)
         return NULL; // caller error
 
+    enum RegistryBackend backend = config ? config->backend : REG_BACKEND_CHAINED;
+    if (backend != REG_BACKEND_CHAINED && backend != REG_BACKEND_FLAT)
+        return NULL; // caller error
+    const struct LinalgAllocator* allocator = config ? config->allocator : NULL;
+    if (!mem_valid(allocator))
+        return NULL; // caller error
+    if (config && config->concurrent)
+        return init_sharded(table_size, config);
+
     // allocate for table
-    struct RegistryHash* reg_table = malloc(sizeof(struct RegistryHash));
+    struct RegistryHash* reg_table =
+        mem_calloc(allocator, 1, sizeof(struct RegistryHash), ALLOC_SITE_REG_TABLE);
     if (!reg_table)
     {
         LOG_OUT(LOG_ERROR, "failed to allocate %zu bytes for reg table of size %zu.",
                 sizeof(struct RegistryHash), table_size);
         return NULL;
     }
+    reg_table->backend = backend;
+    reg_table->rehash_index = REHASH_IDLE;
+    reg_table->seed = (config && config->seed) ? config->seed : make_seed(reg_table);
+    reg_table->allocator = mem_resolve(allocator);
+    reg_table->retired.allocator = &reg_table->allocator;
+    reg_table->snapshots = config && config->snapshots; // persist starts as the empty map
+
+    reg_table->arena = reg_arena_init(sizeof(struct RegistryLL), &reg_table->allocator);
+    reg_table->handles = reg_handles_init(&reg_table->allocator);
+    if (config && config->prefix_index)
+        reg_table->prefix = reg_trie_init(&reg_table->allocator);
+    if (config && config->negative_filter)
+    {
+        reg_table->filter_min = table_size;
+        reg_table->filter = reg_filter_init(table_size, &reg_table->allocator);
+    }
+    if (!reg_table->arena || !reg_table->handles ||
+        (config && config->prefix_index && !reg_table->prefix) ||
+        (config && config->negative_filter && !reg_table->filter))
+    {
+        reg_arena_destroy(reg_table->arena);
+        reg_handles_destroy(reg_table->handles);
+        reg_trie_destroy(reg_table->prefix);
+        reg_filter_destroy(reg_table->filter);
+        mem_free(allocator, reg_table, ALLOC_SITE_REG_TABLE);
+        return NULL;
+    }
+
+    if (backend == REG_BACKEND_FLAT)
+    {
+        reg_table->flat = reg_flat_init(table_size, reg_table->arena, reg_table->handles,
+                                        &reg_table->allocator);
+        if (!reg_table->flat)
+        {
+            reg_arena_destroy(reg_table->arena);
+            reg_handles_destroy(reg_table->handles);
+            reg_trie_destroy(reg_table->prefix);
+            reg_filter_destroy(reg_table->filter);
+            mem_free(allocator, reg_table, ALLOC_SITE_REG_TABLE);
+            return NULL;
+        }
+        LOG_OUT(LOG_DEBUG, "success: reg_table=%p backend=FLAT capacity=%zu.", reg_table,
+                reg_flat_capacity(reg_table->flat));
+        return reg_table;
+    }
 
     // allocate for table buckets
     // calloc -> initialize to zero
-    struct RegistryLL** table = calloc(table_size, sizeof(struct RegistryLL*));
+    struct RegistryLL** table = mem_calloc(&reg_table->allocator, table_size,
+                                           sizeof(struct RegistryLL*), ALLOC_SITE_REG_TABLE);
     if (!table)
     {
         LOG_OUT(LOG_ERROR,
                 "failed to allocate %zu bytes for table buckets for reg_table of size %zu.",
                 table_size * sizeof(struct RegistryLL*), table_size);
-        free(reg_table);
+        reg_arena_destroy(reg_table->arena);
+        reg_handles_destroy(reg_table->handles);
+        reg_trie_destroy(reg_table->prefix);
+        reg_filter_destroy(reg_table->filter);
+        mem_free(allocator, reg_table, ALLOC_SITE_REG_TABLE);
         return NULL;
     }
 
     // populate reg_table struct on success
-    reg_table->table = table;
-    reg_table->size = table_size;
+    reg_table->table[0] = table;
+    reg_table->size[0] = table_size;
+    reg_table->min_size = table_size;
 
-    LOG_OUT(LOG_DEBUG, "success: reg_table=%p size=%zu.", reg_table, reg_table->size);
+    LOG_OUT(LOG_DEBUG, "success: reg_table=%p size=%zu.", reg_table, reg_table->size[0]);
     return reg_table;
 }
 
@@ -120,118 +437,153 @@ int destroy_reg_table(struct RegistryHash* reg_table)
     if (!reg_table)
         return 0; // return 0 if passed NULL
 
-    LOG_OUT(LOG_DEBUG, "reg_table teardown beginning table=%p size=%zu.", reg_table,
-            reg_table->size);
+    LOG_OUT(LOG_DEBUG, "reg_table teardown beginning table=%p size=%zu count=%zu.", reg_table,
+            reg_table->size[0], reg_table->count);
+    struct LinalgAllocator allocator = reg_table->allocator;
+
+    if (reg_table->shards)
+    {
+        for (size_t i = 0; i < reg_table->shard_count; i++)
+        {
+            destroy_reg_table(reg_table->shards[i].reg);
+            pthread_mutex_destroy(&reg_table->shards[i].lock);
+        }
+        mem_free(&allocator, reg_table->shards, ALLOC_SITE_REG_TABLE);
+        mem_free(&allocator, reg_table, ALLOC_SITE_REG_TABLE);
+        return 0;
+    }
 
     size_t decref_obj_count = 0;
     size_t free_node_count = 0;
 
-    for (size_t i = 0; i < reg_table->size; i++)
-    {
-        struct RegistryLL* node = reg_table->table[i];
-        struct RegistryLL* next_node = NULL;
+    // no reader can be inside a registry that is being destroyed
+    reg_ebr_drain(&reg_table->retired, reg_table);
+    reg_mphf_destroy(reg_table->frozen);
+    reg_pmap_release(reg_table->persist, &allocator); // snapshots keep their own refs
+    mem_free(&allocator, reg_table->view, ALLOC_SITE_REG_TABLE);
+    mem_free(&allocator, reg_table->done_view, ALLOC_SITE_REG_TABLE);
+    mem_free(&allocator, reg_table->read_stripes, ALLOC_SITE_REG_TABLE);
 
-        while (node)
+    if (reg_table->flat)
+    {
+        const char* name = NULL;
+        struct ObjWrapper* object = NULL;
+        for (size_t i = 0; i < reg_flat_capacity(reg_table->flat); i++)
         {
-            int decref_ret = decref_obj(node->object);
+            if (!reg_flat_slot(reg_table->flat, i, &name, &object))
+                continue;
+            int decref_ret = decref_obj(object);
             if (decref_ret != 0)
             {
-                LOG_OUT(LOG_ERROR, "decref_obj() failed ptr=%p name=%s slot=%zu rtn=%d.",
-                        node->object, node->name, i, decref_ret);
+                LOG_OUT(LOG_ERROR, "decref_obj() failed ptr=%p name=%s slot=%zu rtn=%d.", object,
+                        name, i, decref_ret);
                 assert(decref_ret == 0);
             }
             else
                 decref_obj_count++;
-            next_node = node->next;
-            free_registry_node(node);
             free_node_count++;
-            node = next_node;
+        }
+        reg_flat_destroy(reg_table->flat);
+    }
+
+    // table[1] is only populated while a rehash is in progress
+    for (int t = 0; t < 2; t++)
+    {
+        if (!reg_table->table[t])
+            continue;
+
+        for (size_t i = 0; i < reg_table->size[t]; i++)
+        {
+            struct RegistryLL* node = reg_table->table[t][i];
+            struct RegistryLL* next_node = NULL;
+
+            while (node)
+            {
+                int decref_ret = decref_obj(node->object);
+                if (decref_ret != 0)
+                {
+                    LOG_OUT(LOG_ERROR, "decref_obj() failed ptr=%p name=%s slot=%zu rtn=%d.",
+                            node->object, node->name, i, decref_ret);
+                    assert(decref_ret == 0);
+                }
+                else
+                    decref_obj_count++;
+                next_node = node->next;
+                free_node_count++; // storage released with the arena below
+                node = next_node;
+            }
         }
     }
 
     LOG_OUT(LOG_DEBUG,
             "reg_table teardown ended table=%p size=%zu decref_count=%zu free_node_count=%zu.",
-            reg_table, reg_table->size, decref_obj_count, free_node_count);
+            reg_table, reg_table->size[0], decref_obj_count, free_node_count);
 
-    free(reg_table->table);
-    free(reg_table);
+    mem_free(&allocator, reg_table->table[0], ALLOC_SITE_REG_TABLE);
+    mem_free(&allocator, reg_table->table[1], ALLOC_SITE_REG_TABLE);
+    reg_arena_destroy(reg_table->arena);
+    reg_handles_destroy(reg_table->handles);
+    reg_trie_destroy(reg_table->prefix);
+    reg_filter_destroy(reg_table->filter);
+    mem_free(&allocator, reg_table, ALLOC_SITE_REG_TABLE);
     return 0;
 }
 
 int add_binding(const char* name, struct ObjWrapper* object, struct RegistryHash* reg_table)
 {
     // return immediately on invalid input
-    if (!name || name[0] == '\0' || !object || !reg_table || reg_table->size == 0)
+    if (!name || name[0] == '\0' || !object || !is_valid_table(reg_table))
         return 1; // caller error
 
-    // local defines
-    size_t index = hash(name) % reg_table->size;
-    struct RegistryLL* prev_node = NULL;
-    struct RegistryLL* already_bound = find_node(&prev_node, reg_table, name, index);
-
-    // if name already bound
-    if (already_bound)
-    {
-        return add_binding_already_bound(object, &already_bound->object);
-    }
+    uint64_t h = hash(reg_table, name);
+    if (!reg_table->shards)
+        return add_binding_hashed(name, h, object, reg_table);
 
-    // if name is not bound create new node
-    return add_binding_new_binding(name, object, reg_table, index);
+    struct RegistryShard* shard = shard_for_hash(reg_table, h);
+    pthread_mutex_lock(&shard->lock);
+    int ret = add_binding_hashed(name, h, object, shard->reg);
+    pthread_mutex_unlock(&shard->lock);
+    return ret;
 }
 
 int remove_binding(const char* name, struct RegistryHash* reg_table)
 {
     // return immediately on invalid input
-    if (!name || name[0] == '\0' || !reg_table || reg_table->size == 0)
+    if (!name || name[0] == '\0' || !is_valid_table(reg_table))
         return 3; // caller error
 
-    // local defines
-    size_t index = hash(name) % reg_table->size;
-    struct RegistryLL* prev_node = NULL;
-    struct RegistryLL* found_node = find_node(&prev_node, reg_table, name, index);
-
-    // binding not found or missing wrapper
-    if (!found_node)
-        return 1;
-    if (!found_node->object)
-    {
-        LOG_OUT(LOG_ERROR, "missing object name=%s node_ptr=%p slot=%zu.", name, found_node, index);
-        return 4; // internal registry error
-    }
-
-    // remove/free the node
-    remove_node(found_node, prev_node, &reg_table->table[index]);
-    struct ObjWrapper* node_object =
-        found_node->object; // store for freeing after found_node released
-    free_registry_node(found_node);
-
-    // decrement the node wrapper
-    LOG_OUT(LOG_DEBUG, "calling decref_obj() obj=%p name=%s", node_object, name);
-    int decref_ret = decref_obj(node_object);
-    if (decref_ret != 0)
-    {
-        LOG_OUT(LOG_ERROR, "decref_obj() failed rtn=%d name=%s obj=%p slot=%zu.", decref_ret, name,
-                node_object, index);
-        assert(decref_ret == 0); // internal invariant violation
-    }
+    uint64_t h = hash(reg_table, name);
+    if (!reg_table->shards)
+        return remove_binding_hashed(name, h, reg_table);
 
-    return 0;
+    struct RegistryShard* shard = shard_for_hash(reg_table, h);
+    pthread_mutex_lock(&shard->lock);
+    int ret = remove_binding_hashed(name, h, shard->reg);
+    pthread_mutex_unlock(&shard->lock);
+    return ret;
 }
 
 struct ObjWrapper* lookup_binding(const char* name, struct RegistryHash* reg_table)
 {
-    if (!name || name[0] == '\0' || !reg_table || reg_table->size == 0)
+    if (!name || name[0] == '\0' || !is_valid_table(reg_table))
         return NULL; // caller error
-    size_t table_size = reg_table->size;
-    size_t index = hash(name) % table_size;
-    struct RegistryLL* prev = NULL;
 
-    struct RegistryLL* node = find_node(&prev, reg_table, name, index);
+    uint64_t h = hash(reg_table, name);
+    if (!reg_table->shards)
+        return lookup_binding_hashed(name, h, reg_table);
 
-    if (!node)
-        return NULL;
+    struct RegistryShard* shard = shard_for_hash(reg_table, h);
+    if (shard->reg->lockfree_reads && reg_ebr_enter())
+    {
+        struct ObjWrapper* object = lookup_binding_lockfree(name, h, shard->reg);
+        reg_ebr_exit();
+        return object;
+    }
 
-    return node->object;
+    pthread_mutex_lock(&shard->lock);
+    struct ObjWrapper* object = lookup_binding_hashed(name, h, shard->reg);
+    pthread_mutex_unlock(&shard->lock);
+    return object;
 }
 
 // Diagnostic: prints current registry bindings; no side effects
@@ -239,260 +591,2244 @@ int list_bindings(struct RegistryHash* reg_table)
 {
     if (!reg_table)
         return 1; // no reg_table
-    if (!reg_table->table)
+    if (!is_valid_table(reg_table))
         return 1; // no table
 
-    size_t table_size = reg_table->size;
-    struct RegistryLL** table = reg_table->table;
+    if (reg_table->shards)
+    {
+        for (size_t i = 0; i < reg_table->shard_count; i++)
+        {
+            pthread_mutex_lock(&reg_table->shards[i].lock);
+            list_bindings(reg_table->shards[i].reg);
+            pthread_mutex_unlock(&reg_table->shards[i].lock);
+        }
+        return 0;
+    }
+
+    if (reg_table->flat)
+    {
+        const char* name = NULL;
+        struct ObjWrapper* object = NULL;
+        for (size_t i = 0; i < reg_flat_capacity(reg_table->flat); i++)
+        {
+            if (reg_flat_slot(reg_table->flat, i, &name, &object))
+                printf("%s -> %p (type=%d, refs=%zu)\n", name, (void*)object, get_obj_type(object),
+                       debug_get_obj_refcount(object));
+        }
+        return 0;
+    }
+
     struct RegistryLL* node;
 
-    for (size_t i = 0; i < table_size; i++)
+    for (int t = 0; t < 2; t++)
     {
-        node = table[i];
-        while (node)
+        struct RegistryLL** table = reg_table->table[t];
+        if (!table)
+            continue;
+
+        for (size_t i = 0; i < reg_table->size[t]; i++)
         {
-            printf("%s -> %p (type=%d, refs=%zu)\n", node->name, (void*)node->object,
-                   get_obj_type(node->object), debug_get_obj_refcount(node->object));
-            node = node->next;
+            node = table[i];
+            while (node)
+            {
+                printf("%s -> %p (type=%d, refs=%zu)\n", node->name, (void*)node->object,
+                       get_obj_type(node->object), debug_get_obj_refcount(node->object));
+                node = node->next;
+            }
         }
     }
     return 0;
 }
-#pragma endregion
-
-#pragma region Private Functions
-/* ============================================================================
- * Private helper implementation
- * ============================================================================
- */
 
-//  Purpose: Hash func for binding registry.
-//  Input assumptions:
-//    s: null-terminated.
-//  Effects: None
-//  Returns:
-//    h: unsigned hash of s.
-//  Note: from K&R 'The C Programming Language'
-static unsigned int hash(const char* s)
+int resolve_binding(const char* name, struct RegistryHash* reg_table, struct BindingHandle* handle)
 {
-    unsigned int h = 0;
-    while (*s)
+    if (!name || name[0] == '\0' || !handle || !is_valid_table(reg_table))
+        return 3; // caller error
+
+    uint64_t h = hash(reg_table, name);
+    if (!reg_table->shards)
+        return resolve_binding_hashed(name, h, reg_table, handle);
+
+    struct RegistryShard* shard = shard_for_hash(reg_table, h);
+    pthread_mutex_lock(&shard->lock);
+    int ret = resolve_binding_hashed(name, h, shard->reg, handle);
+    pthread_mutex_unlock(&shard->lock);
+    if (ret == 0)
     {
-        h = h * 31 + *s++;
+        if (handle->index > (UINT32_MAX >> reg_table->shard_bits))
+            return 2; // shard-local index does not fit next to the shard bits
+        encode_handle(reg_table, shard, handle);
     }
-    return h;
+    return ret;
 }
 
-//  Purpose: Search for registry node by name.
-//  Input assumptions:
-//    prev_node: Previous node container provided by caller.
-//    index: Hash result on name provided by caller.
-//  Effects:
-//    prev_node populated if name not first element.
-//  Returns:
-//    Success: Registry node.
-//    Not found: NULL.
-//  Note: prev_node only valid on non_NULL return.
-static struct RegistryLL* find_node(struct RegistryLL** prev_node, struct RegistryHash* reg_table,
-                                    const char* name, size_t index)
+struct ObjWrapper* lookup_binding_handle(struct BindingHandle handle,
+                                         struct RegistryHash* reg_table)
 {
-    struct RegistryLL** table = reg_table->table;
-    *prev_node = NULL;
-
-    struct RegistryLL* node = table[index];
-    while (node)
+    if (reg_table && reg_table->shards)
     {
-        if (!strcmp(name, node->name))
-        {
-            return node;
-        }
-        *prev_node = node;
-        node = node->next;
+        struct RegistryShard* shard = shard_for_handle(reg_table, &handle);
+        pthread_mutex_lock(&shard->lock);
+        struct ObjWrapper* object = lookup_binding_handle(handle, shard->reg);
+        pthread_mutex_unlock(&shard->lock);
+        return object;
     }
 
-    return NULL;
-}
+    uintptr_t target = 0;
+    if (!reg_table || !reg_handles_resolve(reg_table->handles, handle, &target))
+        return NULL; // caller error or stale handle
 
-//  Purpose: Allocate and return copy of name.
-//  Input assumptions:
-//    name: NULL terminated.
-//  Effects: Heap allocation of name.
-//  Returns:
-//    Success: copied name char*
-//    Allocation failure: NULL
-//  Note: Copied name is owned/freed by registry node
-static char* copy_name(const char* name)
-{
-    size_t str_len = strlen(name) + 1;
-    char* name_copy = malloc(str_len);
-    if (!name_copy)
-        return NULL;
-    strcpy(name_copy, name);
-    return name_copy;
+    if (reg_table->flat)
+        return *reg_flat_object_at(reg_table->flat, (size_t)target);
+    return ((struct RegistryLL*)target)->object;
 }
 
-//  Purpose: Links `new_node` to the list headed by `*list_head`.
-//  Input assumptions: `new_node` and `list_head` exist.
-//  Effects: Registry extended with new node.
-//  Returns:
-//    0: Success.
-//    1: Invalid input.
-//  Note:
-static int add_node(struct RegistryLL* new_node, struct RegistryLL** list_head)
+int rebind_handle(struct BindingHandle* handle, struct ObjWrapper* object,
+                  struct RegistryHash* reg_table)
 {
-    if (!new_node || !list_head)
-        return 1; // call error
-    new_node->next = *list_head;
-    *list_head = new_node;
+    if (!handle || !object || !is_valid_table(reg_table))
+        return 3; // caller error
 
-    return 0;
-}
+    if (reg_table->shards)
+    {
+        struct BindingHandle local = *handle;
+        struct RegistryShard* shard = shard_for_handle(reg_table, &local);
+        pthread_mutex_lock(&shard->lock);
+        int ret = rebind_handle(&local, object, shard->reg);
+        pthread_mutex_unlock(&shard->lock);
+        encode_handle(reg_table, shard, &local);
+        *handle = local;
+        return ret;
+    }
 
-// Unlinks `node` from the list headed by `*list_head`.
-// Does NOT free `node` or `node->name`.
-// Caller is responsible for freeing memory and handling refcounts.
-static int remove_node(struct RegistryLL* node, struct RegistryLL* prev_node,
-                       struct RegistryLL** list_head)
-{
-    if (!node || !list_head)
-        return 3; // call error
-    if (!prev_node)
-        *list_head = node->next;
+    uintptr_t target = 0;
+    if (!reg_handles_resolve(reg_table->handles, *handle, &target))
+        return 1; // stale handle
+
+    struct ObjWrapper** slot = NULL;
+    struct ObjWrapper* bound = NULL;
+    const char* name = NULL;
+    uint64_t h = 0;
+    if (reg_table->flat)
+    {
+        slot = reg_flat_object_at(reg_table->flat, (size_t)target);
+        reg_flat_slot(reg_table->flat, (size_t)target, &name, &bound);
+        h = reg_flat_hash_at(reg_table->flat, (size_t)target);
+    }
     else
-        prev_node->next = node->next;
+    {
+        struct RegistryLL* node = (struct RegistryLL*)target;
+        slot = &node->object;
+        name = node->name;
+        h = node->hash;
+    }
+    if (*slot == object)
+        return 0; // already bound
 
-    return 0;
+    struct RegPmap* next = NULL;
+    int ret = stage_persist(reg_table, name, h, object, &next);
+    if (ret == 2)
+        return 2; // allocation failure
+    if (ret == 4)
+        return 5; // incref failure
+
+    thaw(reg_table);
+    ret = add_binding_already_bound(object, slot);
+    bool landed = (*slot == object);
+    finish_persist(reg_table, next, landed);
+    if (landed)
+        *handle = reg_handles_refresh(reg_table->handles, handle->index);
+    if (ret == 3)
+        return 4; // decref failure
+    if (ret == 4)
+        return 5; // incref failure
+    return ret;
 }
 
-//  Purpose: Helper function for add_binding() for name already bound.
-//  Input assumptions: Valid input assured by add_binding()
-//  Effects:
-//    - Nothing if `old_wrapper` == `new_wrapper`
-//    - Otherwise increment `new_wrapper`, decrement `old_wrapper`.
-//      Replace `old_wrapper` with `new_wrapper` in registry.
-//  Returns:
-//    0: On success.
-//    3: On failed decref_obj().
-//    4: On failed incref_obj().
-//  Notes: Failed decref_obj() is an invariant violation
-static int add_binding_already_bound(struct ObjWrapper* new_wrapper, struct ObjWrapper** slot)
+int remove_binding_handle(struct BindingHandle handle, struct RegistryHash* reg_table)
 {
-    if (new_wrapper == *slot)
-    { // already bound to object
-        LOG_OUT(LOG_DEBUG, "duplicate wrapper binding ignored wrapper=%p.", new_wrapper);
-        return 0;
+    if (!is_valid_table(reg_table))
+        return 3; // caller error
+
+    if (reg_table->shards)
+    {
+        struct RegistryShard* shard = shard_for_handle(reg_table, &handle);
+        pthread_mutex_lock(&shard->lock);
+        int ret = remove_binding_handle(handle, shard->reg);
+        pthread_mutex_unlock(&shard->lock);
+        return ret;
     }
-    else
-    { // name is bound to a different object (overwrite)
 
-        struct ObjWrapper* old_wrapper = *slot;
+    // migrate first: with lockfree_reads a step may move the target node
+    rehash_step(reg_table, REHASH_STEP_BUCKETS);
 
-        // increment new wrapper
-        int incref_ret = incref_obj(new_wrapper);
-        if (incref_ret != 0)
+    uintptr_t target = 0;
+    if (!reg_handles_resolve(reg_table->handles, handle, &target))
+        return 1; // stale handle
+
+    if (reg_table->flat)
+    {
+        const char* name = NULL;
+        struct ObjWrapper* erased_object = NULL;
+        struct RegPmap* next = NULL;
+        if (!reg_flat_slot(reg_table->flat, (size_t)target, &name, &erased_object))
         {
-            LOG_OUT(LOG_ERROR, "incref_obj failure wrapper=%p ret=%d.", new_wrapper, incref_ret);
-            return 4; // incref failure
+            LOG_OUT(LOG_ERROR, "handle index=%u targets empty flat slot=%zu.", handle.index,
+                    (size_t)target);
+            return 4; // internal registry error
         }
-        // replace found node object with caller `object`
-        *slot = new_wrapper;
+        if (stage_persist(reg_table, name, reg_flat_hash_at(reg_table->flat, (size_t)target),
+                          NULL, &next) != 0)
+            return 2; // allocation failure
+        thaw(reg_table);
+        finish_persist(reg_table, next, true);
+        if (reg_table->prefix)
+            reg_trie_remove(reg_table->prefix, name); // name is freed by the erase
+        reg_flat_erase_at(reg_table->flat, (size_t)target, &erased_object);
+        reg_table->count--;
+        note_removal(reg_table);
+        decref_removed(erased_object);
+        return 0;
+    }
 
-        // decrement previously bound wrapper
-        LOG_OUT(LOG_DEBUG, "calling decref_obj() after overwrite of ptr=%p type=%d", old_wrapper,
-                get_obj_type(old_wrapper));
-        int decref_ret = decref_obj(old_wrapper);
-        if (decref_ret != 0)
+    struct RegistryLL* node = (struct RegistryLL*)target;
+    struct RegistryLL* prev_node = NULL;
+    struct RegistryLL** list_head = NULL;
+    if (!find_node_links(&prev_node, &list_head, reg_table, node))
+    {
+        LOG_OUT(LOG_ERROR, "handle index=%u targets unlinked node=%p.", handle.index,
+                (void*)node);
+        return 4; // internal registry error
+    }
+    struct RegPmap* next = NULL;
+    if (stage_persist(reg_table, node->name, node->hash, NULL, &next) != 0)
+        return 2; // allocation failure
+    thaw(reg_table);
+    finish_persist(reg_table, next, true);
+
+    remove_node(node, prev_node, list_head);
+    reg_table->count--;
+    if (reg_table->prefix)
+        reg_trie_remove(reg_table->prefix, node->name);
+    note_removal(reg_table);
+    struct ObjWrapper* node_object = node->object;
+    free_registry_node(reg_table, node);
+    decref_removed(node_object);
+
+    maybe_shrink(reg_table);
+    return 0;
+}
+
+int registry_stats(struct RegistryHash* reg_table, struct RegistryStats* stats)
+{
+    if (!stats || !is_valid_table(reg_table))
+        return 1; // caller error
+
+    *stats = (struct RegistryStats){0};
+    size_t chain_total = 0;
+    size_t chains = 0;
+
+    if (reg_table->shards)
+    {
+        for (size_t i = 0; i < reg_table->shard_count; i++)
         {
-            LOG_OUT(LOG_ERROR, "decref_obj failure wrapper=%p ret=%d.", old_wrapper, decref_ret);
-            assert(decref_ret == 0); // invariant violation
-            return 3;
+            pthread_mutex_lock(&reg_table->shards[i].lock);
+            accumulate_stats(reg_table->shards[i].reg, stats, &chain_total, &chains);
+            pthread_mutex_unlock(&reg_table->shards[i].lock);
         }
-
-        LOG_OUT(LOG_DEBUG, "registry overwrite occurred: old=%p new=%p type=%d.", old_wrapper,
-                *slot, get_obj_type(new_wrapper));
-        return 0;
     }
+    else
+        accumulate_stats(reg_table, stats, &chain_total, &chains);
+
+    if (stats->buckets)
+        stats->load_factor = (double)stats->bindings / (double)stats->buckets;
+    if (chains)
+        stats->mean_chain = (double)chain_total / (double)chains;
+    if (stats->lookups)
+        stats->avg_lookup_probes = (double)stats->lookup_probes / (double)stats->lookups;
+    if (stats->adds)
+        stats->avg_add_probes = (double)stats->add_probes / (double)stats->adds;
+    if (stats->removes)
+        stats->avg_remove_probes = (double)stats->remove_probes / (double)stats->removes;
+    if (stats->filter_rejects + stats->filter_false_positives)
+        stats->filter_fpr = (double)stats->filter_false_positives /
+                            (double)(stats->filter_rejects + stats->filter_false_positives);
+    if (stats->bindings)
+        stats->filter_bits_per_binding =
+            (double)stats->filter_bytes * 8.0 / (double)stats->bindings;
+    return 0;
 }
 
-//  Purpose: Helper function for add_binding() when name is not already bound.
-//  Input Assumptions: Valid input already assured by add_binding().
-//  Effects: New node added to Registry linked list.
-//  Returns:
-//    0: Success.
-//    2: Allocation failure.
-//    3: decref_obj() failure.
-//    4: incref_obj() failure.
-//    5: add_node() failure.
-//  Notes: Failed decref_obj() is an invariant violation
-static int add_binding_new_binding(const char* name, struct ObjWrapper* new_wrapper,
-                                   struct RegistryHash* reg_table, size_t index)
+int reserve_bindings(struct RegistryHash* reg_table, size_t additional)
 {
-    char* new_name = copy_name(name);
-    if (!new_name)
+    if (!is_valid_table(reg_table))
+        return 3; // caller error
+
+    if (reg_table->shards)
     {
-        LOG_OUT(LOG_ERROR, "failed to copy name=%s for ptr=%p", name, new_wrapper);
-        return 2; // allocation failure
+        // names spread evenly over shards; leave 1/8 slack for the variance
+        size_t per_shard = additional / reg_table->shard_count;
+        per_shard += per_shard / 8 + 1;
+        int ret = 0;
+        for (size_t i = 0; i < reg_table->shard_count; i++)
+        {
+            pthread_mutex_lock(&reg_table->shards[i].lock);
+            if (reserve_bindings(reg_table->shards[i].reg, per_shard) != 0)
+                ret = 2;
+            pthread_mutex_unlock(&reg_table->shards[i].lock);
+        }
+        return ret;
     }
 
-    struct RegistryLL* new_node = malloc(sizeof(struct RegistryLL));
-    if (!new_node)
+    size_t needed = reg_table->count + additional;
+    if (reg_table->flat)
+        return reg_flat_reserve(reg_table->flat, needed);
+
+    int t = (reg_table->rehash_index != REHASH_IDLE) ? 1 : 0;
+    if (needed <= reg_table->size[t] * LOAD_FACTOR_GROW_NUM)
+        return 0;
+    if (reg_table->lockfree_reads)
     {
-        LOG_OUT(LOG_ERROR, "failed to allocate %zu bytes for registry node.",
-                sizeof(struct RegistryLL));
-        free(new_name);
-        return 2; // allocation failure
+        if (t == 1)
+            return 0; // readers may still hold the current rehash; grow on demand
+        return start_rehash(reg_table, next_prime(needed / LOAD_FACTOR_GROW_NUM));
+    }
+
+    finish_rehash(reg_table);
+    if (start_rehash(reg_table, next_prime(needed / LOAD_FACTOR_GROW_NUM)) != 0)
+        return 2; // allocation failure
+    finish_rehash(reg_table); // one pass now instead of steps interleaved with the load
+    return 0;
+}
+
+int for_each_binding_prefix(struct RegistryHash* reg_table, const char* prefix,
+                            binding_visit_fn visit, void* ctx)
+{
+    if (!prefix || !visit || !is_valid_table(reg_table))
+        return 1; // caller error
+
+    struct RegTrieNames names = {0};
+    int ret = 0;
+    if (reg_table->shards)
+    {
+        if (!reg_table->shards[0].reg->prefix)
+            return 4; // no prefix index
+        for (size_t i = 0; ret == 0 && i < reg_table->shard_count; i++)
+        {
+            pthread_mutex_lock(&reg_table->shards[i].lock);
+            ret = reg_trie_collect(reg_table->shards[i].reg->prefix, prefix, &names);
+            pthread_mutex_unlock(&reg_table->shards[i].lock);
+        }
+    }
+    else if (!reg_table->prefix)
+        return 4; // no prefix index
+    else
+        ret = reg_trie_collect(reg_table->prefix, prefix, &names);
+
+    // visit outside any lock so the callback may modify the registry
+    const char* name = names.data;
+    for (size_t i = 0; ret == 0 && i < names.count; i++)
+    {
+        if (visit(ctx, name) != 0)
+            break;
+        name += strlen(name) + 1;
+    }
+
+    reg_trie_names_free(&names);
+    return ret;
+}
+
+int remove_bindings_prefix(struct RegistryHash* reg_table, const char* prefix, size_t* removed)
+{
+    size_t local_removed = 0;
+    if (!removed)
+        removed = &local_removed;
+    *removed = 0;
+
+    if (!prefix || !is_valid_table(reg_table))
+        return 1; // caller error
+
+    if (!reg_table->shards)
+        return reg_table->prefix ? remove_prefix_local(reg_table, prefix, removed) : 4;
+
+    if (!reg_table->shards[0].reg->prefix)
+        return 4; // no prefix index
+    int ret = 0;
+    for (size_t i = 0; i < reg_table->shard_count; i++)
+    {
+        pthread_mutex_lock(&reg_table->shards[i].lock);
+        if (remove_prefix_local(reg_table->shards[i].reg, prefix, removed) != 0)
+            ret = 2;
+        pthread_mutex_unlock(&reg_table->shards[i].lock);
+    }
+    return ret;
+}
+
+int freeze_registry(struct RegistryHash* reg_table)
+{
+    if (!is_valid_table(reg_table))
+        return 3; // caller error
+
+    if (!reg_table->shards)
+        return freeze_local(reg_table);
+
+    int ret = 0;
+    for (size_t i = 0; i < reg_table->shard_count; i++)
+    {
+        pthread_mutex_lock(&reg_table->shards[i].lock);
+        int shard_ret = freeze_local(reg_table->shards[i].reg);
+        pthread_mutex_unlock(&reg_table->shards[i].lock);
+        if (ret == 0)
+            ret = shard_ret;
+    }
+    return ret;
+}
+
+int snapshot_registry(struct RegistryHash* reg_table, struct RegSnapshot** out)
+{
+    if (!out)
+        return 3; // caller error
+    *out = NULL;
+    if (!is_valid_table(reg_table))
+        return 3; // caller error
+
+    size_t n = reg_table->shards ? reg_table->shard_count : 1;
+    const struct LinalgAllocator* allocator = &reg_table->allocator;
+    struct RegSnapshot* snapshot =
+        mem_calloc(allocator, 1, sizeof(struct RegSnapshot) + n * sizeof(struct RegPmap*),
+                   ALLOC_SITE_REG_SNAPSHOT);
+    if (!snapshot)
+    {
+        LOG_OUT(LOG_ERROR, "failed to allocate snapshot of %zu shards.", n);
+        return 2;
+    }
+    snapshot->allocator = *allocator;
+    snapshot->seed = reg_table->seed;
+    snapshot->shard_bits = reg_table->shards ? reg_table->shard_bits : 0;
+    snapshot->root_count = n;
+
+    // registries built without config->snapshots start their persistent map
+    // on the first snapshot, one shard lock at a time
+    for (size_t i = 0; i < n; i++)
+    {
+        struct RegistryHash* shard = shard_reg(reg_table, i);
+        if (reg_table->shards)
+            pthread_mutex_lock(&reg_table->shards[i].lock);
+        int ret = shard->snapshots ? 0 : enable_snapshots(shard);
+        if (reg_table->shards)
+            pthread_mutex_unlock(&reg_table->shards[i].lock);
+        if (ret != 0)
+        {
+            mem_free(allocator, snapshot, ALLOC_SITE_REG_SNAPSHOT);
+            return ret;
+        }
+    }
+
+    // One cut across all shards: every lock is held at once, but only to
+    // retain each shard's current root.
+    for (size_t i = 0; reg_table->shards && i < n; i++)
+        pthread_mutex_lock(&reg_table->shards[i].lock);
+    for (size_t i = 0; i < n; i++)
+    {
+        snapshot->roots[i] = shard_reg(reg_table, i)->persist;
+        reg_pmap_retain(snapshot->roots[i]);
+        snapshot->count += reg_pmap_count(snapshot->roots[i]);
+    }
+    for (size_t i = n; reg_table->shards && i-- > 0;)
+        pthread_mutex_unlock(&reg_table->shards[i].lock);
+
+    LOG_OUT(LOG_DEBUG, "snapshot=%p of reg_table=%p bindings=%zu.", snapshot, reg_table,
+            snapshot->count);
+    *out = snapshot;
+    return 0;
+}
+
+struct ObjWrapper* snapshot_lookup(const struct RegSnapshot* snapshot, const char* name)
+{
+    if (!snapshot || !name || name[0] == '\0')
+        return NULL; // caller error
+
+    uint64_t h = hash_seeded(snapshot->seed, name);
+    size_t i = snapshot->shard_bits ? (size_t)(h >> (64 - snapshot->shard_bits)) : 0;
+    return reg_pmap_find(snapshot->roots[i], name, h);
+}
+
+size_t snapshot_count(const struct RegSnapshot* snapshot)
+{
+    return snapshot ? snapshot->count : 0;
+}
+
+int release_snapshot(struct RegSnapshot* snapshot)
+{
+    if (!snapshot)
+        return 0; // no snapshot is noop
+
+    struct LinalgAllocator allocator = snapshot->allocator;
+    for (size_t i = 0; i < snapshot->root_count; i++)
+        reg_pmap_release(snapshot->roots[i], &allocator);
+    mem_free(&allocator, snapshot, ALLOC_SITE_REG_SNAPSHOT);
+    return 0;
+}
+
+/* ============================================================================
+ * Public debug functions
+ * ============================================================================
+ */
+size_t debug_get_reg_bucket_count(const struct RegistryHash* reg_table)
+{
+    if (!reg_table)
+        return 0; // invalid input
+
+    if (reg_table->shards)
+    {
+        size_t total = 0;
+        for (size_t i = 0; i < reg_table->shard_count; i++)
+        {
+            pthread_mutex_lock(&reg_table->shards[i].lock);
+            total += debug_get_reg_bucket_count(reg_table->shards[i].reg);
+            pthread_mutex_unlock(&reg_table->shards[i].lock);
+        }
+        return total;
+    }
+
+    if (reg_table->flat)
+        return reg_flat_capacity(reg_table->flat);
+
+    // while rehashing, report the table the registry is converging on
+    if (reg_table->rehash_index != REHASH_IDLE)
+        return reg_table->size[1];
+    return reg_table->size[0];
+}
+#pragma endregion
+
+#pragma region Private Functions
+/* ============================================================================
+ * Private helper implementation
+ * ============================================================================
+ */
+
+//  Purpose: Hash func for binding registry.
+//  Input assumptions:
+//    s: null-terminated.
+//  Effects: None
+//  Returns:
+//    64-bit hash of s keyed by reg_table->seed.
+static uint64_t hash(const struct RegistryHash* reg_table, const char* s)
+{
+    return hash_seeded(reg_table->seed, s);
+}
+
+//  Purpose: Registry hash of s under an explicit seed (see hash()).
+//  Input assumptions:
+//    s: null-terminated.
+//  Effects: None
+//  Returns:
+//    64-bit hash of s keyed by seed.
+//  Note: wyhash-style multiply/fold over 16-byte blocks. Every input byte and
+//    the length pass through a 64x64->128 multiply, so names differing only
+//    in a few digits still land far apart, and outputs are unpredictable
+//    without the seed.
+static uint64_t hash_seeded(uint64_t seed, const char* s)
+{
+    const uint64_t k0 = 0xa0761d6478bd642full;
+    const uint64_t k1 = 0xe7037ed1a0b428dbull;
+    const unsigned char* p = (const unsigned char*)s;
+    size_t len = strlen(s);
+    uint64_t h = seed ^ mix_mul(seed ^ k0, (uint64_t)len ^ k1);
+    uint64_t a = 0;
+    uint64_t b = 0;
+
+    size_t rem = len;
+    while (rem > 16)
+    {
+        h = mix_mul(read_u64(p) ^ k1, read_u64(p + 8) ^ h);
+        p += 16;
+        rem -= 16;
+    }
+
+    if (rem >= 8)
+    { // two overlapping words cover 8..16 bytes
+        a = read_u64(p);
+        b = read_u64(p + rem - 8);
+    }
+    else
+    {
+        for (size_t i = 0; i < rem; i++)
+            a |= (uint64_t)p[i] << (8 * i);
+    }
+
+    return mix_mul(k1 ^ len, mix_mul(a ^ k1, b ^ h));
+}
+
+//  Purpose: Multiply two words to 128 bits and fold the halves together.
+//  Input assumptions: None.
+//  Effects: None.
+//  Returns: low64(a*b) ^ high64(a*b).
+static inline uint64_t mix_mul(uint64_t a, uint64_t b)
+{
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 r = (unsigned __int128)a * b;
+    return (uint64_t)r ^ (uint64_t)(r >> 64);
+#else
+    uint64_t a_lo = (uint32_t)a, a_hi = a >> 32;
+    uint64_t b_lo = (uint32_t)b, b_hi = b >> 32;
+    uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo;
+    uint64_t lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+    uint64_t cross = (lo_lo >> 32) + (uint32_t)hi_lo + lo_hi;
+    uint64_t lo = (cross << 32) | (uint32_t)lo_lo;
+    uint64_t hi = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+    return lo ^ hi;
+#endif
+}
+
+//  Purpose: Unaligned native-endian 8-byte load.
+//  Input assumptions: p has 8 readable bytes.
+//  Effects: None.
+//  Returns: Loaded word.
+static inline uint64_t read_u64(const unsigned char* p)
+{
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+//  Purpose: Produce a per-registry seed when the caller does not supply one.
+//  Input assumptions: salt is any address unique to the registry.
+//  Effects: Advances a file-local counter.
+//  Returns: Non-zero 64-bit seed.
+//  Note: Mixes wall clock, the registry address and a counter through the
+//    splitmix64 finalizer; not cryptographic, but not guessable from names.
+static uint64_t make_seed(const void* salt)
+{
+    static uint64_t counter = 0;
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+
+    uint64_t z = (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+    z ^= (uint64_t)(uintptr_t)salt;
+    z += 0x9e3779b97f4a7c15ull * ++counter;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    z ^= z >> 31;
+    return z ? z : 0x9e3779b97f4a7c15ull;
+}
+
+//  Purpose: Check that reg_table was produced by init_reg_table_config().
+//  Input assumptions: None.
+//  Effects: None.
+//  Returns: true when reg_table is non-NULL and has backend storage (or shards).
+static bool is_valid_table(const struct RegistryHash* reg_table)
+{
+    if (!reg_table)
+        return false;
+    if (reg_table->shards)
+        return true;
+    if (reg_table->backend == REG_BACKEND_FLAT)
+        return reg_table->flat != NULL;
+    return reg_table->table[0] != NULL && reg_table->size[0] > 0;
+}
+
+//  Purpose: Search for registry node by name.
+//  Input assumptions:
+//    prev_node: Previous node container provided by caller.
+//    list_head: Bucket head container provided by caller.
+//    h: hash() of name provided by caller.
+//    probes: Probe counter provided by caller.
+//  Effects:
+//    prev_node populated if name not first element.
+//    list_head populated with the bucket slot holding the found node.
+//    *probes incremented once per node visited.
+//  Returns:
+//    Success: Registry node.
+//    Not found: NULL.
+//  Note: prev_node and list_head only valid on non-NULL return. Searches
+//    table[0] then, while rehashing, table[1].
+static struct RegistryLL* find_node(struct RegistryLL** prev_node, struct RegistryLL*** list_head,
+                                    const struct RegistryHash* reg_table, const char* name,
+                                    uint64_t h, size_t* probes)
+{
+    for (int t = 0; t < 2; t++)
+    {
+        struct RegistryLL** table = reg_table->table[t];
+        if (!table)
+            break;
+
+        struct RegistryLL** head = &table[h % reg_table->size[t]];
+        *prev_node = NULL;
+
+        struct RegistryLL* node = *head;
+        while (node)
+        {
+            (*probes)++;
+            if (node->hash == h && !strcmp(name, node->name))
+            {
+                *list_head = head;
+                return node;
+            }
+            *prev_node = node;
+            node = node->next;
+        }
+    }
+
+    return NULL;
+}
+
+//  Purpose: Return the bucket slot new nodes with hash `h` are linked into.
+//  Input assumptions: reg_table valid.
+//  Effects: None.
+//  Returns: Bucket head in table[1] while rehashing, table[0] otherwise.
+//  Note: Never inserts behind rehash_index, so migrated buckets stay empty.
+static struct RegistryLL** insert_bucket(struct RegistryHash* reg_table, uint64_t h)
+{
+    int t = (reg_table->rehash_index != REHASH_IDLE) ? 1 : 0;
+    return &reg_table->table[t][h % reg_table->size[t]];
+}
+
+//  Purpose: Begin incremental migration of table[0] into a table of new_size.
+//  Input assumptions: No rehash in progress; new_size > 0.
+//  Effects: Allocates table[1]; sets rehash_index to 0.
+//  Returns:
+//    0: Rehash started.
+//    2: Allocation failure; registry unchanged and keeps working at the
+//       current size.
+//  Note: Allocation failure is not surfaced to callers, growth is retried on
+//    the next insert.
+static int start_rehash(struct RegistryHash* reg_table, size_t new_size)
+{
+    struct RegistryLL** new_table = mem_calloc(&reg_table->allocator, new_size,
+                                               sizeof(struct RegistryLL*), ALLOC_SITE_REG_TABLE);
+    if (!new_table)
+    {
+        LOG_OUT(LOG_WARNING, "failed to allocate %zu bytes for rehash %zu->%zu buckets.",
+                new_size * sizeof(struct RegistryLL*), reg_table->size[0], new_size);
+        return 2;
+    }
+
+    if (reg_table->lockfree_reads)
+    {
+        // reserve the completion view now so finishing can never fail
+        struct RegTableView* done_view =
+            mem_alloc(&reg_table->allocator, sizeof(struct RegTableView), ALLOC_SITE_REG_TABLE);
+        struct RegTableView* view =
+            mem_alloc(&reg_table->allocator, sizeof(struct RegTableView), ALLOC_SITE_REG_TABLE);
+        if (!done_view || !view)
+        {
+            LOG_OUT(LOG_WARNING, "failed to allocate views for rehash %zu->%zu buckets.",
+                    reg_table->size[0], new_size);
+            mem_free(&reg_table->allocator, done_view, ALLOC_SITE_REG_TABLE);
+            mem_free(&reg_table->allocator, view, ALLOC_SITE_REG_TABLE);
+            mem_free(&reg_table->allocator, new_table, ALLOC_SITE_REG_TABLE);
+            return 2;
+        }
+        *done_view = (struct RegTableView){{new_table, NULL}, {new_size, 0}};
+        reg_table->done_view = done_view;
+        *view = (struct RegTableView){{reg_table->table[0], new_table},
+                                      {reg_table->size[0], new_size}};
+        publish_view(reg_table, view);
+        reg_table->rehash_epoch = reg_ebr_epoch();
+    }
+
+    reg_table->table[1] = new_table;
+    reg_table->size[1] = new_size;
+    reg_table->rehash_index = 0;
+
+    LOG_OUT(LOG_DEBUG, "rehash started reg_table=%p size=%zu->%zu count=%zu.", reg_table,
+            reg_table->size[0], new_size, reg_table->count);
+    return 0;
+}
+
+//  Purpose: Migrate up to num_buckets non-empty buckets from table[0] into
+//    table[1].
+//  Input assumptions: reg_table valid.
+//  Effects:
+//    - Nodes relinked (not reallocated) into table[1]; rehash_index advanced.
+//      With lockfree_reads, nodes are copied instead and the originals
+//      retired; nothing moves until readers have dropped the pre-rehash view.
+//    - Visits at most REHASH_MAX_EMPTY_VISITS empty buckets so sparse tables
+//      cannot stall a single call.
+//    - Completes the rehash (swaps tables) once table[0] is drained.
+//  Returns: 0 in all cases (no-op when idle or when a copy cannot be
+//    allocated; migration resumes on a later call).
+static int rehash_step(struct RegistryHash* reg_table, size_t num_buckets)
+{
+    if (reg_table->rehash_index == REHASH_IDLE)
+        return 0;
+    if (reg_table->lockfree_reads && !reg_ebr_safe(reg_table->rehash_epoch))
+    {
+        reg_ebr_try_advance();
+        if (!reg_ebr_safe(reg_table->rehash_epoch))
+            return 0; // a reader may still only know table[0]
+    }
+
+    size_t empty_visits = REHASH_MAX_EMPTY_VISITS;
+    struct RegistryLL** old_table = reg_table->table[0];
+    struct RegistryLL** new_table = reg_table->table[1];
+
+    while (num_buckets > 0 && reg_table->rehash_index < reg_table->size[0])
+    {
+        struct RegistryLL* node = old_table[reg_table->rehash_index];
+        if (!node)
+        {
+            reg_table->rehash_index++;
+            if (--empty_visits == 0)
+                break;
+            continue;
+        }
+
+        if (reg_table->lockfree_reads)
+        {
+            if (migrate_bucket_copies(reg_table, reg_table->rehash_index) != 0)
+                return 0; // allocation failure; retry on a later call
+        }
+        else
+        {
+            while (node)
+            {
+                struct RegistryLL* next_node = node->next;
+                add_node(node, &new_table[node->hash % reg_table->size[1]]);
+                node = next_node;
+            }
+            old_table[reg_table->rehash_index] = NULL;
+        }
+        reg_table->rehash_index++;
+        num_buckets--;
+    }
+
+    if (reg_table->rehash_index >= reg_table->size[0])
+    {
+        if (reg_table->lockfree_reads)
+        {
+            publish_view(reg_table, reg_table->done_view);
+            reg_table->done_view = NULL;
+            retire(reg_table, reg_table->table[0], reclaim_block);
+        }
+        else
+            mem_free(&reg_table->allocator, reg_table->table[0], ALLOC_SITE_REG_TABLE);
+        reg_table->table[0] = reg_table->table[1];
+        reg_table->size[0] = reg_table->size[1];
+        reg_table->table[1] = NULL;
+        reg_table->size[1] = 0;
+        reg_table->rehash_index = REHASH_IDLE;
+
+        LOG_OUT(LOG_DEBUG, "rehash completed reg_table=%p size=%zu count=%zu.", reg_table,
+                reg_table->size[0], reg_table->count);
+    }
+
+    return 0;
+}
+
+//  Purpose: Drain any in-progress rehash in a single call.
+//  Input assumptions: reg_table valid.
+//  Effects: All nodes end up in table[0]; registry idle on return.
+//  Returns: 0 in all cases.
+//  Note: Only used when a new resize is required before the current one has
+//    been amortized away. Never used with lockfree_reads, where migration may
+//    have to wait for readers.
+static int finish_rehash(struct RegistryHash* reg_table)
+{
+    while (reg_table->rehash_index != REHASH_IDLE)
+        rehash_step(reg_table, reg_table->size[0]);
+    return 0;
+}
+
+//  Purpose: Start growing the table if inserting one more binding would
+//    exceed the grow load factor.
+//  Input assumptions: reg_table valid.
+//  Effects: May drain a pending rehash and start a new one. With
+//    lockfree_reads a pending rehash is left to finish incrementally first.
+//  Returns: 0 in all cases; allocation failure leaves the table as-is.
+static int maybe_grow(struct RegistryHash* reg_table)
+{
+    int t = (reg_table->rehash_index != REHASH_IDLE) ? 1 : 0;
+    if (reg_table->count + 1 <= reg_table->size[t] * LOAD_FACTOR_GROW_NUM)
+        return 0;
+    if (t == 1 && reg_table->lockfree_reads)
+        return 0; // chains run long until readers let the current rehash finish
+
+    finish_rehash(reg_table);
+    start_rehash(reg_table, next_prime(reg_table->size[0] * 2 + 1));
+    return 0;
+}
+
+//  Purpose: Start shrinking the table once load falls below the shrink
+//    threshold.
+//  Input assumptions: reg_table valid.
+//  Effects: May start a rehash into a smaller table; never shrinks below the
+//    size passed to init_reg_table().
+//  Returns: 0 in all cases.
+static int maybe_shrink(struct RegistryHash* reg_table)
+{
+    if (reg_table->rehash_index != REHASH_IDLE)
+        return 0; // let the current rehash finish first
+    if (reg_table->size[0] <= reg_table->min_size)
+        return 0;
+    if (reg_table->count >= reg_table->size[0] / LOAD_FACTOR_SHRINK_DIV)
+        return 0;
+
+    size_t new_size = next_prime(reg_table->count * 2 + 1);
+    if (new_size < reg_table->min_size)
+        new_size = reg_table->min_size;
+    if (new_size >= reg_table->size[0])
+        return 0;
+
+    start_rehash(reg_table, new_size);
+    return 0;
+}
+
+//  Purpose: Return the smallest prime >= n (bucket counts stay prime so the
+//    modulo uses all bits of hash()).
+//  Input assumptions: None.
+//  Effects: None.
+//  Returns: Prime >= n (2 for n < 2).
+static size_t next_prime(size_t n)
+{
+    if (n <= 2)
+        return 2;
+    if (n % 2 == 0)
+        n++;
+    for (;; n += 2)
+    {
+        bool is_prime = true;
+        for (size_t d = 3; d * d <= n; d += 2)
+        {
+            if (n % d == 0)
+            {
+                is_prime = false;
+                break;
+            }
+        }
+        if (is_prime)
+            return n;
+    }
+}
+
+//  Purpose: Links `new_node` to the list headed by `*list_head`.
+//  Input assumptions: `new_node` and `list_head` exist.
+//  Effects: Registry extended with new node.
+//  Returns:
+//    0: Success.
+//    1: Invalid input.
+//  Note:
+static int add_node(struct RegistryLL* new_node, struct RegistryLL** list_head)
+{
+    if (!new_node || !list_head)
+        return 1; // call error
+    new_node->next = *list_head;
+    publish_node(list_head, new_node);
+
+    return 0;
+}
+
+// Unlinks `node` from the list headed by `*list_head`.
+// Does NOT free `node` or `node->name`.
+// Caller is responsible for freeing memory and handling refcounts.
+static int remove_node(struct RegistryLL* node, struct RegistryLL* prev_node,
+                       struct RegistryLL** list_head)
+{
+    if (!node || !list_head)
+        return 3; // call error
+    if (!prev_node)
+        publish_node(list_head, node->next);
+    else
+        publish_node(&prev_node->next, node->next);
+
+    return 0;
+}
+
+//  Purpose: Helper function for add_binding() for name already bound.
+//  Input assumptions: Valid input assured by add_binding()
+//  Effects:
+//    - Nothing if `old_wrapper` == `new_wrapper`
+//    - Otherwise increment `new_wrapper`, decrement `old_wrapper`.
+//      Replace `old_wrapper` with `new_wrapper` in registry.
+//  Returns:
+//    0: On success.
+//    3: On failed decref_obj().
+//    4: On failed incref_obj().
+//  Notes: Failed decref_obj() is an invariant violation
+static int add_binding_already_bound(struct ObjWrapper* new_wrapper, struct ObjWrapper** slot)
+{
+    if (new_wrapper == *slot)
+    { // already bound to object
+        LOG_OUT(LOG_DEBUG, "duplicate wrapper binding ignored wrapper=%p.", new_wrapper);
+        return 0;
+    }
+    else
+    { // name is bound to a different object (overwrite)
+
+        struct ObjWrapper* old_wrapper = *slot;
+
+        // increment new wrapper
+        int incref_ret = incref_obj(new_wrapper);
+        if (incref_ret != 0)
+        {
+            LOG_OUT(LOG_ERROR, "incref_obj failure wrapper=%p ret=%d.", new_wrapper, incref_ret);
+            return 4; // incref failure
+        }
+        // replace found node object with caller `object`
+        publish_object(slot, new_wrapper);
+
+        // decrement previously bound wrapper
+        LOG_OUT(LOG_DEBUG, "calling decref_obj() after overwrite of ptr=%p type=%d", old_wrapper,
+                get_obj_type(old_wrapper));
+        int decref_ret = decref_obj(old_wrapper);
+        if (decref_ret != 0)
+        {
+            LOG_OUT(LOG_ERROR, "decref_obj failure wrapper=%p ret=%d.", old_wrapper, decref_ret);
+            assert(decref_ret == 0); // invariant violation
+            return 3;
+        }
+
+        LOG_OUT(LOG_DEBUG, "registry overwrite occurred: old=%p new=%p type=%d.", old_wrapper,
+                *slot, get_obj_type(new_wrapper));
+        return 0;
+    }
+}
+
+//  Purpose: Helper function for add_binding() when name is not already bound.
+//  Input Assumptions: Valid input already assured by add_binding();
+//    `list_head` is the insert bucket for `name`.
+//  Effects: New node added to Registry linked list.
+//  Returns:
+//    0: Success.
+//    2: Allocation failure.
+//    3: decref_obj() failure.
+//    4: incref_obj() failure.
+//    5: add_node() failure.
+//  Notes: Failed decref_obj() is an invariant violation
+static int add_binding_new_binding(const char* name, uint64_t h, struct ObjWrapper* new_wrapper,
+                                   struct RegistryHash* reg_table, struct RegistryLL** list_head)
+{
+    char* new_name = reg_arena_copy_name(reg_table->arena, name);
+    if (!new_name)
+    {
+        LOG_OUT(LOG_ERROR, "failed to copy name=%s for ptr=%p", name, new_wrapper);
+        return 2; // allocation failure
+    }
+
+    struct RegistryLL* new_node = reg_arena_alloc_node(reg_table->arena);
+    if (!new_node)
+    {
+        LOG_OUT(LOG_ERROR, "failed to allocate %zu bytes for registry node.",
+                sizeof(struct RegistryLL));
+        reg_arena_free_name(reg_table->arena, new_name);
+        return 2; // allocation failure
     }
 
     // populate new node
+    new_node->hash = h;
     new_node->name = new_name;
     new_node->next = NULL;
     new_node->object = new_wrapper;
+    new_node->handle_slot = REG_HANDLE_NONE;
+
+    // increment new wrapper
+    int incref_ret = incref_obj(new_node->object);
+    if (incref_ret)
+    {
+        LOG_OUT(LOG_ERROR, "incref_obj() failed with ret=%d.", incref_ret);
+        free_registry_node(reg_table, new_node);
+        return 4; // incref failure
+    }
+
+    // add new node
+    int add_node_return = add_node(new_node, list_head);
+    // successfully added node
+    if (add_node_return == 0)
+    {
+        LOG_OUT(LOG_DEBUG, "added object binding name=%s ptr=%p.", name, new_wrapper);
+        return 0;
+    }
+
+    // failed to add new node
+    else
+    {
+        LOG_OUT(LOG_ERROR, "add_node() failed name=%s ptr=%p ret=%d calling decref_obj().", name,
+                new_node, add_node_return);
+        int decref_ret = decref_obj(new_wrapper);
+        free_registry_node(reg_table, new_node);
+        if (decref_ret != 0)
+        {
+            assert(decref_ret == 0); // invariant violation
+            return 3;
+        }
+        return 5; // add_node() failure
+    }
+}
+
+//  Purpose: Helper function for add_binding() on the flat backend when name is
+//    not already bound.
+//  Input Assumptions: Valid input assured by add_binding(); name not in table.
+//  Effects: Slot added to the flat table, then `new_wrapper` retained.
+//  Returns:
+//    0: Success.
+//    2: Allocation failure (no refcount change).
+//    4: incref_obj() failure (slot removed again).
+//  Notes: Storage is reserved before incref_obj() so an allocation failure
+//    never touches the object's refcount.
+static int add_binding_new_flat(const char* name, struct ObjWrapper* new_wrapper,
+                                struct RegistryHash* reg_table, uint64_t h)
+{
+    if (reg_flat_insert(reg_table->flat, name, h, new_wrapper) != 0)
+        return 2; // allocation failure
+
+    int incref_ret = incref_obj(new_wrapper);
+    if (incref_ret)
+    {
+        LOG_OUT(LOG_ERROR, "incref_obj() failed with ret=%d.", incref_ret);
+        struct ObjWrapper* erased_object = NULL;
+        reg_flat_erase(reg_table->flat, name, h, &erased_object);
+        return 4; // incref failure
+    }
+
+    LOG_OUT(LOG_DEBUG, "added object binding name=%s ptr=%p backend=FLAT.", name, new_wrapper);
+    return 0;
+}
+
+//  Purpose: Helper function to release 'node' and 'node->name'.
+//  Input Assumptions: Caller assures `node` and `node->name` exist and that
+//    `node` is no longer linked.
+//  Effects: `node` and `node->name` returned to the registry arena free lists
+//    (retired first with lockfree_reads); any handle directory slot released.
+//  Returns: 0 in all cases.
+//  Notes: None.
+static int free_registry_node(struct RegistryHash* reg_table, struct RegistryLL* node)
+{
+    if (node->handle_slot != REG_HANDLE_NONE)
+        reg_handles_release(reg_table->handles, node->handle_slot - 1);
+    if (reg_table->lockfree_reads)
+    {
+        retire(reg_table, node->name, reclaim_name);
+        retire(reg_table, node, reclaim_node);
+        return 0;
+    }
+    reg_arena_free_name(reg_table->arena, node->name);
+    reg_arena_free_node(reg_table->arena, node);
+
+    return 0;
+}
+
+//  Purpose: Rebind an existing entry and invalidate its outstanding handles.
+//  Input Assumptions: `slot` is the object field of the entry bound to name;
+//    `handle_slot` is the
+//    entry's directory field; h == hash(name).
+//  Effects: As add_binding_already_bound(); if the bound object changes the
+//    snapshot map is updated and the registry thawed first, and if the entry
+//    has been resolved its directory generation is refreshed.
+//  Returns: add_binding_already_bound() codes, or 2 on allocation failure
+//    (entry unchanged).
+static int rebind_entry(struct RegistryHash* reg_table, const char* name, uint64_t h,
+                        struct ObjWrapper* new_wrapper, struct ObjWrapper** slot,
+                        uint32_t handle_slot)
+{
+    if (*slot == new_wrapper)
+        return add_binding_already_bound(new_wrapper, slot); // no-op
+
+    struct RegPmap* next = NULL;
+    int ret = stage_persist(reg_table, name, h, new_wrapper, &next);
+    if (ret != 0)
+        return ret;
+    thaw(reg_table);
+    ret = add_binding_already_bound(new_wrapper, slot);
+    bool landed = (*slot == new_wrapper);
+    finish_persist(reg_table, next, landed);
+    if (landed && handle_slot != REG_HANDLE_NONE)
+        reg_handles_refresh(reg_table->handles, handle_slot - 1);
+    return ret;
+}
+
+//  Purpose: Locate the bucket and predecessor of a known node without
+//    comparing names.
+//  Input Assumptions: `node` is linked into table[0] or table[1].
+//  Effects: prev_node and list_head populated on success.
+//  Returns:
+//    true: Node found.
+//    false: Node not linked (internal error).
+//  Note: Walks only the node's own bucket in each table, comparing pointers.
+static bool find_node_links(struct RegistryLL** prev_node, struct RegistryLL*** list_head,
+                            const struct RegistryHash* reg_table, const struct RegistryLL* node)
+{
+    for (int t = 0; t < 2; t++)
+    {
+        struct RegistryLL** table = reg_table->table[t];
+        if (!table)
+            break;
+
+        struct RegistryLL** head = &table[node->hash % reg_table->size[t]];
+        *prev_node = NULL;
+        for (struct RegistryLL* cur = *head; cur; cur = cur->next)
+        {
+            if (cur == node)
+            {
+                *list_head = head;
+                return true;
+            }
+            *prev_node = cur;
+        }
+    }
+
+    return false;
+}
+
+//  Purpose: Drop the registry's reference to an object whose binding was
+//    just removed through a handle.
+//  Input Assumptions: Binding storage already released.
+//  Effects: decref_obj(object); may destroy the object.
+//  Returns: 0 in all cases.
+//  Notes: Failed decref_obj() is an invariant violation.
+static int decref_removed(struct ObjWrapper* object)
+{
+    LOG_OUT(LOG_DEBUG, "calling decref_obj() obj=%p after handle removal", object);
+    int decref_ret = decref_obj(object);
+    if (decref_ret != 0)
+    {
+        LOG_OUT(LOG_ERROR, "decref_obj() failed rtn=%d obj=%p.", decref_ret, object);
+        assert(decref_ret == 0); // internal invariant violation
+    }
+    return 0;
+}
+
+//  Purpose: add_binding() body for one single-threaded registry.
+//  Input Assumptions: Input validated by add_binding(); h == hash(name);
+//    reg_table is not a router.
+//  Effects: As add_binding().
+//  Returns: add_binding() codes.
+static int add_binding_hashed(const char* name, uint64_t h, struct ObjWrapper* object,
+                              struct RegistryHash* reg_table)
+{
+    size_t probes = 0;
+    if (reg_table->flat)
+    {
+        size_t index = reg_flat_find_index(reg_table->flat, name, h, &probes);
+        count_op(&reg_table->counters.adds, &reg_table->counters.add_probes, probes);
+        if (index != reg_flat_capacity(reg_table->flat))
+            return rebind_entry(reg_table, name, h, object,
+                                reg_flat_object_at(reg_table->flat, index),
+                                *reg_flat_handle_at(reg_table->flat, index));
+
+        struct RegPmap* next = NULL;
+        int new_ret = stage_persist(reg_table, name, h, object, &next);
+        if (new_ret != 0)
+            return new_ret;
+        thaw(reg_table);
+        new_ret = add_binding_new_flat(name, object, reg_table, h);
+        finish_persist(reg_table, next, new_ret == 0); // before index_name() can roll back
+        if (new_ret == 0)
+        {
+            reg_table->count++;
+            new_ret = index_name(reg_table, name, h);
+        }
+        return new_ret;
+    }
+
+    // amortize any in-progress rehash over mutating calls
+    rehash_step(reg_table, REHASH_STEP_BUCKETS);
+
+    // local defines
+    struct RegistryLL* prev_node = NULL;
+    struct RegistryLL** list_head = NULL;
+    struct RegistryLL* already_bound =
+        find_node(&prev_node, &list_head, reg_table, name, h, &probes);
+    count_op(&reg_table->counters.adds, &reg_table->counters.add_probes, probes);
+
+    // if name already bound
+    if (already_bound)
+    {
+        return rebind_entry(reg_table, name, h, object, &already_bound->object,
+                            already_bound->handle_slot);
+    }
+
+    // if name is not bound create new node; resize first so it lands in the
+    // table that will survive the rehash
+    struct RegPmap* next = NULL;
+    int new_ret = stage_persist(reg_table, name, h, object, &next);
+    if (new_ret != 0)
+        return new_ret;
+    thaw(reg_table);
+    maybe_grow(reg_table);
+    new_ret = add_binding_new_binding(name, h, object, reg_table, insert_bucket(reg_table, h));
+    finish_persist(reg_table, next, new_ret == 0); // before index_name() can roll back
+    if (new_ret == 0)
+    {
+        reg_table->count++;
+        new_ret = index_name(reg_table, name, h);
+    }
+    return new_ret;
+}
+
+//  Purpose: remove_binding() body for one single-threaded registry.
+//  Input Assumptions: Input validated by remove_binding(); h == hash(name);
+//    reg_table is not a router.
+//  Effects: As remove_binding().
+//  Returns: remove_binding() codes.
+static int remove_binding_hashed(const char* name, uint64_t h, struct RegistryHash* reg_table)
+{
+    size_t probes = 0;
+    if (reg_table->flat)
+    {
+        struct ObjWrapper* erased_object = NULL;
+        size_t index = reg_flat_find_index(reg_table->flat, name, h, &probes);
+        count_op(&reg_table->counters.removes, &reg_table->counters.remove_probes, probes);
+        if (index == reg_flat_capacity(reg_table->flat))
+            return 1; // binding not found
+        struct RegPmap* next = NULL;
+        if (stage_persist(reg_table, name, h, NULL, &next) != 0)
+            return 2; // allocation failure
+        thaw(reg_table);
+        finish_persist(reg_table, next, true);
+        reg_flat_erase_at(reg_table->flat, index, &erased_object);
+        reg_table->count--;
+        if (reg_table->prefix)
+            reg_trie_remove(reg_table->prefix, name);
+        note_removal(reg_table);
+
+        LOG_OUT(LOG_DEBUG, "calling decref_obj() obj=%p name=%s", erased_object, name);
+        int decref_ret = decref_obj(erased_object);
+        if (decref_ret != 0)
+        {
+            LOG_OUT(LOG_ERROR, "decref_obj() failed rtn=%d name=%s obj=%p.", decref_ret, name,
+                    erased_object);
+            assert(decref_ret == 0); // internal invariant violation
+        }
+        return 0;
+    }
+
+    rehash_step(reg_table, REHASH_STEP_BUCKETS);
+
+    // local defines
+    struct RegistryLL* prev_node = NULL;
+    struct RegistryLL** list_head = NULL;
+    struct RegistryLL* found_node = find_node(&prev_node, &list_head, reg_table, name, h, &probes);
+    count_op(&reg_table->counters.removes, &reg_table->counters.remove_probes, probes);
+
+    // binding not found or missing wrapper
+    if (!found_node)
+        return 1;
+    if (!found_node->object)
+    {
+        LOG_OUT(LOG_ERROR, "missing object name=%s node_ptr=%p hash=%016llx.", name, found_node,
+                (unsigned long long)h);
+        return 4; // internal registry error
+    }
+    struct RegPmap* next = NULL;
+    if (stage_persist(reg_table, name, h, NULL, &next) != 0)
+        return 2; // allocation failure
+    thaw(reg_table);
+    finish_persist(reg_table, next, true);
+
+    // remove/free the node
+    remove_node(found_node, prev_node, list_head);
+    reg_table->count--;
+    if (reg_table->prefix)
+        reg_trie_remove(reg_table->prefix, name);
+    note_removal(reg_table);
+    struct ObjWrapper* node_object =
+        found_node->object; // store for freeing after found_node released
+    free_registry_node(reg_table, found_node);
+
+    // decrement the node wrapper
+    LOG_OUT(LOG_DEBUG, "calling decref_obj() obj=%p name=%s", node_object, name);
+    int decref_ret = decref_obj(node_object);
+    if (decref_ret != 0)
+    {
+        LOG_OUT(LOG_ERROR, "decref_obj() failed rtn=%d name=%s obj=%p hash=%016llx.", decref_ret,
+                name, node_object, (unsigned long long)h);
+        assert(decref_ret == 0); // internal invariant violation
+    }
+
+    maybe_shrink(reg_table);
+    return 0;
+}
+
+//  Purpose: lookup_binding() body for one single-threaded registry.
+//  Input Assumptions: Input validated by lookup_binding(); h == hash(name);
+//    reg_table is not a router.
+//  Effects: Operation counters only.
+//  Returns: Bound object or NULL.
+static struct ObjWrapper* lookup_binding_hashed(const char* name, uint64_t h,
+                                                struct RegistryHash* reg_table)
+{
+    size_t probes = 0;
+    if (reg_table->filter && filter_rejects(&reg_table->counters, reg_table->filter, h))
+        return NULL;
 
-    // increment new wrapper
-    int incref_ret = incref_obj(new_node->object);
-    if (incref_ret)
+    struct ObjWrapper* object = NULL;
+    if (reg_table->frozen)
     {
-        LOG_OUT(LOG_ERROR, "incref_obj() failed with ret=%d.", incref_ret);
-        free_registry_node(new_node);
-        return 4; // incref failure
+        probes = 1;
+        object = reg_mphf_find(reg_table->frozen, name, h);
+    }
+    else if (reg_table->flat)
+    {
+        struct ObjWrapper** slot = reg_flat_find(reg_table->flat, name, h, &probes);
+        object = slot ? *slot : NULL;
+    }
+    else
+    {
+        struct RegistryLL* prev = NULL;
+        struct RegistryLL** list_head = NULL;
+        struct RegistryLL* node = find_node(&prev, &list_head, reg_table, name, h, &probes);
+        object = node ? node->object : NULL;
     }
 
-    // add new node
-    int add_node_return = add_node(new_node, &reg_table->table[index]);
-    // successfully added node
-    if (add_node_return == 0)
+    count_op(&reg_table->counters.lookups, &reg_table->counters.lookup_probes, probes);
+    if (!object && reg_table->filter)
+        count_event(&reg_table->counters.filter_false_positives);
+    return object;
+}
+
+//  Purpose: resolve_binding() body for one single-threaded registry.
+//  Input Assumptions: Input validated by resolve_binding(); h == hash(name);
+//    reg_table is not a router.
+//  Effects: May claim a directory slot for the binding.
+//  Returns: resolve_binding() codes.
+static int resolve_binding_hashed(const char* name, uint64_t h, struct RegistryHash* reg_table,
+                                  struct BindingHandle* handle)
+{
+    uint32_t* handle_slot = NULL;
+    uintptr_t target = 0;
+    size_t probes = 0;
+
+    if (reg_table->flat)
+    {
+        size_t index = reg_flat_find_index(reg_table->flat, name, h, &probes);
+        count_op(&reg_table->counters.lookups, &reg_table->counters.lookup_probes, probes);
+        if (index == reg_flat_capacity(reg_table->flat))
+            return 1; // binding not found
+        handle_slot = reg_flat_handle_at(reg_table->flat, index);
+        target = (uintptr_t)index;
+    }
+    else
+    {
+        struct RegistryLL* prev = NULL;
+        struct RegistryLL** list_head = NULL;
+        struct RegistryLL* node = find_node(&prev, &list_head, reg_table, name, h, &probes);
+        count_op(&reg_table->counters.lookups, &reg_table->counters.lookup_probes, probes);
+        if (!node)
+            return 1; // binding not found
+        handle_slot = &node->handle_slot;
+        target = (uintptr_t)node;
+    }
+
+    // every resolve of the same binding shares one directory slot
+    if (*handle_slot != REG_HANDLE_NONE)
     {
-        LOG_OUT(LOG_DEBUG, "added object binding name=%s ptr=%p slot=%zu.", name, new_wrapper,
-                index);
+        *handle = reg_handles_current(reg_table->handles, *handle_slot - 1);
         return 0;
     }
+    if (reg_handles_acquire(reg_table->handles, target, handle) != 0)
+        return 2; // allocation failure
+    *handle_slot = handle->index + 1;
+    return 0;
+}
 
-    // failed to add new node
-    else
+//  Purpose: Build a concurrent router over shard_count single-threaded
+//    registries.
+//  Input Assumptions: table_size > 0; config->concurrent set and backend
+//    validated by init_reg_table_config().
+//  Effects: Allocates the router, the shard array and every shard registry.
+//  Returns:
+//    Router on success.
+//    NULL on allocation failure or config->shards > MAX_SHARDS; nothing
+//    leaked.
+//  Note: Shard count is rounded up to a power of two; table_size is split
+//    evenly across shards. Chained shards serve lookup_binding() lock-free.
+static struct RegistryHash* init_sharded(size_t table_size, const struct RegistryConfig* config)
+{
+    size_t wanted = config->shards ? config->shards : DEFAULT_SHARDS;
+    if (wanted > MAX_SHARDS)
+        return NULL; // caller error
+
+    unsigned int shard_bits = 0;
+    while (((size_t)1 << shard_bits) < wanted)
+        shard_bits++;
+    size_t shard_count = (size_t)1 << shard_bits;
+
+    const struct LinalgAllocator* allocator = config->allocator;
+    struct RegistryHash* router =
+        mem_calloc(allocator, 1, sizeof(struct RegistryHash), ALLOC_SITE_REG_TABLE);
+    struct RegistryShard* shards =
+        mem_aligned_alloc(allocator, _Alignof(struct RegistryShard),
+                          shard_count * sizeof(struct RegistryShard), ALLOC_SITE_REG_TABLE);
+    if (!router || !shards)
     {
-        LOG_OUT(LOG_ERROR, "add_node() failed name=%s ptr=%p ret=%d slot=%zu calling decref_obj().",
-                name, new_node, add_node_return, index);
-        int decref_ret = decref_obj(new_wrapper);
-        free_registry_node(new_node);
-        if (decref_ret != 0)
+        LOG_OUT(LOG_ERROR, "failed to allocate router for %zu shards.", shard_count);
+        mem_free(allocator, router, ALLOC_SITE_REG_TABLE);
+        mem_free(allocator, shards, ALLOC_SITE_REG_TABLE);
+        return NULL;
+    }
+    router->allocator = mem_resolve(allocator);
+    router->backend = config->backend;
+    router->rehash_index = REHASH_IDLE;
+    router->seed = config->seed ? config->seed : make_seed(router);
+    router->shards = shards;
+    router->shard_count = shard_count;
+    router->shard_bits = shard_bits;
+
+    struct RegistryConfig shard_config = *config;
+    shard_config.concurrent = false;
+    shard_config.seed = router->seed; // router hashes once for all shards
+    size_t shard_size = table_size / shard_count ? table_size / shard_count : 1;
+
+    for (size_t i = 0; i < shard_count; i++)
+    {
+        shards[i].reg = init_reg_table_config(shard_size, &shard_config);
+        if (shards[i].reg && config->backend == REG_BACKEND_CHAINED &&
+            enable_lockfree_reads(shards[i].reg) != 0)
         {
-            assert(decref_ret == 0); // invariant violation
-            return 3;
+            destroy_reg_table(shards[i].reg);
+            shards[i].reg = NULL;
+        }
+        if (!shards[i].reg || pthread_mutex_init(&shards[i].lock, NULL) != 0)
+        {
+            LOG_OUT(LOG_ERROR, "failed to initialize shard %zu of %zu.", i, shard_count);
+            destroy_reg_table(shards[i].reg);
+            for (size_t j = 0; j < i; j++)
+            {
+                destroy_reg_table(shards[j].reg);
+                pthread_mutex_destroy(&shards[j].lock);
+            }
+            mem_free(allocator, shards, ALLOC_SITE_REG_TABLE);
+            mem_free(allocator, router, ALLOC_SITE_REG_TABLE);
+            return NULL;
         }
-        return 5; // add_node() failure
     }
+
+    LOG_OUT(LOG_DEBUG, "success: reg_table=%p concurrent shards=%zu shard_size=%zu.", router,
+            shard_count, shard_size);
+    return router;
 }
 
-//  Purpose: Helper function to release 'node' and 'node->name'.
-//  Input Assumptions: Caller assures `node` and `node->name` exist.
-//  Effects: `node` and `node->name` are freed.
+//  Purpose: Shard owning hash `h`.
+//  Input Assumptions: reg_table is a router.
+//  Effects: None.
+//  Returns: Shard selected by the top shard_bits bits of h.
+//  Note: Top bits are independent of the bits both backends index with.
+static inline struct RegistryShard* shard_for_hash(const struct RegistryHash* reg_table,
+                                                   uint64_t h)
+{
+    if (reg_table->shard_bits == 0)
+        return &reg_table->shards[0];
+    return &reg_table->shards[h >> (64 - reg_table->shard_bits)];
+}
+
+//  Purpose: Split a router handle into its shard and shard-local handle.
+//  Input Assumptions: reg_table is a router.
+//  Effects: handle->index rewritten to the shard-local index.
+//  Returns: Shard the handle was issued by.
+static inline struct RegistryShard* shard_for_handle(const struct RegistryHash* reg_table,
+                                                     struct BindingHandle* handle)
+{
+    uint32_t shard = handle->index & (uint32_t)(reg_table->shard_count - 1);
+    handle->index >>= reg_table->shard_bits;
+    return &reg_table->shards[shard];
+}
+
+//  Purpose: Turn a shard-local handle into a router handle.
+//  Input Assumptions: handle->index fits in 32 - shard_bits bits.
+//  Effects: handle->index rewritten.
+//  Returns: None.
+static inline void encode_handle(const struct RegistryHash* reg_table,
+                                 const struct RegistryShard* shard, struct BindingHandle* handle)
+{
+    handle->index = (handle->index << reg_table->shard_bits) |
+                    (uint32_t)(shard - reg_table->shards);
+}
+
+//  Purpose: Store a chain link that lock-free readers may be following.
+//  Input assumptions: `node`, if non-NULL, is fully initialized.
+//  Effects: *link = node with release ordering.
+//  Returns: None.
+//  Note: A plain store on x86/ARM64 ordering-wise; single-threaded registries
+//    pay nothing for it.
+static inline void publish_node(struct RegistryLL** link, struct RegistryLL* node)
+{
+    __atomic_store_n(link, node, __ATOMIC_RELEASE);
+}
+
+//  Purpose: Store a bound object that lock-free readers may be loading.
+//  Input assumptions: None.
+//  Effects: *slot = object with release ordering.
+//  Returns: None.
+static inline void publish_object(struct ObjWrapper** slot, struct ObjWrapper* object)
+{
+    __atomic_store_n(slot, object, __ATOMIC_RELEASE);
+}
+
+//  Purpose: Switch a fresh chained registry to lock-free lookups.
+//  Input assumptions: Chained backend, no rehash in progress, not yet shared.
+//  Effects: Allocates the reader counter stripes and publishes the initial
+//    view; sets lockfree_reads.
+//  Returns:
+//    0: Success.
+//    2: Allocation failure; registry unchanged.
+static int enable_lockfree_reads(struct RegistryHash* reg_table)
+{
+    size_t stripe_bytes = READ_STRIPES * sizeof(struct RegReadStripe);
+    struct RegReadStripe* stripes = mem_aligned_alloc(
+        &reg_table->allocator, _Alignof(struct RegReadStripe), stripe_bytes, ALLOC_SITE_REG_TABLE);
+    struct RegTableView* view =
+        mem_alloc(&reg_table->allocator, sizeof(struct RegTableView), ALLOC_SITE_REG_TABLE);
+    if (!stripes || !view)
+    {
+        LOG_OUT(LOG_ERROR, "failed to allocate %zu bytes for registry view.",
+                stripe_bytes + sizeof(struct RegTableView));
+        mem_free(&reg_table->allocator, stripes, ALLOC_SITE_REG_TABLE);
+        mem_free(&reg_table->allocator, view, ALLOC_SITE_REG_TABLE);
+        return 2;
+    }
+
+    memset(stripes, 0, stripe_bytes);
+    reg_table->read_stripes = stripes;
+
+    *view = (struct RegTableView){{reg_table->table[0], NULL}, {reg_table->size[0], 0}};
+    reg_table->lockfree_reads = true;
+    publish_view(reg_table, view);
+    return 0;
+}
+
+//  Purpose: Make `view` the tables lock-free readers traverse.
+//  Input assumptions: lockfree_reads; `view` fully initialized; shard lock held
+//    (or registry not yet shared).
+//  Effects: Release-stores reg_table->view; retires the previous view.
 //  Returns: 0 in all cases.
-//  Notes: None.
-static int free_registry_node(struct RegistryLL* node)
+static int publish_view(struct RegistryHash* reg_table, struct RegTableView* view)
+{
+    struct RegTableView* old_view = reg_table->view;
+    __atomic_store_n(&reg_table->view, view, __ATOMIC_RELEASE);
+    if (old_view)
+        retire(reg_table, old_view, reclaim_block);
+    return 0;
+}
+
+//  Purpose: lookup_binding() body for a lockfree_reads registry.
+//  Input assumptions: Caller is inside reg_ebr_enter(); h == hash(name).
+//  Effects: None.
+//  Returns: Bound object or NULL.
+//  Note: Takes no lock and writes nothing shared but this thread's counter
+//    stripe; bounded by the length of the two chains it walks.
+static struct ObjWrapper* lookup_binding_lockfree(const char* name, uint64_t h,
+                                                  struct RegistryHash* reg_table)
+{
+    struct RegOpCounters* counters = read_counters(reg_table);
+    const struct RegFilter* filter = __atomic_load_n(&reg_table->filter, __ATOMIC_ACQUIRE);
+    if (filter && filter_rejects(counters, filter, h))
+        return NULL;
+
+    const struct RegMphf* frozen = __atomic_load_n(&reg_table->frozen, __ATOMIC_ACQUIRE);
+    if (frozen)
+    {
+        count_op(&counters->lookups, &counters->lookup_probes, 1);
+        struct ObjWrapper* object = reg_mphf_find(frozen, name, h);
+        if (!object && filter)
+            count_event(&counters->filter_false_positives);
+        return object;
+    }
+
+    const struct RegTableView* view = __atomic_load_n(&reg_table->view, __ATOMIC_ACQUIRE);
+    struct ObjWrapper* object = NULL;
+    size_t probes = 0;
+
+    for (int t = 0; t < 2 && !object; t++)
+    {
+        struct RegistryLL** table = view->table[t];
+        if (!table)
+            break;
+
+        struct RegistryLL* node = __atomic_load_n(&table[h % view->size[t]], __ATOMIC_ACQUIRE);
+        while (node)
+        {
+            probes++;
+            if (node->hash == h && !strcmp(name, node->name))
+            {
+                object = __atomic_load_n(&node->object, __ATOMIC_ACQUIRE);
+                break;
+            }
+            node = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE);
+        }
+    }
+
+    count_op(&counters->lookups, &counters->lookup_probes, probes);
+    if (!object && filter)
+        count_event(&counters->filter_false_positives);
+    return object;
+}
+
+//  Purpose: Hand unlinked memory to the registry's retire list.
+//  Input assumptions: lockfree_reads; shard lock held; `ptr` unreachable
+//    from view, buckets and chains.
+//  Effects: `ptr` reclaimed once no reader can hold it; every
+//    RETIRE_COLLECT_THRESHOLD items the list is swept for safe entries.
+//  Returns: None.
+static void retire(struct RegistryHash* reg_table, void* ptr, reg_ebr_reclaim_fn reclaim)
+{
+    reg_ebr_retire(&reg_table->retired, ptr, reclaim, reg_table);
+    if (reg_table->retired.count % RETIRE_COLLECT_THRESHOLD == 0)
+        reg_ebr_collect(&reg_table->retired, reg_table);
+}
+
+//  Purpose: reg_ebr_reclaim_fn for registry nodes.
+//  Input assumptions: reg_table is the owning registry.
+//  Effects: Node returned to the arena.
+//  Returns: None.
+static void reclaim_node(void* reg_table, void* node)
+{
+    reg_arena_free_node(((struct RegistryHash*)reg_table)->arena, node);
+}
+
+//  Purpose: reg_ebr_reclaim_fn for name strings.
+//  Input assumptions: reg_table is the owning registry.
+//  Effects: Name returned to the arena.
+//  Returns: None.
+static void reclaim_name(void* reg_table, void* name)
+{
+    reg_arena_free_name(((struct RegistryHash*)reg_table)->arena, name);
+}
+
+//  Purpose: reg_ebr_reclaim_fn for bucket arrays and views.
+//  Input assumptions: reg_table is the owning registry; block came from its
+//    allocator with ALLOC_SITE_REG_TABLE.
+//  Effects: block freed.
+//  Returns: None.
+static void reclaim_block(void* reg_table, void* block)
+{
+    mem_free(&((struct RegistryHash*)reg_table)->allocator, block, ALLOC_SITE_REG_TABLE);
+}
+
+//  Purpose: reg_ebr_reclaim_fn for a dropped frozen table.
+//  Input assumptions: frozen came from reg_mphf_build().
+//  Effects: reg_mphf_destroy(frozen).
+//  Returns: None.
+static void reclaim_frozen(void* unused, void* frozen)
+{
+    (void)unused;
+    reg_mphf_destroy(frozen);
+}
+
+//  Purpose: reg_ebr_reclaim_fn for a replaced negative filter.
+//  Input assumptions: filter came from reg_filter_init().
+//  Effects: reg_filter_destroy(filter).
+//  Returns: None.
+static void reclaim_filter(void* unused, void* filter)
+{
+    (void)unused;
+    reg_filter_destroy(filter);
+}
+
+//  Purpose: Move one table[0] bucket into table[1] without disturbing
+//    readers that are walking it.
+//  Input assumptions: lockfree_reads; rehashing; shard lock held; readers
+//    already see table[1] (rehash_epoch is safe).
+//  Effects: Each node is copied into its table[1] bucket (sharing the name,
+//    handle slots retargeted), then the old bucket is cleared and the
+//    originals retired.
+//  Returns:
+//    0: Bucket migrated.
+//    2: Allocation failure; nothing changed.
+//  Note: Copies are published before the old bucket is cleared, so a reader
+//    finds each binding in table[0], table[1] or both at every instant.
+static int migrate_bucket_copies(struct RegistryHash* reg_table, size_t bucket)
+{
+    struct RegistryLL** old_head = &reg_table->table[0][bucket];
+    size_t length = 0;
+    for (struct RegistryLL* node = *old_head; node; node = node->next)
+        length++;
+
+    // allocate every copy up front so the bucket moves all-or-nothing
+    struct RegistryLL* copies = NULL;
+    for (size_t i = 0; i < length; i++)
+    {
+        struct RegistryLL* copy = reg_arena_alloc_node(reg_table->arena);
+        if (!copy)
+        {
+            LOG_OUT(LOG_WARNING, "failed to allocate rehash copy of bucket %zu.", bucket);
+            while (copies)
+            {
+                struct RegistryLL* next_copy = copies->next;
+                reg_arena_free_node(reg_table->arena, copies);
+                copies = next_copy;
+            }
+            return 2;
+        }
+        copy->next = copies;
+        copies = copy;
+    }
+
+    for (struct RegistryLL* node = *old_head; node; node = node->next)
+    {
+        struct RegistryLL* copy = copies;
+        copies = copies->next;
+        copy->hash = node->hash;
+        copy->object = node->object;
+        copy->name = node->name; // shared; the original is retired without it
+        copy->handle_slot = node->handle_slot;
+        if (copy->handle_slot != REG_HANDLE_NONE)
+            reg_handles_retarget(reg_table->handles, copy->handle_slot - 1, (uintptr_t)copy);
+        add_node(copy, &reg_table->table[1][copy->hash % reg_table->size[1]]);
+    }
+
+    struct RegistryLL* node = *old_head;
+    publish_node(old_head, NULL);
+    while (node)
+    {
+        struct RegistryLL* next_node = node->next;
+        retire(reg_table, node, reclaim_node);
+        node = next_node;
+    }
+    return 0;
+}
+
+//  Purpose: Record one name-based operation and its probe count.
+//  Input assumptions: ops/probe_total point into reg_table->counters with the
+//    shard lock held, or into the caller's read_counters() stripe.
+//  Effects: *ops += 1, *probe_total += probes.
+//  Returns: None.
+//  Note: Relaxed load + store rather than an atomic add. A stripe is written
+//    by one thread unless more than READ_STRIPES threads read the registry,
+//    in which case threads sharing a slot may lose the odd increment.
+static inline void count_op(uint64_t* ops, uint64_t* probe_total, size_t probes)
+{
+    __atomic_store_n(ops, __atomic_load_n(ops, __ATOMIC_RELAXED) + 1, __ATOMIC_RELAXED);
+    __atomic_store_n(probe_total, __atomic_load_n(probe_total, __ATOMIC_RELAXED) + probes,
+                     __ATOMIC_RELAXED);
+}
+
+//  Purpose: Bump a single statistics counter (see count_op()).
+//  Input assumptions: As count_op().
+//  Effects: counter incremented.
+//  Returns: None.
+static inline void count_event(uint64_t* counter)
+{
+    __atomic_store_n(counter, __atomic_load_n(counter, __ATOMIC_RELAXED) + 1, __ATOMIC_RELAXED);
+}
+
+//  Purpose: Pick the counters a lock-free reader on this thread updates.
+//  Input assumptions: reg_table->lockfree_reads.
+//  Effects: Assigns the thread a reader slot on its first call.
+//  Returns: This thread's stripe of reg_table->read_stripes.
+static inline struct RegOpCounters* read_counters(struct RegistryHash* reg_table)
+{
+    if (!thread_read_stripe)
+        thread_read_stripe =
+            (__atomic_fetch_add(&next_read_stripe, 1, __ATOMIC_RELAXED) & (READ_STRIPES - 1)) + 1;
+    return &reg_table->read_stripes[thread_read_stripe - 1].counters;
+}
+
+//  Purpose: Add one single-threaded registry's raw figures to `stats`.
+//  Input assumptions: reg_table valid and not a router; shard lock held if
+//    it is a shard.
+//  Effects: bindings, buckets, max_chain, chain_histogram and the counter
+//    fields of `stats` accumulated; *chain_total and *chains accumulate the
+//    sum and number of chains behind mean_chain.
+//  Returns: None.
+//  Note: O(buckets); derived ratios are left to the caller.
+static void accumulate_stats(struct RegistryHash* reg_table, struct RegistryStats* stats,
+                             size_t* chain_total, size_t* chains)
+{
+    const struct RegOpCounters* counters = &reg_table->counters;
+    stats->bindings += reg_table->count;
+    stats->frozen_bindings += reg_mphf_count(reg_table->frozen);
+    stats->frozen_bytes += reg_mphf_bytes(reg_table->frozen);
+    stats->filter_bytes += reg_filter_bytes(reg_table->filter);
+    stats->filter_rejects += counters->filter_rejects;
+    stats->filter_false_positives += counters->filter_false_positives;
+    stats->lookups += counters->lookups;
+    stats->lookup_probes += counters->lookup_probes;
+    for (size_t i = 0; reg_table->read_stripes && i < READ_STRIPES; i++)
+    {
+        const struct RegOpCounters* stripe = &reg_table->read_stripes[i].counters;
+        stats->filter_rejects += __atomic_load_n(&stripe->filter_rejects, __ATOMIC_RELAXED);
+        stats->filter_false_positives +=
+            __atomic_load_n(&stripe->filter_false_positives, __ATOMIC_RELAXED);
+        stats->lookups += __atomic_load_n(&stripe->lookups, __ATOMIC_RELAXED);
+        stats->lookup_probes += __atomic_load_n(&stripe->lookup_probes, __ATOMIC_RELAXED);
+    }
+    stats->adds += counters->adds;
+    stats->add_probes += counters->add_probes;
+    stats->removes += counters->removes;
+    stats->remove_probes += counters->remove_probes;
+
+    if (reg_table->flat)
+    {
+        size_t max_groups = stats->max_chain;
+        reg_flat_probe_stats(reg_table->flat, stats->chain_histogram, REG_STATS_HISTOGRAM_BINS,
+                             &max_groups, chain_total);
+        stats->max_chain = max_groups;
+        stats->buckets += reg_flat_capacity(reg_table->flat);
+        *chains += reg_table->count;
+        return;
+    }
+
+    for (int t = 0; t < 2; t++)
+    {
+        if (!reg_table->table[t])
+            continue;
+
+        // migrated table[0] buckets are permanently empty; skip them
+        size_t first = (t == 0 && reg_table->rehash_index != REHASH_IDLE)
+                           ? reg_table->rehash_index
+                           : 0;
+        for (size_t i = first; i < reg_table->size[t]; i++)
+        {
+            size_t length = 0;
+            for (struct RegistryLL* node = reg_table->table[t][i]; node; node = node->next)
+                length++;
+
+            stats->chain_histogram[length < REG_STATS_HISTOGRAM_BINS
+                                       ? length
+                                       : REG_STATS_HISTOGRAM_BINS - 1]++;
+            if (length > stats->max_chain)
+                stats->max_chain = length;
+            if (length)
+            {
+                *chain_total += length;
+                (*chains)++;
+            }
+        }
+        stats->buckets += reg_table->size[t] - first;
+    }
+}
+
+//  Purpose: Add a freshly bound name to the negative filter and prefix
+//    index, whichever are enabled.
+//  Input Assumptions: name was just bound as a new binding in reg_table;
+//    h == hash(name); reg_table is not a router.
+//  Effects: Sets the filter bits (rebuilding it larger once bindings exceed
+//    its capacity) and inserts into reg_table->prefix. On trie allocation
+//    failure the new binding is removed again, so table and index stay in
+//    step.
+//  Returns:
+//    0 on success or when reg_table has no prefix index.
+//    2 on allocation failure (binding not added).
+static int index_name(struct RegistryHash* reg_table, const char* name, uint64_t h)
+{
+    if (reg_table->filter)
+    {
+        if (reg_table->count > reg_filter_capacity(reg_table->filter))
+            rebuild_filter(reg_table); // includes the new binding
+        else
+            reg_filter_add(reg_table->filter, h);
+    }
+
+    if (!reg_table->prefix || reg_trie_insert(reg_table->prefix, name) == 0)
+        return 0;
+
+    LOG_OUT(LOG_ERROR, "failed to index name=%s; binding rolled back.", name);
+    remove_binding_hashed(name, h, reg_table);
+    return 2;
+}
+
+//  Purpose: remove_bindings_prefix() body for one single-threaded registry.
+//  Input Assumptions: reg_table is not a router and has a prefix index;
+//    caller holds its lock if any.
+//  Effects: Removes every binding under prefix; adds the count to *removed.
+//  Returns:
+//    0 on success.
+//    2 on allocation failure collecting the names (nothing removed).
+static int remove_prefix_local(struct RegistryHash* reg_table, const char* prefix,
+                               size_t* removed)
+{
+    struct RegTrieNames names = {0};
+    if (reg_trie_collect(reg_table->prefix, prefix, &names) != 0)
+    {
+        reg_trie_names_free(&names);
+        return 2;
+    }
+
+    // names are copies, so the trie may change under the loop
+    const char* name = names.data;
+    for (size_t i = 0; i < names.count; i++)
+    {
+        if (remove_binding_hashed(name, hash(reg_table, name), reg_table) == 0)
+            (*removed)++;
+        name += strlen(name) + 1;
+    }
+
+    reg_trie_names_free(&names);
+    return 0;
+}
+//  Purpose: freeze_registry() body for one single-threaded registry.
+//  Input Assumptions: reg_table is not a router; caller holds its lock if any.
+//  Effects: Builds and publishes reg_table->frozen from the current bindings.
+//  Returns: freeze_registry() codes (0, 2, 5).
+static int freeze_local(struct RegistryHash* reg_table)
+{
+    if (reg_table->frozen)
+        return 0; // nothing changed since the last freeze
+
+    struct RegMphfKey* keys =
+        mem_alloc(&reg_table->allocator, (reg_table->count + 1) * sizeof(struct RegMphfKey),
+                  ALLOC_SITE_REG_FROZEN);
+    if (!keys)
+    {
+        LOG_OUT(LOG_ERROR, "failed to allocate %zu freeze keys.", reg_table->count);
+        return 2;
+    }
+
+    struct RegMphfKey* cursor = keys;
+    visit_entries(reg_table, collect_key, &cursor);
+    size_t n = (size_t)(cursor - keys);
+
+    struct RegMphf* frozen = NULL;
+    int ret = reg_mphf_build(keys, n, reg_table->seed, &reg_table->allocator, &frozen);
+    mem_free(&reg_table->allocator, keys, ALLOC_SITE_REG_FROZEN);
+    if (ret != 0)
+        return ret;
+
+    if (reg_table->lockfree_reads)
+        __atomic_store_n(&reg_table->frozen, frozen, __ATOMIC_RELEASE);
+    else
+        reg_table->frozen = frozen;
+    LOG_OUT(LOG_DEBUG, "froze reg_table=%p bindings=%zu bytes=%zu.", reg_table, n,
+            reg_mphf_bytes(frozen));
+    return 0;
+}
+
+//  Purpose: Drop the frozen table before the bindings change.
+//  Input Assumptions: reg_table is not a router; caller holds its lock if any.
+//  Effects: reg_table->frozen cleared; with lockfree_reads the frozen table
+//    is retired (in-flight lock-free lookups may still be reading it).
+//  Returns: None.
+static void thaw(struct RegistryHash* reg_table)
+{
+    struct RegMphf* frozen = reg_table->frozen;
+    if (!frozen)
+        return;
+
+    if (reg_table->lockfree_reads)
+    {
+        __atomic_store_n(&reg_table->frozen, NULL, __ATOMIC_RELEASE);
+        retire(reg_table, frozen, reclaim_frozen);
+    }
+    else
+    {
+        reg_table->frozen = NULL;
+        reg_mphf_destroy(frozen);
+    }
+    LOG_OUT(LOG_DEBUG, "thawed reg_table=%p.", reg_table);
+}
+
+//  Purpose: Call `visit` once for every live binding.
+//  Input Assumptions: reg_table is not a router; caller holds its lock if any.
+//  Effects: Whatever visit does; visit must not modify the registry.
+//  Returns: None.
+//  Note: Migrated table[0] buckets are empty, so nothing is visited twice.
+static void visit_entries(struct RegistryHash* reg_table, entry_visit_fn visit, void* ctx)
+{
+    if (reg_table->flat)
+    {
+        const char* name = NULL;
+        struct ObjWrapper* object = NULL;
+        for (size_t i = 0; i < reg_flat_capacity(reg_table->flat); i++)
+        {
+            if (reg_flat_slot(reg_table->flat, i, &name, &object))
+                visit(ctx, name, reg_flat_hash_at(reg_table->flat, i), object);
+        }
+        return;
+    }
+
+    for (int t = 0; t < 2; t++)
+    {
+        for (size_t i = 0; reg_table->table[t] && i < reg_table->size[t]; i++)
+        {
+            for (struct RegistryLL* node = reg_table->table[t][i]; node; node = node->next)
+                visit(ctx, node->name, node->hash, node->object);
+        }
+    }
+}
+
+//  Purpose: entry_visit_fn appending a RegMphfKey.
+//  Input Assumptions: *cursor has room for one more key.
+//  Effects: Writes the key and advances *cursor.
+//  Returns: None.
+static void collect_key(void* cursor, const char* name, uint64_t h, struct ObjWrapper* object)
+{
+    struct RegMphfKey** next = cursor;
+    **next = (struct RegMphfKey){name, h, object};
+    (*next)++;
+}
+
+//  Purpose: entry_visit_fn adding a binding's hash to a filter.
+//  Input Assumptions: filter is a RegFilter not yet visible to readers.
+//  Effects: Sets the hash's bits.
+//  Returns: None.
+static void add_filter_hash(void* filter, const char* name, uint64_t h,
+                            struct ObjWrapper* object)
+{
+    (void)name;
+    (void)object;
+    reg_filter_add(filter, h);
+}
+
+//  Purpose: Replace the negative filter with one built from the current
+//    bindings, sized at twice the binding count.
+//  Input Assumptions: reg_table->filter != NULL; caller holds the lock if any.
+//  Effects: New filter published (old one freed, or retired with
+//    lockfree_reads); filter_stale reset. On allocation failure the old
+//    filter stays, which is still correct, just less selective.
+//  Returns: None.
+static void rebuild_filter(struct RegistryHash* reg_table)
+{
+    size_t capacity = reg_table->count * 2;
+    if (capacity < reg_table->filter_min)
+        capacity = reg_table->filter_min;
+
+    struct RegFilter* filter = reg_filter_init(capacity, &reg_table->allocator);
+    if (!filter)
+        return;
+    visit_entries(reg_table, add_filter_hash, filter);
+
+    struct RegFilter* old = reg_table->filter;
+    if (reg_table->lockfree_reads)
+    {
+        __atomic_store_n(&reg_table->filter, filter, __ATOMIC_RELEASE);
+        retire(reg_table, old, reclaim_filter);
+    }
+    else
+    {
+        reg_table->filter = filter;
+        reg_filter_destroy(old);
+    }
+    reg_table->filter_stale = 0;
+    LOG_OUT(LOG_DEBUG, "rebuilt filter reg_table=%p bindings=%zu capacity=%zu.", reg_table,
+            reg_table->count, capacity);
+}
+
+//  Purpose: Account for a removed binding whose hash stays in the filter.
+//  Input Assumptions: Binding already unlinked and count decremented; caller
+//    holds the lock if any.
+//  Effects: filter_stale incremented; the filter is rebuilt once stale
+//    hashes fill half of it or outnumber the live bindings (the floor keeps
+//    small registries from rebuilding on every removal). Each rebuild is
+//    paid for by at least as many removals, so this is amortized O(1).
+//  Returns: None.
+static void note_removal(struct RegistryHash* reg_table)
 {
-    free(node->name);
-    free(node);
+    if (!reg_table->filter)
+        return;
+    size_t stale = ++reg_table->filter_stale;
+    if (stale > reg_filter_capacity(reg_table->filter) / 2 ||
+        (stale > reg_table->count && stale > reg_table->filter_min / 2))
+        rebuild_filter(reg_table);
+}
 
+//  Purpose: Answer a lookup from the negative filter when it can.
+//  Input Assumptions: filter is the registry's current (or a just-retired)
+//    filter; counters as count_op().
+//  Effects: On rejection counts the lookup (0 probes) and the rejection.
+//  Returns: true if h is certainly unbound.
+static inline bool filter_rejects(struct RegOpCounters* counters, const struct RegFilter* filter,
+                                  uint64_t h)
+{
+    if (reg_filter_maybe(filter, h))
+        return false;
+    count_op(&counters->lookups, &counters->lookup_probes, 0);
+    count_event(&counters->filter_rejects);
+    return true;
+}
+//  Purpose: Start maintaining reg_table->persist from the current bindings.
+//  Input Assumptions: reg_table is not a router and !reg_table->snapshots;
+//    caller holds its lock if any.
+//  Effects: On success persist holds every binding (one new object
+//    reference each) and snapshots is set; every later write updates it.
+//  Returns:
+//    0 on success.
+//    2 on allocation failure (registry unchanged).
+//  Note: O(n log n) once per registry; RegistryConfig.snapshots avoids it.
+static int enable_snapshots(struct RegistryHash* reg_table)
+{
+    struct PersistBuild build = {reg_table, NULL, 0};
+    visit_entries(reg_table, persist_binding, &build);
+    if (build.ret != 0)
+    {
+        reg_pmap_release(build.root, &reg_table->allocator);
+        return 2;
+    }
+    reg_table->persist = build.root;
+    reg_table->snapshots = true;
     return 0;
 }
+
+//  Purpose: entry_visit_fn adding one binding to a PersistBuild.
+//  Input Assumptions: build points to a PersistBuild.
+//  Effects: build->root replaced by the map with the binding; the old root
+//    is released (nothing else holds it yet).
+//  Returns: None.
+static void persist_binding(void* build, const char* name, uint64_t h,
+                            struct ObjWrapper* object)
+{
+    struct PersistBuild* state = build;
+    if (state->ret != 0)
+        return;
+
+    struct RegPmap* next = NULL;
+    state->ret = reg_pmap_put(state->root, name, h, object, &state->reg_table->allocator, &next);
+    if (state->ret != 0)
+        return;
+    reg_pmap_release(state->root, &state->reg_table->allocator);
+    state->root = next;
+}
+
+//  Purpose: Build the persistent map a write will publish, before the write
+//    touches the table.
+//  Input Assumptions: reg_table is not a router; caller holds its lock if
+//    any; object == NULL removes `name`, which is bound.
+//  Effects: *next = the updated map (NULL without snapshots). The current
+//    map is unchanged, so a failed write only has to drop *next.
+//  Returns:
+//    0 on success.
+//    2 on allocation failure.
+//    4 on incref_obj() failure.
+//  Note: O(log32 n) small allocations; nothing is copied without snapshots.
+static int stage_persist(struct RegistryHash* reg_table, const char* name, uint64_t h,
+                         struct ObjWrapper* object, struct RegPmap** next)
+{
+    *next = NULL;
+    if (!reg_table->snapshots)
+        return 0;
+    if (object)
+        return reg_pmap_put(reg_table->persist, name, h, object, &reg_table->allocator, next);
+
+    int ret = reg_pmap_remove(reg_table->persist, name, h, &reg_table->allocator, next);
+    if (ret == 1)
+    {
+        LOG_OUT(LOG_ERROR, "bound name=%s missing from the snapshot map.", name);
+        reg_pmap_retain(reg_table->persist);
+        *next = reg_table->persist; // nothing to drop
+        return 0;
+    }
+    return ret;
+}
+
+//  Purpose: Publish or drop a map built by stage_persist().
+//  Input Assumptions: As stage_persist(); `landed` tells whether the write
+//    changed the table.
+//  Effects: landed: persist = next and the registry's reference on the old
+//    map is dropped; otherwise next is dropped.
+//  Returns: None.
+//  Note: Releasing the old map frees only what no snapshot still holds and
+//    next does not share, i.e. at most the path the write replaced; whole
+//    versions are freed by the last release_snapshot(), on its thread.
+static void finish_persist(struct RegistryHash* reg_table, struct RegPmap* next, bool landed)
+{
+    if (!reg_table->snapshots)
+        return;
+    if (!landed)
+    {
+        reg_pmap_release(next, &reg_table->allocator);
+        return;
+    }
+    struct RegPmap* old = reg_table->persist;
+    reg_table->persist = next;
+    reg_pmap_release(old, &reg_table->allocator);
+}
+
+//  Purpose: Registry behind shard i (the registry itself when not a router).
+//  Input Assumptions: i < shard_count for a router, i == 0 otherwise.
+//  Effects: None.
+//  Returns: Shard-local registry.
+static inline struct RegistryHash* shard_reg(struct RegistryHash* reg_table, size_t i)
+{
+    return reg_table->shards ? reg_table->shards[i].reg : reg_table;
+}
 #pragma endregion
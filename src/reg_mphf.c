@@ -0,0 +1,360 @@
+#include "reg_mphf.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "logs.h"
+#include "mem_alloc.h"
+
+#pragma region Head Comment
+/*
+ * Translation unit implements:
+ * - Construction and lookup of the perfect hash behind frozen registries.
+ *
+ * Scheme (hash-and-displace):
+ * - k = mix(h ^ salt). Bucket b = range(k, buckets); entry
+ *   = range(mix(k ^ pilot[b] * GOLDEN), slots).
+ * - slots = count + count / SLACK_DIV + SLACK_MIN. The table is not minimal:
+ *   even the last buckets placed see at least SLACK_MIN + count / SLACK_DIV
+ *   free entries, so a bucket of size s needs about (slots / free)^s tries
+ *   instead of the unbounded search a full table forces on small inputs.
+ * - Build sorts buckets by size, largest first, and for each bucket tries
+ *   pilots 0, 1, 2, ... until every key of the bucket lands on a distinct free
+ *   entry. Early buckets see an almost empty table; the many singleton
+ *   buckets at the end need about slots / free_entries tries each, which
+ *   sums to O(count).
+ * - A bucket whose search exceeds the try limit restarts the whole build
+ *   with a new salt (bounded number of attempts).
+ *
+ * Memory layout (one block):
+ *   struct RegMphf | entries[slots] | pilots[buckets] | name bytes
+ */
+#pragma endregion
+
+#pragma region Local Definitions
+/* ============================================================================
+ * File-local definitions
+ * ============================================================================
+ */
+#define KEYS_PER_BUCKET 4 // average bucket load; ~1 byte of pilot per key
+#define SLACK_DIV 8       // spare entries per stored key: 1 / SLACK_DIV
+#define SLACK_MIN 4       // spare entries every table gets, however small
+#define TRIES_PER_SLOT 64 // pilot search budget per bucket, scaled by slots
+#define BUILD_ATTEMPTS 4  // salts tried before giving up
+#define GOLDEN 0x9E3779B97F4A7C15ull
+
+struct RegMphfEntry
+{
+    uint64_t hash;             // registry hash, compared before the name
+    size_t name_offset;        // into names
+    struct ObjWrapper* object; // non-owning; NULL marks a spare entry
+};
+
+struct RegMphf
+{
+    size_t count;          // stored bindings
+    size_t slots;          // entries, count plus spares
+    size_t buckets;        // pilot count
+    uint64_t salt;         // salt that produced the pilots
+    size_t bytes;          // size of this block
+    struct LinalgAllocator allocator; // allocated this block
+    const uint32_t* pilots; // inside this block
+    const char* names;      // inside this block, NUL-terminated names
+    struct RegMphfEntry entries[];
+};
+
+// Build scratch space, sized once per reg_mphf_build() call.
+struct MphfScratch
+{
+    uint64_t* keys;         // mixed hash per key
+    size_t* bucket_start;   // [buckets + 1], prefix sums of bucket sizes
+    size_t* bucket_keys;    // key indices grouped by bucket
+    size_t* bucket_order;   // bucket ids, largest first
+    bool* taken;            // [slots]
+    size_t* positions;      // candidate entries for the current bucket
+};
+#pragma endregion
+
+#pragma region Private Function Prototypes
+/* ============================================================================
+ * Private function prototypes
+ * ============================================================================
+ */
+static inline uint64_t mix64(uint64_t x);
+static inline size_t range(uint64_t x, size_t n);
+static inline size_t entry_index(uint64_t key, uint32_t pilot, size_t slots);
+static int find_pilots(const struct MphfScratch* scratch, size_t slots, size_t buckets,
+                       uint32_t* pilots);
+static void free_scratch(const struct LinalgAllocator* allocator, struct MphfScratch* scratch);
+#pragma endregion
+
+#pragma region Public API
+/* ============================================================================
+ * Public API implementation
+ * ============================================================================
+ */
+
+int reg_mphf_build(const struct RegMphfKey* keys, size_t count, uint64_t salt,
+                   const struct LinalgAllocator* allocator, struct RegMphf** out)
+{
+    *out = NULL;
+    size_t slots = count + count / SLACK_DIV + SLACK_MIN;
+    size_t buckets = count / KEYS_PER_BUCKET + 1;
+    size_t name_bytes = 0;
+    for (size_t i = 0; i < count; i++)
+        name_bytes += strlen(keys[i].name) + 1;
+
+    size_t bytes = sizeof(struct RegMphf) + slots * sizeof(struct RegMphfEntry) +
+                   buckets * sizeof(uint32_t) + name_bytes;
+    struct RegMphf* table = mem_alloc(allocator, bytes, ALLOC_SITE_REG_FROZEN);
+    struct MphfScratch scratch = {
+        .keys = mem_alloc(allocator, (count + 1) * sizeof(uint64_t), ALLOC_SITE_REG_FROZEN),
+        .bucket_start = mem_calloc(allocator, buckets + 1, sizeof(size_t), ALLOC_SITE_REG_FROZEN),
+        .bucket_keys = mem_alloc(allocator, (count + 1) * sizeof(size_t), ALLOC_SITE_REG_FROZEN),
+        .bucket_order = mem_alloc(allocator, buckets * sizeof(size_t), ALLOC_SITE_REG_FROZEN),
+        .taken = mem_alloc(allocator, slots, ALLOC_SITE_REG_FROZEN),
+        .positions = mem_alloc(allocator, (count + 1) * sizeof(size_t), ALLOC_SITE_REG_FROZEN),
+    };
+    if (!table || !scratch.keys || !scratch.bucket_start || !scratch.bucket_keys ||
+        !scratch.bucket_order || !scratch.taken || !scratch.positions)
+    {
+        LOG_OUT(LOG_ERROR, "failed to allocate perfect hash for %zu bindings (%zu bytes).", count,
+                bytes);
+        mem_free(allocator, table, ALLOC_SITE_REG_FROZEN);
+        free_scratch(allocator, &scratch);
+        return 2;
+    }
+
+    uint32_t* pilots = (uint32_t*)&table->entries[slots];
+    int ret = 5;
+    for (int attempt = 0; attempt < BUILD_ATTEMPTS && ret == 5; attempt++)
+    {
+        if (attempt > 0)
+            salt = mix64(salt + GOLDEN);
+
+        // group keys by bucket: counting sort on bucket id
+        memset(scratch.bucket_start, 0, (buckets + 1) * sizeof(size_t));
+        for (size_t i = 0; i < count; i++)
+        {
+            scratch.keys[i] = mix64(keys[i].hash ^ salt);
+            scratch.bucket_start[range(scratch.keys[i], buckets) + 1]++;
+        }
+        for (size_t b = 0; b < buckets; b++)
+            scratch.bucket_start[b + 1] += scratch.bucket_start[b];
+        for (size_t i = 0; i < count; i++)
+            scratch.bucket_keys[scratch.bucket_start[range(scratch.keys[i], buckets)]++] = i;
+        // the fill pass advanced every start to the next bucket's start
+        for (size_t b = buckets; b > 0; b--)
+            scratch.bucket_start[b] = scratch.bucket_start[b - 1];
+        scratch.bucket_start[0] = 0;
+
+        ret = find_pilots(&scratch, slots, buckets, pilots);
+    }
+    if (ret != 0)
+    {
+        LOG_OUT(LOG_WARNING, "no perfect hash for %zu bindings after %d salts.", count,
+                BUILD_ATTEMPTS);
+        mem_free(allocator, table, ALLOC_SITE_REG_FROZEN);
+        free_scratch(allocator, &scratch);
+        return ret;
+    }
+
+    table->count = count;
+    table->slots = slots;
+    table->buckets = buckets;
+    table->salt = salt;
+    table->bytes = bytes;
+    table->allocator = mem_resolve(allocator);
+    table->pilots = pilots;
+    char* names = (char*)&pilots[buckets];
+    table->names = names;
+    for (size_t e = 0; e < slots; e++)
+        table->entries[e] = (struct RegMphfEntry){0, 0, NULL};
+
+    size_t offset = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        uint64_t key = scratch.keys[i];
+        size_t index = entry_index(key, pilots[range(key, buckets)], slots);
+        size_t len = strlen(keys[i].name) + 1;
+        memcpy(names + offset, keys[i].name, len);
+        table->entries[index] = (struct RegMphfEntry){keys[i].hash, offset, keys[i].object};
+        offset += len;
+    }
+
+    free_scratch(allocator, &scratch);
+    *out = table;
+    return 0;
+}
+
+void reg_mphf_destroy(struct RegMphf* table)
+{
+    if (!table)
+        return;
+    struct LinalgAllocator allocator = table->allocator;
+    mem_free(&allocator, table, ALLOC_SITE_REG_FROZEN);
+}
+
+struct ObjWrapper* reg_mphf_find(const struct RegMphf* table, const char* name, uint64_t h)
+{
+    if (table->count == 0)
+        return NULL;
+
+    uint64_t key = mix64(h ^ table->salt);
+    const struct RegMphfEntry* entry =
+        &table->entries[entry_index(key, table->pilots[range(key, table->buckets)], table->slots)];
+    if (!entry->object || entry->hash != h || strcmp(table->names + entry->name_offset, name) != 0)
+        return NULL;
+    return entry->object;
+}
+
+size_t reg_mphf_count(const struct RegMphf* table)
+{
+    return table ? table->count : 0;
+}
+
+size_t reg_mphf_slots(const struct RegMphf* table)
+{
+    return table ? table->slots : 0;
+}
+
+size_t reg_mphf_bytes(const struct RegMphf* table)
+{
+    return table ? table->bytes : 0;
+}
+#pragma endregion
+
+#pragma region Private Functions
+/* ============================================================================
+ * Private helper implementation
+ * ============================================================================
+ */
+
+//  Purpose: 64-bit finalizer (splitmix64); a bijection, so distinct inputs
+//    stay distinct.
+//  Input assumptions: None.
+//  Effects: None.
+//  Returns: Mixed value.
+static inline uint64_t mix64(uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return x;
+}
+
+//  Purpose: Map a uniform 64-bit value onto [0, n) without a division.
+//  Input assumptions: n > 0.
+//  Effects: None.
+//  Returns: (x * n) >> 64.
+static inline size_t range(uint64_t x, size_t n)
+{
+    return (size_t)(((unsigned __int128)x * n) >> 64);
+}
+
+//  Purpose: Entry a key lands on under `pilot`.
+//  Input assumptions: slots > 0.
+//  Effects: None.
+//  Returns: Index in [0, slots).
+static inline size_t entry_index(uint64_t key, uint32_t pilot, size_t slots)
+{
+    return range(mix64(key ^ (pilot * GOLDEN)), slots);
+}
+
+//  Purpose: Choose a pilot for every bucket so all keys get distinct entries.
+//  Input assumptions: scratch->keys/bucket_start/bucket_keys filled for the
+//    current salt.
+//  Effects: Writes pilots; uses taken/positions/bucket_order as scratch.
+//  Returns:
+//    0 on success.
+//    5 if two keys of a bucket share a mixed hash or a bucket exhausts its
+//      try limit (caller retries with a new salt).
+static int find_pilots(const struct MphfScratch* scratch, size_t slots, size_t buckets,
+                       uint32_t* pilots)
+{
+    // order buckets largest first: counting sort on bucket size
+    size_t max_size = 0;
+    for (size_t b = 0; b < buckets; b++)
+    {
+        size_t size = scratch->bucket_start[b + 1] - scratch->bucket_start[b];
+        if (size > max_size)
+            max_size = size;
+    }
+    size_t next = 0;
+    for (size_t size = max_size + 1; size-- > 0;)
+    {
+        for (size_t b = 0; b < buckets; b++)
+        {
+            if (scratch->bucket_start[b + 1] - scratch->bucket_start[b] == size)
+                scratch->bucket_order[next++] = b;
+        }
+    }
+
+    memset(scratch->taken, 0, slots);
+    // with the spare entries a bucket's search is short; the budget only
+    // bounds the pathological salt, which the caller then replaces
+    uint64_t max_tries = (uint64_t)slots * TRIES_PER_SLOT;
+    if (max_tries > UINT32_MAX)
+        max_tries = UINT32_MAX;
+
+    for (size_t o = 0; o < buckets; o++)
+    {
+        size_t b = scratch->bucket_order[o];
+        const size_t* members = &scratch->bucket_keys[scratch->bucket_start[b]];
+        size_t size = scratch->bucket_start[b + 1] - scratch->bucket_start[b];
+        pilots[b] = 0;
+        if (size == 0)
+            continue;
+
+        // equal mixed hashes collide under every pilot
+        for (size_t i = 0; i < size; i++)
+        {
+            for (size_t j = i + 1; j < size; j++)
+            {
+                if (scratch->keys[members[i]] == scratch->keys[members[j]])
+                    return 5;
+            }
+        }
+
+        uint64_t pilot = 0;
+        for (; pilot < max_tries; pilot++)
+        {
+            size_t placed = 0;
+            for (; placed < size; placed++)
+            {
+                size_t index = entry_index(scratch->keys[members[placed]], (uint32_t)pilot, slots);
+                if (scratch->taken[index])
+                    break;
+                scratch->taken[index] = true; // tentatively, also catches in-bucket clashes
+                scratch->positions[placed] = index;
+            }
+            if (placed == size)
+                break;
+            for (size_t i = 0; i < placed; i++)
+                scratch->taken[scratch->positions[i]] = false;
+        }
+        if (pilot == max_tries)
+            return 5;
+        pilots[b] = (uint32_t)pilot;
+    }
+    return 0;
+}
+
+//  Purpose: Release build scratch buffers.
+//  Input assumptions: Unallocated members are NULL.
+//  Effects: Frees memory.
+//  Returns: None.
+static void free_scratch(const struct LinalgAllocator* allocator, struct MphfScratch* scratch)
+{
+    mem_free(allocator, scratch->keys, ALLOC_SITE_REG_FROZEN);
+    mem_free(allocator, scratch->bucket_start, ALLOC_SITE_REG_FROZEN);
+    mem_free(allocator, scratch->bucket_keys, ALLOC_SITE_REG_FROZEN);
+    mem_free(allocator, scratch->bucket_order, ALLOC_SITE_REG_FROZEN);
+    mem_free(allocator, scratch->taken, ALLOC_SITE_REG_FROZEN);
+    mem_free(allocator, scratch->positions, ALLOC_SITE_REG_FROZEN);
+}
+#pragma endregion
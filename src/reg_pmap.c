@@ -0,0 +1,546 @@
+#include "reg_pmap.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "logs.h"
+#include "math_objs.h"
+#include "mem_alloc.h"
+
+#pragma region Head Comment
+/*
+ * Translation unit implements:
+ * - The persistent name->object map behind registry snapshots.
+ *
+ * Scheme (hash array mapped trie with path copying):
+ * - A branch at depth d indexes children by hash bits [5d, 5d + 5): bit p of
+ *   its 32-bit bitmap is set when child p exists, and children[] holds only
+ *   the existing ones, in position order (index = popcount of lower bits).
+ * - A leaf may sit at any depth: put() pushes an existing leaf down only as
+ *   far as needed to separate it from the new one, and remove() pulls a
+ *   lone leaf back up, so lookups stop at the first leaf on the path.
+ * - Names with equal 64-bit hashes never separate; they share one leaf
+ *   chain (leaf->next), copied up to the changed entry on update.
+ * - Every update returns a new root and copies the nodes on its path; the
+ *   rest is shared and gains a reference from each copied parent.
+ */
+#pragma endregion
+
+#pragma region Local Definitions
+/* ============================================================================
+ * File-local definitions
+ * ============================================================================
+ */
+#define BITS_PER_LEVEL 5
+#define LEVEL_MASK 31u
+
+// Common node header; a map is a pointer to its root node.
+struct RegPmap
+{
+    size_t refs;     // atomic: maps and parent nodes holding this node
+    size_t count;    // bindings in this subtree (leaf: its chain)
+    uint32_t bitmap; // branch: occupied child positions; 0 for a leaf
+};
+
+struct PmapBranch
+{
+    struct RegPmap node;
+    struct RegPmap* children[]; // popcount(bitmap), in position order
+};
+
+struct PmapLeaf
+{
+    struct RegPmap node;
+    uint64_t hash;             // registry hash of name
+    struct ObjWrapper* object; // one reference held by the leaf
+    struct PmapLeaf* next;     // next name with the same hash, or NULL
+    char name[];
+};
+#pragma endregion
+
+#pragma region Private Function Prototypes
+/* ============================================================================
+ * Private function prototypes
+ * ============================================================================
+ */
+static inline unsigned int position(uint64_t h, unsigned int shift);
+static inline unsigned int child_index(uint32_t bitmap, unsigned int pos);
+static inline struct PmapLeaf* as_leaf(const struct RegPmap* node);
+static inline struct PmapBranch* as_branch(const struct RegPmap* node);
+static inline void retain(struct RegPmap* node);
+static int new_leaf(const char* name, uint64_t h, struct ObjWrapper* object,
+                    struct PmapLeaf* next, const struct LinalgAllocator* allocator,
+                    struct PmapLeaf** out);
+static struct PmapBranch* new_branch(uint32_t bitmap, const struct LinalgAllocator* allocator);
+static int chain_without(const struct PmapLeaf* chain, const char* name,
+                         const struct LinalgAllocator* allocator, struct PmapLeaf** out);
+static int join(struct RegPmap* a, uint64_t ha, struct RegPmap* b, uint64_t hb,
+                unsigned int shift, const struct LinalgAllocator* allocator,
+                struct RegPmap** out);
+static int put_node(const struct RegPmap* node, unsigned int shift, struct PmapLeaf* leaf,
+                    const struct LinalgAllocator* allocator, struct RegPmap** out);
+static int remove_node(const struct RegPmap* node, unsigned int shift, const char* name,
+                       uint64_t h, const struct LinalgAllocator* allocator,
+                       struct RegPmap** out);
+static struct PmapBranch* copy_branch(const struct PmapBranch* branch, uint32_t bitmap,
+                                      unsigned int skip, const struct LinalgAllocator* allocator);
+#pragma endregion
+
+#pragma region Public API
+/* ============================================================================
+ * Public API implementation
+ * ============================================================================
+ */
+
+int reg_pmap_put(const struct RegPmap* map, const char* name, uint64_t h,
+                 struct ObjWrapper* object, const struct LinalgAllocator* allocator,
+                 struct RegPmap** out)
+{
+    *out = NULL;
+    struct PmapLeaf* leaf = NULL;
+    int ret = new_leaf(name, h, object, NULL, allocator, &leaf);
+    if (ret != 0)
+        return ret;
+
+    ret = put_node(map, 0, leaf, allocator, out);
+    if (ret != 0)
+    {
+        reg_pmap_release(&leaf->node, allocator);
+        *out = NULL;
+    }
+    return ret;
+}
+
+int reg_pmap_remove(const struct RegPmap* map, const char* name, uint64_t h,
+                    const struct LinalgAllocator* allocator, struct RegPmap** out)
+{
+    *out = NULL;
+    return remove_node(map, 0, name, h, allocator, out);
+}
+
+struct ObjWrapper* reg_pmap_find(const struct RegPmap* map, const char* name, uint64_t h)
+{
+    unsigned int shift = 0;
+    while (map && map->bitmap)
+    {
+        unsigned int pos = position(h, shift);
+        if (!(map->bitmap & (1u << pos)))
+            return NULL;
+        map = as_branch(map)->children[child_index(map->bitmap, pos)];
+        shift += BITS_PER_LEVEL;
+    }
+
+    for (const struct PmapLeaf* leaf = map ? as_leaf(map) : NULL; leaf; leaf = leaf->next)
+    {
+        if (leaf->hash != h)
+            return NULL; // a chain shares one hash
+        if (!strcmp(leaf->name, name))
+            return leaf->object;
+    }
+    return NULL;
+}
+
+size_t reg_pmap_count(const struct RegPmap* map)
+{
+    return map ? map->count : 0;
+}
+
+void reg_pmap_retain(struct RegPmap* map)
+{
+    if (map)
+        retain(map);
+}
+
+void reg_pmap_release(struct RegPmap* map, const struct LinalgAllocator* allocator)
+{
+    while (map && __atomic_sub_fetch(&map->refs, 1, __ATOMIC_ACQ_REL) == 0)
+    {
+        if (map->bitmap)
+        {
+            struct PmapBranch* branch = as_branch(map);
+            unsigned int n = (unsigned int)__builtin_popcount(map->bitmap);
+            for (unsigned int i = 0; i < n; i++)
+                reg_pmap_release(branch->children[i], allocator); // depth <= 13
+            mem_free(allocator, branch, ALLOC_SITE_REG_SNAPSHOT);
+            return;
+        }
+
+        struct PmapLeaf* leaf = as_leaf(map);
+        map = leaf->next ? &leaf->next->node : NULL;
+        int decref_ret = decref_obj(leaf->object);
+        if (decref_ret != 0)
+        {
+            LOG_OUT(LOG_ERROR, "decref_obj() failed rtn=%d obj=%p name=%s.", decref_ret,
+                    leaf->object, leaf->name);
+            assert(decref_ret == 0); // internal invariant violation
+        }
+        mem_free(allocator, leaf, ALLOC_SITE_REG_SNAPSHOT);
+    }
+}
+#pragma endregion
+
+#pragma region Private Functions
+/* ============================================================================
+ * Private helper implementation
+ * ============================================================================
+ */
+
+//  Purpose: Child position of hash `h` in a branch at bit offset `shift`.
+//  Input assumptions: shift < 64.
+//  Effects: None.
+//  Returns: Position in [0, 32).
+static inline unsigned int position(uint64_t h, unsigned int shift)
+{
+    return (unsigned int)(h >> shift) & LEVEL_MASK;
+}
+
+//  Purpose: Index into children[] of position `pos`.
+//  Input assumptions: pos < 32.
+//  Effects: None.
+//  Returns: Number of occupied positions below pos.
+static inline unsigned int child_index(uint32_t bitmap, unsigned int pos)
+{
+    return (unsigned int)__builtin_popcount(bitmap & ((1u << pos) - 1));
+}
+
+//  Purpose: View a node as a leaf.
+//  Input assumptions: node->bitmap == 0.
+//  Effects: None.
+//  Returns: The leaf.
+static inline struct PmapLeaf* as_leaf(const struct RegPmap* node)
+{
+    return (struct PmapLeaf*)node;
+}
+
+//  Purpose: View a node as a branch.
+//  Input assumptions: node->bitmap != 0.
+//  Effects: None.
+//  Returns: The branch.
+static inline struct PmapBranch* as_branch(const struct RegPmap* node)
+{
+    return (struct PmapBranch*)node;
+}
+
+//  Purpose: Add one reference to a node.
+//  Input assumptions: node != NULL and already referenced by the caller.
+//  Effects: node->refs incremented.
+//  Returns: None.
+static inline void retain(struct RegPmap* node)
+{
+    __atomic_add_fetch(&node->refs, 1, __ATOMIC_RELAXED);
+}
+
+//  Purpose: Allocate a leaf binding `name` to `object`.
+//  Input assumptions: `next` is NULL or a chain of the same hash whose
+//    reference moves to the new leaf.
+//  Effects: Copies name; increfs object. On failure `next` is still the
+//    caller's.
+//  Returns:
+//    0: Success, *out has one reference.
+//    2: Allocation failure.
+//    4: incref_obj() failure.
+static int new_leaf(const char* name, uint64_t h, struct ObjWrapper* object,
+                    struct PmapLeaf* next, const struct LinalgAllocator* allocator,
+                    struct PmapLeaf** out)
+{
+    size_t len = strlen(name) + 1;
+    struct PmapLeaf* leaf =
+        mem_alloc(allocator, sizeof(struct PmapLeaf) + len, ALLOC_SITE_REG_SNAPSHOT);
+    if (!leaf)
+    {
+        LOG_OUT(LOG_ERROR, "failed to allocate snapshot leaf for name=%s.", name);
+        return 2;
+    }
+
+    int incref_ret = incref_obj(object);
+    if (incref_ret != 0)
+    {
+        LOG_OUT(LOG_ERROR, "incref_obj() failed with ret=%d.", incref_ret);
+        mem_free(allocator, leaf, ALLOC_SITE_REG_SNAPSHOT);
+        return 4;
+    }
+
+    leaf->node = (struct RegPmap){1, 1 + (next ? next->node.count : 0), 0};
+    leaf->hash = h;
+    leaf->object = object;
+    leaf->next = next;
+    memcpy(leaf->name, name, len);
+    *out = leaf;
+    return 0;
+}
+
+//  Purpose: Allocate a branch with room for popcount(bitmap) children.
+//  Input assumptions: bitmap != 0.
+//  Effects: refs = 1, count = 0; children uninitialized.
+//  Returns: Branch, or NULL on allocation failure.
+static struct PmapBranch* new_branch(uint32_t bitmap, const struct LinalgAllocator* allocator)
+{
+    size_t n = (size_t)__builtin_popcount(bitmap);
+    size_t bytes = sizeof(struct PmapBranch) + n * sizeof(struct RegPmap*);
+    struct PmapBranch* branch = mem_alloc(allocator, bytes, ALLOC_SITE_REG_SNAPSHOT);
+    if (!branch)
+    {
+        LOG_OUT(LOG_ERROR, "failed to allocate snapshot branch of %zu children.", n);
+        return NULL;
+    }
+    branch->node = (struct RegPmap){1, 0, bitmap};
+    return branch;
+}
+
+//  Purpose: Copy `branch` onto a new bitmap, leaving one slot to the caller.
+//  Input assumptions: bitmap is branch's bitmap, with or without one bit
+//    changed; `skip` is the position being replaced, inserted or removed.
+//  Effects: Every kept child gains a reference; count covers kept children.
+//  Returns: The copy with children[child_index(bitmap, skip)] unset when
+//    skip is in bitmap, or NULL on allocation failure.
+static struct PmapBranch* copy_branch(const struct PmapBranch* branch, uint32_t bitmap,
+                                      unsigned int skip, const struct LinalgAllocator* allocator)
+{
+    struct PmapBranch* copy = new_branch(bitmap, allocator);
+    if (!copy)
+        return NULL;
+
+    size_t out = 0;
+    size_t in = 0;
+    for (unsigned int pos = 0; pos < 32; pos++)
+    {
+        bool had = branch->node.bitmap & (1u << pos);
+        bool has = bitmap & (1u << pos);
+        if (pos != skip && had)
+        {
+            struct RegPmap* child = branch->children[in];
+            retain(child);
+            copy->children[out] = child;
+            copy->node.count += child->count;
+        }
+        in += had;
+        out += has;
+    }
+    return copy;
+}
+
+//  Purpose: Copy a same-hash chain without the entry for `name`.
+//  Input assumptions: chain is NULL or a leaf chain.
+//  Effects: Entries before the match are copied (names and object refs);
+//    the rest of the chain is shared.
+//  Returns:
+//    0: Found; *out is the new chain (NULL when it was the only entry).
+//    1: name not in chain; *out untouched.
+//    2 or 4: new_leaf() failure; *out untouched.
+static int chain_without(const struct PmapLeaf* chain, const char* name,
+                         const struct LinalgAllocator* allocator, struct PmapLeaf** out)
+{
+    if (!chain)
+        return 1;
+    if (!strcmp(chain->name, name))
+    {
+        if (chain->next)
+            retain(&chain->next->node);
+        *out = chain->next;
+        return 0;
+    }
+
+    struct PmapLeaf* rest = NULL;
+    int ret = chain_without(chain->next, name, allocator, &rest);
+    if (ret != 0)
+        return ret;
+    ret = new_leaf(chain->name, chain->hash, chain->object, rest, allocator, out);
+    if (ret != 0)
+        reg_pmap_release(rest ? &rest->node : NULL, allocator);
+    return ret;
+}
+
+//  Purpose: Build the smallest subtree holding two nodes whose hashes
+//    differ.
+//  Input assumptions: ha != hb; a and b are owned references (leaves, or a
+//    leaf and the subtree it was pushed down from) that agree on every hash
+//    bit below `shift`.
+//  Effects: On success a and b move into *out; on failure both are released.
+//  Returns: 0 on success, 2 on allocation failure.
+static int join(struct RegPmap* a, uint64_t ha, struct RegPmap* b, uint64_t hb,
+                unsigned int shift, const struct LinalgAllocator* allocator,
+                struct RegPmap** out)
+{
+    unsigned int pa = position(ha, shift);
+    unsigned int pb = position(hb, shift);
+    if (pa == pb)
+    {
+        struct RegPmap* child = NULL;
+        if (join(a, ha, b, hb, shift + BITS_PER_LEVEL, allocator, &child) != 0)
+            return 2;
+        struct PmapBranch* branch = new_branch(1u << pa, allocator);
+        if (!branch)
+        {
+            reg_pmap_release(child, allocator);
+            return 2;
+        }
+        branch->children[0] = child;
+        branch->node.count = child->count;
+        *out = &branch->node;
+        return 0;
+    }
+
+    struct PmapBranch* branch = new_branch((1u << pa) | (1u << pb), allocator);
+    if (!branch)
+    {
+        reg_pmap_release(a, allocator);
+        reg_pmap_release(b, allocator);
+        return 2;
+    }
+    branch->children[pa < pb ? 0 : 1] = a;
+    branch->children[pa < pb ? 1 : 0] = b;
+    branch->node.count = a->count + b->count;
+    *out = &branch->node;
+    return 0;
+}
+
+//  Purpose: put() below `node`.
+//  Input assumptions: leaf is a fresh single-entry leaf owned by the caller;
+//    node (NULL for empty) agrees with leaf->hash on the bits below shift.
+//  Effects: On success the leaf's reference moves into *out; on failure it
+//    stays the caller's. node is never modified.
+//  Returns: 0 on success, 2 or 4 on failure.
+static int put_node(const struct RegPmap* node, unsigned int shift, struct PmapLeaf* leaf,
+                    const struct LinalgAllocator* allocator, struct RegPmap** out)
+{
+    uint64_t h = leaf->hash;
+    if (!node)
+    {
+        *out = &leaf->node;
+        return 0;
+    }
+
+    if (!node->bitmap)
+    {
+        struct PmapLeaf* old = as_leaf(node);
+        if (old->hash == h)
+        {
+            // same hash: the new entry heads the chain, minus any old one
+            struct PmapLeaf* rest = NULL;
+            int ret = chain_without(old, leaf->name, allocator, &rest);
+            if (ret == 1)
+            {
+                retain(&old->node);
+                rest = old;
+            }
+            else if (ret != 0)
+                return ret;
+            leaf->next = rest;
+            leaf->node.count = 1 + (rest ? rest->node.count : 0);
+            *out = &leaf->node;
+            return 0;
+        }
+
+        retain(&old->node);
+        retain(&leaf->node); // join() consumes one reference on failure
+        int ret = join(&old->node, old->hash, &leaf->node, h, shift, allocator, out);
+        if (ret == 0)
+            reg_pmap_release(&leaf->node, allocator); // the subtree holds it now
+        return ret;
+    }
+
+    const struct PmapBranch* branch = as_branch(node);
+    unsigned int pos = position(h, shift);
+    uint32_t bit = 1u << pos;
+    struct RegPmap* child = NULL;
+    if (node->bitmap & bit)
+    {
+        const struct RegPmap* old_child = branch->children[child_index(node->bitmap, pos)];
+        int ret = put_node(old_child, shift + BITS_PER_LEVEL, leaf, allocator, &child);
+        if (ret != 0)
+            return ret;
+    }
+    else
+        child = &leaf->node;
+
+    struct PmapBranch* copy = copy_branch(branch, node->bitmap | bit, pos, allocator);
+    if (!copy)
+    {
+        if (child != &leaf->node)
+        {
+            // the leaf is referenced from child now; keep the caller's copy
+            retain(&leaf->node);
+            reg_pmap_release(child, allocator);
+        }
+        return 2;
+    }
+    copy->children[child_index(copy->node.bitmap, pos)] = child;
+    copy->node.count += child->count;
+    *out = &copy->node;
+    return 0;
+}
+
+//  Purpose: remove() below `node`.
+//  Input assumptions: node (NULL for empty) agrees with h on the bits below
+//    shift.
+//  Effects: node is never modified.
+//  Returns: reg_pmap_remove() codes; on 0, *out is NULL when the subtree
+//    became empty.
+static int remove_node(const struct RegPmap* node, unsigned int shift, const char* name,
+                       uint64_t h, const struct LinalgAllocator* allocator,
+                       struct RegPmap** out)
+{
+    if (!node)
+        return 1;
+
+    if (!node->bitmap)
+    {
+        if (as_leaf(node)->hash != h)
+            return 1;
+        struct PmapLeaf* rest = NULL;
+        int ret = chain_without(as_leaf(node), name, allocator, &rest);
+        if (ret == 4)
+            ret = 2; // copying a chain entry cannot fail for a live object
+        if (ret == 0)
+            *out = rest ? &rest->node : NULL;
+        return ret;
+    }
+
+    const struct PmapBranch* branch = as_branch(node);
+    unsigned int pos = position(h, shift);
+    uint32_t bit = 1u << pos;
+    if (!(node->bitmap & bit))
+        return 1;
+
+    unsigned int index = child_index(node->bitmap, pos);
+    struct RegPmap* child = NULL;
+    int ret =
+        remove_node(branch->children[index], shift + BITS_PER_LEVEL, name, h, allocator, &child);
+    if (ret != 0)
+        return ret;
+
+    unsigned int n = (unsigned int)__builtin_popcount(node->bitmap);
+    if (!child && n == 1)
+        return 0; // subtree empty
+    if (!child && n == 2 && !branch->children[1 - index]->bitmap)
+    {
+        // lone leaf left: it moves up in place of this branch
+        retain(branch->children[1 - index]);
+        *out = branch->children[1 - index];
+        return 0;
+    }
+    if (child && n == 1 && !child->bitmap)
+    {
+        *out = child;
+        return 0;
+    }
+
+    uint32_t bitmap = child ? node->bitmap : node->bitmap & ~bit;
+    struct PmapBranch* copy = copy_branch(branch, bitmap, pos, allocator);
+    if (!copy)
+    {
+        reg_pmap_release(child, allocator);
+        return 2;
+    }
+    if (child)
+    {
+        copy->children[index] = child;
+        copy->node.count += child->count;
+    }
+    *out = &copy->node;
+    return 0;
+}
+#pragma endregion
@@ -0,0 +1,478 @@
+#include "reg_trie.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "logs.h"
+#include "mem_alloc.h"
+
+#pragma region Head Comment
+/*
+ * Translation unit implements:
+ * - Insert, remove and prefix collection for the path-compressed trie behind
+ *   the registry's prefix index.
+ *
+ * Layout:
+ * - Each node stores the label of the edge that leads to it inline (flexible
+ *   array member), so a node is one allocation. Splitting a node shortens its
+ *   label in place; merging two nodes allocates one replacement node.
+ * - Children form a singly linked list sorted by first label byte. Registry
+ *   names fan out over few distinct bytes per level ("layer0", "layer1", ...),
+ *   so a short list beats a 256-entry table on both memory and scan cost.
+ */
+#pragma endregion
+
+#pragma region Local Definitions
+/* ============================================================================
+ * File-local definitions
+ * ============================================================================
+ */
+#define NAMES_MIN_CAPACITY 256
+#define PATH_MIN_CAPACITY 64
+
+struct RegTrieNode
+{
+    struct RegTrieNode* child;   // first child (sorted by label[0])
+    struct RegTrieNode* sibling; // next child of the same parent
+    size_t label_len;            // 0 only for the root
+    bool terminal;               // a stored name ends at this node
+    char label[];                // edge label, not NUL-terminated
+};
+
+struct RegTrie
+{
+    struct RegTrieNode* root;
+    size_t count;
+    struct LinalgAllocator allocator; // every node and the trie itself
+};
+
+// Growable byte buffer holding the path from the collect root to the node
+// being visited.
+struct TriePath
+{
+    const struct LinalgAllocator* allocator;
+    char* data;
+    size_t len;
+    size_t capacity;
+};
+#pragma endregion
+
+#pragma region Private Function Prototypes
+/* ============================================================================
+ * Private function prototypes
+ * ============================================================================
+ */
+static struct RegTrieNode* new_node(const struct LinalgAllocator* allocator, const char* label,
+                                    size_t label_len, bool terminal);
+static void free_subtree(const struct LinalgAllocator* allocator, struct RegTrieNode* node);
+static struct RegTrieNode** find_child_link(struct RegTrieNode* node, char first);
+static size_t common_prefix(const char* a, size_t a_len, const char* b, size_t b_len);
+static void merge_with_child(const struct LinalgAllocator* allocator, struct RegTrieNode** link);
+static int path_append(struct TriePath* path, const char* bytes, size_t len);
+static int names_append(struct RegTrieNames* names, const char* name, size_t len);
+static int collect_subtree(const struct RegTrieNode* node, struct TriePath* path,
+                           struct RegTrieNames* names);
+#pragma endregion
+
+#pragma region Public API
+/* ============================================================================
+ * Public API implementation
+ * ============================================================================
+ */
+
+struct RegTrie* reg_trie_init(const struct LinalgAllocator* allocator)
+{
+    struct RegTrie* trie = mem_alloc(allocator, sizeof(struct RegTrie), ALLOC_SITE_REG_PREFIX);
+    if (!trie)
+    {
+        LOG_OUT(LOG_ERROR, "failed to allocate %zu bytes for trie.", sizeof(struct RegTrie));
+        return NULL;
+    }
+
+    trie->allocator = mem_resolve(allocator);
+    trie->root = new_node(&trie->allocator, NULL, 0, false);
+    if (!trie->root)
+    {
+        mem_free(allocator, trie, ALLOC_SITE_REG_PREFIX);
+        return NULL;
+    }
+    trie->count = 0;
+    return trie;
+}
+
+int reg_trie_destroy(struct RegTrie* trie)
+{
+    if (!trie)
+        return 0;
+
+    struct LinalgAllocator allocator = trie->allocator;
+    free_subtree(&allocator, trie->root);
+    mem_free(&allocator, trie, ALLOC_SITE_REG_PREFIX);
+    return 0;
+}
+
+int reg_trie_insert(struct RegTrie* trie, const char* name)
+{
+    struct RegTrieNode* node = trie->root;
+    const char* key = name;
+    size_t rem = strlen(name);
+
+    while (rem > 0)
+    {
+        struct RegTrieNode** link = find_child_link(node, key[0]);
+        struct RegTrieNode* child = *link;
+
+        if (!child || child->label[0] != key[0])
+        {
+            // no edge starts with key[0]: hang the rest of the key off node
+            struct RegTrieNode* leaf = new_node(&trie->allocator, key, rem, true);
+            if (!leaf)
+                return 2;
+            leaf->sibling = child;
+            *link = leaf;
+            trie->count++;
+            return 0;
+        }
+
+        size_t common = common_prefix(child->label, child->label_len, key, rem);
+        if (common == child->label_len)
+        {
+            node = child;
+            key += common;
+            rem -= common;
+            continue;
+        }
+
+        // key diverges inside child's label: split the edge at `common`.
+        // Allocate everything first so failure leaves the trie untouched.
+        bool ends_here = (common == rem);
+        struct RegTrieNode* mid = new_node(&trie->allocator, child->label, common, ends_here);
+        struct RegTrieNode* leaf =
+            ends_here ? NULL : new_node(&trie->allocator, key + common, rem - common, true);
+        if (!mid || (!ends_here && !leaf))
+        {
+            mem_free(&trie->allocator, mid, ALLOC_SITE_REG_PREFIX);
+            mem_free(&trie->allocator, leaf, ALLOC_SITE_REG_PREFIX);
+            return 2;
+        }
+
+        memmove(child->label, child->label + common, child->label_len - common);
+        child->label_len -= common;
+        mid->sibling = child->sibling;
+        child->sibling = NULL;
+        mid->child = child;
+        *link = mid;
+
+        if (leaf)
+        {
+            // two children with distinct first bytes; keep them sorted
+            if ((unsigned char)leaf->label[0] < (unsigned char)child->label[0])
+            {
+                leaf->sibling = child;
+                mid->child = leaf;
+            }
+            else
+                child->sibling = leaf;
+        }
+        trie->count++;
+        return 0;
+    }
+
+    if (!node->terminal && node != trie->root)
+    {
+        node->terminal = true;
+        trie->count++;
+    }
+    return 0;
+}
+
+int reg_trie_remove(struct RegTrie* trie, const char* name)
+{
+    struct RegTrieNode* parent = NULL;
+    struct RegTrieNode** parent_link = NULL;
+    struct RegTrieNode** link = &trie->root;
+    const char* key = name;
+    size_t rem = strlen(name);
+
+    while (rem > 0)
+    {
+        struct RegTrieNode** next = find_child_link(*link, key[0]);
+        struct RegTrieNode* child = *next;
+        if (!child || child->label[0] != key[0] || child->label_len > rem ||
+            memcmp(child->label, key, child->label_len) != 0)
+            return 1;
+
+        parent = *link;
+        parent_link = link;
+        link = next;
+        key += child->label_len;
+        rem -= child->label_len;
+    }
+
+    struct RegTrieNode* node = *link;
+    if (!node->terminal || node == trie->root)
+        return 1;
+
+    node->terminal = false;
+    trie->count--;
+
+    if (!node->child)
+    {
+        // leaf: unlink it, then the parent may be left with a single child
+        *link = node->sibling;
+        mem_free(&trie->allocator, node, ALLOC_SITE_REG_PREFIX);
+        if (parent != trie->root && !parent->terminal && parent->child &&
+            !parent->child->sibling)
+            merge_with_child(&trie->allocator, parent_link);
+    }
+    else if (!node->child->sibling)
+        merge_with_child(&trie->allocator, link);
+
+    return 0;
+}
+
+int reg_trie_collect(const struct RegTrie* trie, const char* prefix, struct RegTrieNames* names)
+{
+    const struct RegTrieNode* node = trie->root;
+    size_t len = strlen(prefix);
+    size_t consumed = 0; // prefix bytes spelled by the edges above node
+
+    // descend until the prefix is used up; the subtree below node matches
+    while (consumed < len)
+    {
+        const struct RegTrieNode* child = node->child;
+        while (child && (unsigned char)child->label[0] < (unsigned char)prefix[consumed])
+            child = child->sibling;
+        if (!child || child->label[0] != prefix[consumed])
+            return 0;
+
+        size_t rem = len - consumed;
+        size_t common = common_prefix(child->label, child->label_len, prefix + consumed, rem);
+        if (common < rem && common < child->label_len)
+            return 0; // diverges inside the edge
+
+        node = child;
+        if (common == rem)
+            break; // prefix ends at or inside child's label
+        consumed += common;
+    }
+
+    // path = bytes above node; collect_subtree appends node's own label
+    struct TriePath path = {.allocator = &trie->allocator};
+    if (!names->data)
+        names->allocator = trie->allocator;
+    int ret = path_append(&path, prefix, consumed);
+    if (ret == 0)
+        ret = collect_subtree(node, &path, names);
+    mem_free(&trie->allocator, path.data, ALLOC_SITE_REG_PREFIX);
+    return ret;
+}
+
+void reg_trie_names_free(struct RegTrieNames* names)
+{
+    if (!names)
+        return;
+    if (names->data)
+        mem_free(&names->allocator, names->data, ALLOC_SITE_REG_PREFIX);
+    *names = (struct RegTrieNames){0};
+}
+
+size_t reg_trie_count(const struct RegTrie* trie)
+{
+    return trie ? trie->count : 0;
+}
+#pragma endregion
+
+#pragma region Private Functions
+/* ============================================================================
+ * Private helper implementation
+ * ============================================================================
+ */
+
+//  Purpose: Allocate a node carrying a copy of `label`.
+//  Input assumptions: label points to label_len readable bytes (or is NULL
+//    when label_len == 0).
+//  Effects: Allocates one block.
+//  Returns:
+//    Node with no children or siblings on success.
+//    NULL on allocation failure.
+static struct RegTrieNode* new_node(const struct LinalgAllocator* allocator, const char* label,
+                                    size_t label_len, bool terminal)
+{
+    struct RegTrieNode* node =
+        mem_alloc(allocator, sizeof(struct RegTrieNode) + label_len, ALLOC_SITE_REG_PREFIX);
+    if (!node)
+    {
+        LOG_OUT(LOG_ERROR, "failed to allocate %zu bytes for trie node.",
+                sizeof(struct RegTrieNode) + label_len);
+        return NULL;
+    }
+
+    node->child = NULL;
+    node->sibling = NULL;
+    node->label_len = label_len;
+    node->terminal = terminal;
+    if (label_len)
+        memcpy(node->label, label, label_len);
+    return node;
+}
+
+//  Purpose: Free `node`, its children and (recursively) their subtrees.
+//  Input assumptions: node may be NULL; its siblings are not freed.
+//  Effects: Frees memory.
+//  Returns: None.
+static void free_subtree(const struct LinalgAllocator* allocator, struct RegTrieNode* node)
+{
+    if (!node)
+        return;
+
+    struct RegTrieNode* child = node->child;
+    while (child)
+    {
+        struct RegTrieNode* next = child->sibling;
+        free_subtree(allocator, child);
+        child = next;
+    }
+    mem_free(allocator, node, ALLOC_SITE_REG_PREFIX);
+}
+
+//  Purpose: Locate where a child starting with `first` is, or would be
+//    inserted, in node's sorted child list.
+//  Input assumptions: node != NULL.
+//  Effects: None.
+//  Returns: Link to the first child whose label[0] >= first (or to the list
+//    tail); the caller checks whether *link actually starts with `first`.
+static struct RegTrieNode** find_child_link(struct RegTrieNode* node, char first)
+{
+    struct RegTrieNode** link = &node->child;
+    while (*link && (unsigned char)(*link)->label[0] < (unsigned char)first)
+        link = &(*link)->sibling;
+    return link;
+}
+
+//  Purpose: Length of the longest common prefix of two byte strings.
+//  Input assumptions: None.
+//  Effects: None.
+//  Returns: Number of leading bytes equal in a and b.
+static size_t common_prefix(const char* a, size_t a_len, const char* b, size_t b_len)
+{
+    size_t limit = (a_len < b_len) ? a_len : b_len;
+    size_t i = 0;
+    while (i < limit && a[i] == b[i])
+        i++;
+    return i;
+}
+
+//  Purpose: Fold a non-terminal node with exactly one child into that child.
+//  Input assumptions: *link is a non-root, non-terminal node with one child.
+//  Effects: Replaces *link with one node whose label is the concatenation;
+//    frees both originals. Left as is on allocation failure (the trie stays
+//    correct, just one node less compact).
+//  Returns: None.
+static void merge_with_child(const struct LinalgAllocator* allocator, struct RegTrieNode** link)
+{
+    struct RegTrieNode* node = *link;
+    struct RegTrieNode* child = node->child;
+
+    struct RegTrieNode* merged =
+        mem_alloc(allocator, sizeof(struct RegTrieNode) + node->label_len + child->label_len,
+                  ALLOC_SITE_REG_PREFIX);
+    if (!merged)
+        return;
+
+    memcpy(merged->label, node->label, node->label_len);
+    memcpy(merged->label + node->label_len, child->label, child->label_len);
+    merged->label_len = node->label_len + child->label_len;
+    merged->terminal = child->terminal;
+    merged->child = child->child;
+    merged->sibling = node->sibling;
+    *link = merged;
+
+    mem_free(allocator, child, ALLOC_SITE_REG_PREFIX);
+    mem_free(allocator, node, ALLOC_SITE_REG_PREFIX);
+}
+
+//  Purpose: Append bytes to the traversal path.
+//  Input assumptions: path != NULL.
+//  Effects: May grow path->data.
+//  Returns:
+//    0 on success.
+//    2 on allocation failure.
+static int path_append(struct TriePath* path, const char* bytes, size_t len)
+{
+    if (path->len + len > path->capacity || !path->data)
+    {
+        size_t capacity = path->capacity ? path->capacity : PATH_MIN_CAPACITY;
+        while (capacity < path->len + len)
+            capacity *= 2;
+        char* data = mem_realloc(path->allocator, path->data, path->capacity, capacity,
+                                 ALLOC_SITE_REG_PREFIX);
+        if (!data)
+        {
+            LOG_OUT(LOG_ERROR, "failed to allocate %zu bytes for trie path.", capacity);
+            return 2;
+        }
+        path->data = data;
+        path->capacity = capacity;
+    }
+
+    if (len)
+        memcpy(path->data + path->len, bytes, len);
+    path->len += len;
+    return 0;
+}
+
+//  Purpose: Append one NUL-terminated name to a name list.
+//  Input assumptions: name points to len bytes (no terminator required).
+//  Effects: May grow names->data.
+//  Returns:
+//    0 on success.
+//    2 on allocation failure.
+static int names_append(struct RegTrieNames* names, const char* name, size_t len)
+{
+    if (names->used + len + 1 > names->capacity)
+    {
+        size_t capacity = names->capacity ? names->capacity : NAMES_MIN_CAPACITY;
+        while (capacity < names->used + len + 1)
+            capacity *= 2;
+        char* data = mem_realloc(&names->allocator, names->data, names->capacity, capacity,
+                                 ALLOC_SITE_REG_PREFIX);
+        if (!data)
+        {
+            LOG_OUT(LOG_ERROR, "failed to allocate %zu bytes for name list.", capacity);
+            return 2;
+        }
+        names->data = data;
+        names->capacity = capacity;
+    }
+
+    memcpy(names->data + names->used, name, len);
+    names->data[names->used + len] = '\0';
+    names->used += len + 1;
+    names->count++;
+    return 0;
+}
+
+//  Purpose: Depth-first walk appending every name stored at or below node.
+//  Input assumptions: path holds the bytes of every edge above node.
+//  Effects: Appends to names; path is restored to its entry length.
+//  Returns:
+//    0 on success.
+//    2 on allocation failure.
+static int collect_subtree(const struct RegTrieNode* node, struct TriePath* path,
+                           struct RegTrieNames* names)
+{
+    size_t base = path->len;
+    int ret = path_append(path, node->label, node->label_len);
+    if (ret == 0 && node->terminal)
+        ret = names_append(names, path->data, path->len);
+
+    for (const struct RegTrieNode* child = node->child; ret == 0 && child; child = child->sibling)
+        ret = collect_subtree(child, path, names);
+
+    path->len = base;
+    return ret;
+}
+#pragma endregion
@@ -0,0 +1,90 @@
+// Buffer recycling benchmark: a loop that creates, fills and drops a
+// same-shaped matrix every iteration, with the recycling pool off and on.
+//
+// Build (from repo root):
+//   gcc -O2 -DNDEBUG -pthread -Iinclude -Isrc/internal src/*.c tests/bench/buffer_pool_bench.c
+//       -o tests/builds/buffer_pool_bench
+//
+// Usage:
+//   tests/builds/buffer_pool_bench [dim] [iterations]
+//
+// Each iteration allocates a dim x dim double buffer (default 2048, 32 MiB)
+// with linalg_alloc_elements(), writes every element, binds it to a matrix
+// and drops the matrix. Reports ms/iteration for ELEMENTS_ALIGNED and
+// ELEMENTS_HUGE buffers; with the pool off every iteration faults its pages
+// in again, with it on only the first one does.
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "logs.h"
+#include "math_objs.h"
+#include "obj_buffer.h"
+
+/* ============================================================================
+ * Helper function prototypes
+ * ============================================================================
+ */
+static double now_ns(void);
+static double run(size_t dim, size_t iterations, enum ElementAlloc kind);
+
+/* ============================================================================
+ * main()
+ * ============================================================================
+ */
+int main(int argc, char** argv)
+{
+    size_t dim = (argc > 1) ? strtoull(argv[1], NULL, 10) : 2048;
+    size_t iterations = (argc > 2) ? strtoull(argv[2], NULL, 10) : 50;
+
+    set_log_level(LOG_NONE);
+
+    printf("%-10s %14s %14s\n", "kind", "pool off ms", "pool on ms");
+    for (int k = 0; k < 2; k++)
+    {
+        enum ElementAlloc kind = k ? ELEMENTS_HUGE : ELEMENTS_ALIGNED;
+        obj_buffer_pool_config(0, 0);
+        double off = run(dim, iterations, kind);
+        obj_buffer_pool_config((size_t)1 << 30, 1000);
+        double on = run(dim, iterations, kind);
+        obj_buffer_pool_config(0, 0);
+        if (off < 0 || on < 0)
+            return 1;
+        printf("%-10s %14.3f %14.3f\n", k ? "huge" : "aligned", off / 1e6, on / 1e6);
+    }
+    return 0;
+}
+
+/* ============================================================================
+ * Helper functions
+ * ============================================================================
+ */
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+// ns per create/fill/drop iteration, or -1 on failure
+static double run(size_t dim, size_t iterations, enum ElementAlloc kind)
+{
+    size_t count = dim * dim;
+    double start = now_ns();
+    for (size_t i = 0; i < iterations; i++)
+    {
+        struct List elements;
+        if (obj_buffer_alloc(&elements, count, sizeof(double), kind) != 0)
+            return -1;
+        double* list = elements.list;
+        for (size_t e = 0; e < count; e++)
+            list[e] = (double)(e + i);
+
+        struct ObjWrapper* matrix = create_matrix(elements, dim, dim);
+        if (!matrix)
+            return -1;
+        decref_obj(matrix);
+    }
+    return (now_ns() - start) / (double)iterations;
+}
@@ -0,0 +1,144 @@
+// Bulk create+bind benchmark: linalg_create_bind_matrix() loop vs one
+// linalg_create_bind_matrices() call.
+//
+// Build (from repo root):
+//   gcc -O2 -DNDEBUG -pthread -Iinclude -Isrc/internal src/*.c tests/bench/linalg_bulk_bench.c
+//       -o tests/builds/linalg_bulk_bench
+//
+// Usage:
+//   tests/builds/linalg_bulk_bench [max_items]
+//
+// For 10K, 50K and 200K items (capped at max_items) loads 4x4 double
+// matrices named like model weights and reports total ms and ns/item for each
+// path. Element buffers are allocated before timing starts.
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "linalg.h"
+#include "logs.h"
+
+/* ============================================================================
+ * File-local definitions
+ * ============================================================================
+ */
+#define NAME_LEN 32
+#define DIM 4
+
+static const size_t bench_sizes[] = {10000, 50000, 200000};
+
+/* ============================================================================
+ * Helper function prototypes
+ * ============================================================================
+ */
+static double now_ns(void);
+static struct MatrixSpec* make_specs(size_t count, char* names);
+static double run_loop(size_t count);
+static double run_batch(size_t count);
+
+/* ============================================================================
+ * main()
+ * ============================================================================
+ */
+int main(int argc, char** argv)
+{
+    size_t max_items = (argc > 1) ? strtoull(argv[1], NULL, 10) : 200000;
+
+    set_log_level(LOG_NONE);
+
+    printf("%-10s %12s %12s %14s %14s\n", "items", "loop ms", "batch ms", "loop ns/item",
+           "batch ns/item");
+    for (size_t s = 0; s < sizeof(bench_sizes) / sizeof(bench_sizes[0]); s++)
+    {
+        size_t count = bench_sizes[s];
+        if (count > max_items)
+            break;
+
+        double loop_ns = run_loop(count);
+        double batch_ns = run_batch(count);
+        printf("%-10zu %12.2f %12.2f %14.1f %14.1f\n", count, loop_ns / 1e6, batch_ns / 1e6,
+               loop_ns / (double)count, batch_ns / (double)count);
+    }
+    return 0;
+}
+
+/* ============================================================================
+ * Helper functions
+ * ============================================================================
+ */
+
+// Monotonic clock in nanoseconds.
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+// Specs with freshly allocated DIMxDIM element buffers and unique names.
+static struct MatrixSpec* make_specs(size_t count, char* names)
+{
+    struct MatrixSpec* specs = malloc(count * sizeof(struct MatrixSpec));
+    if (!specs)
+        return NULL;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        char* name = names + i * NAME_LEN;
+        snprintf(name, NAME_LEN, "layer_%04zu_w_%02zu", i / 64, i % 64);
+        double* list = malloc(DIM * DIM * sizeof(double));
+        for (size_t e = 0; list && e < DIM * DIM; e++)
+            list[e] = (double)(i + e);
+        struct List elements = {.list = list, .size = DIM * DIM, .type_size = sizeof(double)};
+        specs[i] = (struct MatrixSpec){name, elements, DIM, DIM};
+    }
+    return specs;
+}
+
+// Loads `count` matrices one call at a time; returns elapsed ns.
+static double run_loop(size_t count)
+{
+    char* names = malloc(count * NAME_LEN);
+    struct MatrixSpec* specs = names ? make_specs(count, names) : NULL;
+    if (!specs || linalg_init_reg_table(1024) != 0)
+        return 0.0;
+
+    double t0 = now_ns();
+    for (size_t i = 0; i < count; i++)
+    {
+        if (linalg_create_bind_matrix(specs[i].elements, specs[i].num_rows, specs[i].num_cols,
+                                      specs[i].name) == 4)
+            free(specs[i].elements.list);
+    }
+    double t1 = now_ns();
+
+    linalg_shutdown();
+    free(specs);
+    free(names);
+    return t1 - t0;
+}
+
+// Loads `count` matrices with one bulk call; returns elapsed ns.
+static double run_batch(size_t count)
+{
+    char* names = malloc(count * NAME_LEN);
+    struct MatrixSpec* specs = names ? make_specs(count, names) : NULL;
+    int* status = malloc(count * sizeof(int));
+    if (!specs || !status || linalg_init_reg_table(1024) != 0)
+        return 0.0;
+
+    double t0 = now_ns();
+    linalg_create_bind_matrices(specs, count, status);
+    double t1 = now_ns();
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (status[i] == 1 || status[i] == 4)
+            free(specs[i].elements.list);
+    }
+    linalg_shutdown();
+    free(status);
+    free(specs);
+    free(names);
+    return t1 - t0;
+}
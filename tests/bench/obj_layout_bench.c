@@ -0,0 +1,154 @@
+// Object layout benchmark: split (wrapper -> Matrix -> elements.list) vs
+// inline (one block) matrices.
+//
+// Build (from repo root):
+//   gcc -O2 -DNDEBUG -pthread -Iinclude -Isrc/internal src/*.c tests/bench/obj_layout_bench.c
+//       -o tests/builds/obj_layout_bench
+//
+// Usage:
+//   tests/builds/obj_layout_bench [max_objects]
+//
+// For 10K, 100K and 1M 4x4 double matrices (capped at max_objects) reports
+// ns/object to create each layout and to sum every element of every matrix
+// visited in a shuffled order, which defeats the prefetcher so each
+// dependent load is a likely cache miss.
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "logs.h"
+#include "math_objs.h"
+
+/* ============================================================================
+ * File-local definitions
+ * ============================================================================
+ */
+#define DIM 4
+
+static const size_t bench_sizes[] = {10000, 100000, 1000000};
+
+/* ============================================================================
+ * Helper function prototypes
+ * ============================================================================
+ */
+static double now_ns(void);
+static double create_all(struct ObjWrapper** objects, size_t count, bool use_inline);
+static double sum_all(struct ObjWrapper** objects, const size_t* order, size_t count,
+                      double* sum);
+static void shuffle(size_t* order, size_t count);
+
+/* ============================================================================
+ * main()
+ * ============================================================================
+ */
+int main(int argc, char** argv)
+{
+    size_t max_objects = (argc > 1) ? strtoull(argv[1], NULL, 10) : 1000000;
+
+    set_log_level(LOG_NONE);
+
+    struct ObjWrapper** objects = malloc(max_objects * sizeof(struct ObjWrapper*));
+    size_t* order = malloc(max_objects * sizeof(size_t));
+    if (!objects || !order)
+        return 1;
+
+    printf("%-10s %12s %12s %12s %12s\n", "objects", "split new", "inline new", "split sum",
+           "inline sum");
+    for (size_t s = 0; s < sizeof(bench_sizes) / sizeof(bench_sizes[0]); s++)
+    {
+        size_t count = bench_sizes[s];
+        if (count > max_objects)
+            break;
+        for (size_t i = 0; i < count; i++)
+            order[i] = i;
+        shuffle(order, count);
+
+        double sums[2] = {0};
+        double create_ns[2];
+        double sum_ns[2];
+        for (int use_inline = 0; use_inline < 2; use_inline++)
+        {
+            create_ns[use_inline] = create_all(objects, count, use_inline);
+            sum_ns[use_inline] = sum_all(objects, order, count, &sums[use_inline]);
+            for (size_t i = 0; i < count; i++)
+                decref_obj(objects[i]);
+        }
+        if (sums[0] != sums[1])
+            fprintf(stderr, "layouts disagree: %f vs %f\n", sums[0], sums[1]);
+
+        printf("%-10zu %12.1f %12.1f %12.1f %12.1f\n", count, create_ns[0] / (double)count,
+               create_ns[1] / (double)count, sum_ns[0] / (double)count,
+               sum_ns[1] / (double)count);
+    }
+
+    free(objects);
+    free(order);
+    destroy_obj_list();
+    return 0;
+}
+
+/* ============================================================================
+ * Helper functions
+ * ============================================================================
+ */
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static double create_all(struct ObjWrapper** objects, size_t count, bool use_inline)
+{
+    double start = now_ns();
+    for (size_t i = 0; i < count; i++)
+    {
+        double* values = malloc(DIM * DIM * sizeof(double));
+        if (!values)
+            exit(1);
+        for (size_t e = 0; e < DIM * DIM; e++)
+            values[e] = (double)(i + e);
+
+        struct List elements = {.list = values, .size = DIM * DIM, .type_size = sizeof(double)};
+        objects[i] = use_inline ? create_matrix_inline(NULL, elements, DIM, DIM, INLINE_TAKE)
+                                : create_matrix(elements, DIM, DIM);
+        if (!objects[i])
+        {
+            fprintf(stderr, "matrix creation failed at %zu\n", i);
+            exit(1);
+        }
+    }
+    return now_ns() - start;
+}
+
+static double sum_all(struct ObjWrapper** objects, const size_t* order, size_t count,
+                      double* sum)
+{
+    double start = now_ns();
+    double total = 0.0;
+    for (size_t i = 0; i < count; i++)
+    {
+        const struct List* elements = get_obj_elements(objects[order[i]]);
+        const double* values = elements->list;
+        for (size_t e = 0; e < elements->size; e++)
+            total += values[e];
+    }
+    *sum = total;
+    return now_ns() - start;
+}
+
+static void shuffle(size_t* order, size_t count)
+{
+    uint64_t state = 0x9e3779b97f4a7c15ull;
+    for (size_t i = count - 1; i > 0; i--)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        size_t j = (size_t)(state % (i + 1));
+        size_t tmp = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+}
@@ -0,0 +1,102 @@
+// Object store benchmark: create and destroy scalar objects in the
+// process-wide store.
+//
+// Build (from repo root):
+//   gcc -O2 -DNDEBUG -pthread -Iinclude -Isrc/internal src/*.c tests/bench/obj_store_bench.c
+//       -o tests/builds/obj_store_bench
+//
+// Usage:
+//   tests/builds/obj_store_bench [max_objects]
+//
+// For 10K, 100K and 1M objects (capped at max_objects) creates every object,
+// then releases them oldest first (the far end of the root set) and newest
+// first, reporting ns/object for each phase. Every phase should stay flat
+// as the object count grows.
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "logs.h"
+#include "math_objs.h"
+
+/* ============================================================================
+ * File-local definitions
+ * ============================================================================
+ */
+static const size_t bench_sizes[] = {10000, 100000, 1000000};
+
+/* ============================================================================
+ * Helper function prototypes
+ * ============================================================================
+ */
+static double now_ns(void);
+static double create_all(struct ObjWrapper** objects, size_t count);
+static double destroy_all(struct ObjWrapper** objects, size_t count, bool oldest_first);
+
+/* ============================================================================
+ * main()
+ * ============================================================================
+ */
+int main(int argc, char** argv)
+{
+    size_t max_objects = (argc > 1) ? strtoull(argv[1], NULL, 10) : 1000000;
+
+    set_log_level(LOG_NONE);
+
+    struct ObjWrapper** objects = malloc(max_objects * sizeof(struct ObjWrapper*));
+    if (!objects)
+        return 1;
+
+    printf("%-10s %14s %14s %14s\n", "objects", "create ns", "old-first ns", "new-first ns");
+    for (size_t s = 0; s < sizeof(bench_sizes) / sizeof(bench_sizes[0]); s++)
+    {
+        size_t count = bench_sizes[s];
+        if (count > max_objects)
+            break;
+
+        double create_ns = create_all(objects, count);
+        double oldest_ns = destroy_all(objects, count, true);
+        create_all(objects, count);
+        double newest_ns = destroy_all(objects, count, false);
+        printf("%-10zu %14.1f %14.1f %14.1f\n", count, create_ns / (double)count,
+               oldest_ns / (double)count, newest_ns / (double)count);
+    }
+
+    free(objects);
+    destroy_obj_list();
+    return 0;
+}
+
+/* ============================================================================
+ * Helper functions
+ * ============================================================================
+ */
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static double create_all(struct ObjWrapper** objects, size_t count)
+{
+    double start = now_ns();
+    for (size_t i = 0; i < count; i++)
+    {
+        objects[i] = create_scalar((double)i);
+        if (!objects[i])
+        {
+            fprintf(stderr, "create_scalar() failed at %zu\n", i);
+            exit(1);
+        }
+    }
+    return now_ns() - start;
+}
+
+static double destroy_all(struct ObjWrapper** objects, size_t count, bool oldest_first)
+{
+    double start = now_ns();
+    for (size_t i = 0; i < count; i++)
+        decref_obj(objects[oldest_first ? i : count - 1 - i]);
+    return now_ns() - start;
+}
@@ -0,0 +1,114 @@
+// Reference count benchmark: incref_obj()/decref_obj() pairs on the thread
+// that created the object and on threads sharing one object.
+//
+// Build (from repo root):
+//   gcc -O2 -DNDEBUG -pthread -Iinclude -Isrc/internal src/*.c tests/bench/refcount_bench.c
+//       -o tests/builds/refcount_bench
+//
+// Usage:
+//   tests/builds/refcount_bench [pairs]
+//
+// Reports ns per incref/decref pair for the creating thread alone, for one
+// other thread alone, and per thread with 1, 2 and 4 threads hammering the
+// same object. The first column is the single-threaded cost every object
+// pays.
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "logs.h"
+#include "math_objs.h"
+
+/* ============================================================================
+ * File-local definitions
+ * ============================================================================
+ */
+#define MAX_THREADS 4
+
+struct PairRun
+{
+    struct ObjWrapper* object;
+    size_t pairs;
+    double ns;
+};
+
+/* ============================================================================
+ * Helper function prototypes
+ * ============================================================================
+ */
+static double now_ns(void);
+static void* run_pairs(void* arg);
+static double threaded_pairs(struct ObjWrapper* object, size_t pairs, size_t threads);
+
+/* ============================================================================
+ * main()
+ * ============================================================================
+ */
+int main(int argc, char** argv)
+{
+    size_t pairs = (argc > 1) ? strtoull(argv[1], NULL, 10) : 10000000;
+
+    set_log_level(LOG_NONE);
+
+    struct ObjWrapper* object = create_scalar(1.0);
+    if (!object)
+        return 1;
+
+    struct PairRun owner = {object, pairs, 0.0};
+    run_pairs(&owner);
+
+    printf("%-12s %12s %12s %12s %12s\n", "pairs", "owner ns", "1 thread ns", "2 threads ns",
+           "4 threads ns");
+    printf("%-12zu %12.2f %12.2f %12.2f %12.2f\n", pairs, owner.ns / (double)pairs,
+           threaded_pairs(object, pairs, 1), threaded_pairs(object, pairs, 2),
+           threaded_pairs(object, pairs, 4));
+
+    decref_obj(object);
+    destroy_obj_list();
+    return 0;
+}
+
+/* ============================================================================
+ * Helper functions
+ * ============================================================================
+ */
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void* run_pairs(void* arg)
+{
+    struct PairRun* run = arg;
+    double start = now_ns();
+    for (size_t i = 0; i < run->pairs; i++)
+    {
+        incref_obj(run->object);
+        decref_obj(run->object);
+    }
+    run->ns = now_ns() - start;
+    return NULL;
+}
+
+// mean ns per pair per thread
+static double threaded_pairs(struct ObjWrapper* object, size_t pairs, size_t threads)
+{
+    pthread_t ids[MAX_THREADS];
+    struct PairRun runs[MAX_THREADS];
+    for (size_t i = 0; i < threads; i++)
+    {
+        runs[i] = (struct PairRun){object, pairs / threads, 0.0};
+        pthread_create(&ids[i], NULL, run_pairs, &runs[i]);
+    }
+
+    double total = 0.0;
+    for (size_t i = 0; i < threads; i++)
+    {
+        pthread_join(ids[i], NULL);
+        total += runs[i].ns;
+    }
+    return total / (double)(pairs / threads * threads);
+}
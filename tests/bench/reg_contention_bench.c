@@ -0,0 +1,166 @@
+// Registry contention benchmark: one global mutex vs a concurrent (sharded)
+// registry, 1..N threads.
+//
+// Build (from repo root):
+//   gcc -O2 -DNDEBUG -pthread -Iinclude -Isrc/internal src/*.c tests/bench/reg_contention_bench.c
+//       -o tests/builds/reg_contention_bench
+//
+// Usage:
+//   tests/builds/reg_contention_bench [max_threads] [ops_per_thread] [write_every]
+//
+// Each thread owns NAMES_PER_THREAD names bound to its own object and runs
+// lookups with one remove+add pair every write_every operations (default 16;
+// pass 1000 for a read-mostly mix, where the sharded registry's lookups take
+// no lock). Reports total
+// Mops/s for thread counts 1, 2, 4, ... up to max_threads.
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "logs.h"
+#include "math_objs.h"
+#include "reg_hash.h"
+
+/* ============================================================================
+ * File-local definitions
+ * ============================================================================
+ */
+#define NAME_LEN 64 // fits "t%02zu_layer_%06zu_w" for any size_t
+#define NAMES_PER_THREAD 4096
+#define DEFAULT_WRITE_EVERY 16
+
+struct BenchThread
+{
+    struct RegistryHash* reg_table;
+    pthread_mutex_t* global_lock; // NULL for the concurrent registry
+    struct ObjWrapper* object;
+    char* names;
+    size_t ops;
+    size_t write_every;
+    pthread_barrier_t* start;
+};
+
+/* ============================================================================
+ * Helper function prototypes
+ * ============================================================================
+ */
+static double now_ns(void);
+static void* bench_thread(void* arg);
+static double run_mode(bool concurrent, size_t num_threads, size_t ops, size_t write_every);
+
+/* ============================================================================
+ * main()
+ * ============================================================================
+ */
+int main(int argc, char** argv)
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t max_threads = (argc > 1) ? strtoull(argv[1], NULL, 10) : (size_t)(cpus > 0 ? cpus : 1);
+    size_t ops = (argc > 2) ? strtoull(argv[2], NULL, 10) : 2000000;
+    size_t write_every = (argc > 3) ? strtoull(argv[3], NULL, 10) : DEFAULT_WRITE_EVERY;
+    if (write_every == 0)
+        write_every = DEFAULT_WRITE_EVERY;
+
+    set_log_level(LOG_NONE);
+
+    printf("%-8s %16s %16s\n", "threads", "global Mops/s", "sharded Mops/s");
+    for (size_t n = 1; n <= max_threads; n *= 2)
+    {
+        double global = run_mode(false, n, ops, write_every);
+        double sharded = run_mode(true, n, ops, write_every);
+        printf("%-8zu %16.2f %16.2f\n", n, global, sharded);
+    }
+    return 0;
+}
+
+/* ============================================================================
+ * Helper functions
+ * ============================================================================
+ */
+
+// Monotonic clock in nanoseconds.
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+// Runs `ops` mixed operations on the thread's own names.
+static void* bench_thread(void* arg)
+{
+    struct BenchThread* bench = arg;
+    size_t found = 0;
+
+    pthread_barrier_wait(bench->start);
+    for (size_t i = 0; i < bench->ops; i++)
+    {
+        const char* name = bench->names + (i % NAMES_PER_THREAD) * NAME_LEN;
+        if (bench->global_lock)
+            pthread_mutex_lock(bench->global_lock);
+        if (i % bench->write_every == 0)
+        {
+            remove_binding(name, bench->reg_table);
+            add_binding(name, bench->object, bench->reg_table);
+        }
+        else
+            found += (lookup_binding(name, bench->reg_table) != NULL);
+        if (bench->global_lock)
+            pthread_mutex_unlock(bench->global_lock);
+    }
+
+    return (void*)found;
+}
+
+// Times num_threads workers on a fresh registry; returns total Mops/s.
+static double run_mode(bool concurrent, size_t num_threads, size_t ops, size_t write_every)
+{
+    struct RegistryConfig config = {.concurrent = concurrent, .shards = 64};
+    struct RegistryHash* reg_table = init_reg_table_config(1024, &config);
+    pthread_mutex_t global_lock = PTHREAD_MUTEX_INITIALIZER;
+    pthread_barrier_t start;
+    struct BenchThread* benches = calloc(num_threads, sizeof(struct BenchThread));
+    pthread_t* threads = calloc(num_threads, sizeof(pthread_t));
+    if (!reg_table || !benches || !threads)
+        return 0.0;
+
+    pthread_barrier_init(&start, NULL, (unsigned int)num_threads + 1);
+    for (size_t t = 0; t < num_threads; t++)
+    {
+        struct BenchThread* bench = &benches[t];
+        bench->reg_table = reg_table;
+        bench->global_lock = concurrent ? NULL : &global_lock;
+        bench->object = create_scalar((double)t);
+        bench->names = malloc(NAMES_PER_THREAD * NAME_LEN);
+        bench->ops = ops;
+        bench->write_every = write_every;
+        bench->start = &start;
+        for (size_t i = 0; i < NAMES_PER_THREAD; i++)
+        {
+            snprintf(bench->names + i * NAME_LEN, NAME_LEN, "t%02zu_layer_%06zu_w", t, i);
+            add_binding(bench->names + i * NAME_LEN, bench->object, reg_table);
+        }
+        pthread_create(&threads[t], NULL, bench_thread, bench);
+    }
+
+    pthread_barrier_wait(&start);
+    double t0 = now_ns();
+    for (size_t t = 0; t < num_threads; t++)
+        pthread_join(threads[t], NULL);
+    double t1 = now_ns();
+
+    destroy_reg_table(reg_table);
+    for (size_t t = 0; t < num_threads; t++)
+    {
+        decref_obj(benches[t].object);
+        free(benches[t].names);
+    }
+    pthread_barrier_destroy(&start);
+    free(benches);
+    free(threads);
+
+    return (double)(num_threads * ops) / ((t1 - t0) / 1e9) / 1e6;
+}
@@ -0,0 +1,179 @@
+// Registry backend benchmark: chained vs flat vs chained frozen into a
+// perfect hash, each optionally behind the negative-lookup filter.
+//
+// Build (from repo root):
+//   gcc -O2 -DNDEBUG -Iinclude -Isrc/internal src/*.c tests/bench/reg_hash_bench.c
+//       -o tests/builds/reg_hash_bench
+//
+// Usage:
+//   tests/builds/reg_hash_bench [max_names]
+//
+// For each name count (1K, 100K, 10M, capped at max_names) and each backend,
+// reports ns/op for: add, lookup hit, lookup miss, handle lookup, remove.
+// The "frozen" row calls freeze_registry() after the adds (its build time is
+// reported separately); its remove column includes the thaw. "+bloom" rows
+// enable RegistryConfig.negative_filter and print the filter's size and
+// false-positive rate after the miss pass.
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "logs.h"
+#include "math_objs.h"
+#include "reg_hash.h"
+
+/* ============================================================================
+ * File-local definitions
+ * ============================================================================
+ */
+#define NAME_LEN 32
+
+static const size_t bench_sizes[] = {1000, 100000, 10000000};
+
+/* ============================================================================
+ * Helper function prototypes
+ * ============================================================================
+ */
+static double now_ns(void);
+static char* make_names(size_t count, const char* prefix);
+static int run_backend(const struct RegistryConfig* config, bool frozen, const char* label,
+                       size_t count, const char* hit_names, const char* miss_names,
+                       struct ObjWrapper* object);
+
+/* ============================================================================
+ * main()
+ * ============================================================================
+ */
+int main(int argc, char** argv)
+{
+    size_t max_names = (argc > 1) ? strtoull(argv[1], NULL, 10) : 10000000;
+
+    set_log_level(LOG_NONE);
+
+    struct ObjWrapper* object = create_scalar(1.0);
+    if (!object)
+        return 1;
+
+    printf("%-10s %-8s %12s %12s %12s %12s %12s\n", "names", "backend", "add ns/op", "hit ns/op",
+           "miss ns/op", "handle ns/op", "remove ns/op");
+
+    for (size_t s = 0; s < sizeof(bench_sizes) / sizeof(bench_sizes[0]); s++)
+    {
+        size_t count = bench_sizes[s];
+        if (count > max_names)
+            break;
+
+        char* hit_names = make_names(count, "layer");
+        char* miss_names = make_names(count, "absent");
+        if (!hit_names || !miss_names)
+        {
+            free(hit_names);
+            free(miss_names);
+            return 1;
+        }
+
+        const struct RegistryConfig chained = {.backend = REG_BACKEND_CHAINED};
+        const struct RegistryConfig flat = {.backend = REG_BACKEND_FLAT};
+        const struct RegistryConfig chained_bloom = {.backend = REG_BACKEND_CHAINED,
+                                                     .negative_filter = true};
+        const struct RegistryConfig flat_bloom = {.backend = REG_BACKEND_FLAT,
+                                                  .negative_filter = true};
+        run_backend(&chained, false, "chained", count, hit_names, miss_names, object);
+        run_backend(&flat, false, "flat", count, hit_names, miss_names, object);
+        run_backend(&chained, true, "frozen", count, hit_names, miss_names, object);
+        run_backend(&chained_bloom, false, "ch+bloom", count, hit_names, miss_names, object);
+        run_backend(&flat_bloom, false, "fl+bloom", count, hit_names, miss_names, object);
+        run_backend(&chained_bloom, true, "fr+bloom", count, hit_names, miss_names, object);
+
+        free(hit_names);
+        free(miss_names);
+    }
+
+    decref_obj(object);
+    return 0;
+}
+
+/* ============================================================================
+ * Helper functions
+ * ============================================================================
+ */
+
+// Monotonic clock in nanoseconds.
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+// Allocates count fixed-width machine-style names ("<prefix>_00000042_w").
+// Returns NULL on allocation failure; caller frees.
+static char* make_names(size_t count, const char* prefix)
+{
+    char* names = malloc(count * NAME_LEN);
+    if (!names)
+        return NULL;
+    for (size_t i = 0; i < count; i++)
+        snprintf(names + i * NAME_LEN, NAME_LEN, "%s_%08zu_w", prefix, i);
+    return names;
+}
+
+// Times one add/lookup/remove cycle of `count` names on a fresh registry.
+static int run_backend(const struct RegistryConfig* config, bool frozen, const char* label,
+                       size_t count, const char* hit_names, const char* miss_names,
+                       struct ObjWrapper* object)
+{
+    struct RegistryHash* reg_table = init_reg_table_config(16, config);
+    if (!reg_table)
+        return 2;
+
+    struct BindingHandle* handles = malloc(count * sizeof(struct BindingHandle));
+    if (!handles)
+    {
+        destroy_reg_table(reg_table);
+        return 2;
+    }
+    size_t found = 0;
+
+    double t0 = now_ns();
+    for (size_t i = 0; i < count; i++)
+        add_binding(hit_names + i * NAME_LEN, object, reg_table);
+    double t1 = now_ns();
+    if (frozen)
+    {
+        double f0 = now_ns();
+        if (freeze_registry(reg_table) != 0)
+            printf("freeze_registry() failed for %zu names\n", count);
+        double f1 = now_ns();
+        printf("%-10zu %-8s freeze took %.1f ms (%.1f ns/name)\n", count, label, (f1 - f0) / 1e6,
+               (f1 - f0) / count);
+    }
+    double t_lookup = now_ns();
+    for (size_t i = 0; i < count; i++)
+        found += (lookup_binding(hit_names + i * NAME_LEN, reg_table) != NULL);
+    double t2 = now_ns();
+    for (size_t i = 0; i < count; i++)
+        found += (lookup_binding(miss_names + i * NAME_LEN, reg_table) != NULL);
+    double t3 = now_ns();
+    struct RegistryStats stats;
+    if (config->negative_filter && registry_stats(reg_table, &stats) == 0)
+        printf("%-10zu %-8s filter %zu bytes (%.1f bits/name), false positives %.3f%%\n", count,
+               label, stats.filter_bytes, stats.filter_bits_per_binding, stats.filter_fpr * 100);
+    for (size_t i = 0; i < count; i++)
+        resolve_binding(hit_names + i * NAME_LEN, reg_table, &handles[i]);
+    double t4 = now_ns();
+    for (size_t i = 0; i < count; i++)
+        found += (lookup_binding_handle(handles[i], reg_table) != NULL);
+    double t5 = now_ns();
+    for (size_t i = 0; i < count; i++)
+        remove_binding(hit_names + i * NAME_LEN, reg_table);
+    double t6 = now_ns();
+
+    printf("%-10zu %-8s %12.1f %12.1f %12.1f %12.1f %12.1f\n", count, label, (t1 - t0) / count,
+           (t2 - t_lookup) / count, (t3 - t2) / count, (t5 - t4) / count, (t6 - t5) / count);
+
+    free(handles);
+    destroy_reg_table(reg_table);
+    return (found == 2 * count) ? 0 : 3;
+}
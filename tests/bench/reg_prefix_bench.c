@@ -0,0 +1,131 @@
+// Prefix index benchmark: cost of listing and dropping one session's names
+// as the registry grows, and the add overhead of keeping the index.
+//
+// Build (from repo root):
+//   gcc -O2 -DNDEBUG -pthread -Iinclude -Isrc/internal src/*.c tests/bench/reg_prefix_bench.c
+//       -o tests/builds/reg_prefix_bench
+//
+// Usage:
+//   tests/builds/reg_prefix_bench [max_bindings]
+//
+// Fills a registry with sessions of SESSION_NAMES names each
+// ("s<k>.model.layer<i>.W"), then times enumerating and removing one
+// session by prefix. With the index both should stay flat as the total
+// grows. Also reports ns/add with and without prefix_index.
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "logs.h"
+#include "math_objs.h"
+#include "reg_hash.h"
+
+/* ============================================================================
+ * File-local definitions
+ * ============================================================================
+ */
+#define NAME_LEN 48
+#define SESSION_NAMES 1000
+
+static const size_t bench_sizes[] = {10000, 100000, 1000000};
+
+/* ============================================================================
+ * Helper function prototypes
+ * ============================================================================
+ */
+static double now_ns(void);
+static int count_visit(void* ctx, const char* name);
+static double fill(struct RegistryHash* reg_table, struct ObjWrapper* object, size_t count);
+static void run_size(size_t count, struct ObjWrapper* object);
+
+/* ============================================================================
+ * main()
+ * ============================================================================
+ */
+int main(int argc, char** argv)
+{
+    size_t max_bindings = (argc > 1) ? strtoull(argv[1], NULL, 10) : 1000000;
+
+    set_log_level(LOG_NONE);
+    struct ObjWrapper* object = create_scalar(1.0);
+
+    printf("%-10s %14s %14s %14s %14s\n", "bindings", "add ns plain", "add ns index",
+           "list us", "drop us");
+    for (size_t s = 0; s < sizeof(bench_sizes) / sizeof(bench_sizes[0]); s++)
+    {
+        if (bench_sizes[s] > max_bindings)
+            break;
+        run_size(bench_sizes[s], object);
+    }
+
+    decref_obj(object);
+    return 0;
+}
+
+/* ============================================================================
+ * Helper functions
+ * ============================================================================
+ */
+
+// Monotonic clock in nanoseconds.
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+// Counts visited names.
+static int count_visit(void* ctx, const char* name)
+{
+    (void)name;
+    (*(size_t*)ctx)++;
+    return 0;
+}
+
+// Binds `count` session-structured names; returns elapsed ns.
+static double fill(struct RegistryHash* reg_table, struct ObjWrapper* object, size_t count)
+{
+    char name[NAME_LEN];
+    double t0 = now_ns();
+    for (size_t i = 0; i < count; i++)
+    {
+        snprintf(name, sizeof(name), "s%zu.model.layer%zu.W", i / SESSION_NAMES,
+                 i % SESSION_NAMES);
+        add_binding(name, object, reg_table);
+    }
+    return now_ns() - t0;
+}
+
+// One table row: add cost both ways, then list+drop the middle session.
+static void run_size(size_t count, struct ObjWrapper* object)
+{
+    struct RegistryConfig plain_config = {0};
+    struct RegistryConfig index_config = {.prefix_index = true};
+    struct RegistryHash* plain = init_reg_table_config(1024, &plain_config);
+    struct RegistryHash* indexed = init_reg_table_config(1024, &index_config);
+    if (!plain || !indexed)
+        return;
+
+    double plain_ns = fill(plain, object, count);
+    double index_ns = fill(indexed, object, count);
+    destroy_reg_table(plain);
+
+    char prefix[NAME_LEN];
+    snprintf(prefix, sizeof(prefix), "s%zu.", count / SESSION_NAMES / 2);
+    size_t listed = 0;
+    size_t removed = 0;
+
+    double t0 = now_ns();
+    for_each_binding_prefix(indexed, prefix, count_visit, &listed);
+    double t1 = now_ns();
+    remove_bindings_prefix(indexed, prefix, &removed);
+    double t2 = now_ns();
+
+    if (listed != SESSION_NAMES || removed != SESSION_NAMES)
+        fprintf(stderr, "unexpected match count listed=%zu removed=%zu\n", listed, removed);
+    printf("%-10zu %14.1f %14.1f %14.1f %14.1f\n", count, plain_ns / (double)count,
+           index_ns / (double)count, (t1 - t0) / 1e3, (t2 - t1) / 1e3);
+    destroy_reg_table(indexed);
+}
@@ -1,11 +1,18 @@
 #include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #include "linalg_types.h"
 #include "math_objs.h"
+#include "mem_alloc.h"
+#include "obj_buffer.h"
+#include "obj_slab.h"
 
 #define DELIM "********************************************\n"
 
@@ -14,6 +21,8 @@
  * Test function prototpes
  * ============================================================================
  */
+int test_mem_alloc_00();
+
 int test_create_matrix_00();
 int test_create_matrix_01();
 int test_create_matrix_02();
@@ -38,12 +47,35 @@ int test_get_obj_type_01();
 int test_debug_get_obj_refcount_00();
 int test_debug_get_obj_refcount_01();
 
+int test_create_matrix_inline_00();
+int test_create_matrix_inline_01();
+int test_create_vector_inline_00();
+int test_small_obj_00();
+int test_obj_store_00();
+int test_obj_store_01();
+int test_obj_store_reclaim_00();
+int test_obj_slab_00();
+int test_obj_buffer_00();
+int test_obj_buffer_01();
+int test_obj_buffer_02();
+int test_obj_memory_00();
+int test_biased_refcount_00();
+int test_biased_refcount_01();
+
 /* ============================================================================
  * Helper function prototypes
  * ============================================================================
  */
 int return_valid_matrix_components(struct List* elements, size_t* num_rows, size_t* num_cols);
 int return_valid_vector_components(struct List* elements);
+static void* slab_release_worker(void* arg);
+static void* shared_ref_worker(void* arg);
+static void* orphan_create_worker(void* arg);
+static void* budget_fill_worker(void* arg);
+static void log_release(void* ctx, void* list, size_t bytes);
+static void* count_alloc(void* ctx, size_t bytes, enum AllocSite site);
+static void* count_aligned_alloc(void* ctx, size_t alignment, size_t bytes, enum AllocSite site);
+static void count_free(void* ctx, void* block, enum AllocSite site);
 #pragma endregion
 
 #pragma region main()
@@ -53,6 +85,9 @@ int return_valid_vector_components(struct List* elements);
  */
 int main()
 {
+    // installs the process-wide allocator: must come before anything allocates
+    assert(test_mem_alloc_00() == 0);
+
     assert(test_create_matrix_00() == 0);
     assert(test_create_matrix_01() == 0);
     assert(test_create_matrix_02() == 0);
@@ -77,6 +112,22 @@ int main()
     assert(test_debug_get_obj_refcount_00() == 0);
     assert(test_debug_get_obj_refcount_01() == 0);
 
+    assert(test_create_matrix_inline_00() == 0);
+    assert(test_create_matrix_inline_01() == 0);
+    assert(test_create_vector_inline_00() == 0);
+    assert(test_small_obj_00() == 0);
+
+    assert(test_obj_store_00() == 0);
+    assert(test_obj_store_01() == 0);
+    assert(test_obj_store_reclaim_00() == 0);
+    assert(test_obj_slab_00() == 0);
+    assert(test_obj_buffer_00() == 0);
+    assert(test_obj_buffer_01() == 0);
+    assert(test_obj_buffer_02() == 0);
+    assert(test_obj_memory_00() == 0);
+    assert(test_biased_refcount_00() == 0);
+    assert(test_biased_refcount_01() == 0);
+
     return 0;
 }
 #pragma endregion
@@ -353,7 +404,7 @@ int test_create_matrix_05()
     }
 
     // Invalidate elements.size
-    elements.size = ++elements.size;
+    ++elements.size;
 
     new_matrix = create_matrix(elements, num_rows, num_cols);
     returns_NULL = (new_matrix == NULL);
@@ -802,7 +853,7 @@ int test_debug_get_obj_refcount_01()
 
     struct ObjWrapper* null_wrapper = NULL;
 
-    rtns_minus_1 = (debug_get_obj_refcount(null_wrapper) == -1);
+    rtns_minus_1 = (debug_get_obj_refcount(null_wrapper) == (size_t)-1);
     if (rtns_minus_1 == false)
     {
         printf("%s FAILED on rtns_minus_1.\n%s\n", test_name, DELIM);
@@ -814,6 +865,1095 @@ int test_debug_get_obj_refcount_01()
 }
 #pragma endregion
 
+#pragma region create_*_inline() tests
+/* ============================================================================
+ * create_*_inline() tests
+ * ============================================================================
+ */
+int test_create_matrix_inline_00()
+{
+    // Test case for valid input, INLINE_TAKE
+    // elements are copied next to the wrapper and the caller's buffer is
+    // released by the library (ASAN flags a leak or double free otherwise).
+    // 6x6 doubles is too large for the small-object layout.
+
+    const char* test_name = "test_create_matrix_inline_00";
+    size_t num_rows = 6;
+    size_t num_cols = 6;
+    struct List elements = {.list = malloc(36 * sizeof(double)), .size = 36,
+                            .type_size = sizeof(double)};
+    for (size_t i = 0; i < 36; i++)
+        ((double*)elements.list)[i] = (double)(i + 1);
+
+    struct ObjWrapper* matrix =
+        create_matrix_inline(NULL, elements, num_rows, num_cols, INLINE_TAKE);
+    if (!matrix || get_obj_type(matrix) != OBJ_MATRIX)
+    {
+        free(elements.list); // failure leaves it with us
+        printf("%s FAILED on rtn_wrapper_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    const struct List* inline_elements = get_obj_elements(matrix);
+    const double* values = inline_elements->list;
+    uintptr_t offset = (uintptr_t)values - (uintptr_t)matrix;
+    bool layout_OK = (inline_elements->size == num_rows * num_cols &&
+                      inline_elements->type_size == sizeof(double) &&
+                      (uintptr_t)values % 64 == 0 && offset > 0 && offset <= 256 &&
+                      values[0] == 1.0 && values[7] == 8.0);
+    if (layout_OK == false)
+    {
+        printf("%s FAILED on layout_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    bool decref_OK = (decref_obj(matrix) == 0);
+    if (decref_OK == false)
+    {
+        printf("%s FAILED on decref_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    printf("%s PASSED.\n%s\n", test_name, DELIM);
+    return 0;
+}
+
+int test_create_matrix_inline_01()
+{
+    // Test case for INLINE_COPY and invalid input: the caller's buffer is
+    // never taken and later writes to it do not reach the object
+
+    const char* test_name = "test_create_matrix_inline_01";
+    struct List elements = {0};
+    size_t num_rows = 0;
+    size_t num_cols = 0;
+    return_valid_matrix_components(&elements, &num_rows, &num_cols);
+
+    bool invalid_OK =
+        (create_matrix_inline(NULL, elements, num_rows + 1, num_cols, INLINE_TAKE) == NULL &&
+         create_matrix_inline(NULL, (struct List){0}, 1, 1, INLINE_COPY) == NULL);
+    if (invalid_OK == false)
+    {
+        printf("%s FAILED on invalid_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    struct ObjWrapper* matrix =
+        create_matrix_inline(NULL, elements, num_rows, num_cols, INLINE_COPY);
+    ((double*)elements.list)[0] = -1.0;
+    const struct List* inline_elements = get_obj_elements(matrix);
+    bool copy_OK = (matrix && inline_elements->list != elements.list &&
+                    ((const double*)inline_elements->list)[0] == 1.0);
+    free(elements.list); // still ours
+    if (copy_OK == false)
+    {
+        printf("%s FAILED on copy_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    bool refcount_OK = (incref_obj(matrix) == 0 && decref_obj(matrix) == 0 &&
+                        decref_obj(matrix) == 0);
+    if (refcount_OK == false)
+    {
+        printf("%s FAILED on refcount_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    printf("%s PASSED.\n%s\n", test_name, DELIM);
+    return 0;
+}
+
+int test_create_vector_inline_00()
+{
+    // Test case for valid input, both modes, in a private store
+
+    const char* test_name = "test_create_vector_inline_00";
+    struct List taken = {0};
+    struct List copied = {0};
+    return_valid_vector_components(&taken);
+    return_valid_vector_components(&copied);
+
+    struct ObjStore* store = obj_store_init(false, NULL);
+    struct ObjWrapper* first = create_vector_inline(store, taken, INLINE_TAKE);
+    struct ObjWrapper* second = create_vector_inline(store, copied, INLINE_COPY);
+    free(copied.list);
+
+    bool create_OK = (first && second && get_obj_type(first) == OBJ_VECTOR &&
+                      get_obj_elements(second)->size == 8 && obj_store_count(store) == 2 &&
+                      get_obj_elements(create_scalar_in(store, 1.0)) == NULL);
+    if (create_OK == false)
+    {
+        printf("%s FAILED on create_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    obj_store_destroy(store); // releases both blocks and the scalar
+    printf("%s PASSED.\n%s\n", test_name, DELIM);
+    return 0;
+}
+#pragma endregion
+
+#pragma region small object tests
+/* ============================================================================
+ * small-object layout tests
+ * ============================================================================
+ */
+int test_small_obj_00()
+{
+    // Test case for valid input: small matrices and vectors keep their
+    // elements next to the wrapper and free the caller's buffer (ASAN flags
+    // a leak or double free otherwise); larger ones keep the caller's buffer
+
+    const char* test_name = "test_small_obj_00";
+    struct List small_elements = {0};
+    struct List vector_elements = {0};
+    size_t num_rows = 0;
+    size_t num_cols = 0;
+    return_valid_matrix_components(&small_elements, &num_rows, &num_cols);
+    return_valid_vector_components(&vector_elements);
+    struct List large_elements = {.list = calloc(17, sizeof(double)), .size = 17,
+                                  .type_size = sizeof(double)};
+
+    struct ObjWrapper* matrix = create_matrix(small_elements, num_rows, num_cols);
+    struct ObjWrapper* vector = create_vector(vector_elements);
+    struct ObjWrapper* large = create_vector(large_elements);
+    struct ObjWrapper* scalar = create_scalar(3.0);
+    if (!matrix || !vector || !large || !scalar)
+    {
+        printf("%s FAILED on create_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    const struct List* matrix_list = get_obj_elements(matrix);
+    const struct List* vector_list = get_obj_elements(vector);
+    uintptr_t matrix_offset = (uintptr_t)matrix_list->list - (uintptr_t)matrix;
+    uintptr_t vector_offset = (uintptr_t)vector_list->list - (uintptr_t)vector;
+    bool layout_OK = (matrix_offset > 0 && matrix_offset <= 256 && vector_offset > 0 &&
+                      vector_offset <= 256 && matrix_list->size == 8 &&
+                      ((const double*)matrix_list->list)[7] == 8.0 &&
+                      ((const double*)vector_list->list)[0] == 1.0 &&
+                      get_obj_elements(large)->list == large_elements.list);
+    if (layout_OK == false)
+    {
+        printf("%s FAILED on layout_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    bool type_OK = (get_obj_type(matrix) == OBJ_MATRIX && get_obj_type(vector) == OBJ_VECTOR &&
+                    get_obj_type(large) == OBJ_VECTOR && get_obj_type(scalar) == OBJ_SCALAR &&
+                    get_obj_elements(scalar) == NULL);
+    if (type_OK == false)
+    {
+        printf("%s FAILED on type_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    bool decref_OK = (incref_obj(matrix) == 0 && decref_obj(matrix) == 0 &&
+                      decref_obj(matrix) == 0 && decref_obj(vector) == 0 &&
+                      decref_obj(large) == 0 && decref_obj(scalar) == 0);
+    if (decref_OK == false)
+    {
+        printf("%s FAILED on decref_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    printf("%s PASSED.\n%s\n", test_name, DELIM);
+    return 0;
+}
+#pragma endregion
+
+#pragma region obj_store tests
+/* ============================================================================
+ * obj_store_*() tests
+ * ============================================================================
+ */
+int test_obj_store_00()
+{
+    // test for valid input: objects live in the store they were created in,
+    // and destroying a store releases what is left in it
+
+    const char* test_name = "test_obj_store_00";
+    struct List elements;
+    size_t rows;
+    size_t cols;
+
+    struct ObjStore* store = obj_store_init(false, NULL);
+    if (!store)
+    {
+        printf("%s FAILED on store_init_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    size_t default_count = obj_store_count(NULL);
+    return_valid_matrix_components(&elements, &rows, &cols);
+    struct ObjWrapper* matrix = create_matrix_in(store, elements, rows, cols);
+    struct ObjWrapper* scalar = create_scalar_in(store, 1.0);
+    struct ObjWrapper* outside = create_scalar(2.0);
+
+    bool counts_OK = (matrix && scalar && outside && obj_store_count(store) == 2 &&
+                      obj_store_count(NULL) == default_count + 1);
+    if (counts_OK == false)
+    {
+        printf("%s FAILED on counts_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    bool decref_OK = (decref_obj(scalar) == 0 && obj_store_count(store) == 1 &&
+                      decref_obj(outside) == 0 && obj_store_count(NULL) == default_count);
+    if (decref_OK == false)
+    {
+        printf("%s FAILED on decref_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    obj_store_destroy(store); // releases matrix and its elements
+    obj_store_destroy(NULL);
+    printf("%s PASSED.\n%s\n", test_name, DELIM);
+    return 0;
+}
+
+int test_obj_store_01()
+{
+    // test for valid input: objects leave the store from the head, the tail
+    // and the middle without disturbing the others
+
+    const char* test_name = "test_obj_store_01";
+    struct ObjWrapper* objects[6] = {0};
+
+    struct ObjStore* store = obj_store_init(true, NULL);
+    if (!store)
+    {
+        printf("%s FAILED on store_init_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    bool create_OK = true;
+    for (size_t i = 0; i < 6; i++)
+    {
+        objects[i] = create_scalar_in(store, (double)i);
+        if (!objects[i])
+            create_OK = false;
+    }
+    if (create_OK == false || obj_store_count(store) != 6)
+    {
+        printf("%s FAILED on create_OK.\n%s\n", test_name, DELIM);
+        obj_store_destroy(store);
+        return 1;
+    }
+
+    // newest (list head), oldest (tail), then one from the middle
+    bool remove_OK = (decref_obj(objects[5]) == 0 && decref_obj(objects[0]) == 0 &&
+                      decref_obj(objects[2]) == 0 && obj_store_count(store) == 3);
+    if (remove_OK == false)
+    {
+        printf("%s FAILED on remove_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    // survivors are still linked: the store can re-link and drain them
+    objects[5] = create_scalar_in(store, 5.0);
+    bool relink_OK = (objects[5] && obj_store_count(store) == 4 &&
+                      get_obj_type(objects[3]) == OBJ_SCALAR && decref_obj(objects[3]) == 0 &&
+                      obj_store_count(store) == 3);
+    if (relink_OK == false)
+    {
+        printf("%s FAILED on relink_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    obj_store_destroy(store); // releases objects 1, 4 and 5
+    printf("%s PASSED.\n%s\n", test_name, DELIM);
+    return 0;
+}
+
+int test_obj_store_reclaim_00()
+{
+    // test for valid input: released objects leave the store at once but are
+    // freed later, the queue never grows past max_pending, and switching
+    // back to RECLAIM_INLINE frees whatever is left (ASAN checks the frees)
+
+    const char* test_name = "test_obj_store_reclaim_00";
+    struct ObjStore* store = obj_store_init(true, NULL);
+
+    bool invalid_OK = (obj_store_set_reclaim(store, (enum ReclaimMode)7, 0) == 1 &&
+                       obj_store_collect(store) == 0);
+    if (invalid_OK == false)
+    {
+        printf("%s FAILED on invalid_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    bool deferred_OK = (obj_store_set_reclaim(store, RECLAIM_DEFERRED, 4) == 0);
+    for (size_t i = 0; deferred_OK && i < 6; i++)
+    {
+        struct List elements = {0};
+        return_valid_vector_components(&elements);
+        struct ObjWrapper* vector = create_vector_in(store, elements);
+        deferred_OK = (vector && decref_obj(vector) == 0 && obj_store_count(store) == 0 &&
+                       obj_store_pending(store) >= 1 && obj_store_pending(store) <= 4);
+    }
+    deferred_OK = deferred_OK && obj_store_collect(store) == 2 && obj_store_pending(store) == 0;
+    if (deferred_OK == false)
+    {
+        printf("%s FAILED on deferred_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    bool background_OK = (obj_store_set_reclaim(store, RECLAIM_BACKGROUND, 2) == 0);
+    for (size_t i = 0; background_OK && i < 100; i++)
+    {
+        struct ObjWrapper* scalar = create_scalar_in(store, (double)i);
+        background_OK = (scalar && decref_obj(scalar) == 0 && obj_store_pending(store) <= 2);
+    }
+    background_OK = background_OK && obj_store_set_reclaim(store, RECLAIM_INLINE, 0) == 0 &&
+                    obj_store_pending(store) == 0;
+    if (background_OK == false)
+    {
+        printf("%s FAILED on background_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    obj_store_set_reclaim(store, RECLAIM_DEFERRED, 0);
+    decref_obj(create_scalar_in(store, 1.0));
+    obj_store_destroy(store); // frees the queued scalar
+    printf("%s PASSED.\n%s\n", test_name, DELIM);
+    return 0;
+}
+#pragma endregion
+
+#pragma region obj_slab tests
+/* ============================================================================
+ * obj_slab tests
+ * ============================================================================
+ */
+
+// not one of the pools math_objs.c uses
+static struct ObjSlab test_slab = OBJ_SLAB_INITIALIZER(OBJ_SLAB_MAX_POOLS - 1, 40);
+
+struct SlabRelease
+{
+    void** items;
+    size_t count;
+};
+
+int test_obj_slab_00()
+{
+    // test for valid input: items are distinct and aligned, may be released
+    // on another thread, and whole pages go back once every item is home
+
+    const char* test_name = "test_obj_slab_00";
+    enum
+    {
+        NUM_ITEMS = 2000
+    };
+    void* items[NUM_ITEMS];
+
+    bool alloc_OK = true;
+    for (size_t i = 0; i < NUM_ITEMS; i++)
+    {
+        items[i] = obj_slab_alloc(&test_slab);
+        if (!items[i] || (uintptr_t)items[i] % 16 != 0)
+            alloc_OK = false;
+        else
+            memset(items[i], (int)(i & 0xff), 40);
+    }
+    for (size_t i = 0; alloc_OK && i < NUM_ITEMS; i++)
+    {
+        if (((unsigned char*)items[i])[39] != (unsigned char)(i & 0xff))
+            alloc_OK = false; // overlapping items
+    }
+    if (alloc_OK == false || obj_slab_pages(&test_slab) < 2)
+    {
+        printf("%s FAILED on alloc_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    // pages are pinned while anything is out
+    bool pinned_OK = (obj_slab_trim(&test_slab) == 0);
+    if (pinned_OK == false)
+    {
+        printf("%s FAILED on pinned_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    // the second half is released by a thread that exits with it cached
+    struct SlabRelease release = {items + NUM_ITEMS / 2, NUM_ITEMS / 2};
+    pthread_t thread;
+    pthread_create(&thread, NULL, slab_release_worker, &release);
+    pthread_join(thread, NULL);
+    for (size_t i = 0; i < NUM_ITEMS / 2; i++)
+        obj_slab_free(&test_slab, items[i]);
+
+    bool trim_OK = (obj_slab_trim(&test_slab) > 0 && obj_slab_pages(&test_slab) == 0);
+    if (trim_OK == false)
+    {
+        printf("%s FAILED on trim_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    printf("%s PASSED.\n%s\n", test_name, DELIM);
+    return 0;
+}
+
+static void* slab_release_worker(void* arg)
+{
+    struct SlabRelease* release = arg;
+    for (size_t i = 0; i < release->count; i++)
+        obj_slab_free(&test_slab, release->items[i]);
+    return NULL;
+}
+#pragma endregion
+
+#pragma region obj_buffer tests
+/* ============================================================================
+ * obj_buffer tests
+ * ============================================================================
+ */
+int test_obj_buffer_00()
+{
+    // test for valid input: library buffers are aligned and record their
+    // kind, objects release them through the matching path (ASAN flags a
+    // free() of a mapping), packed payloads are aligned too, and an object's
+    // own storage cannot be handed to another object
+
+    const char* test_name = "test_obj_buffer_00";
+    struct List elements = {0};
+
+    bool invalid_OK = (obj_buffer_alloc(NULL, 8, sizeof(double), ELEMENTS_ALIGNED) == 1 &&
+                       obj_buffer_alloc(&elements, 0, sizeof(double), ELEMENTS_ALIGNED) == 1 &&
+                       obj_buffer_alloc(&elements, 8, sizeof(double), ELEMENTS_MALLOC) == 1 &&
+                       obj_buffer_alloc(&elements, SIZE_MAX, 2, ELEMENTS_ALIGNED) == 1 &&
+                       elements.list == NULL);
+    obj_buffer_free(elements); // NULL list: no-op
+    if (invalid_OK == false)
+    {
+        printf("%s FAILED on invalid_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    struct List aligned;
+    struct List fallback;
+    bool aligned_OK =
+        (obj_buffer_alloc(&aligned, 1000, sizeof(double), ELEMENTS_ALIGNED) == 0 &&
+         obj_buffer_alloc(&fallback, 1000, sizeof(double), ELEMENTS_HUGE) == 0 &&
+         aligned.alloc == ELEMENTS_ALIGNED && fallback.alloc == ELEMENTS_ALIGNED &&
+         (uintptr_t)aligned.list % OBJ_BUFFER_ALIGN == 0 &&
+         (uintptr_t)fallback.list % OBJ_BUFFER_ALIGN == 0 && aligned.size == 1000 &&
+         aligned.type_size == sizeof(double));
+    if (aligned_OK == false)
+    {
+        printf("%s FAILED on aligned_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+    memset(aligned.list, 0, 1000 * sizeof(double));
+    obj_buffer_free(fallback);
+
+    size_t huge_count = (3 << 20) / sizeof(double); // 3 MiB
+    struct List huge;
+    bool huge_OK = (obj_buffer_alloc(&huge, huge_count, sizeof(double), ELEMENTS_HUGE) == 0 &&
+                    huge.alloc == ELEMENTS_HUGE &&
+                    (uintptr_t)huge.list % OBJ_BUFFER_HUGE_BYTES == 0);
+    if (huge_OK == false)
+    {
+        printf("%s FAILED on huge_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+    ((double*)huge.list)[0] = 1.0;
+    ((double*)huge.list)[huge_count - 1] = 2.0;
+
+    struct ObjWrapper* vector = create_vector(aligned);
+    struct ObjWrapper* matrix = create_matrix(huge, 1024, huge_count / 1024);
+    bool owned_OK = (vector && matrix && get_obj_elements(vector)->list == aligned.list &&
+                     get_obj_elements(vector)->alloc == ELEMENTS_ALIGNED &&
+                     get_obj_elements(matrix)->alloc == ELEMENTS_HUGE &&
+                     ((const double*)get_obj_elements(matrix)->list)[huge_count - 1] == 2.0);
+    if (owned_OK == false)
+    {
+        printf("%s FAILED on owned_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    struct List small;
+    struct List packed_source;
+    obj_buffer_alloc(&small, 4, sizeof(double), ELEMENTS_ALIGNED);
+    obj_buffer_alloc(&packed_source, 32, sizeof(double), ELEMENTS_ALIGNED);
+    memset(packed_source.list, 0, 32 * sizeof(double));
+    memset(small.list, 0, 4 * sizeof(double));
+    struct ObjWrapper* small_matrix = create_matrix(small, 2, 2); // frees `small`
+    struct ObjWrapper* block = create_vector_inline(NULL, packed_source, INLINE_TAKE);
+    const struct List* small_list = small_matrix ? get_obj_elements(small_matrix) : NULL;
+    const struct List* block_list = block ? get_obj_elements(block) : NULL;
+    struct ObjWrapper* copy = block_list ? create_vector_inline(NULL, *block_list, INLINE_COPY)
+                                         : NULL;
+    bool packed_OK = (small_list && block_list && copy &&
+                      small_list->alloc == ELEMENTS_OBJECT &&
+                      (uintptr_t)small_list->list % OBJ_BUFFER_ALIGN == 0 &&
+                      block_list->alloc == ELEMENTS_OBJECT &&
+                      (uintptr_t)block_list->list % OBJ_BUFFER_ALIGN == 0 &&
+                      create_vector(*block_list) == NULL); // storage of another object
+    if (packed_OK == false)
+    {
+        printf("%s FAILED on packed_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    bool decref_OK = (decref_obj(vector) == 0 && decref_obj(matrix) == 0 &&
+                      decref_obj(small_matrix) == 0 && decref_obj(block) == 0 &&
+                      decref_obj(copy) == 0);
+    if (decref_OK == false)
+    {
+        printf("%s FAILED on decref_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    printf("%s PASSED.\n%s\n", test_name, DELIM);
+    return 0;
+}
+
+struct ReleaseLog
+{
+    int calls;
+    size_t bytes;
+};
+
+int test_obj_buffer_01()
+{
+    // test for valid input: wrapped caller memory is bound in place at any
+    // size, is not charged as object memory, and an external buffer goes
+    // back to its callback exactly once when the object is freed (or when
+    // an INLINE_TAKE copy is made)
+
+    const char* test_name = "test_obj_buffer_01";
+    struct ReleaseLog log = {0};
+    double borrowed[4] = {1.0, 2.0, 3.0, 4.0};
+    struct List elements;
+
+    bool invalid_OK =
+        (obj_buffer_wrap(NULL, borrowed, 4, sizeof(double), NULL, NULL) == 1 &&
+         obj_buffer_wrap(&elements, NULL, 4, sizeof(double), NULL, NULL) == 1 &&
+         obj_buffer_wrap(&elements, borrowed, SIZE_MAX, 2, NULL, NULL) == 1 &&
+         create_vector((struct List){.list = borrowed,
+                                     .size = 4,
+                                     .type_size = sizeof(double),
+                                     .alloc = ELEMENTS_EXTERNAL}) == NULL);
+    if (invalid_OK == false)
+    {
+        printf("%s FAILED on invalid_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    struct MemoryStats before;
+    struct MemoryStats after;
+    struct List small;
+    struct List large;
+    struct List copied;
+    size_t large_count = 4096;
+    obj_memory_stats(&before);
+    bool wrap_OK =
+        (obj_buffer_wrap(&small, borrowed, 4, sizeof(double), NULL, NULL) == 0 &&
+         obj_buffer_wrap(&large, calloc(large_count, sizeof(double)), large_count,
+                         sizeof(double), log_release, &log) == 0 &&
+         obj_buffer_wrap(&copied, calloc(64, sizeof(double)), 64, sizeof(double), log_release,
+                         &log) == 0 &&
+         small.alloc == ELEMENTS_BORROWED && large.alloc == ELEMENTS_EXTERNAL &&
+         large.release_ctx == &log);
+    if (wrap_OK == false)
+    {
+        printf("%s FAILED on wrap_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    struct ObjWrapper* small_matrix = create_matrix(small, 2, 2);
+    struct ObjWrapper* large_vector = create_vector(large);
+    struct ObjWrapper* block = create_vector_inline(NULL, copied, INLINE_TAKE);
+    obj_memory_stats(&after);
+    bool bound_OK =
+        (small_matrix && large_vector && block &&
+         get_obj_elements(small_matrix)->list == borrowed &&
+         get_obj_elements(large_vector)->list == large.list && log.calls == 1 &&
+         log.bytes == 64 * sizeof(double) && // INLINE_TAKE released the source
+         after.vectors.bytes - before.vectors.bytes < large_count * sizeof(double));
+    if (bound_OK == false)
+    {
+        printf("%s FAILED on bound_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    ((double*)get_obj_elements(small_matrix)->list)[3] = 8.0; // writes reach the caller
+    bool release_OK = (borrowed[3] == 8.0 && decref_obj(small_matrix) == 0 &&
+                       decref_obj(block) == 0 && log.calls == 1 &&
+                       decref_obj(large_vector) == 0 && log.calls == 2 &&
+                       log.bytes == (64 + large_count) * sizeof(double));
+    if (release_OK == false)
+    {
+        printf("%s FAILED on release_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    printf("%s PASSED.\n%s\n", test_name, DELIM);
+    return 0;
+}
+
+int test_obj_buffer_02()
+{
+    // test for valid input: with the pool on, a released buffer comes back
+    // for the next request of its size class and kind (not for another
+    // class or kind), buffers over the cap or past the age limit are
+    // released, and turning the pool off empties it
+
+    const char* test_name = "test_obj_buffer_02";
+    struct BufferPoolStats stats;
+    struct List first;
+    struct List second;
+    int rc = 1;
+
+    obj_buffer_pool_config(16 << 20, 0);
+    do
+    {
+        // 100000 doubles and 100001 doubles share a class; a 4x smaller
+        // request does not; neither does a small one or a huge one
+        obj_buffer_alloc(&first, 100000, sizeof(double), ELEMENTS_ALIGNED);
+        void* pooled = first.list;
+        struct ObjWrapper* vector = create_vector(first);
+        bool put_OK = (vector && decref_obj(vector) == 0);
+        obj_buffer_pool_stats(&stats);
+        put_OK = put_OK && stats.buffers == 1 && stats.bytes >= 100000 * sizeof(double);
+        if (put_OK == false)
+        {
+            printf("%s FAILED on put_OK.\n%s\n", test_name, DELIM);
+            break;
+        }
+
+        obj_buffer_alloc(&second, 25000, sizeof(double), ELEMENTS_ALIGNED);
+        bool other_class_OK = (second.list != pooled);
+        obj_buffer_free(second);
+        obj_buffer_alloc(&second, 100001, sizeof(double), ELEMENTS_ALIGNED);
+        obj_buffer_pool_stats(&stats);
+        bool take_OK = (other_class_OK && second.list == pooled && stats.hits == 1 &&
+                        stats.buffers == 1); // the 25000 one waits now
+        ((double*)second.list)[100000] = 1.0;    // the whole request is usable
+        obj_buffer_free(second);
+        if (take_OK == false)
+        {
+            printf("%s FAILED on take_OK.\n%s\n", test_name, DELIM);
+            break;
+        }
+
+        size_t huge_count = (3 << 20) / sizeof(double); // 3 MiB
+        obj_buffer_alloc(&first, huge_count, sizeof(double), ELEMENTS_HUGE);
+        pooled = first.list;
+        obj_buffer_free(first);
+        obj_buffer_alloc(&second, huge_count, sizeof(double), ELEMENTS_HUGE);
+        bool huge_OK = (second.alloc == ELEMENTS_HUGE && second.list == pooled &&
+                        (uintptr_t)second.list % OBJ_BUFFER_HUGE_BYTES == 0);
+        obj_buffer_free(second);
+        if (huge_OK == false)
+        {
+            printf("%s FAILED on huge_OK.\n%s\n", test_name, DELIM);
+            break;
+        }
+
+        // a 4 MiB cap keeps only the newest buffers; a 1 ms age limit
+        // lets the next use of the pool drop everything older
+        obj_buffer_pool_config(4 << 20, 0);
+        obj_buffer_pool_stats(&stats);
+        bool cap_OK = (stats.bytes <= (4 << 20) && stats.released >= 1);
+        obj_buffer_pool_config(4 << 20, 1);
+        nanosleep(&(struct timespec){0, 5000000}, NULL);
+        obj_buffer_alloc(&first, 100000, sizeof(double), ELEMENTS_ALIGNED);
+        obj_buffer_pool_stats(&stats);
+        bool age_OK = (stats.buffers == 0);
+        obj_buffer_free(first);
+        if (cap_OK == false || age_OK == false)
+        {
+            printf("%s FAILED on %s.\n%s\n", test_name, cap_OK ? "age_OK" : "cap_OK", DELIM);
+            break;
+        }
+
+        obj_buffer_pool_config(0, 0);
+        obj_buffer_pool_stats(&stats);
+        bool off_OK = (stats.buffers == 0 && stats.bytes == 0 && stats.max_bytes == 0);
+        if (off_OK == false)
+        {
+            printf("%s FAILED on off_OK.\n%s\n", test_name, DELIM);
+            break;
+        }
+
+        printf("%s PASSED.\n%s\n", test_name, DELIM);
+        rc = 0;
+    } while (0);
+
+    obj_buffer_pool_config(0, 0);
+    return rc;
+}
+
+static void log_release(void* ctx, void* list, size_t bytes)
+{
+    struct ReleaseLog* log = ctx;
+    log->calls++;
+    log->bytes += bytes;
+    free(list);
+}
+#pragma endregion
+
+#pragma region memory accounting tests
+/* ============================================================================
+ * obj_memory_stats() / obj_set_memory_budget() tests
+ * ============================================================================
+ */
+#define BUDGET_THREADS 4
+#define BUDGET_MAX_SCALARS 4096
+
+struct BudgetFill
+{
+    struct ObjWrapper* objects[BUDGET_MAX_SCALARS];
+    size_t count;
+};
+
+int test_obj_memory_00()
+{
+    // test for valid input: create and destroy move the per-type counters,
+    // a budget refuses objects that do not fit (leaving the caller's buffer
+    // alone), batch items report the budget individually, and threads
+    // racing to fill a budget never overshoot it together
+
+    const char* test_name = "test_obj_memory_00";
+    struct MemoryStats base;
+    struct MemoryStats stats;
+
+    bool invalid_OK = (obj_memory_stats(NULL) == 1 && obj_memory_stats(&base) == 0 &&
+                       base.budget == 0);
+    if (invalid_OK == false)
+    {
+        printf("%s FAILED on invalid_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    struct List big = {.list = calloc(36, sizeof(double)), .size = 36, .type_size = sizeof(double)};
+    struct List small = {0};
+    return_valid_vector_components(&small);
+    struct ObjWrapper* matrix = create_matrix(big, 6, 6);
+    struct ObjWrapper* vector = create_vector(small);
+    struct ObjWrapper* scalar = create_scalar(1.0);
+    obj_memory_stats(&stats);
+    bool count_OK =
+        (matrix && vector && scalar && !obj_budget_rejected() &&
+         stats.matrices.objects == base.matrices.objects + 1 &&
+         stats.matrices.bytes >= base.matrices.bytes + 36 * sizeof(double) &&
+         stats.vectors.objects == base.vectors.objects + 1 &&
+         stats.scalars.objects == base.scalars.objects + 1 &&
+         stats.total_bytes == stats.scalars.bytes + stats.vectors.bytes + stats.matrices.bytes);
+    if (count_OK == false)
+    {
+        printf("%s FAILED on count_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    // room for one more 6x6 matrix but not two
+    size_t matrix_bytes = stats.matrices.bytes - base.matrices.bytes;
+    size_t scalar_bytes = stats.scalars.bytes - base.scalars.bytes;
+    obj_set_memory_budget(stats.total_bytes + matrix_bytes + matrix_bytes / 2);
+    struct List first = {.list = calloc(36, sizeof(double)), .size = 36,
+                         .type_size = sizeof(double)};
+    struct List second = {.list = calloc(36, sizeof(double)), .size = 36,
+                          .type_size = sizeof(double)};
+    struct ObjWrapper* fits = create_matrix(first, 6, 6);
+    struct ObjWrapper* refused = create_matrix(second, 6, 6);
+    obj_memory_stats(&stats);
+    bool budget_OK = (fits && !refused && obj_budget_rejected() &&
+                      stats.budget_rejections == base.budget_rejections + 1 &&
+                      stats.total_bytes <= stats.budget);
+    if (budget_OK == false)
+    {
+        printf("%s FAILED on budget_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+    decref_obj(fits); // frees room for exactly one of the batch items
+
+    struct MatrixSpec specs[2] = {
+        {"a", second, 6, 6},
+        {"b", {.list = calloc(36, sizeof(double)), .size = 36, .type_size = sizeof(double)}, 6, 6}};
+    struct ObjWrapper* batch[2];
+    bool over_budget[2] = {true, false};
+    bool batch_OK = (create_matrices_in(NULL, specs, 2, batch, over_budget) == 1 && batch[0] &&
+                     !batch[1] && !over_budget[0] && over_budget[1]);
+    free(specs[1].elements.list); // refused: still ours
+    if (batch_OK == false)
+    {
+        printf("%s FAILED on batch_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+    decref_obj(batch[0]);
+
+    obj_memory_stats(&stats);
+    obj_set_memory_budget(stats.total_bytes + 2000 * scalar_bytes); // shared by all threads
+    pthread_t threads[BUDGET_THREADS];
+    struct BudgetFill* fills = calloc(BUDGET_THREADS, sizeof(struct BudgetFill));
+    for (size_t i = 0; i < BUDGET_THREADS; i++)
+        pthread_create(&threads[i], NULL, budget_fill_worker, &fills[i]);
+    for (size_t i = 0; i < BUDGET_THREADS; i++)
+        pthread_join(threads[i], NULL);
+    obj_memory_stats(&stats);
+    bool race_OK = (stats.total_bytes <= stats.budget &&
+                    stats.total_bytes + scalar_bytes > stats.budget); // filled up
+    for (size_t i = 0; i < BUDGET_THREADS; i++)
+    {
+        race_OK = race_OK && fills[i].count < BUDGET_MAX_SCALARS;
+        for (size_t j = 0; j < fills[i].count; j++)
+            decref_obj(fills[i].objects[j]);
+    }
+    free(fills);
+    if (race_OK == false)
+    {
+        printf("%s FAILED on race_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    obj_set_memory_budget(0);
+    decref_obj(matrix);
+    decref_obj(vector);
+    decref_obj(scalar);
+    obj_memory_stats(&stats);
+    bool release_OK = (stats.total_bytes == base.total_bytes &&
+                       stats.matrices.objects == base.matrices.objects &&
+                       stats.vectors.objects == base.vectors.objects &&
+                       stats.scalars.objects == base.scalars.objects);
+    if (release_OK == false)
+    {
+        printf("%s FAILED on release_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    printf("%s PASSED.\n%s\n", test_name, DELIM);
+    return 0;
+}
+
+static void* budget_fill_worker(void* arg)
+{
+    struct BudgetFill* fill = arg;
+    while (fill->count < BUDGET_MAX_SCALARS)
+    {
+        struct ObjWrapper* scalar = create_scalar((double)fill->count);
+        if (!scalar)
+            break; // budget reached
+        fill->objects[fill->count++] = scalar;
+    }
+    return NULL;
+}
+#pragma endregion
+
+#pragma region biased refcount tests
+/* ============================================================================
+ * biased reference count tests
+ * ============================================================================
+ */
+#define SHARED_REF_THREADS 4
+#define SHARED_REF_ROUNDS 10000
+
+int test_biased_refcount_00()
+{
+    // test for valid input: references the creating thread took are dropped
+    // by other threads while they churn their own; the object survives until
+    // the last reference and is destroyed exactly once
+
+    const char* test_name = "test_biased_refcount_00";
+    struct ObjStore* store = obj_store_init(true, NULL);
+    struct ObjWrapper* scalar = create_scalar_in(store, 1.0);
+
+    // one owner reference per worker, each dropped by that worker
+    bool incref_OK = (scalar != NULL);
+    for (size_t i = 0; incref_OK && i < SHARED_REF_THREADS; i++)
+        incref_OK = (incref_obj(scalar) == 0);
+    if (incref_OK == false || debug_get_obj_refcount(scalar) != SHARED_REF_THREADS + 1)
+    {
+        printf("%s FAILED on incref_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    pthread_t threads[SHARED_REF_THREADS];
+    for (size_t i = 0; i < SHARED_REF_THREADS; i++)
+        pthread_create(&threads[i], NULL, shared_ref_worker, scalar);
+    bool worker_OK = true;
+    for (size_t i = 0; i < SHARED_REF_THREADS; i++)
+    {
+        void* ret = NULL;
+        pthread_join(threads[i], &ret);
+        worker_OK = worker_OK && ret == NULL;
+    }
+
+    bool alive_OK = (worker_OK && debug_get_obj_refcount(scalar) == 1 &&
+                     obj_store_count(store) == 1 && get_obj_type(scalar) == OBJ_SCALAR);
+    if (alive_OK == false)
+    {
+        printf("%s FAILED on alive_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    bool destroy_OK = (decref_obj(scalar) == 0 && obj_store_count(store) == 0);
+    obj_store_destroy(store);
+    if (destroy_OK == false)
+    {
+        printf("%s FAILED on destroy_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    printf("%s PASSED.\n%s\n", test_name, DELIM);
+    return 0;
+}
+
+int test_biased_refcount_01()
+{
+    // test for valid input: an object whose creating thread has exited is
+    // still destroyed by the last decref_obj() on another thread, and
+    // teardown settles objects owned by other threads
+
+    const char* test_name = "test_biased_refcount_01";
+    struct ObjStore* store = obj_store_init(true, NULL);
+    struct ObjWrapper* objects[2] = {NULL, NULL};
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, orphan_create_worker, (void*)store);
+    pthread_join(thread, (void**)&objects[0]);
+    pthread_create(&thread, NULL, orphan_create_worker, (void*)store);
+    pthread_join(thread, (void**)&objects[1]);
+
+    bool create_OK = (objects[0] && objects[1] && obj_store_count(store) == 2);
+    if (create_OK == false)
+    {
+        printf("%s FAILED on create_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    bool decref_OK = (incref_obj(objects[0]) == 0 && decref_obj(objects[0]) == 0 &&
+                      obj_store_count(store) == 2 && decref_obj(objects[0]) == 0 &&
+                      obj_store_count(store) == 1);
+    if (decref_OK == false)
+    {
+        printf("%s FAILED on decref_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    obj_store_destroy(store); // objects[1] is still biased to its exited owner
+    printf("%s PASSED.\n%s\n", test_name, DELIM);
+    return 0;
+}
+
+static void* shared_ref_worker(void* arg)
+{
+    struct ObjWrapper* scalar = arg;
+    for (size_t i = 0; i < SHARED_REF_ROUNDS; i++)
+    {
+        if (incref_obj(scalar) != 0 || decref_obj(scalar) != 0)
+            return arg; // failure
+    }
+    return decref_obj(scalar) == 0 ? NULL : arg; // the owner reference handed to us
+}
+
+static void* orphan_create_worker(void* arg)
+{
+    return create_scalar_in(arg, 2.0);
+}
+#pragma endregion
+
+#pragma region mem_alloc tests
+/* ============================================================================
+ * mem_set_process_allocator() tests
+ * ============================================================================
+ */
+
+struct SiteCounter
+{
+    atomic_size_t allocs[ALLOC_SITE_COUNT]; // blocks handed out
+    atomic_size_t live[ALLOC_SITE_COUNT];   // handed out and not yet freed
+};
+
+static struct SiteCounter process_counter;
+
+int test_mem_alloc_00()
+{
+    // test for valid input: an allocator installed before the library first
+    // allocates serves object memory under the right sites, blocks go back
+    // to it, and once it is in use it cannot be replaced
+    // (must run before any other test allocates)
+
+    const char* test_name = "test_mem_alloc_00";
+    struct LinalgAllocator counting = {count_alloc, count_aligned_alloc, count_free,
+                                       &process_counter};
+    struct LinalgAllocator broken = {count_alloc, NULL, count_free, &process_counter};
+    struct List elements;
+    size_t rows;
+    size_t cols;
+
+    bool install_OK = (mem_set_process_allocator(&broken) == 1 &&
+                       mem_set_process_allocator(&counting) == 0);
+    if (install_OK == false)
+    {
+        printf("%s FAILED on install_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    struct ObjStore* store = obj_store_init(false, NULL);
+    return_valid_matrix_components(&elements, &rows, &cols);
+    struct ObjWrapper* matrix = store ? create_matrix_in(store, elements, rows, cols) : NULL;
+    struct List aligned;
+    bool aligned_ok = (obj_buffer_alloc(&aligned, 1024, sizeof(double), ELEMENTS_ALIGNED) == 0);
+    bool sites_OK = (matrix && aligned_ok &&
+                     atomic_load(&process_counter.allocs[ALLOC_SITE_OBJ_STORE]) > 0 &&
+                     atomic_load(&process_counter.allocs[ALLOC_SITE_OBJ_SLAB]) > 0 &&
+                     atomic_load(&process_counter.live[ALLOC_SITE_ELEMENTS]) == 1);
+    if (aligned_ok)
+        obj_buffer_free(aligned);
+    obj_store_destroy(store);
+    if (sites_OK == false)
+    {
+        printf("%s FAILED on sites_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    bool released_OK = (atomic_load(&process_counter.live[ALLOC_SITE_ELEMENTS]) == 0 &&
+                        mem_set_process_allocator(NULL) == 4);
+    if (released_OK == false)
+    {
+        printf("%s FAILED on released_OK.\n%s\n", test_name, DELIM);
+        return 1;
+    }
+
+    printf("%s PASSED.\n%s\n", test_name, DELIM);
+    return 0;
+}
+
+static void* count_alloc(void* ctx, size_t bytes, enum AllocSite site)
+{
+    struct SiteCounter* counter = ctx;
+    void* block = malloc(bytes);
+    if (block)
+    {
+        atomic_fetch_add(&counter->allocs[site], 1);
+        atomic_fetch_add(&counter->live[site], 1);
+    }
+    return block;
+}
+
+static void* count_aligned_alloc(void* ctx, size_t alignment, size_t bytes, enum AllocSite site)
+{
+    struct SiteCounter* counter = ctx;
+    void* block = aligned_alloc(alignment, bytes);
+    if (block)
+    {
+        atomic_fetch_add(&counter->allocs[site], 1);
+        atomic_fetch_add(&counter->live[site], 1);
+    }
+    return block;
+}
+
+static void count_free(void* ctx, void* block, enum AllocSite site)
+{
+    struct SiteCounter* counter = ctx;
+    atomic_fetch_sub(&counter->live[site], 1);
+    free(block);
+}
+#pragma endregion
+
 #pragma region helper functions
 /* ============================================================================
  * Helper functions
@@ -842,6 +1982,7 @@ int return_valid_matrix_components(struct List* elements, size_t* num_rows, size
     elements->list = element_list;
     elements->size = element_list_size;
     elements->type_size = sizeof(double);
+    elements->alloc = ELEMENTS_MALLOC;
 
     *num_rows = rows;
     *num_cols = cols;
@@ -868,6 +2009,7 @@ int return_valid_vector_components(struct List* elements)
     elements->list = element_list;
     elements->size = element_list_size;
     elements->type_size = sizeof(double);
+    elements->alloc = ELEMENTS_MALLOC;
 
     return 0;
 };
@@ -1,9 +1,13 @@
 #include <assert.h>
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "math_objs.h"
+#include "logs.h"
 #include "reg_hash.h"
+#include "reg_mphf.h"
 
 /* ============================================================================
  * File-local definitions
@@ -32,6 +36,25 @@ int test_lookup_existing_binding();
 int test_lookup_binding_invalid_name();
 int test_lookup_binding_invalid_table();
 int test_list_bindings();
+int test_reg_table_grows_and_shrinks();
+int test_flat_backend_bindings();
+int test_init_reg_table_config_invalid();
+int test_seeded_registry_bindings();
+int test_registry_churn_and_long_names();
+int test_binding_handles();
+int test_concurrent_registry_threads();
+int test_lockfree_lookups_during_writes();
+int test_filtered_lookups_during_writes();
+int test_reserve_bindings();
+int test_registry_stats();
+int test_prefix_index();
+int test_prefix_index_churn();
+int test_freeze_registry();
+int test_frozen_lookups_during_thaw();
+int test_mphf_build_failure_rate();
+int test_negative_filter();
+int test_registry_snapshots();
+int test_snapshot_readers_during_writes();
 
 /* ============================================================================
  * main()
@@ -55,6 +78,25 @@ int main()
     assert(test_lookup_binding_invalid_name() == 0);
     assert(test_lookup_binding_invalid_table() == 0);
     assert(test_list_bindings() == 0);
+    assert(test_reg_table_grows_and_shrinks() == 0);
+    assert(test_flat_backend_bindings() == 0);
+    assert(test_init_reg_table_config_invalid() == 0);
+    assert(test_seeded_registry_bindings() == 0);
+    assert(test_registry_churn_and_long_names() == 0);
+    assert(test_binding_handles() == 0);
+    assert(test_concurrent_registry_threads() == 0);
+    assert(test_lockfree_lookups_during_writes() == 0);
+    assert(test_filtered_lookups_during_writes() == 0);
+    assert(test_reserve_bindings() == 0);
+    assert(test_registry_stats() == 0);
+    assert(test_prefix_index() == 0);
+    assert(test_prefix_index_churn() == 0);
+    assert(test_freeze_registry() == 0);
+    assert(test_frozen_lookups_during_thaw() == 0);
+    assert(test_mphf_build_failure_rate() == 0);
+    assert(test_negative_filter() == 0);
+    assert(test_registry_snapshots() == 0);
+    assert(test_snapshot_readers_during_writes() == 0);
 
     return 0;
 }
@@ -864,4 +906,1983 @@ int test_list_bindings()
     {
         return 1;
     }
-}
\ No newline at end of file
+}
+
+int test_reg_table_grows_and_shrinks()
+{
+    const char* test_name = "test_reg_table_grows_and_shrinks";
+    const size_t initial_size = 7;
+    const size_t num_names = 5000;
+    char name[32];
+    struct ObjWrapper* wrapper_ptr = create_scalar(3.14);
+    struct RegistryHash* reg_table = init_reg_table(initial_size);
+
+    bool init_ok = false;
+    bool all_adds_ok = true;
+    bool table_grew = false;
+    bool all_bound_after_adds = true;
+    bool all_removes_ok = true;
+    bool all_unbound_after_removes = true;
+    bool table_shrank = false;
+    size_t grown_size = 0;
+
+    // logging every add/remove would drown the test output
+    set_log_level(LOG_ERROR);
+
+    init_ok = (reg_table != NULL);
+    if (!init_ok)
+        printf("%s FAILED on init_ok.\n%s\n", test_name, DELIM);
+    else
+    {
+        for (size_t i = 0; i < num_names; i++)
+        {
+            snprintf(name, sizeof(name), "layer_%04zu_w", i);
+            if (add_binding(name, wrapper_ptr, reg_table) != 0)
+                all_adds_ok = false;
+        }
+        if (!all_adds_ok)
+            printf("%s FAILED on all_adds_ok.\n%s\n", test_name, DELIM);
+
+        grown_size = debug_get_reg_bucket_count(reg_table);
+        table_grew = (grown_size >= num_names);
+        if (!table_grew)
+            printf("%s FAILED on table_grew.\n%s\n", test_name, DELIM);
+
+        for (size_t i = 0; i < num_names; i++)
+        {
+            snprintf(name, sizeof(name), "layer_%04zu_w", i);
+            if (lookup_binding(name, reg_table) != wrapper_ptr)
+                all_bound_after_adds = false;
+        }
+        if (!all_bound_after_adds)
+            printf("%s FAILED on all_bound_after_adds.\n%s\n", test_name, DELIM);
+
+        for (size_t i = 0; i < num_names; i++)
+        {
+            snprintf(name, sizeof(name), "layer_%04zu_w", i);
+            if (remove_binding(name, reg_table) != 0)
+                all_removes_ok = false;
+        }
+        if (!all_removes_ok)
+            printf("%s FAILED on all_removes_ok.\n%s\n", test_name, DELIM);
+
+        for (size_t i = 0; i < num_names; i++)
+        {
+            snprintf(name, sizeof(name), "layer_%04zu_w", i);
+            if (lookup_binding(name, reg_table) != NULL)
+                all_unbound_after_removes = false;
+        }
+        if (!all_unbound_after_removes)
+            printf("%s FAILED on all_unbound_after_removes.\n%s\n", test_name, DELIM);
+
+        table_shrank = (debug_get_reg_bucket_count(reg_table) < grown_size);
+        if (!table_shrank)
+            printf("%s FAILED on table_shrank.\n%s\n", test_name, DELIM);
+    }
+
+    destroy_reg_table(reg_table);
+    decref_obj(wrapper_ptr);
+    set_log_level(LOG_ALL);
+
+    if (init_ok && all_adds_ok && table_grew && all_bound_after_adds && all_removes_ok &&
+        all_unbound_after_removes && table_shrank)
+    {
+        printf("%s PASSED.\n%s\n", test_name, DELIM);
+        return 0;
+    }
+    else
+    {
+        return 1;
+    }
+}
+
+int test_flat_backend_bindings()
+{
+    const char* test_name = "test_flat_backend_bindings";
+    const size_t num_names = 5000;
+    char name[32];
+    struct RegistryConfig config = {.backend = REG_BACKEND_FLAT};
+    struct ObjWrapper* wrapper_ptr1 = create_scalar(3.14);
+    struct ObjWrapper* wrapper_ptr2 = create_scalar(9.81);
+    struct RegistryHash* reg_table = init_reg_table_config(16, &config);
+
+    bool init_ok = false;
+    bool all_adds_ok = true;
+    bool all_bound_after_adds = true;
+    bool overwrite_ok = false;
+    bool refcounts_after_overwrite_ok = false;
+    bool all_removes_ok = true;
+    bool all_unbound_after_removes = true;
+    bool remove_missing_returns_1 = false;
+
+    set_log_level(LOG_ERROR);
+
+    init_ok = (reg_table != NULL);
+    if (!init_ok)
+        printf("%s FAILED on init_ok.\n%s\n", test_name, DELIM);
+    else
+    {
+        for (size_t i = 0; i < num_names; i++)
+        {
+            snprintf(name, sizeof(name), "layer_%04zu_w", i);
+            if (add_binding(name, wrapper_ptr1, reg_table) != 0)
+                all_adds_ok = false;
+        }
+        if (!all_adds_ok)
+            printf("%s FAILED on all_adds_ok.\n%s\n", test_name, DELIM);
+
+        for (size_t i = 0; i < num_names; i++)
+        {
+            snprintf(name, sizeof(name), "layer_%04zu_w", i);
+            if (lookup_binding(name, reg_table) != wrapper_ptr1)
+                all_bound_after_adds = false;
+        }
+        if (!all_bound_after_adds)
+            printf("%s FAILED on all_bound_after_adds.\n%s\n", test_name, DELIM);
+
+        overwrite_ok = (add_binding("layer_0000_w", wrapper_ptr2, reg_table) == 0 &&
+                        lookup_binding("layer_0000_w", reg_table) == wrapper_ptr2);
+        if (!overwrite_ok)
+            printf("%s FAILED on overwrite_ok.\n%s\n", test_name, DELIM);
+
+        refcounts_after_overwrite_ok = (debug_get_obj_refcount(wrapper_ptr1) == num_names &&
+                                        debug_get_obj_refcount(wrapper_ptr2) == 2);
+        if (!refcounts_after_overwrite_ok)
+            printf("%s FAILED on refcounts_after_overwrite_ok.\n%s\n", test_name, DELIM);
+
+        for (size_t i = 0; i < num_names; i++)
+        {
+            snprintf(name, sizeof(name), "layer_%04zu_w", i);
+            if (remove_binding(name, reg_table) != 0)
+                all_removes_ok = false;
+        }
+        if (!all_removes_ok)
+            printf("%s FAILED on all_removes_ok.\n%s\n", test_name, DELIM);
+
+        for (size_t i = 0; i < num_names; i++)
+        {
+            snprintf(name, sizeof(name), "layer_%04zu_w", i);
+            if (lookup_binding(name, reg_table) != NULL)
+                all_unbound_after_removes = false;
+        }
+        if (!all_unbound_after_removes)
+            printf("%s FAILED on all_unbound_after_removes.\n%s\n", test_name, DELIM);
+
+        remove_missing_returns_1 = (remove_binding("layer_0000_w", reg_table) == 1);
+        if (!remove_missing_returns_1)
+            printf("%s FAILED on remove_missing_returns_1.\n%s\n", test_name, DELIM);
+    }
+
+    destroy_reg_table(reg_table);
+    decref_obj(wrapper_ptr1);
+    decref_obj(wrapper_ptr2);
+    set_log_level(LOG_ALL);
+
+    if (init_ok && all_adds_ok && all_bound_after_adds && overwrite_ok &&
+        refcounts_after_overwrite_ok && all_removes_ok && all_unbound_after_removes &&
+        remove_missing_returns_1)
+    {
+        printf("%s PASSED.\n%s\n", test_name, DELIM);
+        return 0;
+    }
+    else
+    {
+        return 1;
+    }
+}
+
+int test_init_reg_table_config_invalid()
+{
+    // Violates conditions: 1. table_size > 0, 2. config->backend valid.
+
+    const char* test_name = "test_init_reg_table_config_invalid";
+    struct RegistryConfig flat_config = {.backend = REG_BACKEND_FLAT};
+    struct RegistryConfig bad_config = {.backend = (enum RegistryBackend)42};
+
+    bool zero_size_returns_null = false;
+    bool bad_backend_returns_null = false;
+
+    zero_size_returns_null = (init_reg_table_config(0, &flat_config) == NULL);
+    if (!zero_size_returns_null)
+        printf("%s FAILED on zero_size_returns_null.\n%s\n", test_name, DELIM);
+
+    bad_backend_returns_null = (init_reg_table_config(16, &bad_config) == NULL);
+    if (!bad_backend_returns_null)
+        printf("%s FAILED on bad_backend_returns_null.\n%s\n", test_name, DELIM);
+
+    if (zero_size_returns_null && bad_backend_returns_null)
+    {
+        printf("%s PASSED.\n%s\n", test_name, DELIM);
+        return 0;
+    }
+    else
+    {
+        return 1;
+    }
+}
+
+int test_seeded_registry_bindings()
+{
+    // Same names resolve under any seed and either backend; names that differ
+    // in a single digit must not be confused.
+
+    const char* test_name = "test_seeded_registry_bindings";
+    const size_t num_names = 1000;
+    const uint64_t seeds[] = {1, 0xdeadbeefcafef00dull, 0};
+    const enum RegistryBackend backends[] = {REG_BACKEND_CHAINED, REG_BACKEND_FLAT};
+    char name[32];
+    struct ObjWrapper* wrapper_ptr1 = create_scalar(3.14);
+    struct ObjWrapper* wrapper_ptr2 = create_scalar(9.81);
+
+    bool all_inits_ok = true;
+    bool all_lookups_ok = true;
+
+    set_log_level(LOG_ERROR);
+
+    for (size_t b = 0; b < 2; b++)
+    {
+        for (size_t k = 0; k < sizeof(seeds) / sizeof(seeds[0]); k++)
+        {
+            struct RegistryConfig config = {.backend = backends[b], .seed = seeds[k]};
+            struct RegistryHash* reg_table = init_reg_table_config(16, &config);
+            if (!reg_table)
+            {
+                all_inits_ok = false;
+                continue;
+            }
+
+            // even indices -> wrapper 1, odd indices -> wrapper 2
+            for (size_t i = 0; i < num_names; i++)
+            {
+                snprintf(name, sizeof(name), "layer_%04zu_w", i);
+                add_binding(name, (i % 2) ? wrapper_ptr2 : wrapper_ptr1, reg_table);
+            }
+            for (size_t i = 0; i < num_names; i++)
+            {
+                snprintf(name, sizeof(name), "layer_%04zu_w", i);
+                if (lookup_binding(name, reg_table) != ((i % 2) ? wrapper_ptr2 : wrapper_ptr1))
+                    all_lookups_ok = false;
+            }
+
+            destroy_reg_table(reg_table);
+        }
+    }
+
+    if (!all_inits_ok)
+        printf("%s FAILED on all_inits_ok.\n%s\n", test_name, DELIM);
+    if (!all_lookups_ok)
+        printf("%s FAILED on all_lookups_ok.\n%s\n", test_name, DELIM);
+
+    decref_obj(wrapper_ptr1);
+    decref_obj(wrapper_ptr2);
+    set_log_level(LOG_ALL);
+
+    if (all_inits_ok && all_lookups_ok)
+    {
+        printf("%s PASSED.\n%s\n", test_name, DELIM);
+        return 0;
+    }
+    else
+    {
+        return 1;
+    }
+}
+
+int test_registry_churn_and_long_names()
+{
+    // Repeated add/remove cycles recycle arena storage; names past the pooled
+    // size limit and names of every size class must round-trip intact.
+    const char* test_name = "test_registry_churn_and_long_names";
+    const enum RegistryBackend backends[] = {REG_BACKEND_CHAINED, REG_BACKEND_FLAT};
+    char name[400];
+    struct ObjWrapper* wrapper_ptr = create_scalar(3.14);
+
+    bool all_inits_ok = true;
+    bool all_adds_ok = true;
+    bool all_lookups_ok = true;
+    bool all_removes_ok = true;
+
+    for (size_t b = 0; b < 2; b++)
+    {
+        struct RegistryConfig config = {.backend = backends[b]};
+        struct RegistryHash* reg_table = init_reg_table_config(16, &config);
+        if (!reg_table)
+        {
+            all_inits_ok = false;
+            continue;
+        }
+
+        for (size_t cycle = 0; cycle < 20; cycle++)
+        {
+            // lengths 1..399 cover every size class plus oversize names
+            for (size_t len = 1; len < sizeof(name); len++)
+            {
+                memset(name, 'a' + (char)(len % 26), len);
+                name[len] = '\0';
+                name[0] = 'n';
+                if (add_binding(name, wrapper_ptr, reg_table) != 0)
+                    all_adds_ok = false;
+            }
+            for (size_t len = 1; len < sizeof(name); len++)
+            {
+                memset(name, 'a' + (char)(len % 26), len);
+                name[len] = '\0';
+                name[0] = 'n';
+                if (lookup_binding(name, reg_table) != wrapper_ptr)
+                    all_lookups_ok = false;
+            }
+            // leave the odd lengths bound on the last cycle so destroy releases them
+            for (size_t len = 1; len < sizeof(name); len++)
+            {
+                if (cycle == 19 && len % 2)
+                    continue;
+                memset(name, 'a' + (char)(len % 26), len);
+                name[len] = '\0';
+                name[0] = 'n';
+                if (remove_binding(name, reg_table) != 0)
+                    all_removes_ok = false;
+            }
+        }
+
+        if (debug_get_obj_refcount(wrapper_ptr) != 1 + (sizeof(name) / 2))
+            all_removes_ok = false;
+        destroy_reg_table(reg_table);
+    }
+
+    if (debug_get_obj_refcount(wrapper_ptr) != 1)
+        all_removes_ok = false;
+
+    if (!all_inits_ok)
+        printf("%s FAILED on all_inits_ok.\n%s\n", test_name, DELIM);
+    if (!all_adds_ok)
+        printf("%s FAILED on all_adds_ok.\n%s\n", test_name, DELIM);
+    if (!all_lookups_ok)
+        printf("%s FAILED on all_lookups_ok.\n%s\n", test_name, DELIM);
+    if (!all_removes_ok)
+        printf("%s FAILED on all_removes_ok.\n%s\n", test_name, DELIM);
+
+    decref_obj(wrapper_ptr);
+
+    if (all_inits_ok && all_adds_ok && all_lookups_ok && all_removes_ok)
+    {
+        printf("%s PASSED.\n%s\n", test_name, DELIM);
+        return 0;
+    }
+    else
+    {
+        return 1;
+    }
+}
+
+int test_binding_handles()
+{
+    // Handles survive resizing, go stale on rebind/remove and never reach a
+    // different binding; both backends.
+    const char* test_name = "test_binding_handles";
+    const size_t num_names = 2000;
+    const enum RegistryBackend backends[] = {REG_BACKEND_CHAINED, REG_BACKEND_FLAT};
+    char name[32];
+    struct ObjWrapper* wrapper_ptr1 = create_scalar(3.14);
+    struct ObjWrapper* wrapper_ptr2 = create_scalar(9.81);
+    struct BindingHandle handles[8];
+
+    bool all_inits_ok = true;
+    bool all_resolves_ok = true;
+    bool survives_resize = true;
+    bool stale_after_rebind = true;
+    bool rebind_handle_ok = true;
+    bool stale_after_remove = true;
+
+    set_log_level(LOG_ERROR);
+
+    for (size_t b = 0; b < 2; b++)
+    {
+        struct RegistryConfig config = {.backend = backends[b]};
+        struct RegistryHash* reg_table = init_reg_table_config(7, &config);
+        if (!reg_table)
+        {
+            all_inits_ok = false;
+            continue;
+        }
+
+        struct BindingHandle zero = {0};
+        if (lookup_binding_handle(zero, reg_table) != NULL ||
+            resolve_binding("missing", reg_table, &handles[0]) != 1)
+            all_resolves_ok = false;
+
+        for (size_t i = 0; i < 8; i++)
+        {
+            snprintf(name, sizeof(name), "layer_%04zu_w", i);
+            add_binding(name, wrapper_ptr1, reg_table);
+            if (resolve_binding(name, reg_table, &handles[i]) != 0)
+                all_resolves_ok = false;
+        }
+
+        // grow well past the initial size; flat slots move, chained rehashes
+        for (size_t i = 8; i < num_names; i++)
+        {
+            snprintf(name, sizeof(name), "layer_%04zu_w", i);
+            add_binding(name, wrapper_ptr2, reg_table);
+        }
+        for (size_t i = 0; i < 8; i++)
+        {
+            if (lookup_binding_handle(handles[i], reg_table) != wrapper_ptr1)
+                survives_resize = false;
+        }
+
+        // rebind by name: old handle stale, re-resolve sees the new object
+        struct BindingHandle old_handle = handles[0];
+        add_binding("layer_0000_w", wrapper_ptr2, reg_table);
+        if (lookup_binding_handle(old_handle, reg_table) != NULL ||
+            remove_binding_handle(old_handle, reg_table) != 1 ||
+            rebind_handle(&old_handle, wrapper_ptr1, reg_table) != 1 ||
+            rebind_handle(&old_handle, wrapper_ptr1, NULL) != 3)
+            stale_after_rebind = false;
+        if (resolve_binding("layer_0000_w", reg_table, &handles[0]) != 0 ||
+            lookup_binding_handle(handles[0], reg_table) != wrapper_ptr2)
+            stale_after_rebind = false;
+
+        // rebind through the handle: caller's copy refreshed, other copies stale
+        old_handle = handles[1];
+        if (rebind_handle(&handles[1], wrapper_ptr2, reg_table) != 0 ||
+            lookup_binding_handle(handles[1], reg_table) != wrapper_ptr2 ||
+            lookup_binding_handle(old_handle, reg_table) != NULL ||
+            lookup_binding("layer_0001_w", reg_table) != wrapper_ptr2)
+            rebind_handle_ok = false;
+
+        // remove through the handle, then shrink back down
+        for (size_t i = 0; i < 8; i++)
+        {
+            if (remove_binding_handle(handles[i], reg_table) != 0)
+                stale_after_remove = false;
+        }
+        for (size_t i = 8; i < num_names; i++)
+        {
+            snprintf(name, sizeof(name), "layer_%04zu_w", i);
+            remove_binding(name, reg_table);
+        }
+        for (size_t i = 0; i < 8; i++)
+        {
+            snprintf(name, sizeof(name), "layer_%04zu_w", i);
+            if (lookup_binding(name, reg_table) != NULL ||
+                lookup_binding_handle(handles[i], reg_table) != NULL ||
+                remove_binding_handle(handles[i], reg_table) != 1)
+                stale_after_remove = false;
+        }
+
+        // a recycled directory slot must not revive an old handle
+        add_binding("layer_0000_w", wrapper_ptr1, reg_table);
+        struct BindingHandle new_handle = {0};
+        if (resolve_binding("layer_0000_w", reg_table, &new_handle) != 0 ||
+            lookup_binding_handle(handles[0], reg_table) != NULL ||
+            lookup_binding_handle(new_handle, reg_table) != wrapper_ptr1)
+            stale_after_remove = false;
+
+        destroy_reg_table(reg_table);
+    }
+
+    if (debug_get_obj_refcount(wrapper_ptr1) != 1 || debug_get_obj_refcount(wrapper_ptr2) != 1)
+        stale_after_remove = false;
+
+    if (!all_inits_ok)
+        printf("%s FAILED on all_inits_ok.\n%s\n", test_name, DELIM);
+    if (!all_resolves_ok)
+        printf("%s FAILED on all_resolves_ok.\n%s\n", test_name, DELIM);
+    if (!survives_resize)
+        printf("%s FAILED on survives_resize.\n%s\n", test_name, DELIM);
+    if (!stale_after_rebind)
+        printf("%s FAILED on stale_after_rebind.\n%s\n", test_name, DELIM);
+    if (!rebind_handle_ok)
+        printf("%s FAILED on rebind_handle_ok.\n%s\n", test_name, DELIM);
+    if (!stale_after_remove)
+        printf("%s FAILED on stale_after_remove.\n%s\n", test_name, DELIM);
+
+    decref_obj(wrapper_ptr1);
+    decref_obj(wrapper_ptr2);
+    set_log_level(LOG_ALL);
+
+    if (all_inits_ok && all_resolves_ok && survives_resize && stale_after_rebind &&
+        rebind_handle_ok && stale_after_remove)
+    {
+        printf("%s PASSED.\n%s\n", test_name, DELIM);
+        return 0;
+    }
+    else
+    {
+        return 1;
+    }
+}
+
+struct ConcurrentWorker
+{
+    struct RegistryHash* reg_table;
+    struct ObjWrapper* object;
+    size_t id;
+    bool ok;
+};
+
+static void* concurrent_worker(void* arg)
+{
+    // Each worker binds, looks up and removes its own names; half of the
+    // removals go through handles.
+    struct ConcurrentWorker* worker = arg;
+    const size_t num_names = 2000;
+    char name[32];
+
+    worker->ok = true;
+    for (size_t i = 0; i < num_names; i++)
+    {
+        snprintf(name, sizeof(name), "t%zu_layer_%04zu_w", worker->id, i);
+        if (add_binding(name, worker->object, worker->reg_table) != 0)
+            worker->ok = false;
+    }
+    for (size_t i = 0; i < num_names; i++)
+    {
+        snprintf(name, sizeof(name), "t%zu_layer_%04zu_w", worker->id, i);
+        if (lookup_binding(name, worker->reg_table) != worker->object)
+            worker->ok = false;
+    }
+    for (size_t i = 0; i < num_names; i++)
+    {
+        snprintf(name, sizeof(name), "t%zu_layer_%04zu_w", worker->id, i);
+        struct BindingHandle handle = {0};
+        if (i % 2)
+        {
+            if (resolve_binding(name, worker->reg_table, &handle) != 0 ||
+                lookup_binding_handle(handle, worker->reg_table) != worker->object ||
+                remove_binding_handle(handle, worker->reg_table) != 0)
+                worker->ok = false;
+        }
+        else if (remove_binding(name, worker->reg_table) != 0)
+            worker->ok = false;
+    }
+    return NULL;
+}
+
+int test_concurrent_registry_threads()
+{
+    // Concurrent registries keep every binding intact under parallel
+    // add/lookup/remove of disjoint names; both backends.
+    const char* test_name = "test_concurrent_registry_threads";
+    enum
+    {
+        NUM_THREADS = 4
+    };
+    const enum RegistryBackend backends[] = {REG_BACKEND_CHAINED, REG_BACKEND_FLAT};
+    struct ConcurrentWorker workers[NUM_THREADS];
+    pthread_t threads[NUM_THREADS];
+
+    bool all_inits_ok = true;
+    bool all_workers_ok = true;
+    bool refcounts_restored = true;
+
+    set_log_level(LOG_ERROR);
+
+    for (size_t b = 0; b < 2; b++)
+    {
+        struct RegistryConfig config = {.backend = backends[b], .concurrent = true, .shards = 8};
+        struct RegistryHash* reg_table = init_reg_table_config(64, &config);
+        if (!reg_table)
+        {
+            all_inits_ok = false;
+            continue;
+        }
+
+        for (size_t t = 0; t < NUM_THREADS; t++)
+        {
+            workers[t] = (struct ConcurrentWorker){reg_table, create_scalar((double)t), t, false};
+            pthread_create(&threads[t], NULL, concurrent_worker, &workers[t]);
+        }
+        for (size_t t = 0; t < NUM_THREADS; t++)
+        {
+            pthread_join(threads[t], NULL);
+            if (!workers[t].ok)
+                all_workers_ok = false;
+            if (debug_get_obj_refcount(workers[t].object) != 1)
+                refcounts_restored = false;
+            decref_obj(workers[t].object);
+        }
+
+        destroy_reg_table(reg_table);
+    }
+
+    struct RegistryConfig too_many = {.concurrent = true, .shards = 100000};
+    if (init_reg_table_config(64, &too_many) != NULL)
+        all_inits_ok = false;
+
+    if (!all_inits_ok)
+        printf("%s FAILED on all_inits_ok.\n%s\n", test_name, DELIM);
+    if (!all_workers_ok)
+        printf("%s FAILED on all_workers_ok.\n%s\n", test_name, DELIM);
+    if (!refcounts_restored)
+        printf("%s FAILED on refcounts_restored.\n%s\n", test_name, DELIM);
+
+    set_log_level(LOG_ALL);
+
+    if (all_inits_ok && all_workers_ok && refcounts_restored)
+    {
+        printf("%s PASSED.\n%s\n", test_name, DELIM);
+        return 0;
+    }
+    else
+    {
+        return 1;
+    }
+}
+
+struct LockfreeReader
+{
+    struct RegistryHash* reg_table;
+    struct ObjWrapper* object;
+    const bool* stop;
+    size_t lookups;
+    bool ok;
+};
+
+static void* lockfree_reader(void* arg)
+{
+    // Stable names must stay visible while writers churn and rehash.
+    struct LockfreeReader* reader = arg;
+    char name[32];
+
+    reader->ok = true;
+    while (!__atomic_load_n(reader->stop, __ATOMIC_ACQUIRE))
+    {
+        snprintf(name, sizeof(name), "stable_%03zu", reader->lookups % 256);
+        if (lookup_binding(name, reader->reg_table) != reader->object)
+            reader->ok = false;
+        reader->lookups++;
+    }
+    return NULL;
+}
+
+static void* lockfree_writer(void* arg)
+{
+    // Grows each shard well past its initial size, then shrinks it again.
+    struct ConcurrentWorker* worker = arg;
+    char name[32];
+
+    worker->ok = true;
+    for (size_t round = 0; round < 3; round++)
+    {
+        for (size_t i = 0; i < 3000; i++)
+        {
+            snprintf(name, sizeof(name), "w%zu_churn_%04zu", worker->id, i);
+            if (add_binding(name, worker->object, worker->reg_table) != 0)
+                worker->ok = false;
+        }
+        for (size_t i = 0; i < 3000; i++)
+        {
+            snprintf(name, sizeof(name), "w%zu_churn_%04zu", worker->id, i);
+            if (remove_binding(name, worker->reg_table) != 0)
+                worker->ok = false;
+        }
+    }
+    return NULL;
+}
+
+int test_lockfree_lookups_during_writes()
+{
+    // Lookups on a concurrent chained registry run without the shard lock;
+    // they must never miss a stable binding while other threads add, remove
+    // and force rehashes in the same shards.
+    const char* test_name = "test_lockfree_lookups_during_writes";
+    enum
+    {
+        NUM_READERS = 3,
+        NUM_WRITERS = 2
+    };
+    struct LockfreeReader readers[NUM_READERS];
+    struct ConcurrentWorker writers[NUM_WRITERS];
+    pthread_t reader_threads[NUM_READERS];
+    pthread_t writer_threads[NUM_WRITERS];
+    bool stop = false;
+    char name[32];
+
+    bool init_ok = true;
+    bool readers_ok = true;
+    bool writers_ok = true;
+    bool refcounts_restored = true;
+
+    set_log_level(LOG_ERROR);
+
+    struct RegistryConfig config = {.backend = REG_BACKEND_CHAINED, .concurrent = true,
+                                    .shards = 4};
+    struct RegistryHash* reg_table = init_reg_table_config(8, &config);
+    struct ObjWrapper* stable = create_scalar(1.0);
+    if (!reg_table || !stable)
+        init_ok = false;
+
+    for (size_t i = 0; init_ok && i < 256; i++)
+    {
+        snprintf(name, sizeof(name), "stable_%03zu", i);
+        if (add_binding(name, stable, reg_table) != 0)
+            init_ok = false;
+    }
+
+    if (init_ok)
+    {
+        for (size_t r = 0; r < NUM_READERS; r++)
+        {
+            readers[r] = (struct LockfreeReader){reg_table, stable, &stop, r * 97, false};
+            pthread_create(&reader_threads[r], NULL, lockfree_reader, &readers[r]);
+        }
+        for (size_t w = 0; w < NUM_WRITERS; w++)
+        {
+            writers[w] = (struct ConcurrentWorker){reg_table, create_scalar((double)w), w, false};
+            pthread_create(&writer_threads[w], NULL, lockfree_writer, &writers[w]);
+        }
+
+        for (size_t w = 0; w < NUM_WRITERS; w++)
+        {
+            pthread_join(writer_threads[w], NULL);
+            if (!writers[w].ok)
+                writers_ok = false;
+            if (debug_get_obj_refcount(writers[w].object) != 1)
+                refcounts_restored = false;
+            decref_obj(writers[w].object);
+        }
+        __atomic_store_n(&stop, true, __ATOMIC_RELEASE);
+        for (size_t r = 0; r < NUM_READERS; r++)
+        {
+            pthread_join(reader_threads[r], NULL);
+            if (!readers[r].ok)
+                readers_ok = false;
+        }
+    }
+
+    destroy_reg_table(reg_table);
+    if (stable && debug_get_obj_refcount(stable) != 1)
+        refcounts_restored = false;
+    decref_obj(stable);
+
+    if (!init_ok)
+        printf("%s FAILED on init_ok.\n%s\n", test_name, DELIM);
+    if (!readers_ok)
+        printf("%s FAILED on readers_ok.\n%s\n", test_name, DELIM);
+    if (!writers_ok)
+        printf("%s FAILED on writers_ok.\n%s\n", test_name, DELIM);
+    if (!refcounts_restored)
+        printf("%s FAILED on refcounts_restored.\n%s\n", test_name, DELIM);
+
+    set_log_level(LOG_ALL);
+
+    if (init_ok && readers_ok && writers_ok && refcounts_restored)
+    {
+        printf("%s PASSED.\n%s\n", test_name, DELIM);
+        return 0;
+    }
+    else
+    {
+        return 1;
+    }
+}
+
+static void* filtered_reader(void* arg)
+{
+    // Alternates stable names with names no writer ever binds: the first must
+    // pass the filter, the second must miss whether or not the filter is
+    // being rebuilt under the reader.
+    struct LockfreeReader* reader = arg;
+    char name[32];
+
+    reader->ok = true;
+    while (!__atomic_load_n(reader->stop, __ATOMIC_ACQUIRE))
+    {
+        snprintf(name, sizeof(name), "stable_%03zu", reader->lookups % 256);
+        if (lookup_binding(name, reader->reg_table) != reader->object)
+            reader->ok = false;
+        snprintf(name, sizeof(name), "absent_%05zu", reader->lookups % 10000);
+        if (lookup_binding(name, reader->reg_table) != NULL)
+            reader->ok = false;
+        reader->lookups++;
+    }
+    return NULL;
+}
+
+int test_filtered_lookups_during_writes()
+{
+    // As test_lockfree_lookups_during_writes(), with a negative filter in
+    // front of every shard: the writers' churn forces filter rebuilds that
+    // lock-free readers race against.
+    const char* test_name = "test_filtered_lookups_during_writes";
+    enum
+    {
+        NUM_READERS = 3,
+        NUM_WRITERS = 2
+    };
+    struct LockfreeReader readers[NUM_READERS];
+    struct ConcurrentWorker writers[NUM_WRITERS];
+    pthread_t reader_threads[NUM_READERS];
+    pthread_t writer_threads[NUM_WRITERS];
+    struct RegistryStats stats;
+    bool stop = false;
+    char name[32];
+
+    bool init_ok = true;
+    bool readers_ok = true;
+    bool writers_ok = true;
+    bool filter_used = true;
+
+    set_log_level(LOG_ERROR);
+
+    struct RegistryConfig config = {.backend = REG_BACKEND_CHAINED, .concurrent = true,
+                                    .shards = 4, .negative_filter = true};
+    struct RegistryHash* reg_table = init_reg_table_config(8, &config);
+    struct ObjWrapper* stable = create_scalar(1.0);
+    if (!reg_table || !stable)
+        init_ok = false;
+
+    for (size_t i = 0; init_ok && i < 256; i++)
+    {
+        snprintf(name, sizeof(name), "stable_%03zu", i);
+        if (add_binding(name, stable, reg_table) != 0)
+            init_ok = false;
+    }
+
+    if (init_ok)
+    {
+        for (size_t r = 0; r < NUM_READERS; r++)
+        {
+            readers[r] = (struct LockfreeReader){reg_table, stable, &stop, r * 97, false};
+            pthread_create(&reader_threads[r], NULL, filtered_reader, &readers[r]);
+        }
+        for (size_t w = 0; w < NUM_WRITERS; w++)
+        {
+            writers[w] = (struct ConcurrentWorker){reg_table, create_scalar((double)w), w, false};
+            pthread_create(&writer_threads[w], NULL, lockfree_writer, &writers[w]);
+        }
+
+        for (size_t w = 0; w < NUM_WRITERS; w++)
+        {
+            pthread_join(writer_threads[w], NULL);
+            if (!writers[w].ok)
+                writers_ok = false;
+            decref_obj(writers[w].object);
+        }
+        __atomic_store_n(&stop, true, __ATOMIC_RELEASE);
+        for (size_t r = 0; r < NUM_READERS; r++)
+        {
+            pthread_join(reader_threads[r], NULL);
+            if (!readers[r].ok)
+                readers_ok = false;
+        }
+
+        if (registry_stats(reg_table, &stats) != 0 || stats.filter_rejects == 0 ||
+            stats.filter_bytes == 0)
+            filter_used = false;
+    }
+
+    destroy_reg_table(reg_table);
+    decref_obj(stable);
+
+    if (!init_ok)
+        printf("%s FAILED on init_ok.\n%s\n", test_name, DELIM);
+    if (!readers_ok)
+        printf("%s FAILED on readers_ok.\n%s\n", test_name, DELIM);
+    if (!writers_ok)
+        printf("%s FAILED on writers_ok.\n%s\n", test_name, DELIM);
+    if (!filter_used)
+        printf("%s FAILED on filter_used.\n%s\n", test_name, DELIM);
+
+    set_log_level(LOG_ALL);
+
+    if (init_ok && readers_ok && writers_ok && filter_used)
+    {
+        printf("%s PASSED.\n%s\n", test_name, DELIM);
+        return 0;
+    }
+    else
+    {
+        return 1;
+    }
+}
+
+int test_reserve_bindings()
+{
+    // Reserving ahead of a bulk load sizes the registry once; the load itself
+    // then never resizes. Every layout, including concurrent shards.
+    const char* test_name = "test_reserve_bindings";
+    const size_t num_names = 5000;
+    const struct RegistryConfig configs[] = {
+        {.backend = REG_BACKEND_CHAINED},
+        {.backend = REG_BACKEND_FLAT},
+        {.backend = REG_BACKEND_CHAINED, .concurrent = true, .shards = 4},
+        {.backend = REG_BACKEND_FLAT, .concurrent = true, .shards = 4},
+    };
+    char name[32];
+
+    bool invalid_rejected = (reserve_bindings(NULL, 10) == 3);
+    bool reserve_ok = true;
+    bool no_resize_during_load = true;
+    bool bindings_ok = true;
+
+    set_log_level(LOG_ERROR);
+    struct ObjWrapper* object = create_scalar(1.0);
+
+    for (size_t c = 0; c < sizeof(configs) / sizeof(configs[0]); c++)
+    {
+        struct RegistryHash* reg_table = init_reg_table_config(16, &configs[c]);
+        if (!reg_table || reserve_bindings(reg_table, num_names) != 0)
+        {
+            reserve_ok = false;
+            destroy_reg_table(reg_table);
+            continue;
+        }
+
+        size_t reserved_buckets = debug_get_reg_bucket_count(reg_table);
+        if (reserved_buckets < num_names)
+            reserve_ok = false;
+        for (size_t i = 0; i < num_names; i++)
+        {
+            snprintf(name, sizeof(name), "layer_%04zu_w", i);
+            if (add_binding(name, object, reg_table) != 0)
+                bindings_ok = false;
+        }
+        // shards only promise an even spread, so allow them their slack
+        if (!configs[c].concurrent && debug_get_reg_bucket_count(reg_table) != reserved_buckets)
+            no_resize_during_load = false;
+        if (lookup_binding("layer_4999_w", reg_table) != object)
+            bindings_ok = false;
+        if (reserve_bindings(reg_table, 0) != 0)
+            reserve_ok = false;
+
+        destroy_reg_table(reg_table);
+    }
+    decref_obj(object);
+
+    if (!invalid_rejected)
+        printf("%s FAILED on invalid_rejected.\n%s\n", test_name, DELIM);
+    if (!reserve_ok)
+        printf("%s FAILED on reserve_ok.\n%s\n", test_name, DELIM);
+    if (!no_resize_during_load)
+        printf("%s FAILED on no_resize_during_load.\n%s\n", test_name, DELIM);
+    if (!bindings_ok)
+        printf("%s FAILED on bindings_ok.\n%s\n", test_name, DELIM);
+
+    set_log_level(LOG_ALL);
+
+    if (invalid_rejected && reserve_ok && no_resize_during_load && bindings_ok)
+    {
+        printf("%s PASSED.\n%s\n", test_name, DELIM);
+        return 0;
+    }
+    else
+    {
+        return 1;
+    }
+}
+
+int test_registry_stats()
+{
+    // Stats report exact occupancy and operation counts, and the chain
+    // histogram accounts for every bucket (chained) or binding (flat).
+    const char* test_name = "test_registry_stats";
+    const struct RegistryConfig configs[] = {
+        {.backend = REG_BACKEND_CHAINED},
+        {.backend = REG_BACKEND_FLAT},
+        {.backend = REG_BACKEND_CHAINED, .concurrent = true, .shards = 4},
+    };
+    char name[32];
+    struct RegistryStats stats;
+
+    bool invalid_rejected = (registry_stats(NULL, &stats) == 1);
+    bool counts_ok = true;
+    bool histogram_ok = true;
+    bool ratios_ok = true;
+
+    set_log_level(LOG_ERROR);
+    struct ObjWrapper* object = create_scalar(1.0);
+
+    for (size_t c = 0; c < sizeof(configs) / sizeof(configs[0]); c++)
+    {
+        struct RegistryHash* reg_table = init_reg_table_config(32, &configs[c]);
+        if (!reg_table || registry_stats(reg_table, NULL) != 1)
+        {
+            counts_ok = false;
+            destroy_reg_table(reg_table);
+            continue;
+        }
+
+        for (size_t i = 0; i < 300; i++)
+        {
+            snprintf(name, sizeof(name), "layer_%03zu_w", i);
+            add_binding(name, object, reg_table);
+        }
+        for (size_t i = 0; i < 300; i++)
+        {
+            snprintf(name, sizeof(name), "layer_%03zu_w", i);
+            lookup_binding(name, reg_table);
+        }
+        lookup_binding("missing", reg_table);
+        for (size_t i = 0; i < 50; i++)
+        {
+            snprintf(name, sizeof(name), "layer_%03zu_w", i);
+            remove_binding(name, reg_table);
+        }
+
+        if (registry_stats(reg_table, &stats) != 0 || stats.bindings != 250 ||
+            stats.adds != 300 || stats.lookups != 301 || stats.removes != 50)
+            counts_ok = false;
+
+        size_t histogram_total = 0;
+        for (size_t b = 0; b < REG_STATS_HISTOGRAM_BINS; b++)
+            histogram_total += stats.chain_histogram[b];
+        size_t expected_total =
+            (configs[c].backend == REG_BACKEND_FLAT) ? stats.bindings : stats.buckets;
+        if (histogram_total != expected_total)
+            histogram_ok = false;
+
+        double load_factor = (double)stats.bindings / (double)stats.buckets;
+        if (stats.load_factor != load_factor || stats.max_chain < 1 || stats.mean_chain < 1.0 ||
+            stats.mean_chain > (double)stats.max_chain || stats.avg_lookup_probes < 1.0 ||
+            stats.avg_add_probes <= 0.0 || stats.avg_remove_probes < 1.0)
+            ratios_ok = false;
+
+        destroy_reg_table(reg_table);
+    }
+    decref_obj(object);
+
+    if (!invalid_rejected)
+        printf("%s FAILED on invalid_rejected.\n%s\n", test_name, DELIM);
+    if (!counts_ok)
+        printf("%s FAILED on counts_ok.\n%s\n", test_name, DELIM);
+    if (!histogram_ok)
+        printf("%s FAILED on histogram_ok.\n%s\n", test_name, DELIM);
+    if (!ratios_ok)
+        printf("%s FAILED on ratios_ok.\n%s\n", test_name, DELIM);
+
+    set_log_level(LOG_ALL);
+
+    if (invalid_rejected && counts_ok && histogram_ok && ratios_ok)
+    {
+        printf("%s PASSED.\n%s\n", test_name, DELIM);
+        return 0;
+    }
+    else
+    {
+        return 1;
+    }
+}
+
+struct PrefixVisit
+{
+    const char* prefix;
+    size_t count;
+    size_t stop_after; // 0 = never stop
+    bool all_match;
+    struct RegistryHash* remove_from; // non-NULL: remove each visited name
+};
+
+static int prefix_visitor(void* ctx, const char* name)
+{
+    struct PrefixVisit* visit = ctx;
+    if (strncmp(name, visit->prefix, strlen(visit->prefix)) != 0)
+        visit->all_match = false;
+    if (visit->remove_from && remove_binding(name, visit->remove_from) != 0)
+        visit->all_match = false;
+    visit->count++;
+    return (visit->stop_after && visit->count == visit->stop_after) ? 1 : 0;
+}
+
+// Number of names `prefix` enumerates, or (size_t)-1 on error.
+static size_t count_prefix(struct RegistryHash* reg_table, const char* prefix)
+{
+    struct PrefixVisit visit = {prefix, 0, 0, true, NULL};
+    if (for_each_binding_prefix(reg_table, prefix, prefix_visitor, &visit) != 0 ||
+        !visit.all_match)
+        return (size_t)-1;
+    return visit.count;
+}
+
+int test_prefix_index()
+{
+    // Hierarchical names can be enumerated and dropped by prefix on every
+    // layout; removals by name and by handle keep the index in step.
+    const char* test_name = "test_prefix_index";
+    const size_t layers = 40;
+    const struct RegistryConfig configs[] = {
+        {.backend = REG_BACKEND_CHAINED, .prefix_index = true},
+        {.backend = REG_BACKEND_FLAT, .prefix_index = true},
+        {.backend = REG_BACKEND_CHAINED, .concurrent = true, .shards = 4, .prefix_index = true},
+        {.backend = REG_BACKEND_FLAT, .concurrent = true, .shards = 4, .prefix_index = true},
+    };
+    char name[48];
+    size_t removed = 0;
+
+    set_log_level(LOG_ERROR);
+    struct ObjWrapper* object = create_scalar(1.0);
+    size_t base_refs = debug_get_obj_refcount(object);
+
+    struct RegistryHash* plain = init_reg_table(TABLE_SIZE);
+    bool invalid_rejected =
+        (for_each_binding_prefix(plain, "s1.", prefix_visitor, NULL) == 4) &&
+        (remove_bindings_prefix(plain, "s1.", &removed) == 4) &&
+        (for_each_binding_prefix(NULL, "s1.", prefix_visitor, NULL) == 1) &&
+        (remove_bindings_prefix(NULL, "s1.", NULL) == 1);
+    destroy_reg_table(plain);
+
+    bool enumerate_ok = true;
+    bool remove_ok = true;
+    bool survivors_ok = true;
+
+    for (size_t c = 0; c < sizeof(configs) / sizeof(configs[0]); c++)
+    {
+        struct RegistryHash* reg_table = init_reg_table_config(TABLE_SIZE, &configs[c]);
+        if (!reg_table || for_each_binding_prefix(reg_table, NULL, prefix_visitor, NULL) != 1)
+        {
+            enumerate_ok = false;
+            destroy_reg_table(reg_table);
+            continue;
+        }
+
+        for (size_t i = 0; i < layers; i++)
+        {
+            snprintf(name, sizeof(name), "s1.model.layer%02zu.W", i);
+            add_binding(name, object, reg_table);
+            snprintf(name, sizeof(name), "s1.model.layer%02zu.b", i);
+            add_binding(name, object, reg_table);
+            snprintf(name, sizeof(name), "s2.model.layer%02zu.W", i);
+            add_binding(name, object, reg_table);
+        }
+        add_binding("s1.modelx", object, reg_table);
+        add_binding("s1", object, reg_table);
+        add_binding("s1.model.layer00.W", object, reg_table); // rebind: not a new name
+
+        struct PrefixVisit stop = {"s1.", 0, 5, true, NULL};
+        if (count_prefix(reg_table, "s1.model.") != 2 * layers ||
+            count_prefix(reg_table, "s1.mod") != 2 * layers + 1 ||
+            count_prefix(reg_table, "s1") != 2 * layers + 2 ||
+            count_prefix(reg_table, "") != 3 * layers + 2 ||
+            count_prefix(reg_table, "s1.model.layer07.") != 2 ||
+            count_prefix(reg_table, "s1.model.layer07.W") != 1 ||
+            count_prefix(reg_table, "s3.") != 0 ||
+            count_prefix(reg_table, "s1.model.layer07.Wx") != 0 ||
+            for_each_binding_prefix(reg_table, "s1.", prefix_visitor, &stop) != 0 ||
+            stop.count != 5)
+            enumerate_ok = false;
+
+        // single removals leave the index consistent
+        struct BindingHandle handle;
+        remove_binding("s1.model.layer00.b", reg_table);
+        if (resolve_binding("s1.model.layer01.b", reg_table, &handle) != 0 ||
+            remove_binding_handle(handle, reg_table) != 0 ||
+            count_prefix(reg_table, "s1.model.") != 2 * layers - 2)
+            enumerate_ok = false;
+
+        if (remove_bindings_prefix(reg_table, "s1.model.", &removed) != 0 ||
+            removed != 2 * layers - 2 || count_prefix(reg_table, "s1.model.") != 0 ||
+            lookup_binding("s1.model.layer05.W", reg_table) != NULL)
+            remove_ok = false;
+        if (remove_bindings_prefix(reg_table, "nothing.", &removed) != 0 || removed != 0)
+            remove_ok = false;
+
+        if (count_prefix(reg_table, "") != layers + 2 ||
+            lookup_binding("s2.model.layer05.W", reg_table) != object ||
+            lookup_binding("s1.modelx", reg_table) != object ||
+            lookup_binding("s1", reg_table) != object)
+            survivors_ok = false;
+
+        // the visitor may mutate the registry (no lock is held across calls)
+        struct PrefixVisit drop = {"s2.", 0, 0, true, reg_table};
+        if (for_each_binding_prefix(reg_table, "s2.", prefix_visitor, &drop) != 0 ||
+            !drop.all_match || drop.count != layers || count_prefix(reg_table, "") != 2)
+            remove_ok = false;
+
+        if (remove_bindings_prefix(reg_table, "", NULL) != 0 ||
+            debug_get_obj_refcount(object) != base_refs)
+            remove_ok = false;
+
+        destroy_reg_table(reg_table);
+    }
+    decref_obj(object);
+
+    if (!invalid_rejected)
+        printf("%s FAILED on invalid_rejected.\n%s\n", test_name, DELIM);
+    if (!enumerate_ok)
+        printf("%s FAILED on enumerate_ok.\n%s\n", test_name, DELIM);
+    if (!remove_ok)
+        printf("%s FAILED on remove_ok.\n%s\n", test_name, DELIM);
+    if (!survivors_ok)
+        printf("%s FAILED on survivors_ok.\n%s\n", test_name, DELIM);
+
+    set_log_level(LOG_ALL);
+
+    if (invalid_rejected && enumerate_ok && remove_ok && survivors_ok)
+    {
+        printf("%s PASSED.\n%s\n", test_name, DELIM);
+        return 0;
+    }
+    else
+    {
+        return 1;
+    }
+}
+
+int test_prefix_index_churn()
+{
+    // Random adds and removes over names sharing long prefixes split and
+    // re-merge trie edges; per-prefix counts must match a shadow bitmap.
+    const char* test_name = "test_prefix_index_churn";
+    enum
+    {
+        NUM_NAMES = 512,
+        ROUNDS = 20000
+    };
+    const struct RegistryConfig config = {.prefix_index = true};
+    static bool bound[NUM_NAMES];
+    char name[48];
+    unsigned int rng = 12345;
+
+    set_log_level(LOG_ERROR);
+    struct ObjWrapper* object = create_scalar(1.0);
+    struct RegistryHash* reg_table = init_reg_table_config(16, &config);
+    bool init_ok = (reg_table != NULL);
+    bool counts_ok = true;
+
+    for (size_t round = 0; init_ok && round < ROUNDS; round++)
+    {
+        rng = rng * 1103515245u + 12345u;
+        size_t i = (rng >> 8) % NUM_NAMES;
+        // i's bits pick each component, so names share prefixes at several depths
+        snprintf(name, sizeof(name), "s%zu.m%zu.layer%zu", i >> 6, (i >> 3) & 7, i & 7);
+        if (bound[i])
+            counts_ok = counts_ok && (remove_binding(name, reg_table) == 0);
+        else
+            counts_ok = counts_ok && (add_binding(name, object, reg_table) == 0);
+        bound[i] = !bound[i];
+
+        if (round % 997 != 0)
+            continue;
+        size_t expected_all = 0;
+        size_t expected_s3 = 0;
+        size_t expected_s3_m5 = 0;
+        for (size_t j = 0; j < NUM_NAMES; j++)
+        {
+            expected_all += bound[j];
+            expected_s3 += bound[j] && (j >> 6) == 3;
+            expected_s3_m5 += bound[j] && (j >> 6) == 3 && ((j >> 3) & 7) == 5;
+        }
+        if (count_prefix(reg_table, "") != expected_all ||
+            count_prefix(reg_table, "s3.") != expected_s3 ||
+            count_prefix(reg_table, "s3.m5.") != expected_s3_m5)
+            counts_ok = false;
+    }
+
+    size_t removed = 0;
+    size_t expected_all = 0;
+    for (size_t j = 0; j < NUM_NAMES; j++)
+        expected_all += bound[j];
+    if (init_ok && (remove_bindings_prefix(reg_table, "s", &removed) != 0 ||
+                    removed != expected_all || count_prefix(reg_table, "") != 0))
+        counts_ok = false;
+
+    destroy_reg_table(reg_table);
+    decref_obj(object);
+
+    if (!init_ok)
+        printf("%s FAILED on init_ok.\n%s\n", test_name, DELIM);
+    if (!counts_ok)
+        printf("%s FAILED on counts_ok.\n%s\n", test_name, DELIM);
+
+    set_log_level(LOG_ALL);
+
+    if (init_ok && counts_ok)
+    {
+        printf("%s PASSED.\n%s\n", test_name, DELIM);
+        return 0;
+    }
+    else
+    {
+        return 1;
+    }
+}
+
+int test_freeze_registry()
+{
+    // A frozen registry answers every bound name in one probe and rejects
+    // unbound ones; any write thaws it and the table takes over seamlessly.
+    const char* test_name = "test_freeze_registry";
+    const size_t num_names = 3000;
+    const struct RegistryConfig configs[] = {
+        {.backend = REG_BACKEND_CHAINED},
+        {.backend = REG_BACKEND_FLAT},
+        {.backend = REG_BACKEND_CHAINED, .concurrent = true, .shards = 4},
+        {.backend = REG_BACKEND_FLAT, .concurrent = true, .shards = 4},
+    };
+    char name[32];
+    struct RegistryStats before;
+    struct RegistryStats after;
+
+    bool invalid_rejected = (freeze_registry(NULL) == 3);
+    bool freeze_ok = true;
+    bool frozen_lookups_ok = true;
+    bool no_op_keeps_frozen = true;
+    bool thaw_ok = true;
+
+    set_log_level(LOG_ERROR);
+    struct ObjWrapper* object = create_scalar(1.0);
+    struct ObjWrapper* other = create_scalar(2.0);
+
+    for (size_t c = 0; c < sizeof(configs) / sizeof(configs[0]); c++)
+    {
+        struct RegistryHash* reg_table = init_reg_table_config(64, &configs[c]);
+        if (!reg_table || freeze_registry(reg_table) != 0 || lookup_binding("x", reg_table))
+        {
+            freeze_ok = false; // empty registries freeze too
+            destroy_reg_table(reg_table);
+            continue;
+        }
+
+        for (size_t i = 0; i < num_names; i++)
+        {
+            snprintf(name, sizeof(name), "layer_%04zu_w", i);
+            add_binding(name, (i % 2) ? object : other, reg_table);
+        }
+        if (freeze_registry(reg_table) != 0 || freeze_registry(reg_table) != 0 ||
+            registry_stats(reg_table, &before) != 0 || before.frozen_bindings != num_names ||
+            before.frozen_bytes == 0)
+            freeze_ok = false;
+
+        for (size_t i = 0; i < num_names; i++)
+        {
+            snprintf(name, sizeof(name), "layer_%04zu_w", i);
+            if (lookup_binding(name, reg_table) != ((i % 2) ? object : other))
+                frozen_lookups_ok = false;
+        }
+        if (lookup_binding("layer_9999_w", reg_table) || lookup_binding("layer_0001_", reg_table))
+            frozen_lookups_ok = false;
+        registry_stats(reg_table, &after);
+        if (after.lookups - before.lookups != num_names + 2 ||
+            after.lookup_probes - before.lookup_probes != num_names + 2)
+            frozen_lookups_ok = false; // exactly one probe per lookup
+
+        // writes that change nothing keep every shard frozen
+        struct BindingHandle handle;
+        if (remove_binding("layer_9999_w", reg_table) != 1 ||
+            add_binding("layer_0001_w", object, reg_table) != 0 ||
+            resolve_binding("layer_0003_w", reg_table, &handle) != 0 ||
+            rebind_handle(&handle, object, reg_table) != 0 ||
+            remove_binding_handle((struct BindingHandle){0}, reg_table) != 1 ||
+            registry_stats(reg_table, &after) != 0 || after.frozen_bindings != num_names)
+            no_op_keeps_frozen = false;
+
+        // add, rebind (by name and by handle) and remove each thaw (only the
+        // written shard, for concurrent registries)
+        if (add_binding("fresh", object, reg_table) != 0 ||
+            lookup_binding("fresh", reg_table) != object ||
+            registry_stats(reg_table, &after) != 0 || after.frozen_bindings >= num_names ||
+            (!configs[c].concurrent && after.frozen_bindings != 0))
+            thaw_ok = false;
+        freeze_registry(reg_table);
+        if (add_binding("layer_0000_w", object, reg_table) != 0 ||
+            lookup_binding("layer_0000_w", reg_table) != object)
+            thaw_ok = false;
+        freeze_registry(reg_table);
+        if (resolve_binding("layer_0002_w", reg_table, &handle) != 0 ||
+            rebind_handle(&handle, object, reg_table) != 0 ||
+            lookup_binding("layer_0002_w", reg_table) != object)
+            thaw_ok = false;
+        freeze_registry(reg_table);
+        if (remove_binding("layer_0003_w", reg_table) != 0 ||
+            lookup_binding("layer_0003_w", reg_table) != NULL ||
+            lookup_binding("layer_0005_w", reg_table) != object)
+            thaw_ok = false;
+
+        destroy_reg_table(reg_table);
+    }
+    if (debug_get_obj_refcount(object) != 1 || debug_get_obj_refcount(other) != 1)
+        thaw_ok = false;
+    decref_obj(object);
+    decref_obj(other);
+
+    if (!invalid_rejected)
+        printf("%s FAILED on invalid_rejected.\n%s\n", test_name, DELIM);
+    if (!freeze_ok)
+        printf("%s FAILED on freeze_ok.\n%s\n", test_name, DELIM);
+    if (!frozen_lookups_ok)
+        printf("%s FAILED on frozen_lookups_ok.\n%s\n", test_name, DELIM);
+    if (!no_op_keeps_frozen)
+        printf("%s FAILED on no_op_keeps_frozen.\n%s\n", test_name, DELIM);
+    if (!thaw_ok)
+        printf("%s FAILED on thaw_ok.\n%s\n", test_name, DELIM);
+
+    set_log_level(LOG_ALL);
+
+    if (invalid_rejected && freeze_ok && frozen_lookups_ok && no_op_keeps_frozen && thaw_ok)
+    {
+        printf("%s PASSED.\n%s\n", test_name, DELIM);
+        return 0;
+    }
+    else
+    {
+        return 1;
+    }
+}
+
+static void* freeze_writer(void* arg)
+{
+    // Alternates freezing with writes so readers keep crossing thaws.
+    struct ConcurrentWorker* worker = arg;
+    char name[32];
+
+    worker->ok = true;
+    for (size_t i = 0; i < 300; i++)
+    {
+        snprintf(name, sizeof(name), "w%zu_churn_%03zu", worker->id, (i / 2) % 50);
+        int freeze_ret = freeze_registry(worker->reg_table);
+        int write_ret = (i % 2) ? remove_binding(name, worker->reg_table)
+                                : add_binding(name, worker->object, worker->reg_table);
+        if (freeze_ret != 0 || write_ret != 0)
+            worker->ok = false;
+    }
+    return NULL;
+}
+
+int test_frozen_lookups_during_thaw()
+{
+    // Lock-free readers must see stable bindings whether they hit the frozen
+    // snapshot, the table, or a snapshot that is being thawed under them.
+    const char* test_name = "test_frozen_lookups_during_thaw";
+    enum
+    {
+        NUM_READERS = 3
+    };
+    struct LockfreeReader readers[NUM_READERS];
+    pthread_t reader_threads[NUM_READERS];
+    pthread_t writer_thread;
+    bool stop = false;
+    char name[32];
+
+    bool init_ok = true;
+    bool readers_ok = true;
+    bool writer_ok = true;
+
+    set_log_level(LOG_ERROR);
+
+    struct RegistryConfig config = {.backend = REG_BACKEND_CHAINED, .concurrent = true,
+                                    .shards = 4};
+    struct RegistryHash* reg_table = init_reg_table_config(64, &config);
+    struct ObjWrapper* stable = create_scalar(1.0);
+    struct ObjWrapper* churn = create_scalar(2.0);
+    if (!reg_table || !stable || !churn)
+        init_ok = false;
+
+    for (size_t i = 0; init_ok && i < 256; i++)
+    {
+        snprintf(name, sizeof(name), "stable_%03zu", i);
+        if (add_binding(name, stable, reg_table) != 0)
+            init_ok = false;
+    }
+
+    if (init_ok)
+    {
+        for (size_t r = 0; r < NUM_READERS; r++)
+        {
+            readers[r] = (struct LockfreeReader){reg_table, stable, &stop, r * 97, false};
+            pthread_create(&reader_threads[r], NULL, lockfree_reader, &readers[r]);
+        }
+        struct ConcurrentWorker writer = {reg_table, churn, 0, false};
+        pthread_create(&writer_thread, NULL, freeze_writer, &writer);
+        pthread_join(writer_thread, NULL);
+        writer_ok = writer.ok;
+
+        __atomic_store_n(&stop, true, __ATOMIC_RELEASE);
+        for (size_t r = 0; r < NUM_READERS; r++)
+        {
+            pthread_join(reader_threads[r], NULL);
+            if (!readers[r].ok)
+                readers_ok = false;
+        }
+    }
+
+    destroy_reg_table(reg_table);
+    decref_obj(stable);
+    decref_obj(churn);
+
+    if (!init_ok)
+        printf("%s FAILED on init_ok.\n%s\n", test_name, DELIM);
+    if (!readers_ok)
+        printf("%s FAILED on readers_ok.\n%s\n", test_name, DELIM);
+    if (!writer_ok)
+        printf("%s FAILED on writer_ok.\n%s\n", test_name, DELIM);
+
+    set_log_level(LOG_ALL);
+
+    if (init_ok && readers_ok && writer_ok)
+    {
+        printf("%s PASSED.\n%s\n", test_name, DELIM);
+        return 0;
+    }
+    else
+    {
+        return 1;
+    }
+}
+
+int test_mphf_build_failure_rate()
+{
+    // Perfect hash builds over distinct hashes succeed on the first salts at
+    // every size, including the small tables a sharded registry freezes.
+    const char* test_name = "test_mphf_build_failure_rate";
+    enum
+    {
+        MAX_KEYS = 160,
+        BUILDS_PER_SIZE = 12,
+        LARGE_KEYS = 20000
+    };
+    static struct RegMphfKey keys[LARGE_KEYS];
+    static char names[LARGE_KEYS][24]; // "k" + any size_t
+    uint64_t state = 0x2545F4914F6CDD1Dull;
+
+    size_t builds = 0;
+    size_t failures = 0;
+    bool lookups_ok = true;
+
+    set_log_level(LOG_ERROR);
+
+    for (size_t n = 0; n <= MAX_KEYS + 1; n++)
+    {
+        // the final pass builds one large table
+        size_t count = (n <= MAX_KEYS) ? n : LARGE_KEYS;
+        size_t repeats = (n <= MAX_KEYS) ? BUILDS_PER_SIZE : 1;
+        for (size_t r = 0; r < repeats; r++)
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                state ^= state << 13; // xorshift64: distinct, well-spread hashes
+                state ^= state >> 7;
+                state ^= state << 17;
+                snprintf(names[i], sizeof(names[i]), "k%zu", i);
+                keys[i] = (struct RegMphfKey){names[i], state, (struct ObjWrapper*)&keys[i]};
+            }
+
+            struct RegMphf* table = NULL;
+            builds++;
+            if (reg_mphf_build(keys, count, state, NULL, &table) != 0)
+            {
+                failures++;
+                continue;
+            }
+            for (size_t i = 0; i < count; i++)
+            {
+                if (reg_mphf_find(table, names[i], keys[i].hash) != keys[i].object)
+                    lookups_ok = false;
+            }
+            if (reg_mphf_find(table, "missing", state + 1) || reg_mphf_count(table) != count ||
+                reg_mphf_slots(table) < count)
+                lookups_ok = false;
+            reg_mphf_destroy(table);
+        }
+    }
+
+    bool failure_rate_ok = (failures == 0);
+    if (!failure_rate_ok)
+        printf("%s FAILED on failure_rate_ok (%zu of %zu builds).\n%s\n", test_name, failures,
+               builds, DELIM);
+    if (!lookups_ok)
+        printf("%s FAILED on lookups_ok.\n%s\n", test_name, DELIM);
+
+    set_log_level(LOG_ALL);
+
+    if (failure_rate_ok && lookups_ok)
+    {
+        printf("%s PASSED.\n%s\n", test_name, DELIM);
+        return 0;
+    }
+    else
+    {
+        return 1;
+    }
+}
+
+int test_negative_filter()
+{
+    // The filter answers most misses on its own, never hides a bound name
+    // (through growth, removal churn and freezing) and reports its cost.
+    const char* test_name = "test_negative_filter";
+    const size_t num_names = 5000;
+    const size_t num_misses = 20000;
+    const struct RegistryConfig configs[] = {
+        {.backend = REG_BACKEND_CHAINED, .negative_filter = true},
+        {.backend = REG_BACKEND_FLAT, .negative_filter = true},
+        {.backend = REG_BACKEND_CHAINED, .concurrent = true, .shards = 4, .negative_filter = true},
+        {.backend = REG_BACKEND_FLAT, .concurrent = true, .shards = 4, .negative_filter = true},
+    };
+    char name[32];
+    struct RegistryStats before;
+    struct RegistryStats after;
+
+    bool no_false_negatives = true;
+    bool misses_filtered = true;
+    bool stats_ok = true;
+    bool churn_ok = true;
+
+    set_log_level(LOG_ERROR);
+    struct ObjWrapper* object = create_scalar(1.0);
+
+    // without the option nothing is reported
+    struct RegistryHash* plain = init_reg_table(TABLE_SIZE);
+    add_binding("a", object, plain);
+    lookup_binding("b", plain);
+    if (registry_stats(plain, &after) != 0 || after.filter_bytes != 0 ||
+        after.filter_rejects != 0 || after.filter_false_positives != 0)
+        stats_ok = false;
+    destroy_reg_table(plain);
+
+    for (size_t c = 0; c < sizeof(configs) / sizeof(configs[0]); c++)
+    {
+        struct RegistryHash* reg_table = init_reg_table_config(64, &configs[c]);
+        if (!reg_table)
+        {
+            stats_ok = false;
+            continue;
+        }
+
+        // grows well past the initial filter capacity
+        for (size_t i = 0; i < num_names; i++)
+        {
+            snprintf(name, sizeof(name), "blk%zu.attn.w", i);
+            add_binding(name, object, reg_table);
+        }
+        for (size_t i = 0; i < num_names; i++)
+        {
+            snprintf(name, sizeof(name), "blk%zu.attn.w", i);
+            if (lookup_binding(name, reg_table) != object)
+                no_false_negatives = false;
+        }
+
+        registry_stats(reg_table, &before);
+        for (size_t i = 0; i < num_misses; i++)
+        {
+            snprintf(name, sizeof(name), "blk%zu.mlp.w", i);
+            lookup_binding(name, reg_table);
+        }
+        registry_stats(reg_table, &after);
+        uint64_t rejects = after.filter_rejects - before.filter_rejects;
+        uint64_t passed = after.filter_false_positives - before.filter_false_positives;
+        if (rejects + passed != num_misses || passed > num_misses / 50)
+            misses_filtered = false;
+        if (after.filter_bytes == 0 || after.filter_bits_per_binding <= 0.0 ||
+            after.filter_fpr < 0.0 || after.filter_fpr > 0.02 ||
+            after.lookups - before.lookups != num_misses)
+            stats_ok = false;
+
+        // remove most names (stale hashes force rebuilds), then freeze
+        for (size_t i = 0; i < num_names; i++)
+        {
+            if (i % 5 == 0)
+                continue;
+            snprintf(name, sizeof(name), "blk%zu.attn.w", i);
+            if (remove_binding(name, reg_table) != 0)
+                churn_ok = false;
+        }
+        for (int pass = 0; pass < 2; pass++)
+        {
+            for (size_t i = 0; i < num_names; i++)
+            {
+                snprintf(name, sizeof(name), "blk%zu.attn.w", i);
+                if (lookup_binding(name, reg_table) != ((i % 5 == 0) ? object : NULL))
+                    churn_ok = false;
+            }
+            if (freeze_registry(reg_table) != 0)
+                churn_ok = false;
+        }
+        registry_stats(reg_table, &before);
+        if (before.filter_bytes >= after.filter_bytes)
+            churn_ok = false; // rebuilt smaller for the remaining bindings
+
+        destroy_reg_table(reg_table);
+    }
+    if (debug_get_obj_refcount(object) != 1)
+        churn_ok = false;
+    decref_obj(object);
+
+    if (!no_false_negatives)
+        printf("%s FAILED on no_false_negatives.\n%s\n", test_name, DELIM);
+    if (!misses_filtered)
+        printf("%s FAILED on misses_filtered.\n%s\n", test_name, DELIM);
+    if (!stats_ok)
+        printf("%s FAILED on stats_ok.\n%s\n", test_name, DELIM);
+    if (!churn_ok)
+        printf("%s FAILED on churn_ok.\n%s\n", test_name, DELIM);
+
+    if (no_false_negatives && misses_filtered && stats_ok && churn_ok)
+    {
+        printf("%s PASSED.\n%s\n", test_name, DELIM);
+        return 0;
+    }
+    else
+    {
+        return 1;
+    }
+}
+
+int test_registry_snapshots()
+{
+    // A snapshot keeps the mapping (and objects) of the instant it was taken
+    // through overwrites, adds, removes (by name or handle) and registry
+    // teardown; unchanged registries share one version.
+    const char* test_name = "test_registry_snapshots";
+    const size_t num_names = 500;
+    const struct RegistryConfig configs[] = {
+        {.backend = REG_BACKEND_CHAINED},
+        {.backend = REG_BACKEND_FLAT},
+        {.backend = REG_BACKEND_CHAINED, .concurrent = true, .shards = 4},
+        {.backend = REG_BACKEND_FLAT, .concurrent = true, .shards = 4, .negative_filter = true},
+        {.backend = REG_BACKEND_CHAINED, .snapshots = true, .prefix_index = true},
+        {.backend = REG_BACKEND_FLAT, .concurrent = true, .shards = 4, .snapshots = true},
+    };
+    char name[32];
+    struct RegSnapshot* snapshot = NULL;
+
+    bool invalid_rejected = true;
+    bool empty_ok = true;
+    bool isolation_ok = true;
+    bool sharing_ok = true;
+    bool lifetime_ok = true;
+    bool persist_ok = true;
+
+    set_log_level(LOG_ERROR);
+    struct ObjWrapper* object = create_scalar(1.0);
+    struct ObjWrapper* other = create_scalar(2.0);
+
+    if (snapshot_registry(NULL, &snapshot) != 3 || snapshot != NULL ||
+        snapshot_lookup(NULL, "x") != NULL || snapshot_count(NULL) != 0 ||
+        release_snapshot(NULL) != 0)
+        invalid_rejected = false;
+
+    for (size_t c = 0; c < sizeof(configs) / sizeof(configs[0]); c++)
+    {
+        struct RegistryHash* reg_table = init_reg_table_config(64, &configs[c]);
+        struct ObjWrapper* solo = create_scalar(3.0);
+        struct RegSnapshot* first = NULL;
+        struct RegSnapshot* second = NULL;
+        struct RegSnapshot* after = NULL;
+        struct BindingHandle rebound = {0};
+        struct BindingHandle removed = {0};
+        if (!reg_table || !solo || snapshot_registry(reg_table, NULL) != 3)
+        {
+            invalid_rejected = false;
+            destroy_reg_table(reg_table);
+            decref_obj(solo);
+            continue;
+        }
+
+        if (snapshot_registry(reg_table, &first) != 0 || snapshot_count(first) != 0 ||
+            snapshot_lookup(first, "x") != NULL)
+            empty_ok = false;
+        release_snapshot(first);
+
+        for (size_t i = 0; i < num_names; i++)
+        {
+            snprintf(name, sizeof(name), "node%zu.out", i);
+            add_binding(name, object, reg_table);
+        }
+        add_binding("solo", solo, reg_table);
+        // the registry's persistent map holds its own reference from the start
+        if (configs[c].snapshots && debug_get_obj_refcount(solo) != 3)
+            persist_ok = false;
+        if (snapshot_registry(reg_table, &first) != 0 ||
+            snapshot_count(first) != num_names + 1 ||
+            debug_get_obj_refcount(solo) != 3)
+            isolation_ok = false;
+
+        // no write in between: the second snapshot takes no new references
+        if (snapshot_registry(reg_table, &second) != 0 ||
+            snapshot_count(second) != num_names + 1 || debug_get_obj_refcount(solo) != 3)
+            sharing_ok = false;
+
+        add_binding("solo", other, reg_table);
+        add_binding("fresh", object, reg_table);
+        remove_binding("node7.out", reg_table);
+        if (resolve_binding("node9.out", reg_table, &rebound) != 0 ||
+            rebind_handle(&rebound, other, reg_table) != 0 ||
+            resolve_binding("node10.out", reg_table, &removed) != 0 ||
+            remove_binding_handle(removed, reg_table) != 0)
+            persist_ok = false;
+        decref_obj(solo); // only the snapshots keep it alive now
+        if (snapshot_lookup(first, "solo") != solo || snapshot_lookup(second, "solo") != solo ||
+            snapshot_lookup(first, "fresh") != NULL ||
+            snapshot_lookup(first, "node7.out") != object ||
+            snapshot_lookup(first, "node8.out") != object || snapshot_count(first) != num_names + 1)
+            isolation_ok = false;
+        if (snapshot_lookup(first, "node9.out") != object ||
+            snapshot_lookup(first, "node10.out") != object)
+            persist_ok = false;
+        if (get_obj_type(solo) != OBJ_SCALAR || debug_get_obj_refcount(solo) != 1)
+            lifetime_ok = false;
+
+        if (snapshot_registry(reg_table, &after) != 0 || snapshot_lookup(after, "solo") != other ||
+            snapshot_lookup(after, "fresh") != object ||
+            snapshot_lookup(after, "node7.out") != NULL || snapshot_count(after) != num_names)
+            isolation_ok = false;
+        if (snapshot_lookup(after, "node9.out") != other ||
+            snapshot_lookup(after, "node10.out") != NULL)
+            persist_ok = false;
+        release_snapshot(first);
+        release_snapshot(second); // last reference: solo is destroyed here
+
+        // the snapshot outlives its registry
+        destroy_reg_table(reg_table);
+        if (snapshot_lookup(after, "node8.out") != object || snapshot_lookup(after, "zzz") != NULL)
+            lifetime_ok = false;
+        release_snapshot(after);
+    }
+    if (debug_get_obj_refcount(object) != 1 || debug_get_obj_refcount(other) != 1)
+        lifetime_ok = false;
+    decref_obj(object);
+    decref_obj(other);
+
+    if (!invalid_rejected)
+        printf("%s FAILED on invalid_rejected.\n%s\n", test_name, DELIM);
+    if (!empty_ok)
+        printf("%s FAILED on empty_ok.\n%s\n", test_name, DELIM);
+    if (!isolation_ok)
+        printf("%s FAILED on isolation_ok.\n%s\n", test_name, DELIM);
+    if (!sharing_ok)
+        printf("%s FAILED on sharing_ok.\n%s\n", test_name, DELIM);
+    if (!lifetime_ok)
+        printf("%s FAILED on lifetime_ok.\n%s\n", test_name, DELIM);
+    if (!persist_ok)
+        printf("%s FAILED on persist_ok.\n%s\n", test_name, DELIM);
+
+    set_log_level(LOG_ALL);
+
+    if (invalid_rejected && empty_ok && isolation_ok && sharing_ok && lifetime_ok && persist_ok)
+    {
+        printf("%s PASSED.\n%s\n", test_name, DELIM);
+        return 0;
+    }
+    else
+    {
+        return 1;
+    }
+}
+
+static void* snapshot_writer(void* arg)
+{
+    // Appends gen_<i> names in order and points "latest" at a new object each
+    // time, dropping the previous one from the registry.
+    struct ConcurrentWorker* worker = arg;
+    char name[32];
+
+    worker->ok = true;
+    for (size_t i = 0; i < 2000; i++)
+    {
+        struct ObjWrapper* latest = create_scalar((double)i);
+        snprintf(name, sizeof(name), "gen_%zu", i);
+        if (!latest || add_binding(name, worker->object, worker->reg_table) != 0 ||
+            add_binding("latest", latest, worker->reg_table) != 0)
+            worker->ok = false;
+        decref_obj(latest);
+    }
+    return NULL;
+}
+
+static void* snapshot_reader(void* arg)
+{
+    // Every snapshot must be one cut of the writer's sequence: gen_0..gen_n-1
+    // and nothing after, with "latest" alive for as long as it is pinned.
+    struct LockfreeReader* reader = arg;
+    char name[32];
+
+    reader->ok = true;
+    while (!__atomic_load_n(reader->stop, __ATOMIC_ACQUIRE))
+    {
+        struct RegSnapshot* snapshot = NULL;
+        if (snapshot_registry(reader->reg_table, &snapshot) != 0)
+        {
+            reader->ok = false;
+            break;
+        }
+
+        struct ObjWrapper* latest = snapshot_lookup(snapshot, "latest");
+        size_t gens = snapshot_count(snapshot) - (latest ? 1 : 0);
+        snprintf(name, sizeof(name), "gen_%zu", gens);
+        if (snapshot_lookup(snapshot, name) != NULL)
+            reader->ok = false;
+        snprintf(name, sizeof(name), "gen_%zu", gens ? gens - 1 : 0);
+        if (gens && snapshot_lookup(snapshot, name) != reader->object)
+            reader->ok = false;
+        if (latest && get_obj_type(latest) != OBJ_SCALAR)
+            reader->ok = false;
+
+        release_snapshot(snapshot);
+        reader->lookups++;
+    }
+    return NULL;
+}
+
+int test_snapshot_readers_during_writes()
+{
+    // Snapshot readers on other threads see consistent cuts across shards
+    // while a writer keeps adding and rebinding.
+    const char* test_name = "test_snapshot_readers_during_writes";
+    enum
+    {
+        NUM_READERS = 3
+    };
+    struct LockfreeReader readers[NUM_READERS];
+    pthread_t reader_threads[NUM_READERS];
+    pthread_t writer_thread;
+    bool stop = false;
+
+    bool init_ok = true;
+    bool readers_ok = true;
+    bool writer_ok = true;
+
+    set_log_level(LOG_ERROR);
+
+    struct RegistryConfig config = {.backend = REG_BACKEND_CHAINED, .concurrent = true,
+                                    .shards = 4};
+    struct RegistryHash* reg_table = init_reg_table_config(64, &config);
+    struct ObjWrapper* object = create_scalar(1.0);
+    if (!reg_table || !object)
+        init_ok = false;
+
+    if (init_ok)
+    {
+        for (size_t r = 0; r < NUM_READERS; r++)
+        {
+            readers[r] = (struct LockfreeReader){reg_table, object, &stop, 0, false};
+            pthread_create(&reader_threads[r], NULL, snapshot_reader, &readers[r]);
+        }
+        struct ConcurrentWorker writer = {reg_table, object, 0, false};
+        pthread_create(&writer_thread, NULL, snapshot_writer, &writer);
+        pthread_join(writer_thread, NULL);
+        writer_ok = writer.ok;
+
+        __atomic_store_n(&stop, true, __ATOMIC_RELEASE);
+        for (size_t r = 0; r < NUM_READERS; r++)
+        {
+            pthread_join(reader_threads[r], NULL);
+            if (!readers[r].ok || readers[r].lookups == 0)
+                readers_ok = false;
+        }
+    }
+
+    destroy_reg_table(reg_table);
+    if (object && debug_get_obj_refcount(object) != 1)
+        readers_ok = false; // every snapshot reference was given back
+    decref_obj(object);
+
+    if (!init_ok)
+        printf("%s FAILED on init_ok.\n%s\n", test_name, DELIM);
+    if (!readers_ok)
+        printf("%s FAILED on readers_ok.\n%s\n", test_name, DELIM);
+    if (!writer_ok)
+        printf("%s FAILED on writer_ok.\n%s\n", test_name, DELIM);
+
+    set_log_level(LOG_ALL);
+
+    if (init_ok && readers_ok && writer_ok)
+    {
+        printf("%s PASSED.\n%s\n", test_name, DELIM);
+        return 0;
+    }
+    else
+    {
+        return 1;
+    }
+}